@@ -0,0 +1,106 @@
+-- Dates are stored as day numbers: days since 1970-01-01, the julian day 2440587.5.
+--   date -> day number:  CAST(julianday(date) - 2440587.5 AS INTEGER)
+--   day number -> date:  date(day + 2440587.5)
+-- Range filters compare integers, and the tables with a composite primary key are stored without a rowid.
+-- Dates julianday() can not parse are kept as they were in Member_InvalidDate and Attendance_InvalidDate,
+-- the server logs their number at startup.
+
+-- Unparsable dates of members, the member itself keeps NULL in their place
+CREATE TABLE Member_InvalidDate (
+    member_id   INTEGER NOT NULL,
+    birthDate   TEXT,
+    createDate  TEXT
+);
+
+INSERT INTO Member_InvalidDate (member_id, birthDate, createDate)
+SELECT id, birthDate, createDate
+FROM Member
+WHERE (birthDate IS NOT NULL AND julianday(birthDate) IS NULL)
+   OR (createDate IS NOT NULL AND julianday(createDate) IS NULL);
+
+-- Member table
+CREATE TABLE Member_new (
+    id          INTEGER PRIMARY KEY,
+    firstName   VARCHAR(100),
+    lastName    VARCHAR(100),
+    email       VARCHAR(255),
+    phoneNumber VARCHAR(100),
+    birthDate   INTEGER,
+    createDate  INTEGER,
+    notes       TEXT,
+    active      BOOLEAN
+);
+
+INSERT INTO Member_new (id, firstName, lastName, email, phoneNumber, birthDate, createDate, notes, active)
+SELECT id, firstName, lastName, email, phoneNumber,
+       CAST(julianday(birthDate) - 2440587.5 AS INTEGER),
+       CAST(julianday(createDate) - 2440587.5 AS INTEGER),
+       notes, active
+FROM Member;
+
+DROP TABLE Member;
+ALTER TABLE Member_new RENAME TO Member;
+
+-- Member as the API sees it, with the day numbers mapped back to YYYY-MM-DD
+CREATE VIEW MemberView AS
+SELECT id, firstName, lastName, email, phoneNumber,
+       date(birthDate + 2440587.5) AS birthDate,
+       date(createDate + 2440587.5) AS createDate,
+       notes, active
+FROM Member;
+
+-- Attendances without a member or a valid date can not be part of any range and are moved aside
+CREATE TABLE Attendance_InvalidDate (
+    member_id   INTEGER,
+    date        TEXT
+);
+
+INSERT INTO Attendance_InvalidDate (member_id, date)
+SELECT member_id, date
+FROM Attendance
+WHERE member_id IS NULL OR julianday(date) IS NULL;
+
+CREATE TABLE Attendance_new (
+    member_id   INTEGER NOT NULL,
+    date        INTEGER NOT NULL,
+    PRIMARY KEY (member_id, date),
+    FOREIGN KEY (member_id) REFERENCES Member(id)
+) WITHOUT ROWID;
+
+INSERT OR IGNORE INTO Attendance_new (member_id, date)
+SELECT member_id, CAST(julianday(date) - 2440587.5 AS INTEGER)
+FROM Attendance
+WHERE member_id IS NOT NULL AND julianday(date) IS NOT NULL;
+
+DROP TABLE Attendance;
+ALTER TABLE Attendance_new RENAME TO Attendance;
+
+-- junction tables
+
+CREATE TABLE Address_Member_new (
+    address_id          INTEGER NOT NULL,
+    member_id           INTEGER NOT NULL,
+    PRIMARY KEY (address_id, member_id),
+    FOREIGN KEY (address_id) REFERENCES Address(id),
+    FOREIGN KEY (member_id) REFERENCES Member(id)
+) WITHOUT ROWID;
+
+INSERT OR IGNORE INTO Address_Member_new (address_id, member_id)
+SELECT address_id, member_id FROM Address_Member WHERE address_id IS NOT NULL AND member_id IS NOT NULL;
+
+DROP TABLE Address_Member;
+ALTER TABLE Address_Member_new RENAME TO Address_Member;
+
+CREATE TABLE Department_Member_new (
+    department_id       INTEGER NOT NULL,
+    member_id           INTEGER NOT NULL,
+    PRIMARY KEY (department_id, member_id),
+    FOREIGN KEY (department_id) REFERENCES Department(id),
+    FOREIGN KEY (member_id) REFERENCES Member(id)
+) WITHOUT ROWID;
+
+INSERT OR IGNORE INTO Department_Member_new (department_id, member_id)
+SELECT department_id, member_id FROM Department_Member WHERE department_id IS NOT NULL AND member_id IS NOT NULL;
+
+DROP TABLE Department_Member;
+ALTER TABLE Department_Member_new RENAME TO Department_Member;
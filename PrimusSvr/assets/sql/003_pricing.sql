@@ -0,0 +1,18 @@
+-- Membership fees, formerly compiled in as constants::pricing::DepartmentPrices.
+--   rule 'none':      fee of a member without a department
+--   rule 'multiple':  fee of a member in more than one department
+--   rule 'single':    fee of a member in exactly the department department_id
+-- department_id is 0 for the rules which do not depend on a department.
+CREATE TABLE Pricing (
+    rule            VARCHAR(20) NOT NULL,
+    department_id   INTEGER NOT NULL DEFAULT 0,
+    fee             INTEGER NOT NULL,
+    PRIMARY KEY (rule, department_id)
+) WITHOUT ROWID;
+
+INSERT INTO Pricing (rule, department_id, fee) VALUES
+    ('none', 0, 0),
+    ('multiple', 0, 20),
+    ('single', 1, 8),
+    ('single', 2, 10),
+    ('single', 3, 15);
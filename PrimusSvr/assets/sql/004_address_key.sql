@@ -0,0 +1,12 @@
+-- Addresses are deduplicated by normalizedKey: a hash of street, house number, postal code, city and
+-- country, folded to lower case and single spaces (see primus::database::AddressKey).
+-- Rows written before this migration have no key yet. NULL never collides in a unique index, the
+-- AddressDeduplicator fills the keys in after startup and merges the duplicates it finds.
+ALTER TABLE Address ADD COLUMN normalizedKey VARCHAR(16);
+
+CREATE UNIQUE INDEX Address_normalizedKey ON Address (normalizedKey);
+
+-- Address as the API sees it, without the key
+CREATE VIEW AddressView AS
+SELECT id, postalCode, city, country, houseNumber, street
+FROM Address;
@@ -0,0 +1,83 @@
+-- Change log of the delta sync (GET /api/sync). Every write to Member, Department_Member and Address_Member
+-- stamps the row it touched with the next sequence number, a deleted row leaves a tombstone (deleted = 1).
+-- One entry is kept per row: the latest change replaces the earlier ones, so a sync reads as many entries as
+-- rows changed since, and the log never holds more entries than rows ever existed.
+--   entity 1: member        member_id, related_id 0
+--   entity 2: department    member_id, related_id = department_id
+--   entity 3: address       member_id, related_id = address_id
+-- AUTOINCREMENT never hands out a sequence number twice, not even the one of a replaced entry.
+-- The triggers delete before they insert instead of INSERT OR REPLACE, which an INSERT OR IGNORE into the
+-- table of the trigger would turn into OR IGNORE.
+CREATE TABLE ChangeLog (
+    seq         INTEGER PRIMARY KEY AUTOINCREMENT,
+    entity      INTEGER NOT NULL,
+    member_id   INTEGER NOT NULL,
+    related_id  INTEGER NOT NULL DEFAULT 0,
+    deleted     BOOLEAN NOT NULL DEFAULT 0,
+    UNIQUE (entity, member_id, related_id)
+);
+
+-- Member
+
+CREATE TRIGGER ChangeLog_Member_insert AFTER INSERT ON Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 1 AND member_id = NEW.id AND related_id = 0;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (1, NEW.id, 0, 0);
+END;
+
+CREATE TRIGGER ChangeLog_Member_update AFTER UPDATE ON Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 1 AND member_id IN (OLD.id, NEW.id) AND related_id = 0;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) SELECT 1, OLD.id, 0, 1 WHERE OLD.id <> NEW.id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (1, NEW.id, 0, 0);
+END;
+
+CREATE TRIGGER ChangeLog_Member_delete AFTER DELETE ON Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 1 AND member_id = OLD.id AND related_id = 0;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (1, OLD.id, 0, 1);
+END;
+
+-- Department_Member
+
+CREATE TRIGGER ChangeLog_Department_Member_insert AFTER INSERT ON Department_Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 2 AND member_id = NEW.member_id AND related_id = NEW.department_id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (2, NEW.member_id, NEW.department_id, 0);
+END;
+
+CREATE TRIGGER ChangeLog_Department_Member_update AFTER UPDATE ON Department_Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 2 AND member_id = OLD.member_id AND related_id = OLD.department_id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (2, OLD.member_id, OLD.department_id, 1);
+    DELETE FROM ChangeLog WHERE entity = 2 AND member_id = NEW.member_id AND related_id = NEW.department_id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (2, NEW.member_id, NEW.department_id, 0);
+END;
+
+CREATE TRIGGER ChangeLog_Department_Member_delete AFTER DELETE ON Department_Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 2 AND member_id = OLD.member_id AND related_id = OLD.department_id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (2, OLD.member_id, OLD.department_id, 1);
+END;
+
+-- Address_Member
+
+CREATE TRIGGER ChangeLog_Address_Member_insert AFTER INSERT ON Address_Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 3 AND member_id = NEW.member_id AND related_id = NEW.address_id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (3, NEW.member_id, NEW.address_id, 0);
+END;
+
+CREATE TRIGGER ChangeLog_Address_Member_update AFTER UPDATE ON Address_Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 3 AND member_id = OLD.member_id AND related_id = OLD.address_id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (3, OLD.member_id, OLD.address_id, 1);
+    DELETE FROM ChangeLog WHERE entity = 3 AND member_id = NEW.member_id AND related_id = NEW.address_id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (3, NEW.member_id, NEW.address_id, 0);
+END;
+
+CREATE TRIGGER ChangeLog_Address_Member_delete AFTER DELETE ON Address_Member
+BEGIN
+    DELETE FROM ChangeLog WHERE entity = 3 AND member_id = OLD.member_id AND related_id = OLD.address_id;
+    INSERT INTO ChangeLog (entity, member_id, related_id, deleted) VALUES (3, OLD.member_id, OLD.address_id, 1);
+END;
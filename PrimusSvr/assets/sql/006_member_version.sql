@@ -0,0 +1,12 @@
+-- Version of a member row, counted up by every change of the row. GET /api/member/{id} sends it as the ETag,
+-- PUT /api/member with If-Match only updates the row if it still has the version the client read.
+ALTER TABLE Member ADD COLUMN version INTEGER NOT NULL DEFAULT 1;
+
+-- The queries of the DatabaseClient count the version up in their own UPDATE (updateMember checks it in the
+-- same statement). Any other write to a member gets it counted up here. Recursive triggers are off, so the
+-- UPDATE below does not fire the trigger again.
+CREATE TRIGGER Member_version AFTER UPDATE ON Member
+WHEN NEW.version = OLD.version
+BEGIN
+    UPDATE Member SET version = OLD.version + 1 WHERE id = NEW.id;
+END;
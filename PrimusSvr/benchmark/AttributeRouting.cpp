@@ -0,0 +1,189 @@
+/**
+ * Microbenchmark of resolving the {attribute} path segment, built with -DPRIMUS_BUILD_BENCHMARKS=ON.
+ *
+ * Compares primus::attribute::resolve, one trie step per character, against comparing the segment
+ * with every name in turn as the endpoints did before, for a mix of accepted and unknown segments.
+ *
+ * Then routes a mix of requests over every route of the server with an oatpp HttpRouter, once alone and
+ * once after the AttributeInterceptor, which matches the requests against the routes taking an attribute
+ * and hands the resolved one to the endpoint.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "oatpp/core/base/Environment.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+#include "oatpp/web/protocol/http/incoming/SimpleBodyDecoder.hpp"
+#include "oatpp/web/server/HttpRouter.hpp"
+
+#include "general/attributes.hpp"
+#include "general/errors.hpp"
+#include "interceptor/AttributeInterceptor.hpp"
+
+namespace
+{
+    const v_uint32 iterations = 1000000;
+    const v_uint32 routedIterations = 200000;
+
+    /* Every route of the controllers, as their ENDPOINT macros declare them */
+    const char* const routes[][2] = {
+        { "GET", "/" },
+        { "GET", "/web/*" },
+        { "GET", "/api/sync" },
+        { "GET", "/api/events" },
+        { "POST", "/api/batch" },
+        { "GET", "/api/admin/database/pool" },
+        { "GET", "/api/admin/database/statements" },
+        { "GET", "/api/admin/database/queries" },
+        { "GET", "/api/admin/database/queries/slow" },
+        { "POST", "/api/admin/database/backup" },
+        { "GET", "/api/admin/database/backups" },
+        { "POST", "/api/admin/database/reporting/refresh" },
+        { "POST", "/api/admin/database/archive" },
+        { "GET", "/api/admin/database/archive" },
+        { "GET", "/api/admin/referencedata" },
+        { "POST", "/api/admin/referencedata/reload" },
+        { "PUT", "/api/admin/referencedata/pricing" },
+        { "GET", "/api/admin/cache" },
+        { "GET", "/api/members/list/{attribute}" },
+        { "GET", "/api/members/count/{attribute}" },
+        { "GET", "/api/member/{id}" },
+        { "POST", "/api/member" },
+        { "PUT", "/api/member" },
+        { "UPDATE", "/api/member/{id}/activate" },
+        { "UPDATE", "/api/member/{id}/deactivate" },
+        { "GET", "/api/member/{memberId}/assets/profilepicture" },
+        { "POST", "/api/member/{memberId}/department/add/{departmentId}" },
+        { "DELETE", "/api/member/{memberId}/department/remove/{departmentId}" },
+        { "POST", "/api/member/{memberId}/address/add" },
+        { "DELETE", "/api/member/{memberId}/address/remove/{addressId}" },
+        { "POST", "/api/member/{memberId}/attendance/{dateOfAttendance}" },
+        { "DELETE", "/api/member/{memberId}/attendance/{dateOfAttendance}" },
+        { "GET", "/api/member/{memberId}/attendance/history/{fromYear}/{toYear}" },
+        { "GET", "/api/member/{memberId}/fee" },
+        { "GET", "/api/member/{memberId}/list/{attribute}" },
+        { "GET", "api/member/{memberId}/weaponpurchase/" },
+        { "GET", "/api/member/{memberId}/profile" },
+        { "GET", "/api/reports/attendance/{year}" },
+        { "GET", "/api/reports/fees" },
+        { "GET", "/api/reports/weaponpurchase" }
+    };
+
+    /**
+     * @brief Endpoint of every route, the benchmark only looks routes up
+     */
+    class NoHandler : public oatpp::web::server::HttpRequestHandler
+    {
+    public:
+        std::shared_ptr<OutgoingResponse> handle(const std::shared_ptr<IncomingRequest>& request) override
+        {
+            (void)request;
+            return nullptr;
+        }
+    };
+
+    primus::attribute::Attribute compareEach(const oatpp::String& segment, v_uint32 accepted)
+    {
+        for (v_uint32 attribute = 1; attribute < static_cast<v_uint32>(primus::attribute::Attribute::Count); attribute++)
+        {
+            if ((primus::attribute::bit(static_cast<primus::attribute::Attribute>(attribute)) & accepted) != 0 &&
+                segment == primus::attribute::name(static_cast<primus::attribute::Attribute>(attribute)))
+                return static_cast<primus::attribute::Attribute>(attribute);
+        }
+        return primus::attribute::Attribute::Unknown;
+    }
+
+    template<typename Resolve>
+    double measure(const std::vector<oatpp::String>& segments, Resolve resolve)
+    {
+        v_uint32 found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (v_uint32 i = 0; i < iterations; i++)
+        {
+            if (resolve(segments[i % segments.size()], primus::attribute::memberLists) != primus::attribute::Attribute::Unknown)
+                found++;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        /* Keeps the loop from being optimized away */
+        if (found == 0)
+            std::printf("no segment resolved\n");
+        return static_cast<double>(elapsed.count()) / iterations;
+    }
+
+    std::shared_ptr<oatpp::web::protocol::http::incoming::Request> createRequest(const char* method, const char* path)
+    {
+        oatpp::web::protocol::http::RequestStartingLine startingLine;
+        startingLine.method = oatpp::String(method);
+        startingLine.path = oatpp::String(path);
+        startingLine.protocol = oatpp::String("HTTP/1.1");
+
+        return oatpp::web::protocol::http::incoming::Request::createShared(nullptr, startingLine, oatpp::web::protocol::http::Headers(),
+            std::make_shared<oatpp::data::stream::BufferInputStream>(oatpp::String("")),
+            std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>());
+    }
+
+    /**
+     * Nanoseconds per request to run the interceptor, if any, and look the route up
+     */
+    double measureRouting(oatpp::web::server::HttpRouter& router, primus::interceptor::AttributeInterceptor* interceptor,
+                          const std::vector<std::shared_ptr<oatpp::web::protocol::http::incoming::Request>>& requests)
+    {
+        v_uint32 routed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (v_uint32 i = 0; i < routedIterations; i++)
+        {
+            const auto& request = requests[i % requests.size()];
+            if (interceptor && interceptor->intercept(request))
+                continue;
+            if (router.getRoute(request->getStartingLine().method, request->getStartingLine().path))
+                routed++;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        /* Keeps the loop from being optimized away */
+        if (routed == 0)
+            std::printf("no request routed\n");
+        return static_cast<double>(elapsed.count()) / routedIterations;
+    }
+}
+
+int main()
+{
+    oatpp::base::Environment::init();
+    {
+        std::vector<oatpp::String> segments = { "all", "active", "inactive", "birthday", "addresses", "unknown", "x", "birthdays" };
+
+        std::printf("trie:         %6.1f ns per segment\n", measure(segments, primus::attribute::resolve));
+        std::printf("compare each: %6.1f ns per segment\n", measure(segments, compareEach));
+
+        auto router = oatpp::web::server::HttpRouter::createShared();
+        auto handler = std::make_shared<NoHandler>();
+        for (const auto& route : routes)
+            router->route(route[0], route[1], handler);
+
+        auto errors = std::make_shared<primus::error::ErrorResponses>(
+            primus::mapping::NegotiatingObjectMapper::createShared(oatpp::parser::json::mapping::ObjectMapper::createShared()));
+        primus::interceptor::AttributeInterceptor interceptor(errors);
+
+        std::vector<std::shared_ptr<oatpp::web::protocol::http::incoming::Request>> requests = {
+            createRequest("GET", "/api/members/list/active?limit=50&offset=0"),
+            createRequest("GET", "/api/members/count/all"),
+            createRequest("GET", "/api/member/42"),
+            createRequest("GET", "/api/member/42/list/attendances?limit=20"),
+            createRequest("GET", "/api/member/42/profile"),
+            createRequest("PUT", "/api/member"),
+            createRequest("POST", "/api/member/42/attendance/2024-06-01"),
+            createRequest("GET", "/api/reports/fees"),
+            createRequest("GET", "/api/members/list/unknown")
+        };
+
+        std::printf("%u routes\n", static_cast<unsigned>(sizeof(routes) / sizeof(routes[0])));
+        std::printf("router:               %6.1f ns per request\n", measureRouting(*router, nullptr, requests));
+        std::printf("interceptor + router: %6.1f ns per request\n", measureRouting(*router, &interceptor, requests));
+    }
+    oatpp::base::Environment::destroy();
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * Benchmark of the 002_day_numbers migration, built with -DPRIMUS_BUILD_BENCHMARKS=ON.
+ *
+ * Creates the 001_init schema in an in-memory database, fills it with generated members and attendances
+ * (a few of them with dates julianday() can not parse), and times 002_day_numbers.sql on it. A date range
+ * count over the attendances is timed before and after, on the text dates and on the day numbers.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "oatpp/core/base/Environment.hpp"
+#include "oatpp-sqlite/orm.hpp"
+
+namespace
+{
+    const v_uint32 members = 20000;
+    const v_uint32 attendancesPerMember = 50;
+    const v_uint32 rangeIterations = 20;
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    bool execute(sqlite3* handle, const std::string& sql)
+    {
+        char* error = nullptr;
+        if (sqlite3_exec(handle, sql.c_str(), nullptr, nullptr, &error) == SQLITE_OK)
+            return true;
+
+        std::printf("failed to execute: %s\n", error ? error : "unknown error");
+        sqlite3_free(error);
+        return false;
+    }
+
+    /**
+     * A date of 2023 or 2024 as the API writes it, YYYY-MM-DD
+     */
+    std::string dateOf(v_uint32 day)
+    {
+        char date[11];
+        std::snprintf(date, sizeof(date), "%04u-%02u-%02u", 2023 + (day / 336) % 2, (day / 28) % 12 + 1, day % 28 + 1);
+        return date;
+    }
+
+    void fill(sqlite3* handle)
+    {
+        sqlite3_stmt* member = nullptr;
+        sqlite3_stmt* attendance = nullptr;
+        sqlite3_prepare_v2(handle, "INSERT INTO Member VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9);", -1, &member, nullptr);
+        sqlite3_prepare_v2(handle, "INSERT OR IGNORE INTO Attendance VALUES (?1, ?2);", -1, &attendance, nullptr);
+
+        execute(handle, "BEGIN;");
+        for (v_uint32 id = 1; id <= members; id++)
+        {
+            std::string number = std::to_string(id);
+            std::string first = "First " + number;
+            std::string last = "Last " + number;
+            std::string email = "member" + number + "@example.org";
+            /* One member in a thousand has a birth date julianday() can not parse */
+            std::string birthDate = id % 1000 == 0 ? "unknown" : dateOf(id * 7);
+
+            sqlite3_bind_int(member, 1, static_cast<int>(id));
+            sqlite3_bind_text(member, 2, first.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(member, 3, last.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(member, 4, email.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(member, 5, "+49 170 0000000", -1, SQLITE_STATIC);
+            sqlite3_bind_text(member, 6, birthDate.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(member, 7, "2022-01-01", -1, SQLITE_STATIC);
+            sqlite3_bind_null(member, 8);
+            sqlite3_bind_int(member, 9, 1);
+            sqlite3_step(member);
+            sqlite3_reset(member);
+
+            for (v_uint32 i = 0; i < attendancesPerMember; i++)
+            {
+                std::string date = dateOf(id + i * 13);
+                sqlite3_bind_int(attendance, 1, static_cast<int>(id));
+                sqlite3_bind_text(attendance, 2, date.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_step(attendance);
+                sqlite3_reset(attendance);
+            }
+        }
+        execute(handle, "COMMIT;");
+
+        sqlite3_finalize(member);
+        sqlite3_finalize(attendance);
+    }
+
+    /**
+     * Milliseconds to count the attendances of the first half of 2024 with the given query
+     */
+    double timeRange(sqlite3* handle, const char* sql, v_int64& count)
+    {
+        sqlite3_stmt* statement = nullptr;
+        sqlite3_prepare_v2(handle, sql, -1, &statement, nullptr);
+
+        auto start = std::chrono::steady_clock::now();
+        for (v_uint32 i = 0; i < rangeIterations; i++)
+        {
+            if (sqlite3_step(statement) == SQLITE_ROW)
+                count = sqlite3_column_int64(statement, 0);
+            sqlite3_reset(statement);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        sqlite3_finalize(statement);
+        return static_cast<double>(elapsed.count()) / rangeIterations / 1000.0;
+    }
+}
+
+int main()
+{
+    oatpp::base::Environment::init();
+    {
+        sqlite3* handle = nullptr;
+        if (sqlite3_open(":memory:", &handle) != SQLITE_OK)
+        {
+            std::printf("failed to open the database: %s\n", sqlite3_errmsg(handle));
+            return 1;
+        }
+
+        std::string init = readFile(DATABASE_MIGRATIONS "/001_init.sql");
+        std::string dayNumbers = readFile(DATABASE_MIGRATIONS "/002_day_numbers.sql");
+        if (init.empty() || dayNumbers.empty() || !execute(handle, init))
+        {
+            std::printf("failed to read the migrations from %s\n", DATABASE_MIGRATIONS);
+            sqlite3_close(handle);
+            return 1;
+        }
+        fill(handle);
+
+        v_int64 textCount = 0;
+        double textRange = timeRange(handle,
+            "SELECT COUNT(*) FROM Attendance WHERE date BETWEEN '2024-01-01' AND '2024-06-30';", textCount);
+
+        auto start = std::chrono::steady_clock::now();
+        bool migrated = execute(handle, "BEGIN;") && execute(handle, dayNumbers) && execute(handle, "COMMIT;");
+        auto migration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        if (migrated)
+        {
+            v_int64 dayCount = 0;
+            double dayRange = timeRange(handle,
+                "SELECT COUNT(*) FROM Attendance WHERE date BETWEEN CAST(julianday('2024-01-01') - 2440587.5 AS INTEGER) "
+                "AND CAST(julianday('2024-06-30') - 2440587.5 AS INTEGER);", dayCount);
+
+            std::printf("migration:            %8lld ms for %u members and %u attendances\n",
+                static_cast<long long>(migration.count()), members, members * attendancesPerMember);
+            std::printf("range on text dates:  %8.2f ms (%lld attendances)\n", textRange, static_cast<long long>(textCount));
+            std::printf("range on day numbers: %8.2f ms (%lld attendances)\n", dayRange, static_cast<long long>(dayCount));
+        }
+
+        sqlite3_close(handle);
+    }
+    oatpp::base::Environment::destroy();
+    return 0;
+}
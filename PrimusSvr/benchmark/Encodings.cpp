@@ -0,0 +1,78 @@
+/**
+ * Microbenchmark of the response encodings, built with -DPRIMUS_BUILD_BENCHMARKS=ON.
+ *
+ * Writes and reads a page of members with the JSON, CBOR and MessagePack mappers the NegotiatingObjectMapper
+ * selects by the Accept and Content-Type headers, and reports the time per page and the size of the body.
+ */
+
+#include <chrono>
+#include <cstdio>
+
+#include "oatpp/core/base/Environment.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+
+#include "mapping/ContentNegotiation.hpp"
+
+#include "MemberPage.hpp"
+
+namespace
+{
+    const v_uint32 iterations = 2000;
+    const v_uint32 pageSize = 100;
+
+    struct Timing
+    {
+        double      encodeMicros;
+        double      decodeMicros;
+        v_buff_size bytes;
+    };
+
+    double microsPerIteration(const std::chrono::steady_clock::time_point& start)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        return static_cast<double>(elapsed.count()) / iterations / 1000.0;
+    }
+
+    Timing measure(const oatpp::data::mapping::ObjectMapper* mapper, const oatpp::Object<primus::dto::MemberPageDto>& page)
+    {
+        Timing timing;
+
+        oatpp::String body;
+        auto start = std::chrono::steady_clock::now();
+        for (v_uint32 i = 0; i < iterations; i++)
+            body = mapper->writeToString(page);
+        timing.encodeMicros = microsPerIteration(start);
+        timing.bytes = body->size();
+
+        v_uint64 items = 0;
+        start = std::chrono::steady_clock::now();
+        for (v_uint32 i = 0; i < iterations; i++)
+            items += mapper->readFromString<oatpp::Object<primus::dto::MemberPageDto>>(body)->items->size();
+        timing.decodeMicros = microsPerIteration(start);
+
+        /* Keeps the loop from being optimized away */
+        if (items != static_cast<v_uint64>(iterations) * pageSize)
+            std::printf("the page did not survive the round trip\n");
+        return timing;
+    }
+
+    void print(const char* name, const Timing& timing)
+    {
+        std::printf("%-12s encode %8.1f us, decode %8.1f us per page, %6ld bytes\n", name, timing.encodeMicros, timing.decodeMicros, static_cast<long>(timing.bytes));
+    }
+}
+
+int main()
+{
+    oatpp::base::Environment::init();
+    {
+        auto mappers = primus::mapping::NegotiatingObjectMapper::createShared(oatpp::parser::json::mapping::ObjectMapper::createShared());
+        auto page = primus::benchmark::createMemberPage(pageSize);
+
+        print("JSON", measure(mappers->getMapper(primus::mapping::Encoding::Json), page));
+        print("CBOR", measure(mappers->getMapper(primus::mapping::Encoding::Cbor), page));
+        print("MessagePack", measure(mappers->getMapper(primus::mapping::Encoding::MessagePack), page));
+    }
+    oatpp::base::Environment::destroy();
+    return 0;
+}
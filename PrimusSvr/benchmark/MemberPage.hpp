@@ -0,0 +1,44 @@
+#ifndef BENCHMARK_MEMBERPAGE_HPP
+#define BENCHMARK_MEMBERPAGE_HPP
+
+#include <string>
+
+#include "dto/PageDto.hpp"
+
+namespace primus
+{
+    namespace benchmark
+    {
+        /**
+         * A page of generated members as GET /api/members/list/{attribute} answers it, shared by the mapping
+         * benchmarks
+         */
+        inline oatpp::Object<primus::dto::MemberPageDto> createMemberPage(v_uint32 count)
+        {
+            auto page = primus::dto::MemberPageDto::createShared();
+            page->offset = 0u;
+            page->limit = count;
+            page->count = count;
+            page->items = oatpp::Vector<oatpp::Object<primus::dto::database::MemberDto>>::createShared();
+
+            for (v_uint32 id = 1; id <= count; id++)
+            {
+                std::string number = std::to_string(id);
+                auto member = primus::dto::database::MemberDto::createShared();
+                member->id = id;
+                member->firstName = "First " + number;
+                member->lastName = "Last \"" + number + "\"";
+                member->email = "member" + number + "@example.org";
+                member->phoneNumber = "+49 170 " + number;
+                member->birthDate = "1990-01-" + std::string(id % 28 < 9 ? "0" : "") + std::to_string(id % 28 + 1);
+                member->createDate = "2024-06-01";
+                member->notes = id % 4 == 0 ? oatpp::String(nullptr) : oatpp::String("Notes of member " + number);
+                member->active = id % 3 != 0;
+                page->items->push_back(member);
+            }
+            return page;
+        }
+    } // namespace benchmark
+} // namespace primus
+
+#endif // BENCHMARK_MEMBERPAGE_HPP
@@ -0,0 +1,134 @@
+/**
+ * Microbenchmark of reading a page of the member list, built with -DPRIMUS_BUILD_BENCHMARKS=ON.
+ *
+ * Runs the same query on an in-memory database and answers it like GET /api/members/list/{attribute} does,
+ * once through a RowDecoder into an Arena written by writeRows, and once through the ResultMapper into a
+ * MemberDto and its strings per row written by the SpecializedJsonObjectMapper.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "oatpp/core/base/Environment.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+
+#include "database/RowArena.hpp"
+#include "mapping/SpecializedJsonObjectMapper.hpp"
+
+namespace
+{
+    const v_uint32 iterations = 2000;
+    const v_uint32 rows = 1000;
+    const v_uint32 pageSize = 100;
+
+    const char* const pageQuery =
+        "SELECT id, firstName, lastName, email, phoneNumber, birthDate, createDate, notes, active "
+        "FROM Member ORDER BY id LIMIT 100;";
+
+    /**
+     * Runs the page query the way the Executor does, without a statement cache or QueryMonitor
+     */
+    std::shared_ptr<primus::database::CachedQueryResult> runQuery(sqlite3* handle,
+        const std::shared_ptr<oatpp::sqlite::mapping::ResultMapper>& resultMapper,
+        const std::shared_ptr<const oatpp::data::mapping::TypeResolver>& typeResolver)
+    {
+        sqlite3_stmt* statement = nullptr;
+        sqlite3_prepare_v2(handle, pageQuery, -1, &statement, nullptr);
+
+        primus::database::QueryContext context;
+        context.name = "getMemberList";
+        context.counters = nullptr;
+        context.started = std::chrono::steady_clock::now();
+        context.poolWaitMicros = 0;
+
+        auto result = std::make_shared<primus::database::CachedQueryResult>(statement, false, nullptr, nullptr, resultMapper, typeResolver, context);
+        result->start();
+        return result;
+    }
+
+    double microsPerIteration(const std::chrono::steady_clock::time_point& start)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        return static_cast<double>(elapsed.count()) / iterations / 1000.0;
+    }
+
+    void fill(sqlite3* handle)
+    {
+        sqlite3_exec(handle,
+            "CREATE TABLE Member (id INTEGER PRIMARY KEY, firstName TEXT, lastName TEXT, email TEXT, phoneNumber TEXT, "
+            "birthDate TEXT, createDate TEXT, notes TEXT, active INTEGER);", nullptr, nullptr, nullptr);
+        sqlite3_exec(handle, "BEGIN;", nullptr, nullptr, nullptr);
+        for (v_uint32 id = 1; id <= rows; id++)
+        {
+            std::string number = std::to_string(id);
+            std::string insert = "INSERT INTO Member VALUES (" + number + ", 'First " + number + "', 'Last " + number + "', "
+                "'member" + number + "@example.org', '+49 170 " + number + "', '1990-01-15', '2024-06-01', " +
+                (id % 4 == 0 ? std::string("NULL") : "'Notes of member " + number + "'") + ", " + std::to_string(id % 3 != 0 ? 1 : 0) + ");";
+            sqlite3_exec(handle, insert.c_str(), nullptr, nullptr, nullptr);
+        }
+        sqlite3_exec(handle, "COMMIT;", nullptr, nullptr, nullptr);
+    }
+}
+
+int main()
+{
+    oatpp::base::Environment::init();
+    {
+        sqlite3* handle = nullptr;
+        if (sqlite3_open(":memory:", &handle) != SQLITE_OK)
+        {
+            std::printf("failed to open the database: %s\n", sqlite3_errmsg(handle));
+            return 1;
+        }
+        fill(handle);
+
+        auto resultMapper = std::make_shared<oatpp::sqlite::mapping::ResultMapper>();
+        auto typeResolver = std::make_shared<oatpp::data::mapping::TypeResolver>();
+        auto mapper = primus::mapping::SpecializedJsonObjectMapper::createShared(oatpp::parser::json::mapping::ObjectMapper::createShared());
+
+        oatpp::String rowBody;
+        std::size_t chunks = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (v_uint32 i = 0; i < iterations; i++)
+        {
+            auto result = runQuery(handle, resultMapper, typeResolver);
+
+            primus::database::Arena arena;
+            primus::database::RowPage<primus::database::MemberRow> page;
+            page.offset = 0u;
+            page.limit = pageSize;
+            page.items = primus::database::RowDecoder<primus::database::MemberRow>(*result, arena).decode(pageSize);
+            page.count = static_cast<v_uint32>(page.items.size());
+
+            rowBody = mapper->writeRows(page, static_cast<v_buff_size>((page.count.value + 1) * primus::constants::database::arena::rowBytes));
+            chunks = arena.getChunkCount();
+        }
+        double rowMicros = microsPerIteration(start);
+
+        oatpp::String dtoBody;
+        start = std::chrono::steady_clock::now();
+        for (v_uint32 i = 0; i < iterations; i++)
+        {
+            auto result = runQuery(handle, resultMapper, typeResolver);
+
+            auto page = primus::dto::PageDto<oatpp::Object<primus::dto::database::MemberDto>>::createShared();
+            page->offset = 0u;
+            page->limit = pageSize;
+            page->items = result->fetch<oatpp::Vector<oatpp::Object<primus::dto::database::MemberDto>>>();
+            page->count = static_cast<v_uint32>(page->items->size());
+
+            dtoBody = mapper->writeToString(page);
+        }
+        double dtoMicros = microsPerIteration(start);
+
+        std::printf("arena rows: %8.1f us per page, %u arena chunks\n", rowMicros, static_cast<unsigned>(chunks));
+        std::printf("DTO rows:   %8.1f us per page, a DTO and a string per field for each row\n", dtoMicros);
+        if (rowBody != dtoBody)
+            std::printf("the bodies differ, the arena rows are not written like the DTOs\n");
+
+        sqlite3_close(handle);
+    }
+    oatpp::base::Environment::destroy();
+    return 0;
+}
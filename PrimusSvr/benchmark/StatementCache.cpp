@@ -0,0 +1,87 @@
+/**
+ * Microbenchmark of the per connection statement cache, built with -DPRIMUS_BUILD_BENCHMARKS=ON.
+ *
+ * Runs a lookup by primary key on an in-memory database through primus::database::StatementCache, once with
+ * room for the statement (every query after the first is a hit) and once with a capacity of 0 (every query is
+ * prepared and finalized again, as the sqlite executor of oatpp does).
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "oatpp/core/base/Environment.hpp"
+
+#include "database/StatementCache.hpp"
+
+namespace
+{
+    const v_uint32 iterations = 200000;
+    const v_uint32 rows = 1000;
+
+    double measure(sqlite3* handle, std::size_t capacity, const std::shared_ptr<primus::database::StatementCacheMetrics>& metrics)
+    {
+        static const std::string sql = "SELECT firstName FROM Member WHERE id = ?1;";
+        primus::database::StatementCache cache(handle, capacity, metrics);
+
+        v_uint64 found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (v_uint32 i = 0; i < iterations; i++)
+        {
+            bool cached = false;
+            sqlite3_stmt* statement = cache.acquire(sql, cached);
+            sqlite3_bind_int(statement, 1, static_cast<int>(i % rows) + 1);
+            if (sqlite3_step(statement) == SQLITE_ROW)
+                found += static_cast<v_uint64>(sqlite3_column_bytes(statement, 0));
+            cache.release(statement, cached);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        /* Keeps the loop from being optimized away */
+        if (found == 0)
+            std::printf("no member found\n");
+        return static_cast<double>(elapsed.count()) / iterations;
+    }
+
+    void fill(sqlite3* handle)
+    {
+        sqlite3_exec(handle, "CREATE TABLE Member (id INTEGER PRIMARY KEY, firstName TEXT NOT NULL);", nullptr, nullptr, nullptr);
+        sqlite3_exec(handle, "BEGIN;", nullptr, nullptr, nullptr);
+        for (v_uint32 id = 1; id <= rows; id++)
+        {
+            std::string insert = "INSERT INTO Member (id, firstName) VALUES (" + std::to_string(id) + ", 'Member " + std::to_string(id) + "');";
+            sqlite3_exec(handle, insert.c_str(), nullptr, nullptr, nullptr);
+        }
+        sqlite3_exec(handle, "COMMIT;", nullptr, nullptr, nullptr);
+    }
+}
+
+int main()
+{
+    oatpp::base::Environment::init();
+    {
+        sqlite3* handle = nullptr;
+        if (sqlite3_open(":memory:", &handle) != SQLITE_OK)
+        {
+            std::printf("failed to open the database: %s\n", sqlite3_errmsg(handle));
+            return 1;
+        }
+        fill(handle);
+
+        auto hitMetrics = std::make_shared<primus::database::StatementCacheMetrics>();
+        auto missMetrics = std::make_shared<primus::database::StatementCacheMetrics>();
+
+        double hit = measure(handle, 64, hitMetrics);
+        double miss = measure(handle, 0, missMetrics);
+
+        std::printf("cache hit:  %7.1f ns per query (%llu hits, %llu misses)\n", hit,
+            static_cast<unsigned long long>(hitMetrics->hits.load()), static_cast<unsigned long long>(hitMetrics->misses.load()));
+        std::printf("cache miss: %7.1f ns per query (%llu hits, %llu misses)\n", miss,
+            static_cast<unsigned long long>(missMetrics->hits.load()), static_cast<unsigned long long>(missMetrics->misses.load()));
+
+        sqlite3_close(handle);
+    }
+    oatpp::base::Environment::destroy();
+    return 0;
+}
@@ -4,6 +4,11 @@
 #include "general/asserts.hpp"
 #include "controller/StaticController.hpp"
 #include "controller/MemberController.hpp"
+#include "controller/AdminController.hpp"
+#include "controller/BatchController.hpp"
+#include "controller/EventController.hpp"
+#include "controller/SyncController.hpp"
+#include "controller/ReportController.hpp"
 #include "oatpp-swagger/Controller.hpp"
 #include "oatpp/network/Server.hpp"
 #include <iostream>
@@ -24,6 +29,11 @@ namespace primus {
         void run(void) {
             typedef primus::apicontroller::static_endpoint::StaticController    StaticController;
             typedef primus::apicontroller::member_endpoint::MemberController    MemberController;
+            typedef primus::apicontroller::admin_endpoint::AdminController      AdminController;
+            typedef primus::apicontroller::report_endpoint::ReportController    ReportController;
+            typedef primus::apicontroller::batch_endpoint::BatchController      BatchController;
+            typedef primus::apicontroller::event_endpoint::EventController      EventController;
+            typedef primus::apicontroller::sync_endpoint::SyncController        SyncController;
             typedef primus::component::AppComponent                             AppComponent;
             typedef primus::component::DatabaseClient                           DatabaseClient;
             typedef primus::component::DatabaseComponent                        DatabaseComponent;
@@ -65,6 +75,21 @@ namespace primus {
             docEndpoints.append(router->addController(MemberController::createShared())->getEndpoints());                     // Add the endpoints of MemberController to the swagger ui documentation
             OATPP_LOGI(primus::constants::main::logName, "Collected Endpoints of MemberController");
 
+            docEndpoints.append(router->addController(AdminController::createShared())->getEndpoints());
+            OATPP_LOGI(primus::constants::main::logName, "Collected Endpoints of AdminController");
+
+            docEndpoints.append(router->addController(ReportController::createShared())->getEndpoints());
+            OATPP_LOGI(primus::constants::main::logName, "Collected Endpoints of ReportController");
+
+            docEndpoints.append(router->addController(BatchController::createShared())->getEndpoints());
+            OATPP_LOGI(primus::constants::main::logName, "Collected Endpoints of BatchController");
+
+            docEndpoints.append(router->addController(EventController::createShared())->getEndpoints());
+            OATPP_LOGI(primus::constants::main::logName, "Collected Endpoints of EventController");
+
+            docEndpoints.append(router->addController(SyncController::createShared())->getEndpoints());
+            OATPP_LOGI(primus::constants::main::logName, "Collected Endpoints of SyncController");
+
             OATPP_LOGI(primus::constants::main::logName, "Initializing Swagger Endpoint-Controller (oatpp::swagger::Controller) with collected endpoints");
             router->addController(oatpp::swagger::Controller::createShared(docEndpoints));
 
@@ -134,4 +159,4 @@ int main(int argc, const char* argv[])
     oatpp::base::Environment::destroy();
 
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
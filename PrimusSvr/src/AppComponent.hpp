@@ -10,7 +10,15 @@
 
 // App specific headers
 #include "database/DatabaseComponent.hpp"
+#include "cache/CacheComponent.hpp"
+#include "events/EventComponent.hpp"
+#include "general/errors.hpp"
 #include "swagger-ui/SwaggerComponent.hpp"
+#include "interceptor/AttributeInterceptor.hpp"
+#include "interceptor/ContentNegotiationInterceptor.hpp"
+#include "interceptor/InterceptorChain.hpp"
+#include "interceptor/RequestDeadlineInterceptor.hpp"
+#include "interceptor/TenantInterceptor.hpp"
 
 namespace primus
 {
@@ -23,6 +31,12 @@ namespace primus
         class AppComponent
         {
         public:
+            // Cache component, before the database components which invalidate it
+            CacheComponent cacheComponent;
+
+            // Event component, before the controllers which publish to and stream from it
+            EventComponent eventComponent;
+
             // Database component
             DatabaseComponent databaseComponent;
 
@@ -41,16 +55,58 @@ namespace primus
                 }());
 
 
+            // Create the error responses, serialized once, before the ConnectionHandler answering with them
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::error::ErrorResponses>, errorResponses)([] {
+                return std::make_shared<primus::error::ErrorResponses>(primus::mapping::NegotiatingObjectMapper::createShared(oatpp::parser::json::mapping::ObjectMapper::createShared()));
+                }());
+
+
+            // Create the interceptor chain every request runs through, those of a batch included
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::interceptor::InterceptorChain>, interceptorChain)([] {
+                OATPP_COMPONENT(std::shared_ptr<oatpp::web::server::HttpRouter>, router); // get Router component
+
+                /* Answer thrown errors by a StatusDto and unmapped paths by a serialized one */
+                OATPP_COMPONENT(std::shared_ptr<primus::error::ErrorResponses>, errorResponses);
+                auto chain = std::make_shared<primus::interceptor::InterceptorChain>(router, std::make_shared<primus::error::ErrorHandler>(errorResponses));
+
+                /* Read and write DTOs in the encoding the client asks for */
+                chain->addRequestInterceptor(std::make_shared<primus::interceptor::ContentNegotiationInterceptor>());
+                chain->addResponseInterceptor(std::make_shared<primus::interceptor::ContentNegotiationResetInterceptor>());
+
+                /* Reject unknown list and count attributes before routing, in the encoding just picked */
+                chain->addRequestInterceptor(std::make_shared<primus::interceptor::AttributeInterceptor>(errorResponses));
+
+                /* Bound the database work of every request */
+                chain->addRequestInterceptor(std::make_shared<primus::interceptor::RequestDeadlineInterceptor>());
+                chain->addResponseInterceptor(std::make_shared<primus::interceptor::RequestDeadlineResetInterceptor>());
+
+                /* Route every request to the database of its club */
+                OATPP_COMPONENT(std::shared_ptr<primus::tenant::TenantRegistry>, tenantRegistry);
+                if (tenantRegistry->isEnabled())
+                {
+                    chain->addRequestInterceptor(std::make_shared<primus::interceptor::TenantInterceptor>(tenantRegistry));
+                    chain->addResponseInterceptor(std::make_shared<primus::interceptor::TenantResetInterceptor>());
+                }
+
+                return chain;
+                }());
+
+
             // Create ConnectionHandler component which uses Router component to route requests
             OATPP_CREATE_COMPONENT(std::shared_ptr<oatpp::network::ConnectionHandler>, serverConnectionHandler)([] {
                 OATPP_COMPONENT(std::shared_ptr<oatpp::web::server::HttpRouter>, router); // get Router component
-                return oatpp::web::server::HttpConnectionHandler::createShared(router);
+                auto connectionHandler = oatpp::web::server::HttpConnectionHandler::createShared(router);
+
+                OATPP_COMPONENT(std::shared_ptr<primus::interceptor::InterceptorChain>, interceptorChain);
+                interceptorChain->install(connectionHandler);
+
+                return connectionHandler;
                 }());
 
 
-            // Create ObjectMapper component to serialize/deserialize Dtos in Contoller's API
+            // Create ObjectMapper component to serialize/deserialize Dtos in Contoller's API, as JSON, CBOR or MessagePack
             OATPP_CREATE_COMPONENT(std::shared_ptr<oatpp::data::mapping::ObjectMapper>, apiObjectMapper)([] {
-                return oatpp::parser::json::mapping::ObjectMapper::createShared();
+                return primus::mapping::NegotiatingObjectMapper::createShared(oatpp::parser::json::mapping::ObjectMapper::createShared());
                 }());
         };
 
@@ -0,0 +1,39 @@
+#ifndef CACHECOMPONENT_HPP
+#define CACHECOMPONENT_HPP
+
+#include "oatpp/core/macro/component.hpp"
+
+#include "ResponseCache.hpp"
+#include "SingleFlight.hpp"
+
+namespace primus
+{
+    namespace component
+    {
+        //   ____           _           ____                                             _   
+        //  / ___|__ _  ___| |__   ___ / ___|___  _ __ ___  _ __   ___  _ __   ___ _ __ | |_ 
+        // | |   / _` |/ __| '_ \ / _ \ |   / _ \| '_ ` _ \| '_ \ / _ \| '_ \ / _ \ '_ \| __|
+        // | |__| (_| | (__| | | |  __/ |__| (_) | | | | | | |_) | (_) | | | |  __/ | | | |_ 
+        //  \____\__,_|\___|_| |_|\___|\____\___/|_| |_| |_| .__/ \___/|_| |_|\___|_| |_|\__|
+        //                                                 |_|                               
+        /**
+         * @brief Cache component responsible for creating the caches shared by the controllers.
+         */
+        class CacheComponent {
+        public:
+            // Create serialized-response cache for hot GET endpoints
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::cache::ResponseCache>, responseCache)([] {
+                return std::make_shared<primus::cache::ResponseCache>();
+                }());
+
+            // Create single-flight layer coalescing identical concurrent read requests
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::cache::SingleFlight>, singleFlight)([] {
+                return std::make_shared<primus::cache::SingleFlight>(primus::cache::SingleFlight::Configuration::fromEnvironment());
+                }());
+
+        };
+
+    } //namespace component
+} // namespace primus
+
+#endif // CACHECOMPONENT_HPP
@@ -0,0 +1,134 @@
+#ifndef ENTITYTAG_HPP
+#define ENTITYTAG_HPP
+
+#include <cctype>
+#include <string>
+
+#include "oatpp/core/Types.hpp"
+
+namespace primus
+{
+    namespace cache
+    {
+        //  _____       _   _ _        _____
+        // | ____|_ __ | |_(_) |_ _   |_   _|_ _  __ _
+        // |  _| | '_ \| __| | __| | | || |/ _` |/ _` |
+        // | |___| | | | |_| | |_| |_| || | (_| | (_| |
+        // |_____|_| |_|\__|_|\__|\__, ||_|\__,_|\__, |
+        //                        |___/          |___/
+        /**
+         * @brief ETags of versioned rows, e.g. "3" for version 3 of a member.
+         *
+         * The encoding of the response is part of the tag ("3#cbor"), as a strong ETag names the exact bytes
+         * sent. If-None-Match compares the whole tag, a client only holds the bytes of the encoding it was
+         * sent. The version alone decides whether an If-Match precondition holds.
+         */
+        class EntityTag
+        {
+        private:
+            /**
+             * Reads the version at the start of one tag of a header and moves past the tag
+             *
+             * @param suffix Set to the encoding suffix following the version, e.g. "#cbor"
+             * @return false if the tag is not one of ours, e.g. a weak tag where a strong one is required
+             */
+            static bool readTag(const std::string& header, std::size_t& position, bool allowWeak, v_uint32& version, std::string& suffix)
+            {
+                while (position < header.size() && (header[position] == ' ' || header[position] == ','))
+                    position++;
+
+                bool valid = true;
+                if (header.compare(position, 2, "W/") == 0)
+                {
+                    valid = allowWeak;
+                    position += 2;
+                }
+                if (position >= header.size() || header[position] != '"')
+                {
+                    position = header.size();
+                    return false;
+                }
+                position++;
+
+                std::size_t digits = position;
+                unsigned long long value = 0;
+                while (position < header.size() && std::isdigit(static_cast<unsigned char>(header[position])) && value <= 0xFFFFFFFFull)
+                    value = value * 10 + static_cast<unsigned long long>(header[position++] - '0');
+                valid = valid && position > digits && value <= 0xFFFFFFFFull;
+
+                std::size_t end = header.find('"', position);
+                suffix = header.substr(position, end == std::string::npos ? std::string::npos : end - position);
+                position = end == std::string::npos ? header.size() : end + 1;
+
+                version = static_cast<v_uint32>(value);
+                return valid;
+            }
+
+        public:
+            /**
+             * The ETag of a version, quotes included
+             *
+             * @param suffix Suffix of the response encoding, see primus::mapping::CurrentEncoding::getKeySuffix
+             */
+            static std::string of(v_uint32 version, const char* suffix)
+            {
+                return "\"" + std::to_string(version) + suffix + "\"";
+            }
+
+            /**
+             * Whether or not a precondition header is "*", which any existing row meets
+             */
+            static bool isAny(const oatpp::String& header)
+            {
+                return header && header->find('*') != std::string::npos;
+            }
+
+            /**
+             * Whether or not an If-None-Match header names none of the tags of the version in the encoding.
+             * Weak tags are compared as well.
+             *
+             * @param suffix Suffix of the response encoding, see primus::mapping::CurrentEncoding::getKeySuffix
+             */
+            static bool noneMatchHolds(const oatpp::String& ifNoneMatch, v_uint32 version, const char* suffix)
+            {
+                if (!ifNoneMatch)
+                    return true;
+                if (isAny(ifNoneMatch))
+                    return false;
+
+                std::size_t position = 0;
+                while (position < ifNoneMatch->size())
+                {
+                    v_uint32 tagged = 0;
+                    std::string encoding;
+                    if (readTag(*ifNoneMatch, position, true, tagged, encoding) && tagged == version && encoding == suffix)
+                        return false;
+                }
+                return true;
+            }
+
+            /**
+             * Reads the version of an If-Match header naming a single strong tag
+             *
+             * @return false if the header names anything else
+             */
+            static bool parseVersion(const oatpp::String& ifMatch, v_uint32& version)
+            {
+                if (!ifMatch)
+                    return false;
+
+                std::size_t position = 0;
+                std::string encoding;
+                if (!readTag(*ifMatch, position, false, version, encoding))
+                    return false;
+
+                while (position < ifMatch->size() && ifMatch->at(position) == ' ')
+                    position++;
+                return position == ifMatch->size();
+            }
+        };
+
+    } // namespace cache
+} // namespace primus
+
+#endif // ENTITYTAG_HPP
@@ -0,0 +1,467 @@
+#ifndef RESPONSECACHE_HPP
+#define RESPONSECACHE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef PRIMUS_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#include "oatpp/core/Types.hpp"
+
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace cache
+    {
+        /**
+         * @brief Tables a cached response can depend on. Every table has its own generation counter.
+         */
+        enum class Table : v_uint32
+        {
+            Member = 0,
+            Address,
+            Department,
+            Attendance,
+            AddressMember,
+            DepartmentMember,
+            Count
+        };
+
+        //  _____     _     _       ____                           _   _
+        // |_   _|_ _| |__ | | ___ / ___| ___ _ __   ___ _ __ __ _| |_(_) ___  _ __  ___
+        //   | |/ _` | '_ \| |/ _ \ |  _ / _ \ '_ \ / _ \ '__/ _` | __| |/ _ \| '_ \/ __|
+        //   | | (_| | |_) | |  __/ |_| |  __/ | | |  __/ | | (_| | |_| | (_) | | | \__ \
+        //   |_|\__,_|_.__/|_|\___|\____|\___|_| |_|\___|_|  \__,_|\__|_|\___/|_| |_|___/
+        /**
+         * @brief One monotonic generation counter per table. A write bumps the counter of every table it touched.
+         */
+        class TableGenerations
+        {
+        private:
+            std::atomic<v_uint64> m_generations[static_cast<v_uint32>(Table::Count)];
+
+        public:
+            TableGenerations()
+            {
+                for (auto& generation : m_generations)
+                    generation.store(0);
+            }
+
+            v_uint64 get(Table table) const
+            {
+                return m_generations[static_cast<v_uint32>(table)].load(std::memory_order_acquire);
+            }
+
+            v_uint64 bump(Table table)
+            {
+                return m_generations[static_cast<v_uint32>(table)].fetch_add(1, std::memory_order_acq_rel) + 1;
+            }
+        };
+
+        /**
+         * @brief Final bytes of a cached response.
+         */
+        struct CachedResponse
+        {
+            oatpp::String contentType;
+            oatpp::String body;
+
+            /**
+             * The gzip variant, compressed by the first request accepting it and shared by the later ones.
+             * nullptr if it is not worth sending, see ResponseCache::compress
+             */
+            oatpp::String getGzipBody() const;
+
+        private:
+            mutable std::once_flag  m_gzipOnce;
+            mutable oatpp::String   m_gzipBody;
+        };
+
+        //  ____                                       ____           _
+        // |  _ \ ___  ___ _ __   ___  _ __  ___  ___ / ___|__ _  ___| |__   ___
+        // | |_) / _ \/ __| '_ \ / _ \| '_ \/ __|/ _ \ |   / _` |/ __| '_ \ / _ \
+        // |  _ <  __/\__ \ |_) | (_) | | | \__ \  __/ |__| (_| | (__| | | |  __/
+        // |_| \_\___||___/ .__/ \___/|_| |_|___/\___|\____\__,_|\___|_| |_|\___|
+        //                |_|
+        /**
+         * @brief Cache for serialized responses of hot GET endpoints.
+         *
+         * Entries are keyed by the normalized request URL and remember the generation of every table they were
+         * computed from. A write bumps the generation of the tables it touched, which drops all dependent entries.
+         * Every scope, the default database ("") or a tenant by its name, counts generations of its own, so the
+         * writes of one club leave the pages of the others cached. The least recently used entry makes room
+         * for a new one once the cache is full.
+         */
+        class ResponseCache
+        {
+        public:
+            typedef std::vector<std::pair<Table, v_uint64>> Dependencies;
+
+            /**
+             * @brief Generations observed before a response is computed. put() only stores the result if none of
+             * the tables changed in the meantime, so a response racing with a write is never cached.
+             */
+            struct Ticket
+            {
+                const TableGenerations* generations;    // Of the scope the ticket was opened for
+                Dependencies            dependencies;
+
+                Ticket() : generations(nullptr) {}
+            };
+
+            struct Statistics
+            {
+                v_uint64 hits;
+                v_uint64 misses;
+                v_uint64 stores;
+                v_uint64 rejectedStores;
+                v_uint64 invalidations;
+                v_uint64 entries;
+            };
+
+        private:
+            struct Entry
+            {
+                std::shared_ptr<const CachedResponse>   response;
+                const TableGenerations*                 generations;
+                Dependencies                            dependencies;
+                std::list<std::string>::iterator        recency;        // Position in m_recency
+            };
+
+            std::mutex                                                          m_scopesLock;
+            std::unordered_map<std::string, std::unique_ptr<TableGenerations>>  m_scopes;     // Never erased, tickets and entries point into it
+
+            mutable std::mutex                          m_lock;
+            std::unordered_map<std::string, Entry>      m_entries;
+            std::list<std::string>                      m_recency;      // Keys of m_entries, most recently used first
+            std::size_t                                 m_maxEntries;
+
+            std::atomic<v_uint64> m_hits;
+            std::atomic<v_uint64> m_misses;
+            std::atomic<v_uint64> m_stores;
+            std::atomic<v_uint64> m_rejectedStores;
+            std::atomic<v_uint64> m_invalidations;
+
+        private:
+            static bool isCurrent(const TableGenerations* generations, const Dependencies& dependencies)
+            {
+                for (auto& dependency : dependencies)
+                {
+                    if (generations->get(dependency.first) != dependency.second)
+                        return false;
+                }
+                return true;
+            }
+
+            TableGenerations& getGenerations(const std::string& scope)
+            {
+                std::lock_guard<std::mutex> guard(m_scopesLock);
+
+                auto& generations = m_scopes[scope];
+                if (!generations)
+                    generations.reset(new TableGenerations());
+                return *generations;
+            }
+
+            std::unordered_map<std::string, Entry>::iterator erase(std::unordered_map<std::string, Entry>::iterator it)
+            {
+                m_recency.erase(it->second.recency);
+                return m_entries.erase(it);
+            }
+
+            void evictLeastRecentlyUsed()
+            {
+                if (m_recency.empty())
+                    return;
+
+                auto victim = m_entries.find(m_recency.back());
+                if (victim != m_entries.end())
+                    erase(victim);
+            }
+
+            /**
+             * Lower case token of a header list item without surrounding whitespace
+             */
+            static std::string trimToken(const std::string& text, std::size_t begin, std::size_t end)
+            {
+                while (begin < end && std::isspace(static_cast<unsigned char>(text[begin])))
+                    begin++;
+                while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1])))
+                    end--;
+
+                std::string token = text.substr(begin, end - begin);
+                for (auto& c : token)
+                    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                return token;
+            }
+
+            /**
+             * The q value of an Accept-Encoding item, e.g. 0.5 for "gzip;q=0.5". 1 without one, 0 if it is malformed
+             */
+            static double parseQuality(const std::string& item, std::size_t parameters)
+            {
+                while (parameters != std::string::npos)
+                {
+                    std::size_t next = item.find(';', parameters + 1);
+                    std::string parameter = trimToken(item, parameters + 1, next == std::string::npos ? item.size() : next);
+                    parameters = next;
+
+                    if (parameter.compare(0, 2, "q=") != 0)
+                        continue;
+
+                    char* end = nullptr;
+                    double quality = std::strtod(parameter.c_str() + 2, &end);
+                    if (end == parameter.c_str() + 2 || *end != '\0' || quality < 0 || quality > 1)
+                        return 0;
+                    return quality;
+                }
+                return 1;
+            }
+
+        public:
+            ResponseCache(std::size_t maxEntries = primus::constants::cache::maxEntries)
+                : m_maxEntries(maxEntries)
+                , m_hits(0)
+                , m_misses(0)
+                , m_stores(0)
+                , m_rejectedStores(0)
+                , m_invalidations(0)
+            {}
+
+            /**
+             * Builds the cache key of a request: the path without query string followed by the query parameters
+             * sorted by name, so "?offset=0&limit=10" and "?limit=10&offset=0" share one entry
+             *
+             * @param path The request path, with or without query string
+             * @param queryParams The parsed query parameters
+             *
+             */
+            template<class QueryParams>
+            static std::string normalizeKey(const std::string& path, const QueryParams& queryParams)
+            {
+                std::vector<std::pair<std::string, std::string>> params;
+                for (auto& param : queryParams.getAll())
+                    params.push_back(std::make_pair(param.first.std_str(), param.second.std_str()));
+                std::sort(params.begin(), params.end());
+
+                std::string key = path.substr(0, path.find('?'));
+                char separator = '?';
+                for (auto& param : params)
+                {
+                    key.push_back(separator);
+                    key.append(param.first);
+                    key.push_back('=');
+                    key.append(param.second);
+                    separator = '&';
+                }
+                return key;
+            }
+
+            std::shared_ptr<const CachedResponse> get(const std::string& key)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+
+                auto it = m_entries.find(key);
+                if (it == m_entries.end() || !isCurrent(it->second.generations, it->second.dependencies))
+                {
+                    if (it != m_entries.end())
+                        erase(it);
+                    m_misses++;
+                    return nullptr;
+                }
+
+                m_recency.splice(m_recency.begin(), m_recency, it->second.recency);
+                m_hits++;
+                return it->second.response;
+            }
+
+            /**
+             * @param scope "" for the default database, the name of the tenant otherwise
+             */
+            Ticket openTicket(const std::string& scope, std::initializer_list<Table> tables)
+            {
+                Ticket ticket;
+                ticket.generations = &getGenerations(scope);
+                for (Table table : tables)
+                    ticket.dependencies.push_back(std::make_pair(table, ticket.generations->get(table)));
+                return ticket;
+            }
+
+            /**
+             * Stores the serialized response. The response is returned in any case so the caller can send it,
+             * but it is only cached if the tables of the ticket did not change while it was computed. The gzip
+             * variant is left to the first request asking for it
+             */
+            std::shared_ptr<const CachedResponse> put(const std::string& key, const Ticket& ticket, const oatpp::String& body, const oatpp::String& contentType)
+            {
+                auto response = std::make_shared<CachedResponse>();
+                response->contentType = contentType;
+                response->body = body;
+
+                std::lock_guard<std::mutex> guard(m_lock);
+
+                if (!isCurrent(ticket.generations, ticket.dependencies))
+                {
+                    m_rejectedStores++;
+                    return response;
+                }
+
+                auto it = m_entries.find(key);
+                if (it == m_entries.end())
+                {
+                    if (m_entries.size() >= m_maxEntries)
+                        evictLeastRecentlyUsed();
+
+                    m_recency.push_front(key);
+                    it = m_entries.insert(std::make_pair(key, Entry())).first;
+                    it->second.recency = m_recency.begin();
+                }
+                else
+                    m_recency.splice(m_recency.begin(), m_recency, it->second.recency);
+
+                it->second.response = response;
+                it->second.generations = ticket.generations;
+                it->second.dependencies = ticket.dependencies;
+                m_stores++;
+                return response;
+            }
+
+            /**
+             * Called by every write path. Bumps the generation of the table in the scope and drops all entries
+             * depending on it, the entries of other scopes stay
+             *
+             * @param scope "" for the default database, the name of the tenant otherwise
+             */
+            void invalidate(const std::string& scope, Table table)
+            {
+                TableGenerations& generations = getGenerations(scope);
+                generations.bump(table);
+                m_invalidations++;
+
+                std::lock_guard<std::mutex> guard(m_lock);
+                for (auto it = m_entries.begin(); it != m_entries.end();)
+                {
+                    if (it->second.generations != &generations || isCurrent(it->second.generations, it->second.dependencies))
+                        ++it;
+                    else
+                        it = erase(it);
+                }
+            }
+
+            void clear()
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_entries.clear();
+                m_recency.clear();
+            }
+
+            Statistics getStatistics() const
+            {
+                Statistics statistics;
+                statistics.hits = m_hits;
+                statistics.misses = m_misses;
+                statistics.stores = m_stores;
+                statistics.rejectedStores = m_rejectedStores;
+                statistics.invalidations = m_invalidations;
+
+                std::lock_guard<std::mutex> guard(m_lock);
+                statistics.entries = m_entries.size();
+                return statistics;
+            }
+
+            /**
+             * Creates the gzip variant of a body. Returns nullptr if zlib is not available, the body is too small
+             * to benefit or compression did not save anything
+             */
+            static oatpp::String compress(const oatpp::String& body)
+            {
+#ifdef PRIMUS_WITH_ZLIB
+                if (!body || body->size() < primus::constants::cache::compressionThreshold)
+                    return nullptr;
+
+                z_stream stream;
+                std::memset(&stream, 0, sizeof(stream));
+
+                /* windowBits 15 + 16 selects the gzip container */
+                if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                    return nullptr;
+
+                std::string compressed;
+                compressed.resize(deflateBound(&stream, static_cast<uLong>(body->size())));
+
+                stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body->data()));
+                stream.avail_in = static_cast<uInt>(body->size());
+                stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+                stream.avail_out = static_cast<uInt>(compressed.size());
+
+                int result = deflate(&stream, Z_FINISH);
+                compressed.resize(stream.total_out);
+                deflateEnd(&stream);
+
+                if (result != Z_STREAM_END || compressed.size() >= body->size())
+                    return nullptr;
+
+                return oatpp::String(compressed);
+#else
+                (void)body;
+                return nullptr;
+#endif
+            }
+
+            /**
+             * Whether or not the value of an Accept-Encoding header allows a gzip encoded response: gzip (or
+             * x-gzip) is listed with a q value above 0, or it is not listed and "*" is. "gzip;q=0" refuses it
+             */
+            static bool acceptsGzip(const oatpp::String& acceptEncoding)
+            {
+                if (!acceptEncoding)
+                    return false;
+
+                const std::string& header = *acceptEncoding;
+                double gzip = -1;
+                double any = -1;
+
+                std::size_t begin = 0;
+                while (begin < header.size())
+                {
+                    std::size_t end = header.find(',', begin);
+                    if (end == std::string::npos)
+                        end = header.size();
+                    std::string item = header.substr(begin, end - begin);
+                    begin = end + 1;
+
+                    std::size_t parameters = item.find(';');
+                    std::string coding = trimToken(item, 0, parameters == std::string::npos ? item.size() : parameters);
+                    if (coding == "gzip" || coding == "x-gzip")
+                        gzip = std::max(gzip, parseQuality(item, parameters));
+                    else if (coding == "*")
+                        any = parseQuality(item, parameters);
+                }
+                return gzip >= 0 ? gzip > 0 : any > 0;
+            }
+        };
+
+        inline oatpp::String CachedResponse::getGzipBody() const
+        {
+            std::call_once(m_gzipOnce, [this] { m_gzipBody = ResponseCache::compress(body); });
+            return m_gzipBody;
+        }
+
+    } // namespace cache
+} // namespace primus
+
+#endif // RESPONSECACHE_HPP
@@ -0,0 +1,214 @@
+#ifndef SINGLEFLIGHT_HPP
+#define SINGLEFLIGHT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "oatpp/core/Types.hpp"
+
+#include "ResponseCache.hpp"
+#include "database/QueryDeadline.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace cache
+    {
+        //  ____  _             _      _____ _ _       _     _
+        // / ___|(_)_ __   __ _| | ___|  ___| (_) __ _| |__ | |_
+        // \___ \| | '_ \ / _` | |/ _ \ |_  | | |/ _` | '_ \| __|
+        //  ___) | | | | | (_| | |  __/  _| | | | (_| | | | | |_
+        // |____/|_|_| |_|\__, |_|\___|_|   |_|_|\__, |_| |_|\__|
+        //                |___/                  |___/
+        /**
+         * @brief Coalesces identical concurrent read requests into one computation.
+         *
+         * The first request for a key computes the response, requests for the same key arriving while it runs
+         * wait for it and send the same serialized bytes. A request only joins if the flight is younger than the
+         * coalescing window and none of the tables of its ticket changed since the flight started, so a request
+         * never receives data older than a write it could have seen. A follower waits no longer than its own
+         * primus::database::RequestDeadline, a slow leader does not hold it past the time it was given.
+         */
+        class SingleFlight
+        {
+        public:
+            typedef std::function<std::shared_ptr<const CachedResponse>()> Computation;
+
+            struct Configuration
+            {
+                std::chrono::milliseconds window;   // 0 disables coalescing
+
+                static Configuration fromEnvironment()
+                {
+                    Configuration configuration;
+                    configuration.window = std::chrono::milliseconds(primus::environment::getUInt("PRIMUS_SINGLE_FLIGHT_WINDOW_MS", primus::constants::cache::singleFlightWindow));
+                    return configuration;
+                }
+            };
+
+            struct Statistics
+            {
+                v_uint64 leaders;       // Computations started
+                v_uint64 followers;     // Requests served by the computation of another request
+                v_uint64 bypasses;      // Requests which found a flight too old or behind a write and computed themselves
+                v_uint64 failures;      // Computations which threw, their followers received the same error
+                v_uint64 timeouts;      // Followers which reached their deadline before the computation finished
+                v_uint64 inFlight;
+            };
+
+        private:
+            struct Flight
+            {
+                ResponseCache::Ticket                   ticket;
+                std::chrono::steady_clock::time_point   started;
+                std::condition_variable                 done;       // Wakes the followers of this flight only
+                bool                                    finished;
+                std::shared_ptr<const CachedResponse>   response;
+                std::exception_ptr                      error;
+
+                Flight() : finished(false) {}
+            };
+
+            Configuration                                               m_configuration;
+            std::mutex                                                  m_lock;
+            std::unordered_map<std::string, std::shared_ptr<Flight>>    m_flights;
+
+            std::atomic<v_uint64> m_leaders;
+            std::atomic<v_uint64> m_followers;
+            std::atomic<v_uint64> m_bypasses;
+            std::atomic<v_uint64> m_failures;
+            std::atomic<v_uint64> m_timeouts;
+
+        private:
+            bool canJoin(const Flight& flight, const ResponseCache::Ticket& ticket, std::chrono::steady_clock::time_point now) const
+            {
+                return now - flight.started <= m_configuration.window && flight.ticket.generations == ticket.generations && flight.ticket.dependencies == ticket.dependencies;
+            }
+
+        public:
+            SingleFlight(const Configuration& configuration)
+                : m_configuration(configuration)
+                , m_leaders(0)
+                , m_followers(0)
+                , m_bypasses(0)
+                , m_failures(0)
+                , m_timeouts(0)
+            {}
+
+            /**
+             * Returns the response of the flight for the key, computing it if there is none to join
+             *
+             * @param key Normalized request key, see ResponseCache::normalizeKey
+             * @param ticket Generations the caller observed before, see ResponseCache::openTicket
+             * @param compute Produces the serialized response, runs on the calling thread. A nullptr, e.g. for a row
+             *                which disappeared, is handed to every follower as well
+             *
+             * @throws whatever the computation of the flight threw, to the leader and every follower
+             * @throws primus::database::RequestTimeoutError if a follower reaches the deadline of its request first
+             *
+             */
+            std::shared_ptr<const CachedResponse> run(const std::string& key, const ResponseCache::Ticket& ticket, const Computation& compute)
+            {
+                if (m_configuration.window.count() == 0)
+                    return compute();
+
+                std::shared_ptr<Flight> flight;
+                {
+                    std::unique_lock<std::mutex> guard(m_lock);
+
+                    auto it = m_flights.find(key);
+                    if (it != m_flights.end())
+                    {
+                        if (canJoin(*it->second, ticket, std::chrono::steady_clock::now()))
+                        {
+                            std::shared_ptr<Flight> joined = it->second;
+                            m_followers++;
+
+                            /* Some standard libraries overflow converting time_point::max() in wait_until, without a deadline wait plainly */
+                            auto deadline = primus::database::RequestDeadline::get();
+                            auto isFinished = [&joined] { return joined->finished; };
+                            if (deadline == std::chrono::steady_clock::time_point::max())
+                                joined->done.wait(guard, isFinished);
+                            else if (!joined->done.wait_until(guard, deadline, isFinished))
+                            {
+                                m_timeouts++;
+                                throw primus::database::RequestTimeoutError("the identical request '" + key + "'");
+                            }
+
+                            if (joined->error)
+                                std::rethrow_exception(joined->error);
+                            return joined->response;
+                        }
+                        m_bypasses++;
+                    }
+
+                    /* A newer flight replaces one that is too old or behind a write, later requests join the newer one */
+                    flight = std::make_shared<Flight>();
+                    flight->ticket = ticket;
+                    flight->started = std::chrono::steady_clock::now();
+                    m_flights[key] = flight;
+                    m_leaders++;
+                }
+
+                std::shared_ptr<const CachedResponse> response;
+                std::exception_ptr error;
+                try
+                {
+                    response = compute();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                    m_failures++;
+                }
+
+                {
+                    std::lock_guard<std::mutex> guard(m_lock);
+
+                    flight->response = response;
+                    flight->error = error;
+                    flight->finished = true;
+
+                    auto it = m_flights.find(key);
+                    if (it != m_flights.end() && it->second == flight)
+                        m_flights.erase(it);
+                }
+                flight->done.notify_all();
+
+                if (error)
+                    std::rethrow_exception(error);
+                return response;
+            }
+
+            const Configuration& getConfiguration() const
+            {
+                return m_configuration;
+            }
+
+            Statistics getStatistics()
+            {
+                Statistics statistics;
+                statistics.leaders = m_leaders;
+                statistics.followers = m_followers;
+                statistics.bypasses = m_bypasses;
+                statistics.failures = m_failures;
+                statistics.timeouts = m_timeouts;
+
+                std::lock_guard<std::mutex> guard(m_lock);
+                statistics.inFlight = m_flights.size();
+                return statistics;
+            }
+        };
+
+    } // namespace cache
+} // namespace primus
+
+#endif // SINGLEFLIGHT_HPP
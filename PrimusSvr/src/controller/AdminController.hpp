@@ -0,0 +1,563 @@
+#ifndef ADMINCONTROLLER_HPP
+#define ADMINCONTROLLER_HPP
+
+#include "oatpp/web/server/api/ApiController.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/core/macro/component.hpp"
+#include "cache/ResponseCache.hpp"
+#include "cache/SingleFlight.hpp"
+#include "database/AttendanceArchive.hpp"
+#include "database/BackupService.hpp"
+#include "database/ConnectionPool.hpp"
+#include "database/QueryMonitor.hpp"
+#include "database/ReferenceData.hpp"
+#include "database/ReportingDatabase.hpp"
+#include "dto/AdminDtos.hpp"
+#include "general/constants.hpp"
+#include "tenant/TenantRegistry.hpp"
+
+namespace primus {
+    namespace apicontroller {
+        namespace admin_endpoint {
+
+#include OATPP_CODEGEN_BEGIN(ApiController) // Begin API Controller codegen
+
+            //     _       _           _        ____            _             _ _
+            //    / \   __| |_ __ ___ (_)_ __  / ___|___  _ __ | |_ _ __ ___ | | | ___ _ __
+            //   / _ \ / _` | '_ ` _ \| | '_ \| |   / _ \| '_ \| __| '__/ _ \| | |/ _ \ '__|
+            //  / ___ \ (_| | | | | | | | | | | |__| (_) | | | | |_| | | (_) | | |  __/ |
+            // /_/   \_\__,_|_| |_| |_|_|_| |_|\____\___/|_| |_|\__|_|  \___/|_|_|\___|_|
+            /**
+             * @brief Operational endpoints (metrics and maintenance) of the server.
+             */
+            class AdminController : public oatpp::web::server::api::ApiController
+            {
+                typedef primus::dto::admin::PoolStatisticsDto PoolStatisticsDto;
+                typedef primus::dto::admin::StatementCacheStatisticsDto StatementCacheStatisticsDto;
+                typedef primus::dto::admin::QueryStatisticsDto QueryStatisticsDto;
+                typedef primus::dto::admin::QueryReportDto QueryReportDto;
+                typedef primus::dto::admin::SlowQueryDto SlowQueryDto;
+                typedef primus::dto::admin::SnapshotDto SnapshotDto;
+                typedef primus::dto::admin::BackupDto BackupDto;
+                typedef primus::dto::admin::ReportingSnapshotDto ReportingSnapshotDto;
+                typedef primus::dto::admin::ArchivedYearDto ArchivedYearDto;
+                typedef primus::dto::admin::ArchiveRunDto ArchiveRunDto;
+                typedef primus::dto::admin::ReferenceDataDto ReferenceDataDto;
+                typedef primus::dto::admin::CacheStatisticsDto CacheStatisticsDto;
+                typedef primus::dto::database::DepartmentDto DepartmentDto;
+                typedef primus::dto::database::PricingRuleDto PricingRuleDto;
+
+            private:
+                OATPP_COMPONENT(std::shared_ptr<primus::database::InstrumentedConnectionPool>, m_connectionPool);
+                OATPP_COMPONENT(std::shared_ptr<primus::database::QueryMonitor>, m_queryMonitor);
+                OATPP_COMPONENT(std::shared_ptr<primus::database::BackupService>, m_backupService);
+                OATPP_COMPONENT(std::shared_ptr<primus::database::ReportingDatabase>, m_reporting);
+                OATPP_COMPONENT(std::shared_ptr<primus::database::AttendanceArchive>, m_archive);
+                OATPP_COMPONENT(std::shared_ptr<primus::component::ReferenceDataStore>, m_referenceData);
+                OATPP_COMPONENT(std::shared_ptr<primus::cache::ResponseCache>, m_responseCache);
+                OATPP_COMPONENT(std::shared_ptr<primus::cache::SingleFlight>, m_singleFlight);
+
+                /**
+                 * The reference data of the current tenant, the default one without one
+                 */
+                const std::shared_ptr<primus::component::ReferenceDataStore>& referenceData() const
+                {
+                    const auto& tenant = primus::tenant::CurrentTenant::get();
+                    return tenant ? tenant->getReferenceData() : m_referenceData;
+                }
+
+                /**
+                 * The pool, backups, archive and reporting snapshot belong to the default database, a request for
+                 * a tenant must not act on or report about them
+                 */
+                void assertDefaultDatabase() const
+                {
+                    OATPP_ASSERT_HTTP(!primus::tenant::CurrentTenant::get(), Status::CODE_501, "Database administration is not available in multi-tenant mode");
+                }
+
+                static oatpp::Object<ReferenceDataDto> toReferenceDataDto(const std::shared_ptr<const primus::component::ReferenceData>& referenceData)
+                {
+                    auto dto = ReferenceDataDto::createShared();
+                    dto->generation = referenceData->getGeneration();
+                    dto->loaded = referenceData->getLoaded();
+
+                    dto->departments = oatpp::Vector<oatpp::Object<DepartmentDto>>::createShared();
+                    for (auto& department : referenceData->getDepartments())
+                    {
+                        auto row = DepartmentDto::createShared();
+                        row->id = department.first;
+                        row->name = department.second;
+                        dto->departments->push_back(row);
+                    }
+
+                    dto->pricing = oatpp::Vector<oatpp::Object<PricingRuleDto>>::createShared();
+                    for (auto& rule : referenceData->getPricing())
+                    {
+                        auto row = PricingRuleDto::createShared();
+                        row->rule = rule.rule;
+                        row->departmentId = rule.departmentId;
+                        row->fee = rule.fee;
+                        dto->pricing->push_back(row);
+                    }
+                    return dto;
+                }
+
+                static oatpp::Object<SnapshotDto> toSnapshotDto(const primus::database::BackupService::Snapshot& snapshot)
+                {
+                    auto dto = SnapshotDto::createShared();
+                    dto->file = snapshot.file;
+                    dto->bytes = snapshot.bytes;
+                    dto->created = snapshot.created;
+                    return dto;
+                }
+
+            public:
+                AdminController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
+                    : oatpp::web::server::api::ApiController(objectMapper)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "AdminController (oatpp::web::server::api::ApiController) initialized");
+
+                }
+
+                static std::shared_ptr<AdminController> createShared(
+                    OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper)
+                )
+                {
+                    return std::make_shared<AdminController>(objectMapper);
+                }
+
+                ENDPOINT("GET", "/api/admin/database/pool", getPoolStatistics)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to get the connection pool statistics");
+
+                    assertDefaultDatabase();
+
+                    auto& metrics = m_connectionPool->getMetrics();
+                    auto& configuration = m_connectionPool->getConfiguration();
+
+                    auto statistics = PoolStatisticsDto::createShared();
+                    statistics->maxConnections = configuration.maxConnections;
+                    statistics->minConnections = configuration.minConnections;
+                    statistics->limit = m_connectionPool->getLimit();
+                    statistics->adaptive = configuration.adaptive;
+                    statistics->connectionTtlSeconds = static_cast<v_uint64>(configuration.connectionTtl.count());
+                    statistics->inUse = metrics->inUse.load();
+                    statistics->peakInUse = metrics->peakInUse.load();
+                    statistics->waiting = metrics->waiting.load();
+
+                    v_uint64 checkouts = metrics->checkouts.load();
+                    v_uint64 timeouts = metrics->timeouts.load();
+                    statistics->checkouts = checkouts;
+                    statistics->timeouts = timeouts;
+                    statistics->averageWaitMicros = (checkouts + timeouts) > 0 ? metrics->waitMicrosTotal.load() / (checkouts + timeouts) : 0;
+                    statistics->maxWaitMicros = metrics->waitMicrosMax.load();
+                    statistics->opened = metrics->opened.load();
+                    statistics->closed = metrics->closed.load();
+                    statistics->reopens = metrics->reopens.load();
+
+                    return createDtoResponse(Status::CODE_200, statistics);
+
+                }
+
+                ENDPOINT("GET", "/api/admin/database/statements", getStatementCacheStatistics)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to get the statement cache statistics");
+
+                    assertDefaultDatabase();
+
+                    auto& statementCaches = m_connectionPool->getStatementCaches();
+                    auto& metrics = statementCaches->getMetrics();
+
+                    auto statistics = StatementCacheStatisticsDto::createShared();
+                    v_uint64 hits = metrics->hits.load();
+                    v_uint64 lookups = hits + metrics->misses.load() + metrics->bypasses.load();
+
+                    statistics->capacity = static_cast<v_uint64>(statementCaches->getCapacity());
+                    statistics->cached = metrics->cached.load();
+                    statistics->hits = hits;
+                    statistics->misses = metrics->misses.load();
+                    statistics->bypasses = metrics->bypasses.load();
+                    statistics->evictions = metrics->evictions.load();
+                    statistics->hitRatio = lookups > 0 ? static_cast<v_float64>(hits) / lookups : 0.0;
+
+                    return createDtoResponse(Status::CODE_200, statistics);
+
+                }
+
+                ENDPOINT("GET", "/api/admin/database/queries", getQueryStatistics)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to get the query statistics");
+
+                    typedef primus::database::QueryMonitor QueryMonitor;
+
+                    auto report = QueryReportDto::createShared();
+                    report->slowQueryThresholdMicros = m_queryMonitor->getSlowThresholdMicros();
+                    report->histogramBounds = oatpp::Vector<oatpp::UInt64>::createShared();
+                    for (v_uint32 i = 0; i < QueryMonitor::BUCKET_COUNT; i++)
+                        report->histogramBounds->push_back(QueryMonitor::getBucketBounds()[i]);
+
+                    report->queries = oatpp::Vector<oatpp::Object<QueryStatisticsDto>>::createShared();
+                    m_queryMonitor->forEach([&report](const std::string& name, const QueryMonitor::Counters& counters) {
+
+                        v_uint64 calls = counters.calls.load();
+
+                        auto statistics = QueryStatisticsDto::createShared();
+                        statistics->name = name;
+                        statistics->calls = calls;
+                        statistics->failures = counters.failures.load();
+                        statistics->slowCalls = counters.slowCalls.load();
+                        statistics->rows = counters.rows.load();
+                        statistics->averageMicros = calls > 0 ? counters.totalMicros.load() / calls : 0;
+                        statistics->p50Micros = counters.percentile(0.50);
+                        statistics->p95Micros = counters.percentile(0.95);
+                        statistics->p99Micros = counters.percentile(0.99);
+                        statistics->maxMicros = counters.maxMicros.load();
+                        statistics->averagePoolWaitMicros = calls > 0 ? counters.poolWaitMicros.load() / calls : 0;
+
+                        statistics->histogram = oatpp::Vector<oatpp::UInt64>::createShared();
+                        for (auto& bucket : counters.buckets)
+                            statistics->histogram->push_back(bucket.load());
+
+                        report->queries->push_back(statistics);
+                    });
+
+                    return createDtoResponse(Status::CODE_200, report);
+
+                }
+
+                ENDPOINT("GET", "/api/admin/database/queries/slow", getSlowQueries)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to get the slow query log");
+
+                    auto result = oatpp::Vector<oatpp::Object<SlowQueryDto>>::createShared();
+                    for (auto& slowQuery : m_queryMonitor->getSlowQueries())
+                    {
+                        auto entry = SlowQueryDto::createShared();
+                        entry->name = slowQuery.name;
+                        entry->sql = slowQuery.sql;
+                        entry->plan = slowQuery.plan;
+                        entry->micros = slowQuery.micros;
+                        entry->rows = slowQuery.rows;
+                        entry->poolWaitMicros = slowQuery.poolWaitMicros;
+                        entry->timestamp = slowQuery.timestamp;
+                        result->push_back(entry);
+                    }
+
+                    return createDtoResponse(Status::CODE_200, result);
+
+                }
+
+                ENDPOINT("POST", "/api/admin/database/backup", createBackup)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to create a database backup");
+
+                    assertDefaultDatabase();
+
+                    auto result = m_backupService->createSnapshot();
+
+                    auto backup = BackupDto::createShared();
+                    backup->snapshot = toSnapshotDto(result.snapshot);
+                    backup->pages = result.pages;
+                    backup->steps = result.steps;
+                    backup->durationMs = result.durationMs;
+                    backup->removed = result.removed;
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Processed request to create a database backup: %s", result.snapshot.file.c_str());
+
+                    return createDtoResponse(Status::CODE_201, backup);
+
+                }
+
+                ENDPOINT("GET", "/api/admin/database/backups", getBackups)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to list the database backups");
+
+                    assertDefaultDatabase();
+
+                    auto snapshots = oatpp::Vector<oatpp::Object<SnapshotDto>>::createShared();
+                    for (auto& snapshot : m_backupService->listSnapshots())
+                        snapshots->push_back(toSnapshotDto(snapshot));
+
+                    return createDtoResponse(Status::CODE_200, snapshots);
+
+                }
+
+                ENDPOINT("POST", "/api/admin/database/reporting/refresh", refreshReporting)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to refresh the reporting snapshot");
+
+                    assertDefaultDatabase();
+
+                    auto snapshot = m_reporting->refresh();
+
+                    auto dto = ReportingSnapshotDto::createShared();
+                    dto->generation = snapshot->getGeneration();
+                    dto->created = snapshot->getCreated();
+                    dto->ageSeconds = snapshot->getAge();
+
+                    return createDtoResponse(Status::CODE_201, dto);
+
+                }
+
+                ENDPOINT("POST", "/api/admin/database/archive", archiveAttendance)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to archive the closed attendance years");
+
+                    assertDefaultDatabase();
+
+                    auto result = m_archive->archiveClosedYears();
+
+                    auto run = ArchiveRunDto::createShared();
+                    run->firstHotYear = m_archive->getFirstHotYear();
+                    run->years = oatpp::Vector<oatpp::Int32>::createShared();
+                    for (v_int32 year : result.years)
+                        run->years->push_back(year);
+                    run->rows = result.rows;
+                    run->batches = result.batches;
+                    run->durationMs = result.durationMs;
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Processed request to archive the closed attendance years: %d years, %lu rows",
+                        static_cast<int>(result.years.size()), static_cast<unsigned long>(result.rows));
+
+                    return createDtoResponse(Status::CODE_200, run);
+
+                }
+
+                ENDPOINT("GET", "/api/admin/database/archive", getArchivedYears)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to list the archived attendance years");
+
+                    assertDefaultDatabase();
+
+                    auto years = oatpp::Vector<oatpp::Object<ArchivedYearDto>>::createShared();
+                    for (auto& year : m_archive->listYears())
+                    {
+                        auto dto = ArchivedYearDto::createShared();
+                        dto->year = year.year;
+                        dto->file = year.file;
+                        dto->bytes = year.bytes;
+                        years->push_back(dto);
+                    }
+
+                    return createDtoResponse(Status::CODE_200, years);
+
+                }
+
+                ENDPOINT("GET", "/api/admin/referencedata", getReferenceData)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to get the reference data");
+
+                    return createDtoResponse(Status::CODE_200, toReferenceDataDto(referenceData()->get()));
+
+                }
+
+                ENDPOINT("POST", "/api/admin/referencedata/reload", reloadReferenceData)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to reload the reference data");
+
+                    return createDtoResponse(Status::CODE_200, toReferenceDataDto(referenceData()->load()));
+
+                }
+
+                ENDPOINT("PUT", "/api/admin/referencedata/pricing", updatePricing,
+                    BODY_DTO(oatpp::Vector<oatpp::Object<PricingRuleDto>>, pricing))
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to replace the pricing table");
+
+                    auto updated = referenceData()->updatePricing(pricing);
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Processed request to replace the pricing table: generation %lu, %d rules",
+                        static_cast<unsigned long>(updated->getGeneration()), static_cast<int>(updated->getPricing().size()));
+
+                    return createDtoResponse(Status::CODE_200, toReferenceDataDto(updated));
+
+                }
+
+                ENDPOINT("GET", "/api/admin/cache", getCacheStatistics)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::admin_endpoint::logName, "Received request to get the cache statistics");
+
+                    auto cache = m_responseCache->getStatistics();
+                    auto flights = m_singleFlight->getStatistics();
+
+                    auto statistics = CacheStatisticsDto::createShared();
+                    statistics->hits = cache.hits;
+                    statistics->misses = cache.misses;
+                    statistics->stores = cache.stores;
+                    statistics->rejectedStores = cache.rejectedStores;
+                    statistics->invalidations = cache.invalidations;
+                    statistics->entries = cache.entries;
+                    statistics->coalescingWindowMs = static_cast<v_uint64>(m_singleFlight->getConfiguration().window.count());
+                    statistics->leaders = flights.leaders;
+                    statistics->followers = flights.followers;
+                    statistics->bypasses = flights.bypasses;
+                    statistics->failures = flights.failures;
+                    statistics->timeouts = flights.timeouts;
+                    statistics->inFlight = flights.inFlight;
+
+                    return createDtoResponse(Status::CODE_200, statistics);
+
+                }
+
+                ENDPOINT_INFO(getPoolStatistics) {
+                    info->name = "getPoolStatistics";
+                    info->summary = "Get the state of the database connection pool";
+                    info->description = "This endpoint returns the configuration and the counters of the database connection pool: checkouts, wait times, timeouts, opened, closed and reopened connections.";
+                    info->path = "/api/admin/database/pool";
+                    info->method = "GET";
+                    info->addTag("Admin");
+                    info->addResponse<Object<PoolStatisticsDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_501, "text/plain");
+                }
+
+                ENDPOINT_INFO(getStatementCacheStatistics) {
+                    info->name = "getStatementCacheStatistics";
+                    info->summary = "Get the counters of the prepared statement caches";
+                    info->description = "This endpoint returns hits, misses and evictions of the per-connection prepared statement caches.";
+                    info->path = "/api/admin/database/statements";
+                    info->method = "GET";
+                    info->addTag("Admin");
+                    info->addResponse<Object<StatementCacheStatisticsDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_501, "text/plain");
+                }
+
+                ENDPOINT_INFO(getQueryStatistics) {
+                    info->name = "getQueryStatistics";
+                    info->summary = "Get statistics of every database query";
+                    info->description = "This endpoint returns call count, failures, rows, latency percentiles and histogram and pool wait time of every named query of the DatabaseClient.";
+                    info->path = "/api/admin/database/queries";
+                    info->method = "GET";
+                    info->addTag("Admin");
+                    info->addResponse<Object<QueryReportDto>>(Status::CODE_200, "application/json");
+                }
+
+                ENDPOINT_INFO(getSlowQueries) {
+                    info->name = "getSlowQueries";
+                    info->summary = "Get the slow query log";
+                    info->description = "This endpoint returns the latest queries above the slow query threshold (PRIMUS_DB_SLOW_QUERY_MS), newest first, with their bound parameters and query plan.";
+                    info->path = "/api/admin/database/queries/slow";
+                    info->method = "GET";
+                    info->addTag("Admin");
+                    info->addResponse<oatpp::Vector<Object<SlowQueryDto>>>(Status::CODE_200, "application/json");
+                }
+
+                ENDPOINT_INFO(createBackup) {
+                    info->name = "createBackup";
+                    info->summary = "Create a database snapshot";
+                    info->description = "This endpoint copies the running database into a new snapshot with the sqlite backup API. Old snapshots beyond the retention limit are removed.";
+                    info->path = "/api/admin/database/backup";
+                    info->method = "POST";
+                    info->addTag("Admin");
+                    info->addResponse<Object<BackupDto>>(Status::CODE_201, "application/json");
+                    info->addResponse<String>(Status::CODE_409, "text/plain");
+                    info->addResponse<String>(Status::CODE_501, "text/plain");
+                }
+
+                ENDPOINT_INFO(getBackups) {
+                    info->name = "getBackups";
+                    info->summary = "List the database snapshots";
+                    info->description = "This endpoint lists the snapshots in the backup directory, newest first.";
+                    info->path = "/api/admin/database/backups";
+                    info->method = "GET";
+                    info->addTag("Admin");
+                    info->addResponse<oatpp::Vector<Object<SnapshotDto>>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_501, "text/plain");
+                }
+
+                ENDPOINT_INFO(refreshReporting) {
+                    info->name = "refreshReporting";
+                    info->summary = "Refresh the reporting snapshot";
+                    info->description = "This endpoint takes a new reporting snapshot right away instead of waiting for the refresh interval (PRIMUS_REPORTING_REFRESH_MINUTES). Reports already running finish on the previous one.";
+                    info->path = "/api/admin/database/reporting/refresh";
+                    info->method = "POST";
+                    info->addTag("Admin");
+                    info->addResponse<Object<ReportingSnapshotDto>>(Status::CODE_201, "application/json");
+                    info->addResponse<String>(Status::CODE_501, "text/plain");
+                }
+
+                ENDPOINT_INFO(archiveAttendance) {
+                    info->name = "archiveAttendance";
+                    info->summary = "Move the closed years out of the Attendance table";
+                    info->description = "This endpoint moves the attendances of every year before the hot years (PRIMUS_ARCHIVE_HOT_YEARS) into one archive file per year, in small batches while the server keeps serving. An interrupted run is resumed by calling it again.";
+                    info->path = "/api/admin/database/archive";
+                    info->method = "POST";
+                    info->addTag("Admin");
+                    info->addResponse<Object<ArchiveRunDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_409, "text/plain");
+                    info->addResponse<String>(Status::CODE_501, "text/plain");
+                }
+
+                ENDPOINT_INFO(getArchivedYears) {
+                    info->name = "getArchivedYears";
+                    info->summary = "List the archived attendance years";
+                    info->description = "This endpoint lists the archive files of the closed years, oldest first.";
+                    info->path = "/api/admin/database/archive";
+                    info->method = "GET";
+                    info->addTag("Admin");
+                    info->addResponse<oatpp::Vector<Object<ArchivedYearDto>>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_501, "text/plain");
+                }
+
+                ENDPOINT_INFO(getReferenceData) {
+                    info->name = "getReferenceData";
+                    info->summary = "Get the reference data";
+                    info->description = "This endpoint returns the departments and the pricing table the server holds in memory, with the generation of the snapshot.";
+                    info->path = "/api/admin/referencedata";
+                    info->method = "GET";
+                    info->addTag("Admin");
+                    info->addResponse<Object<ReferenceDataDto>>(Status::CODE_200, "application/json");
+                }
+
+                ENDPOINT_INFO(reloadReferenceData) {
+                    info->name = "reloadReferenceData";
+                    info->summary = "Reload the reference data";
+                    info->description = "This endpoint reads the Department and Pricing tables again, e.g. after they were changed outside of the server. Requests already running finish on the previous snapshot.";
+                    info->path = "/api/admin/referencedata/reload";
+                    info->method = "POST";
+                    info->addTag("Admin");
+                    info->addResponse<Object<ReferenceDataDto>>(Status::CODE_200, "application/json");
+                }
+
+                ENDPOINT_INFO(updatePricing) {
+                    info->name = "updatePricing";
+                    info->summary = "Replace the pricing table";
+                    info->description = "This endpoint replaces the pricing table in one transaction and swaps in the new reference data. It needs exactly one none rule, one multiple rule and one single rule per department.";
+                    info->path = "/api/admin/referencedata/pricing";
+                    info->method = "PUT";
+                    info->addTag("Admin");
+                    info->addResponse<Object<ReferenceDataDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_400, "text/plain");
+                }
+
+                ENDPOINT_INFO(getCacheStatistics) {
+                    info->name = "getCacheStatistics";
+                    info->summary = "Get the counters of the response cache and the request coalescing";
+                    info->description = "This endpoint returns hits, misses and stores of the response cache and how many identical concurrent read requests shared one query (PRIMUS_SINGLE_FLIGHT_WINDOW_MS).";
+                    info->path = "/api/admin/cache";
+                    info->method = "GET";
+                    info->addTag("Admin");
+                    info->addResponse<Object<CacheStatisticsDto>>(Status::CODE_200, "application/json");
+                }
+            };
+
+#include OATPP_CODEGEN_END(ApiController) // End API Controller codegen
+
+        } // namespace admin_endpoint
+    } // namespace apicontroller
+} // namespace primus
+
+#endif // ADMINCONTROLLER_HPP
@@ -0,0 +1,412 @@
+#ifndef BATCHCONTROLLER_HPP
+#define BATCHCONTROLLER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "oatpp/web/server/api/ApiController.hpp"
+#include "oatpp/web/protocol/http/incoming/SimpleBodyDecoder.hpp"
+#include "oatpp/web/protocol/http/outgoing/Body.hpp"
+#include "oatpp/parser/json/Utils.hpp"
+#include "oatpp/core/data/stream/BufferStream.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/core/macro/component.hpp"
+#include "database/QueryDeadline.hpp"
+#include "dto/BatchDtos.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+#include "interceptor/InterceptorChain.hpp"
+
+namespace primus {
+    namespace apicontroller {
+        namespace batch_endpoint {
+
+#include OATPP_CODEGEN_BEGIN(ApiController) // Begin API Controller codegen
+
+            //  ____        _       _      ____            _             _ _
+            // | __ )  __ _| |_ ___| |__  / ___|___  _ __ | |_ _ __ ___ | | | ___ _ __
+            // |  _ \ / _` | __/ __| '_ \| |   / _ \| '_ \| __| '__/ _ \| | |/ _ \ '__|
+            // | |_) | (_| | || (__| | | | |__| (_) | | | | |_| | | (_) | | |  __/ |
+            // |____/ \__,_|\__\___|_| |_|\____\___/|_| |_|\__|_|  \___/|_|_|\___|_|
+            /**
+             * @brief Runs many sub-requests in one HTTP round trip.
+             *
+             * The sub-requests run through the InterceptorChain of the server and are handled by the endpoints of
+             * the other controllers, without going through the network stack again. Each one picks its tenant,
+             * encoding and deadline from its own headers like any request. Consecutive GET requests run in parallel
+             * on a fixed set of workers, any other method waits for everything before it and runs alone, so a read
+             * following a write sees the write. The results are returned in the order of the sub-requests.
+             */
+            class BatchController : public oatpp::web::server::api::ApiController
+            {
+                typedef primus::dto::batch::BatchRequestDto BatchRequestDto;
+                typedef primus::dto::batch::BatchResultDto BatchResultDto;
+
+                /**
+                 * Outcome of one sub-request, serialized by hand so JSON bodies are embedded as they are
+                 */
+                struct Result
+                {
+                    v_int32         status;
+                    oatpp::String   contentType;
+                    oatpp::String   body;
+
+                    Result() : status(500) {}
+                };
+
+                /**
+                 * @brief Threads running the parallel sub-requests of every batch, started once with the controller.
+                 */
+                class WorkerPool
+                {
+                private:
+                    std::mutex                          m_lock;
+                    std::condition_variable             m_condition;
+                    std::deque<std::function<void()>>   m_jobs;
+                    std::vector<std::thread>            m_threads;
+                    bool                                m_stopped;
+
+                    void work()
+                    {
+                        std::unique_lock<std::mutex> guard(m_lock);
+                        while (true)
+                        {
+                            m_condition.wait(guard, [this]() { return m_stopped || !m_jobs.empty(); });
+                            if (m_jobs.empty())
+                                return;
+
+                            std::function<void()> job = std::move(m_jobs.front());
+                            m_jobs.pop_front();
+                            guard.unlock();
+                            job();
+                            guard.lock();
+                        }
+                    }
+
+                public:
+                    explicit WorkerPool(v_uint32 threads)
+                        : m_stopped(false)
+                    {
+                        for (v_uint32 i = 0; i < threads; i++)
+                            m_threads.emplace_back(&WorkerPool::work, this);
+                    }
+
+                    ~WorkerPool()
+                    {
+                        {
+                            std::lock_guard<std::mutex> guard(m_lock);
+                            m_stopped = true;
+                        }
+                        m_condition.notify_all();
+                        for (auto& thread : m_threads)
+                            thread.join();
+                    }
+
+                    void post(std::function<void()> job)
+                    {
+                        {
+                            std::lock_guard<std::mutex> guard(m_lock);
+                            m_jobs.push_back(std::move(job));
+                        }
+                        m_condition.notify_one();
+                    }
+                };
+
+                /**
+                 * @brief Sub-requests [next, end) of one run of reads, taken one by one by the calling thread and the
+                 * workers which get to it in time.
+                 */
+                struct ParallelRun
+                {
+                    std::mutex                      lock;
+                    std::condition_variable         finished;
+                    v_uint32                        next;
+                    v_uint32                        end;
+                    v_uint32                        active;     // Threads still dispatching
+                    std::function<void(v_uint32)>   dispatch;
+
+                    /**
+                     * Dispatches sub-requests until none is left. A worker arriving after the run ended touches
+                     * nothing but the run itself, so the batch does not wait for it
+                     */
+                    void work()
+                    {
+                        std::unique_lock<std::mutex> guard(lock);
+                        active++;
+                        while (next < end)
+                        {
+                            v_uint32 index = next++;
+                            guard.unlock();
+                            dispatch(index);
+                            guard.lock();
+                        }
+                        if (--active == 0)
+                            finished.notify_all();
+                    }
+                };
+
+            private:
+                OATPP_COMPONENT(std::shared_ptr<primus::interceptor::InterceptorChain>, m_interceptors);
+
+                v_uint32                    m_parallelism;
+                std::unique_ptr<WorkerPool> m_workers;
+
+                static bool isRead(const oatpp::String& method)
+                {
+                    return method == "GET";
+                }
+
+                static Result error(v_int32 status, const std::string& message)
+                {
+                    Result result;
+                    result.status = status;
+                    result.contentType = "text/plain";
+                    result.body = message;
+                    return result;
+                }
+
+                /**
+                 * Reads the body of a response, whether it is a buffer or a stream of known size
+                 */
+                static oatpp::String readBody(const std::shared_ptr<oatpp::web::protocol::http::outgoing::Body>& body)
+                {
+                    if (!body)
+                        return nullptr;
+
+                    if (body->getKnownData() != nullptr)
+                        return oatpp::String(reinterpret_cast<const char*>(body->getKnownData()), body->getKnownSize());
+
+                    oatpp::data::stream::BufferOutputStream stream;
+                    oatpp::async::Action action;
+                    char buffer[4096];
+                    v_io_size size;
+                    while ((size = body->read(buffer, sizeof(buffer), action)) > 0)
+                        stream.writeSimple(buffer, size);
+                    return stream.toString();
+                }
+
+                /**
+                 * Runs one sub-request through the interceptors and its endpoint on the calling thread
+                 *
+                 * @param outer The batch request, its tenant headers are passed on
+                 * @param deadline The deadline of the batch, sub-requests starting after it are not run
+                 *
+                 */
+                Result dispatch(const oatpp::Object<BatchRequestDto>& request, const std::shared_ptr<IncomingRequest>& outer,
+                                const std::chrono::steady_clock::time_point& deadline)
+                {
+                    namespace http = oatpp::web::protocol::http;
+
+                    if (request == nullptr || request->method == nullptr || request->path == nullptr)
+                        return error(400, "Every sub-request needs a method and a path");
+                    if (request->path->compare(0, 5, "/api/") != 0)
+                        return error(400, "Sub-requests are limited to the API: " + *request->path);
+                    if (request->path->compare(0, 10, "/api/batch") == 0)
+                        return error(400, "Batches cannot be nested");
+                    /* The event stream only ends when its client goes away, which a sub-request never does */
+                    if (request->path->compare(0, 11, "/api/events") == 0)
+                        return error(400, "Event streams cannot be part of a batch");
+
+                    if (std::chrono::steady_clock::now() >= deadline)
+                        return error(504, "The batch ran out of time before " + *request->method + " " + *request->path);
+
+                    http::RequestStartingLine startingLine;
+                    startingLine.method = request->method;
+                    startingLine.path = request->path;
+                    startingLine.protocol = oatpp::String("HTTP/1.1");
+
+                    oatpp::String body = request->body ? request->body : oatpp::String("");
+
+                    http::Headers headers;
+                    headers.put(http::Header::CONTENT_LENGTH, oatpp::utils::conversion::int64ToStr(body->size()));
+                    headers.put(http::Header::CONTENT_TYPE, oatpp::String("application/json"));
+                    /* Sub-responses are embedded into a JSON array, so the endpoints write JSON whatever the batch accepts */
+                    headers.put("Accept", oatpp::String("application/json"));
+                    auto tenant = outer->getHeader(primus::constants::tenant::header);
+                    if (tenant)
+                        headers.put(primus::constants::tenant::header, tenant);
+                    auto host = outer->getHeader("Host");
+                    if (host)
+                        headers.put("Host", host);
+
+                    auto subRequest = IncomingRequest::createShared(nullptr, startingLine, headers,
+                                                                    std::make_shared<oatpp::data::stream::BufferInputStream>(body),
+                                                                    std::make_shared<http::incoming::SimpleBodyDecoder>());
+
+                    auto response = m_interceptors->process(subRequest);
+                    if (!response)
+                        return error(500, "The endpoint returned no response");
+
+                    /* An endless stream would block the thread forever, the response is dropped and ends the stream */
+                    if (response->getBody() && response->getBody()->getKnownSize() < 0)
+                        return error(400, "The response of " + *request->method + " " + *request->path + " is a stream of unknown size and cannot be part of a batch");
+
+                    Result result;
+                    result.status = response->getStatus().code;
+                    result.contentType = response->getHeader(http::Header::CONTENT_TYPE);
+                    if (!result.contentType && response->getBody())
+                    {
+                        /* Buffer bodies only declare their content type when they are sent */
+                        http::Headers declared;
+                        response->getBody()->declareHeaders(declared);
+                        result.contentType = declared.get(http::Header::CONTENT_TYPE);
+                    }
+                    result.body = readBody(response->getBody());
+                    return result;
+                }
+
+                /**
+                 * Dispatches requests [begin, end) on the calling thread and up to m_parallelism - 1 workers. The
+                 * calling thread works through the run itself, so a batch never waits for a busy worker to start
+                 */
+                void dispatchParallel(const oatpp::Vector<oatpp::Object<BatchRequestDto>>& requests, v_uint32 begin, v_uint32 end,
+                                      const std::shared_ptr<IncomingRequest>& outer, const std::chrono::steady_clock::time_point& deadline,
+                                      std::vector<Result>& results)
+                {
+                    auto run = std::make_shared<ParallelRun>();
+                    run->next = begin;
+                    run->end = end;
+                    run->active = 0;
+                    run->dispatch = [&](v_uint32 index) {
+                        results[index] = dispatch(requests[index], outer, deadline);
+                    };
+
+                    v_uint32 helpers = std::min(m_parallelism, end - begin) - 1;
+                    for (v_uint32 i = 0; i < helpers; i++)
+                        m_workers->post([run]() { run->work(); });
+
+                    run->work();
+
+                    std::unique_lock<std::mutex> guard(run->lock);
+                    run->finished.wait(guard, [&]() { return run->active == 0; });
+                }
+
+                /**
+                 * Writes the results as a JSON array of BatchResultDto
+                 */
+                static oatpp::String serialize(const std::vector<Result>& results)
+                {
+                    oatpp::data::stream::BufferOutputStream stream;
+                    stream << "[";
+                    for (std::size_t i = 0; i < results.size(); i++)
+                    {
+                        const Result& result = results[i];
+                        if (i > 0)
+                            stream << ",";
+
+                        stream << "{\"status\":" << result.status << ",\"contentType\":";
+                        if (result.contentType)
+                            stream << "\"" << oatpp::parser::json::Utils::escapeString(result.contentType) << "\"";
+                        else
+                            stream << "null";
+
+                        stream << ",\"body\":";
+                        if (!result.body || result.body->empty())
+                            stream << "null";
+                        else if (result.contentType && result.contentType->compare(0, 16, "application/json") == 0)
+                            stream << result.body;
+                        else if (result.contentType && result.contentType->compare(0, 5, "text/") == 0)
+                            stream << "\"" << oatpp::parser::json::Utils::escapeString(result.body) << "\"";
+                        else
+                            stream << "null";
+                        stream << "}";
+                    }
+                    stream << "]";
+                    return stream.toString();
+                }
+
+            public:
+                BatchController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
+                    : oatpp::web::server::api::ApiController(objectMapper)
+                    , m_parallelism(static_cast<v_uint32>(primus::environment::getUInt("PRIMUS_BATCH_PARALLELISM", primus::constants::apicontroller::batch_endpoint::parallelism)))
+                {
+                    if (m_parallelism < 1)
+                        m_parallelism = 1;
+                    m_workers.reset(new WorkerPool(m_parallelism - 1));
+
+                    OATPP_LOGI(primus::constants::apicontroller::batch_endpoint::logName, "BatchController (oatpp::web::server::api::ApiController) initialized");
+
+                }
+
+                static std::shared_ptr<BatchController> createShared(
+                    OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper)
+                )
+                {
+                    return std::make_shared<BatchController>(objectMapper);
+                }
+
+                ENDPOINT("POST", "/api/batch", runBatch,
+                    BODY_DTO(oatpp::Vector<oatpp::Object<BatchRequestDto>>, requests),
+                    REQUEST(std::shared_ptr<IncomingRequest>, request))
+                {
+
+                    OATPP_ASSERT_HTTP(requests != nullptr, Status::CODE_400, "Expected an array of sub-requests");
+                    OATPP_ASSERT_HTTP(requests->size() <= primus::constants::apicontroller::batch_endpoint::maxRequests, Status::CODE_400, "Too many sub-requests in one batch");
+
+                    OATPP_LOGI(primus::constants::apicontroller::batch_endpoint::logName, "Received request to run a batch of %d sub-requests", static_cast<int>(requests->size()));
+
+                    auto started = std::chrono::steady_clock::now();
+                    v_uint32 count = static_cast<v_uint32>(requests->size());
+                    std::vector<Result> results(count);
+
+                    /* Every sub-request gets a deadline of its own, the batch as a whole is bound by the one it got */
+                    auto deadline = primus::database::RequestDeadline::get();
+
+                    /* Runs of reads go in parallel, everything else runs alone in order */
+                    v_uint32 index = 0;
+                    while (index < count)
+                    {
+                        v_uint32 end = index;
+                        while (end < count && requests[end] != nullptr && isRead(requests[end]->method))
+                            end++;
+
+                        if (end - index > 1)
+                            dispatchParallel(requests, index, end, request, deadline, results);
+                        else
+                        {
+                            end = index + 1;
+                            results[index] = dispatch(requests[index], request, deadline);
+                        }
+                        index = end;
+                    }
+
+                    auto response = createResponse(Status::CODE_200, serialize(results));
+                    response->putHeader(oatpp::web::protocol::http::Header::CONTENT_TYPE, "application/json");
+
+                    OATPP_LOGI(primus::constants::apicontroller::batch_endpoint::logName, "Processed batch of %d sub-requests in %lld ms", static_cast<int>(count),
+                        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count()));
+
+                    return response;
+
+                }
+
+                // Endpoint Infos
+
+                ENDPOINT_INFO(runBatch) {
+                    info->name = "runBatch";
+                    info->summary = "Run many API requests in one round trip";
+                    info->description = "This endpoint takes an array of sub-requests (method, path, body as a string) and returns their responses in the same order. Consecutive GET requests run in parallel (PRIMUS_BATCH_PARALLELISM), other methods run alone after everything before them. At most 32 sub-requests per batch, batches cannot be nested and cannot contain event streams or other responses of unknown size.";
+                    info->path = "/api/batch";
+                    info->method = "POST";
+                    info->addTag("Batch");
+                    info->addResponse<oatpp::Vector<Object<BatchResultDto>>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_400, "text/plain");
+                }
+            };
+
+#include OATPP_CODEGEN_END(ApiController) // End API Controller codegen
+
+        } // namespace batch_endpoint
+    } // namespace apicontroller
+} // namespace primus
+
+#endif // BATCHCONTROLLER_HPP
@@ -0,0 +1,167 @@
+#ifndef EVENTCONTROLLER_HPP
+#define EVENTCONTROLLER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "oatpp/web/server/api/ApiController.hpp"
+#include "oatpp/web/protocol/http/outgoing/StreamingBody.hpp"
+#include "oatpp/core/data/stream/Stream.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/core/macro/component.hpp"
+#include "events/ChangeBus.hpp"
+#include "general/constants.hpp"
+
+namespace primus {
+    namespace apicontroller {
+        namespace event_endpoint {
+
+            //  _____                 _   ____  _
+            // | ____|_   _____ _ __ | |_/ ___|| |_ _ __ ___  __ _ _ __ ___
+            // |  _| \ \ / / _ \ '_ \| __\___ \| __| '__/ _ \/ _` | '_ ` _ \
+            // | |___ \ V /  __/ | | | |_ ___) | |_| | |  __/ (_| | | | | | |
+            // |_____| \_/ \___|_| |_|\__|____/ \__|_|  \___|\__,_|_| |_| |_|
+            /**
+             * @brief Body of GET /api/events, writes the events of a subscription as Server-Sent Events.
+             *
+             * Every read blocks until the next event or, after the keep-alive interval, writes a comment, so a
+             * client that went away is noticed by the failing write and its subscription ends with the body.
+             */
+            class EventStream : public oatpp::data::stream::ReadCallback
+            {
+            private:
+                std::shared_ptr<primus::events::Subscription>  m_subscription;
+                std::chrono::milliseconds                       m_keepAlive;
+                std::string                                     m_frame;
+                std::size_t                                     m_position;
+
+                void nextFrame()
+                {
+                    v_uint64 dropped = 0;
+                    auto event = m_subscription->next(m_keepAlive, dropped);
+
+                    m_position = 0;
+                    if (dropped > 0)
+                        m_frame = "event: resync\ndata: {\"dropped\":" + std::to_string(dropped) + "}\n\n";
+                    else if (event)
+                        m_frame = "id: " + std::to_string(event->id) + "\nevent: " + primus::events::topicName(event->topic) + "\ndata: " + event->data + "\n\n";
+                    else
+                        m_frame = ": keep-alive\n\n";
+                }
+
+            public:
+                EventStream(const std::shared_ptr<primus::events::Subscription>& subscription, std::chrono::milliseconds keepAlive)
+                    : m_subscription(subscription)
+                    , m_keepAlive(keepAlive)
+                    , m_frame("retry: " + std::to_string(primus::constants::events::retry) + "\n\n")
+                    , m_position(0)
+                {}
+
+                ~EventStream() override
+                {
+                    m_subscription->close();
+                }
+
+                oatpp::v_io_size read(void* buffer, v_buff_size count, oatpp::async::Action& action) override
+                {
+                    (void)action;
+                    while (m_position >= m_frame.size())
+                    {
+                        if (m_subscription->isClosed())
+                            return 0;
+                        nextFrame();
+                    }
+
+                    std::size_t size = std::min<std::size_t>(static_cast<std::size_t>(count), m_frame.size() - m_position);
+                    std::memcpy(buffer, m_frame.data() + m_position, size);
+                    m_position += size;
+                    return static_cast<oatpp::v_io_size>(size);
+                }
+            };
+
+#include OATPP_CODEGEN_BEGIN(ApiController) // Begin API Controller codegen
+
+            //  _____                 _    ____            _             _ _
+            // | ____|_   _____ _ __ | |_ / ___|___  _ __ | |_ _ __ ___ | | | ___ _ __
+            // |  _| \ \ / / _ \ '_ \| __| |   / _ \| '_ \| __| '__/ _ \| | |/ _ \ '__|
+            // | |___ \ V /  __/ | | | |_| |__| (_) | | | | |_| | | (_) | | |  __/ |
+            // |_____| \_/ \___|_| |_|\__|\____\___/|_| |_|\__|_|  \___/|_|_|\___|_|
+            /**
+             * @brief Pushes the changes made through the MemberController to dashboards and the attendance
+             * desk, instead of them polling the lists and counts.
+             *
+             * Each open stream holds a connection thread of the server, so their number is limited
+             * (PRIMUS_EVENTS_MAX_SUBSCRIBERS). Events are not replayed, a client receiving a resync event or
+             * reconnecting fetches what it shows again.
+             */
+            class EventController : public oatpp::web::server::api::ApiController
+            {
+            private:
+                OATPP_COMPONENT(std::shared_ptr<primus::events::ChangeBus>, m_changeBus);
+
+            public:
+                EventController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
+                    : oatpp::web::server::api::ApiController(objectMapper)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::event_endpoint::logName, "EventController (oatpp::web::server::api::ApiController) initialized");
+
+                }
+
+                static std::shared_ptr<EventController> createShared(
+                    OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper)
+                )
+                {
+                    return std::make_shared<EventController>(objectMapper);
+                }
+
+                ENDPOINT("GET", "/api/events", streamEvents,
+                    REQUEST(std::shared_ptr<IncomingRequest>, request))
+                {
+
+                    v_uint32 topics = primus::events::parseTopics(request->getQueryParameter("topics"));
+                    OATPP_ASSERT_HTTP(topics != 0, Status::CODE_400, "Unknown topic. Available topics: member, attendance, association, count");
+
+                    auto subscription = m_changeBus->subscribe(topics);
+                    OATPP_ASSERT_HTTP(subscription != nullptr, Status::CODE_503, "Too many open event streams");
+
+                    OATPP_LOGI(primus::constants::apicontroller::event_endpoint::logName, "Opened event stream for topics 0x%x, %d streams open", topics, static_cast<int>(m_changeBus->getSubscriberCount()));
+
+                    auto body = std::make_shared<oatpp::web::protocol::http::outgoing::StreamingBody>(
+                        std::make_shared<EventStream>(subscription, std::chrono::seconds(primus::constants::events::keepAlive)));
+
+                    auto response = OutgoingResponse::createShared(Status::CODE_200, body);
+                    response->putHeader(oatpp::web::protocol::http::Header::CONTENT_TYPE, primus::constants::events::contentType);
+                    response->putHeader("Cache-Control", "no-cache");
+                    response->putHeader("X-Accel-Buffering", "no");
+                    return response;
+
+                }
+
+                // Endpoint Infos
+
+                ENDPOINT_INFO(streamEvents) {
+                    info->name = "streamEvents";
+                    info->summary = "Stream the changes to members, attendances, associations and counts";
+                    info->description = "This endpoint keeps the connection open and sends a Server-Sent Event (text/event-stream) for every change, named by its topic with a JSON ChangeEventDto as data. A client falling behind gets superseded events merged; if its queue still overflows, events are dropped and a resync event tells it to fetch its data again.";
+                    info->path = "/api/events";
+                    info->method = "GET";
+                    info->addTag("Events");
+                    info->queryParams["topics"].description = "Comma separated topics to receive: member, attendance, association, count. All topics if omitted";
+                    info->queryParams["topics"].required = false;
+                    info->addResponse<String>(Status::CODE_200, primus::constants::events::contentType);
+                    info->addResponse<String>(Status::CODE_400, "text/plain");
+                    info->addResponse<String>(Status::CODE_503, "text/plain");
+                }
+            };
+
+#include OATPP_CODEGEN_END(ApiController) // End API Controller codegen
+
+        } // namespace event_endpoint
+    } // namespace apicontroller
+} // namespace primus
+
+#endif // EVENTCONTROLLER_HPP
@@ -1,14 +1,31 @@
 #ifndef MEMBERCONTROLLER_HPP
 #define MEMBERCONTROLLER_HPP
 
+#include <ctime>
+
 #include "oatpp/web/server/api/ApiController.hpp"
 #include "oatpp/core/macro/codegen.hpp"
 #include "oatpp/core/macro/component.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
 #include "dto/StatusDto.hpp"
 #include "dto/PageDto.hpp"
 #include "dto/Int32Dto.hpp"
+#include "dto/MemberProfileDto.hpp"
 #include "dto/BooleanDto.hpp"
+#include "dto/FieldSelection.hpp"
+#include "general/attributes.hpp"
 #include "general/constants.hpp"
+#include "general/errors.hpp"
+#include "mapping/ContentNegotiation.hpp"
+#include "cache/EntityTag.hpp"
+#include "cache/ResponseCache.hpp"
+#include "cache/SingleFlight.hpp"
+#include "database/AddressDeduplicator.hpp"
+#include "database/AttendanceArchive.hpp"
+#include "database/RowArena.hpp"
+#include "database/ReferenceData.hpp"
+#include "events/ChangeBus.hpp"
+#include "tenant/TenantRegistry.hpp"
 #include "assert.h"
 
 namespace primus {
@@ -28,6 +45,7 @@ namespace primus {
             class MemberController : public oatpp::web::server::api::ApiController
             {
                 typedef primus::dto::database::MemberDto MemberDto;
+                typedef primus::dto::database::UpdatedMemberDto UpdatedMemberDto;
                 typedef primus::dto::database::DepartmentDto DepartmentDto;
                 typedef primus::dto::database::AddressDto AddressDto;
                 typedef primus::dto::database::DateDto DateDto;
@@ -36,14 +54,455 @@ namespace primus {
                 typedef primus::dto::Int32Dto Int32Dto;
                 typedef primus::dto::BooleanDto BooleanDto;
                 typedef primus::dto::StatusDto StatusDto;
+                typedef primus::dto::MemberProfileDto MemberProfileDto;
+                typedef primus::dto::events::AssociationChangeDto AssociationChangeDto;
+                typedef primus::dto::events::AttendanceChangeDto AttendanceChangeDto;
+                typedef primus::dto::events::MemberCountsDto MemberCountsDto;
+
+                enum ProfileSection : v_uint32
+                {
+                    ProfileMember           = 1 << 0,
+                    ProfileAddresses        = 1 << 1,
+                    ProfileDepartments      = 1 << 2,
+                    ProfileAttendances      = 1 << 3,
+                    ProfileFee              = 1 << 4,
+                    ProfileWeaponPurchase   = 1 << 5,
+                    ProfileAvatar           = 1 << 6,
+                    ProfileAll              = (1 << 7) - 1
+                };
 
             private:
                 OATPP_COMPONENT(std::shared_ptr<primus::component::DatabaseClient>, m_database);
+                OATPP_COMPONENT(std::shared_ptr<primus::component::MemberDirectory>, m_directory);
+                OATPP_COMPONENT(std::shared_ptr<primus::cache::ResponseCache>, m_responseCache);
+                OATPP_COMPONENT(std::shared_ptr<primus::cache::SingleFlight>, m_singleFlight);
+                OATPP_COMPONENT(std::shared_ptr<primus::database::AttendanceArchive>, m_archive);
+                OATPP_COMPONENT(std::shared_ptr<primus::component::ReferenceDataStore>, m_referenceData);
+                OATPP_COMPONENT(std::shared_ptr<primus::events::ChangeBus>, m_changeBus);
+                OATPP_COMPONENT(std::shared_ptr<primus::error::ErrorResponses>, m_errors);
+
+                /* Serializes ?fields= responses, the fields not selected are null and left out */
+                std::shared_ptr<ObjectMapper> m_sparseMapper;
+
+                /**
+                 * The database of the current tenant, the default database without one
+                 */
+                const std::shared_ptr<primus::component::DatabaseClient>& database() const
+                {
+                    const auto& tenant = primus::tenant::CurrentTenant::get();
+                    return tenant ? tenant->getDatabase() : m_database;
+                }
+
+                /**
+                 * The member directory of the current tenant, the default directory without one
+                 */
+                const std::shared_ptr<primus::component::MemberDirectory>& directory() const
+                {
+                    const auto& tenant = primus::tenant::CurrentTenant::get();
+                    return tenant ? tenant->getDirectory() : m_directory;
+                }
+
+                /**
+                 * The departments and pricing of the current tenant, the default ones without one
+                 */
+                const std::shared_ptr<primus::component::ReferenceDataStore>& referenceData() const
+                {
+                    const auto& tenant = primus::tenant::CurrentTenant::get();
+                    return tenant ? tenant->getReferenceData() : m_referenceData;
+                }
+
+                /**
+                 * Prefixes a cache or single-flight key by the tenant so clubs never see each other's pages, and
+                 * suffixes it by the response encoding so a CBOR client never gets the JSON bytes
+                 */
+                std::string tenantKey(const std::string& key) const
+                {
+                    const auto& tenant = primus::tenant::CurrentTenant::get();
+                    return (tenant ? tenant->getName() + "@" + key : key) + primus::mapping::CurrentEncoding::getKeySuffix();
+                }
+
+                /**
+                 * The response cache scope of the tenant, its writes only drop its own pages
+                 */
+                static std::string tenantScope()
+                {
+                    const auto& tenant = primus::tenant::CurrentTenant::get();
+                    return tenant ? tenant->getName() : std::string();
+                }
+
+                /**
+                 * The version of a member, MemberNotFound if the member was deleted since the directory was asked
+                 */
+                primus::error::Result<v_uint32> getMemberVersion(const oatpp::UInt32& id)
+                {
+                    auto dbResult = database()->getMemberVersion(id);
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    auto version = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
+
+                    if (version->size() != 1)
+                        return primus::error::Result<v_uint32>::fail(primus::error::Error::MemberNotFound);
+                    return primus::error::Result<v_uint32>::ok(version[0]->value);
+                }
+
+                /**
+                 * Sends a member with its version as ETag, or 304 if ifNoneMatch names the version already
+                 */
+                std::shared_ptr<OutgoingResponse> createMemberResponse(const oatpp::UInt32& id, const oatpp::String& ifNoneMatch)
+                {
+                    auto error = primus::assert::assertMemberExists(id);
+
+                    if (error != primus::error::Error::None)
+                    {
+                        return m_errors->createResponse(error);
+                    }
+
+                    /* A lookup by primary key is all a client revalidating its copy costs */
+                    auto version = getMemberVersion(id);
+                    if (!version.isOk())
+                        return m_errors->createResponse(version.getError());
+
+                    const char* suffix = primus::mapping::CurrentEncoding::getKeySuffix();
+                    std::string etag = primus::cache::EntityTag::of(version.getValue(), suffix);
+                    if (!primus::cache::EntityTag::noneMatchHolds(ifNoneMatch, version.getValue(), suffix))
+                    {
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member with id: %d not modified", id.operator v_uint32());
+
+                        auto response = createResponse(Status::CODE_304);
+                        response->putHeader("ETag", etag);
+                        response->putHeader("Vary", "Accept, Accept-Encoding");
+                        return response;
+                    }
+
+                    /* Not kept in the response cache, but identical concurrent requests share one query. The member may
+                       be newer than the version read before it, its next revalidation then fetches it again. A member
+                       deleted in between leaves the flight without a response */
+                    std::string key = tenantKey("/api/member/" + std::to_string(id.operator v_uint32()));
+                    auto ticket = m_responseCache->openTicket(tenantScope(), { primus::cache::Table::Member });
+
+                    auto coalesced = m_singleFlight->run(key, ticket, [&]() -> std::shared_ptr<const primus::cache::CachedResponse> {
+                        auto dbResult = database()->getMemberById(id);
+
+                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                        if (!dbResult->hasMoreToFetch())
+                            return nullptr;
+
+                        auto result = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
+                        OATPP_ASSERT_HTTP(result->size() == 1, Status::CODE_500, "Unknown error");
+
+                        auto serialized = std::make_shared<primus::cache::CachedResponse>();
+                        serialized->contentType = primus::mapping::CurrentEncoding::getContentType();
+                        serialized->body = getDefaultObjectMapper()->writeToString(result);
+                        return serialized;
+                    });
+                    if (!coalesced)
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Processed request to get member by id: %d", id.operator v_uint32());
+
+                    auto response = createResponse(Status::CODE_200, coalesced->body);
+                    response->putHeader(oatpp::web::protocol::http::Header::CONTENT_TYPE, coalesced->contentType);
+                    response->putHeader("ETag", etag);
+                    response->putHeader("Vary", "Accept, Accept-Encoding");
+                    return response;
+                }
+
+                /**
+                 * Sends a member already read with its version, e.g. the row an UPDATE returned, without asking the
+                 * database again
+                 */
+                std::shared_ptr<OutgoingResponse> createMemberResponse(const oatpp::Object<UpdatedMemberDto>& updated)
+                {
+                    auto member = MemberDto::createShared();
+                    member->id = updated->id;
+                    member->firstName = updated->firstName;
+                    member->lastName = updated->lastName;
+                    member->email = updated->email;
+                    member->phoneNumber = updated->phoneNumber;
+                    member->birthDate = updated->birthDate;
+                    member->createDate = updated->createDate;
+                    member->notes = updated->notes;
+                    member->active = updated->active;
+
+                    auto result = oatpp::Vector<oatpp::Object<MemberDto>>::createShared();
+                    result->push_back(member);
+
+                    auto response = createResponse(Status::CODE_200, getDefaultObjectMapper()->writeToString(result));
+                    response->putHeader(oatpp::web::protocol::http::Header::CONTENT_TYPE, primus::mapping::CurrentEncoding::getContentType());
+                    response->putHeader("ETag", primus::cache::EntityTag::of(updated->version, primus::mapping::CurrentEncoding::getKeySuffix()));
+                    response->putHeader("Vary", "Accept, Accept-Encoding");
+                    return response;
+                }
+
+                /**
+                 * Publishes a change of a member to GET /api/events, followed by the member counts it may have changed
+                 */
+                void publishMember(const char* type, const oatpp::UInt32& id, const oatpp::Object<MemberDto>& member)
+                {
+                    m_changeBus->publish(primus::events::TopicMember, type, "member:" + std::to_string(id.operator v_uint32()), id, member);
+
+                    v_uint32 all = directory()->getMemberCount();
+                    v_uint32 active = directory()->getActiveCount();
+
+                    auto counts = MemberCountsDto::createShared();
+                    counts->all = all;
+                    counts->active = active;
+                    counts->inactive = all - active;
+                    m_changeBus->publish(primus::events::TopicCount, "changed", "count", nullptr, counts);
+                }
+
+                /**
+                 * Publishes a department or address a member was added to or removed from to GET /api/events
+                 */
+                void publishAssociation(const char* type, const oatpp::UInt32& memberId, const oatpp::UInt32& departmentId, const oatpp::UInt32& addressId)
+                {
+                    auto association = AssociationChangeDto::createShared();
+                    association->departmentId = departmentId;
+                    association->addressId = addressId;
+
+                    std::string key = "association:" + std::to_string(memberId.operator v_uint32()) + (departmentId != nullptr ? ":department:" + std::to_string(departmentId.operator v_uint32()) : ":address:" + std::to_string(addressId.operator v_uint32()));
+                    m_changeBus->publish(primus::events::TopicAssociation, type, key, memberId, association);
+                }
+
+                /**
+                 * Publishes an attendance added or removed to GET /api/events
+                 */
+                void publishAttendance(const char* type, const oatpp::UInt32& memberId, const oatpp::String& date)
+                {
+                    auto attendance = AttendanceChangeDto::createShared();
+                    attendance->date = date;
+
+                    m_changeBus->publish(primus::events::TopicAttendance, type, "attendance:" + std::to_string(memberId.operator v_uint32()) + ":" + *date, memberId, attendance);
+                }
+
+                /**
+                 * Attendances of a member newest first, reaching into the archived years once there are any
+                 *
+                 * @param connection Used while no year is archived, the archived years are read on connections of their own
+                 */
+                oatpp::Vector<oatpp::Object<DateDto>> fetchAttendancesOfMember(const oatpp::UInt32& memberId, const oatpp::UInt32& limit, const oatpp::UInt32& offset,
+                                                                              const oatpp::provider::ResourceHandle<oatpp::orm::Connection>& connection = nullptr)
+                {
+                    /* Tenants are never archived, all their years are in the Attendance table */
+                    if (primus::tenant::CurrentTenant::get() || !m_archive->hasArchivedYears())
+                    {
+                        auto dbResult = database()->getAttendancesOfMember(memberId, limit, offset, connection);
+                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                        return dbResult->fetch<oatpp::Vector<oatpp::Object<DateDto>>>();
+                    }
+
+                    auto items = oatpp::Vector<oatpp::Object<DateDto>>::createShared();
+                    v_uint32 remaining = limit ? limit.operator v_uint32() : 0;
+                    v_uint32 skip = offset ? offset.operator v_uint32() : 0;
+
+                    for (const auto& history : m_archive->openFullHistory())
+                    {
+                        if (remaining == 0)
+                            break;
+
+                        auto dbResult = history->getAllAttendancesOfMember(memberId, remaining, skip);
+                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+
+                        auto page = dbResult->fetch<oatpp::Vector<oatpp::Object<DateDto>>>();
+                        for (const auto& item : *page)
+                            items->push_back(item);
+                        remaining -= static_cast<v_uint32>(page->size());
+
+                        /* A page starting past the years of this client continues in the older ones with the rest of the offset */
+                        if (page->empty() && skip > 0)
+                        {
+                            dbResult = history->getAttendanceCountOfMember(memberId);
+                            OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+
+                            auto count = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
+                            skip -= std::min<v_uint32>(skip, count->size() == 1 ? count[0]->value.operator v_uint32() : 0);
+                        }
+                        else
+                            skip = 0;
+                    }
+                    return items;
+                }
+
+                /**
+                 * Builds the response cache key of a request
+                 */
+                std::string cacheKey(const std::shared_ptr<IncomingRequest>& request)
+                {
+                    return tenantKey(primus::cache::ResponseCache::normalizeKey(request->getStartingLine().path.std_str(), request->getQueryParameters()));
+                }
+
+                /**
+                 * Today as month and day in UTC, the date SQLite compares to with 'now'
+                 */
+                static std::string currentDay()
+                {
+                    std::time_t time = std::time(nullptr);
+                    std::tm utc;
+#ifdef _WIN32
+                    gmtime_s(&utc, &time);
+#elif __linux__
+                    gmtime_r(&time, &utc);
+#endif
+
+                    char day[8];
+                    std::strftime(day, sizeof(day), "%m-%d", &utc);
+                    return day;
+                }
+
+                /**
+                 * Sends a cached response, choosing the gzip variant if the client accepts it
+                 */
+                std::shared_ptr<OutgoingResponse> createCachedResponse(const std::shared_ptr<IncomingRequest>& request, const std::shared_ptr<const primus::cache::CachedResponse>& cached)
+                {
+                    oatpp::String gzipBody = primus::cache::ResponseCache::acceptsGzip(request->getHeader("Accept-Encoding")) ? cached->getGzipBody() : nullptr;
+                    bool gzip = gzipBody != nullptr;
+
+                    auto response = createResponse(Status::CODE_200, gzip ? gzipBody : cached->body);
+                    response->putHeader(oatpp::web::protocol::http::Header::CONTENT_TYPE, cached->contentType);
+                    response->putHeader("Vary", "Accept, Accept-Encoding");
+                    if (gzip)
+                        response->putHeader("Content-Encoding", "gzip");
+
+                    return response;
+                }
+
+                /**
+                 * Serializes a dto, stores it in the response cache and sends it
+                 */
+                std::shared_ptr<OutgoingResponse> createCachedDtoResponse(const std::shared_ptr<IncomingRequest>& request, const std::string& key, const primus::cache::ResponseCache::Ticket& ticket, const oatpp::Void& dto)
+                {
+                    oatpp::String body = getDefaultObjectMapper()->writeToString(dto);
+                    return createCachedResponse(request, m_responseCache->put(key, ticket, body, primus::mapping::CurrentEncoding::getContentType()));
+                }
+
+                /**
+                 * Runs the query of a cacheable read through the SingleFlight: identical requests arriving while it
+                 * runs wait for it and send the same bytes. The result is stored in the response cache
+                 *
+                 * @param serialize Queries the database and returns the serialized body, may throw HttpError
+                 *
+                 */
+                std::shared_ptr<OutgoingResponse> createCoalescedResponse(const std::shared_ptr<IncomingRequest>& request, const std::string& key, const primus::cache::ResponseCache::Ticket& ticket, const std::function<oatpp::String()>& serialize)
+                {
+                    auto response = m_singleFlight->run(key, ticket, [&]() -> std::shared_ptr<const primus::cache::CachedResponse> {
+                        return m_responseCache->put(key, ticket, serialize(), primus::mapping::CurrentEncoding::getContentType());
+                    });
+                    return createCachedResponse(request, response);
+                }
+
+                /**
+                 * createCoalescedResponse for a dto
+                 *
+                 * @param produce Queries the database and returns the dto to send, may throw HttpError
+                 * @param mapper Serializes the dto, the default object mapper if null
+                 *
+                 */
+                std::shared_ptr<OutgoingResponse> createCoalescedDtoResponse(const std::shared_ptr<IncomingRequest>& request, const std::string& key, const primus::cache::ResponseCache::Ticket& ticket, const std::function<oatpp::Void()>& produce,
+                                                                             const std::shared_ptr<ObjectMapper>& mapper = nullptr)
+                {
+                    return createCoalescedResponse(request, key, ticket, [&]() -> oatpp::String {
+                        return (mapper ? mapper : getDefaultObjectMapper())->writeToString(produce());
+                    });
+                }
+
+                /**
+                 * The JSON mapper of mapper if it can write pages of RowT without DTOs for the current request, else null
+                 */
+                template<class RowT>
+                std::shared_ptr<primus::mapping::SpecializedJsonObjectMapper> flatRowMapper(const std::shared_ptr<ObjectMapper>& mapper) const
+                {
+                    auto negotiating = std::dynamic_pointer_cast<primus::mapping::NegotiatingObjectMapper>(mapper);
+                    if (!negotiating || primus::mapping::CurrentEncoding::getResponse() != primus::mapping::Encoding::Json || !negotiating->getJson()->canWriteRows<RowT>())
+                        return nullptr;
+                    return negotiating->getJson();
+                }
+
+                /**
+                 * Parses the ?include= list of the profile endpoint into ProfileSection flags, all sections without one.
+                 * UnknownProfileSection if a section is not known
+                 */
+                static primus::error::Result<v_uint32> parseProfileSections(const oatpp::String& include)
+                {
+                    namespace profile = primus::constants::apicontroller::member_endpoint::profile;
+                    static const char* const names[] = { profile::member, profile::addresses, profile::departments, profile::attendances, profile::fee, profile::weaponPurchase, profile::avatar };
+
+                    if (include == nullptr || include->empty())
+                        return primus::error::Result<v_uint32>::ok(ProfileAll);
+
+                    v_uint32 sections = 0;
+                    std::size_t begin = 0;
+                    while (begin <= include->size())
+                    {
+                        std::size_t end = include->find(',', begin);
+                        if (end == std::string::npos)
+                            end = include->size();
+                        std::string name = include->substr(begin, end - begin);
+                        begin = end + 1;
+
+                        if (name.empty())
+                            continue;
+
+                        v_uint32 section = 0;
+                        for (v_uint32 i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+                        {
+                            if (name == names[i])
+                                section = 1 << i;
+                        }
+                        if (section == 0)
+                        {
+                            OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Unknown profile section '%s'", name.c_str());
+                            return primus::error::Result<v_uint32>::fail(primus::error::Error::UnknownProfileSection);
+                        }
+                        sections |= section;
+                    }
+                    return primus::error::Result<v_uint32>::ok(sections);
+                }
+
+                /**
+                 * Whether or not a member may purchase a weapon: 18 attendances within the last year or at least one
+                 * in each of its months
+                 *
+                 * @param connection Connection to run the queries on, one from the pool if null
+                 *
+                 */
+                bool mayPurchaseWeapon(const oatpp::UInt32& memberId, const oatpp::provider::ResourceHandle<oatpp::orm::Connection>& connection = nullptr)
+                {
+                    auto dbResult = database()->getCountOfMemberAttendancesInLastYear(memberId, connection);
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    auto count = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Checking first condition of weapon purchase...");
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member attended %d sessions last year.", count[0]->value.operator v_uint32());
+
+                    if (count[0]->value >= 18)
+                    {
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Which allowes him to purchase a weapon");
+                        return true;
+                    }
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member does not have the yearly attendance to purchase a weapon");
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Checking for secondary-condition (monthly attendance x1)");
+
+                    dbResult = database()->countDistinctAttendentMontsWithinLastYear(memberId, connection);
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    count = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
+
+                    if (count[0]->value == 12)
+                    {
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member attended at least one session per month");
+                        return true;
+                    }
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member attended less than one session per month");
+                    return false;
+                }
 
             public:
                 MemberController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
                     : oatpp::web::server::api::ApiController(objectMapper)
                 {
+                    auto sparseJson = oatpp::parser::json::mapping::ObjectMapper::createShared();
+                    sparseJson->getSerializer()->getConfig()->includeNullFields = false;
+                    m_sparseMapper = primus::mapping::NegotiatingObjectMapper::createShared(sparseJson);
                     
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "MemberController (oatpp::web::server::api::ApiController) initialized");
                     
@@ -57,59 +516,115 @@ namespace primus {
                 }
 
                 ENDPOINT("GET", "/api/members/list/{attribute}", getMembersList,
-                    PATH(oatpp::String, attribute), QUERY(oatpp::UInt32, limit), QUERY(oatpp::UInt32, offset))
+                    PATH(oatpp::String, attribute), QUERY(oatpp::UInt32, limit), QUERY(oatpp::UInt32, offset),
+                    BUNDLE(oatpp::UInt32, resolved, primus::attribute::bundleKey),
+                    REQUEST(std::shared_ptr<IncomingRequest>, request))
                 {
                     
-                    std::shared_ptr<oatpp::orm::QueryResult> dbResult;
-                    if (attribute == oatpp::String("all"))
+                    /* Resolved by the AttributeInterceptor, an unknown attribute never gets here */
+                    auto list = primus::attribute::fromBundle(resolved);
+
+                    std::string key = cacheKey(request);
+                    /* The birthday list changes at midnight as well, not only with the Member table */
+                    if (list == primus::attribute::Attribute::Birthday)
+                        key += "@" + currentDay();
+                    auto cached = m_responseCache->get(key);
+                    if (cached)
                     {
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list of all members. Limit: %d, Offset: %d", limit.operator v_uint32(), offset.operator v_uint32());
-
-                        dbResult = m_database->getAllMembers(limit, offset);
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Serving list of members with %s from response cache", attribute->c_str());
+                        return createCachedResponse(request, cached);
                     }
-                    else if (attribute == oatpp::String("active"))
+                    auto ticket = m_responseCache->openTicket(tenantScope(), { primus::cache::Table::Member });
+
+                    std::function<std::shared_ptr<oatpp::orm::QueryResult>()> query;
+                    switch (list)
                     {
+                    case primus::attribute::Attribute::Active:
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list of all active members. Limit: %d, Offset: %d", limit.operator v_uint32(), offset.operator v_uint32());
 
-                        dbResult = m_database->getActiveMembers(limit, offset);
-                    }
-                    else if (attribute == oatpp::String("inactive"))
-                    {
+                        query = [&]() { return database()->getActiveMembers(limit, offset); };
+                        break;
+                    case primus::attribute::Attribute::Inactive:
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list of all inactive members. Limit: %d, Offset: %d", limit.operator v_uint32(), offset.operator v_uint32());
 
-                        dbResult = m_database->getInactiveMembers(limit, offset);
-                    }
-                    else if (attribute == oatpp::String("birthday"))
-                    {
+                        query = [&]() { return database()->getInactiveMembers(limit, offset); };
+                        break;
+                    case primus::attribute::Attribute::Birthday:
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list of all members with upcomming birthdays. Limit: %d, Offset: %d", limit.operator v_uint32(), offset.operator v_uint32());
 
-                        dbResult = m_database->getMembersWithUpcomingBirthday(limit, offset);
+                        query = [&]() { return database()->getMembersWithUpcomingBirthday(limit, offset); };
+                        break;
+                    default:
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list of all members. Limit: %d, Offset: %d", limit.operator v_uint32(), offset.operator v_uint32());
+
+                        query = [&]() { return database()->getAllMembers(limit, offset); };
+                        break;
                     }
-                    else
+
+                    /* ?fields= narrows the SELECT list, the other columns are neither read, mapped nor encoded */
+                    std::shared_ptr<primus::dto::FieldSelection<MemberDto>> selection;
+                    std::string columns;
+                    oatpp::String fields = request->getQueryParameter("fields");
+                    if (fields)
                     {
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list of members with %s, which is not an available attribute", attribute->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Returning CODE 404: NOT FOUND. Available options: birthday, all, active or inactive");
-
-                        auto status = primus::dto::StatusDto::createShared();
-                        status->code = 404;
-                        status->message = "Received request to get a list of members with invalid attribute. Available options: birthday, all, active or inactive";
-                        status->status = "INVALID ATTRIBUTE";
-                        return createDtoResponse(Status::CODE_200, status);
+                        auto selected = primus::dto::FieldSelection<MemberDto>::select(fields);
+                        if (!selected.isOk())
+                        {
+                            OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Rejected field selection '%s'", fields->c_str());
+                            return m_errors->createResponse(selected.getError());
+                        }
+                        selection = selected.getValue();
+                        columns = selection->getColumns();
+                        query = [&]() { return database()->getMemberListColumns(attribute, columns, limit, offset); };
                     }
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
-                    auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
+                    auto mapper = selection ? m_sparseMapper : getDefaultObjectMapper();
+                    auto flatMapper = flatRowMapper<primus::database::MemberRow>(mapper);
 
-                    auto page = PageDto<oatpp::Object<MemberDto>>::createShared();
+                    return createCoalescedResponse(request, key, ticket, [&]() -> oatpp::String {
+                        auto dbResult = query();
+                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
-                    page->offset = offset;
-                    page->limit = limit;
-                    page->count = items->size();
-                    page->items = items;
+                        v_uint32 count;
+                        oatpp::String body;
 
-                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Processed request to get a list of members with %s. Limit: %d, Offset: %d. Returned %d items", attribute->c_str(), limit.operator v_uint32(), offset.operator v_uint32(), page->count.operator v_uint32());
-                    
-                    return createDtoResponse(Status::CODE_200, page);
+                        auto rows = std::dynamic_pointer_cast<primus::database::CachedQueryResult>(dbResult);
+                        if (flatMapper && rows)
+                        {
+                            /* Rows are decoded into an arena and written from there, no DTO or string is allocated per row.
+                               Columns a ?fields= projection did not select stay null and are left out like with the DTOs */
+                            primus::database::Arena arena;
+                            primus::database::RowPage<primus::database::MemberRow> page;
+
+                            page.offset = primus::database::valueOf(offset);
+                            page.limit = primus::database::valueOf(limit);
+                            page.items = primus::database::RowDecoder<primus::database::MemberRow>(*rows, arena).decode(std::min<v_uint32>(limit ? *limit : 0, primus::constants::database::arena::reservedRows));
+                            page.count = static_cast<v_uint32>(page.items.size());
+
+                            count = page.count.value;
+                            body = flatMapper->writeRows(page, static_cast<v_buff_size>((count + 1) * primus::constants::database::arena::rowBytes));
+                        }
+                        else
+                        {
+                            auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
+                            if (selection)
+                                selection->apply(items);
+
+                            auto page = PageDto<oatpp::Object<MemberDto>>::createShared();
+
+                            page->offset = offset;
+                            page->limit = limit;
+                            page->count = items->size();
+                            page->items = items;
+
+                            count = *page->count;
+                            body = mapper->writeToString(page);
+                        }
+
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Processed request to get a list of members with %s. Limit: %d, Offset: %d. Returned %d items", attribute->c_str(), limit.operator v_uint32(), offset.operator v_uint32(), count);
+
+                        return body;
+                    });
                 }
 
                 ENDPOINT("UPDATE", "/api/member/{id}/activate", activateMember,
@@ -119,16 +634,19 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to activate member with id: %d", id);
 
                     {
-                        auto status = primus::assert::assertMemberExists(id);
+                        auto error = primus::assert::assertMemberExists(id);
 
-                        if (status->code != 200)
+                        if (error != primus::error::Error::None)
                         {
-                            return createDtoResponse(Status::CODE_500, status);
+                            return m_errors->createResponse(error);
                         }
                     }
 
-                    auto dbResult = m_database->activateMember(id);
+                    auto dbResult = database()->activateMember(id);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, "Unknown error");
+                    directory()->setActive(id, true);
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::Member);
+                    publishMember("activated", id, nullptr);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member with id: %d activated", id);
                     
@@ -147,15 +665,18 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to deactivate member with id: %d", id);
 
                     {
-                        auto status = primus::assert::assertMemberExists(id);
-                        if (status->code != 200)
+                        auto error = primus::assert::assertMemberExists(id);
+                        if (error != primus::error::Error::None)
                         {
-                            return createDtoResponse(Status::CODE_500, status);
+                            return m_errors->createResponse(error);
                         }
                     }
 
-                    auto dbResult = m_database->deactivateMember(id);
+                    auto dbResult = database()->deactivateMember(id);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, "UNKNOWN ERROR");
+                    directory()->setActive(id, false);
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::Member);
+                    publishMember("deactivated", id, nullptr);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member with id: %d deactivated", id);
                     
@@ -168,29 +689,13 @@ namespace primus {
                 }
 
                 ENDPOINT("GET", "/api/member/{id}", getMemberById,
-                    PATH(oatpp::UInt32, id))
+                    PATH(oatpp::UInt32, id),
+                    REQUEST(std::shared_ptr<IncomingRequest>, request))
                 {
                     
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get member by id: %d", id.operator v_uint32());
 
-                    auto status = primus::assert::assertMemberExists(id);
-
-                    if (status->code != 200)
-                    {
-                        return createDtoResponse(Status::CODE_500, status);
-                    }
-
-                    auto dbResult = m_database->getMemberById(id);
-
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                    OATPP_ASSERT_HTTP(dbResult->hasMoreToFetch(), Status::CODE_404, "Member not found");
-
-                    auto result = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
-                    OATPP_ASSERT_HTTP(result->size() == 1, Status::CODE_500, "Unknown error");
-
-                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Processed request to get member by id: %d", id.operator v_uint32());
-                    
-                    return createDtoResponse(Status::CODE_200, result);
+                    return createMemberResponse(id, request->getHeader("If-None-Match"));
                 }
 
                 ENDPOINT("POST", "/api/member", createMember,
@@ -209,8 +714,9 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Notes: %s", member->notes->c_str());
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Active: %s", member->active ? "true" : "false");
 
-                    std::shared_ptr<oatpp::orm::QueryResult> dbResult = m_database->createMember(member);
+                    std::shared_ptr<oatpp::orm::QueryResult> dbResult = database()->createMember(member);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, "Bad Request");
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::Member);
 
                     oatpp::UInt32 memberId = oatpp::sqlite::Utils::getLastInsertRowId(dbResult->getConnection());
 
@@ -221,7 +727,7 @@ namespace primus {
                     {
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member already exists. proceeding to return existing user");
 
-                        dbResult = m_database->findMemberIdByDetails(member->firstName, member->lastName, member->email, member->birthDate);
+                        dbResult = database()->findMemberIdByDetails(member->firstName, member->lastName, member->email, member->birthDate);
                         OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, "Unknown error");
 
                         foundMembers = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
@@ -232,109 +738,122 @@ namespace primus {
                     {
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Created member with id: %d", memberId.operator v_uint32());
 
-                        dbResult = m_database->getMemberById(memberId);
+                        dbResult = database()->getMemberById(memberId);
                         OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, "Unknown error");
 
                         foundMembers = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
 
                         retMember = foundMembers[0];
+                        directory()->setMember(memberId, static_cast<bool>(retMember->active));
+                        publishMember("created", memberId, retMember);
                     }
                     
                     return createDtoResponse(memberId == 0 ? Status::CODE_200 : Status::CODE_201, retMember);
                 }
 
                 ENDPOINT("PUT", "/api/member", updateMember,
-                    BODY_DTO(Object<MemberDto>, member))
+                    BODY_DTO(Object<MemberDto>, member),
+                    REQUEST(std::shared_ptr<IncomingRequest>, request))
                 {
                     
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to update member with id: %d", member->id.operator v_uint32());
+                    if (!directory()->exists(member->id))
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
 
+                    if (member->firstName == nullptr || member->lastName == nullptr || member->email == nullptr || member->phoneNumber == nullptr || member->birthDate == nullptr || member->notes == nullptr)
                     {
-                        auto dbResult = m_database->getMemberById(member->id);
-                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                        auto memberArray = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
-                        auto currentMember = memberArray[0];
-
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Old member data:");
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - ID: %d", currentMember->id.operator v_uint32());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - First Name: %s", currentMember->firstName->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Last Name: %s", currentMember->lastName->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Email: %s", currentMember->email->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Phone Number: %s", currentMember->phoneNumber->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Birth Date: %s", currentMember->birthDate->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Create Date: %s", currentMember->createDate->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Notes: %s", currentMember->notes->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Active: %s", currentMember->active ? "true" : "false");
-
-                        if (member->firstName == nullptr || member->lastName == nullptr || member->email == nullptr || member->phoneNumber == nullptr || member->birthDate == nullptr || member->notes == nullptr)
-                        {
-                            oatpp::Object<primus::dto::StatusDto> status = primus::dto::StatusDto::createShared();
+                        return m_errors->createResponse(primus::error::Error::MissingField);
+                    }
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "New member data:");
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - ID: %d", member->id.operator v_uint32());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - First Name: %s", member->firstName->c_str());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Last Name: %s", member->lastName->c_str());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Email: %s", member->email->c_str());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Phone Number: %s", member->phoneNumber->c_str());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Birth Date: %s", member->birthDate->c_str());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Create Date: %s", member->createDate->c_str());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Notes: %s", member->notes->c_str());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Active: %s", member->active ? "true" : "false");
 
-                            status->code = 403;
-                            status->message = "At least one necessary field was null";
-                            status->status = "At least one necessary field was null";
+                    /* With If-Match the UPDATE itself checks the version, so an update made since the client read the
+                       member fails instead of being overwritten */
+                    oatpp::String ifMatch = request->getHeader("If-Match");
+                    bool conditional = ifMatch && !primus::cache::EntityTag::isAny(ifMatch);
 
-                            return createDtoResponse(Status::CODE_403, status);
-                        }
+                    std::shared_ptr<oatpp::orm::QueryResult> dbResult;
+                    if (conditional)
+                    {
+                        v_uint32 version = 0;
+                        OATPP_ASSERT_HTTP(primus::cache::EntityTag::parseVersion(ifMatch, version), Status::CODE_400, "If-Match has to be the ETag of GET /api/member/{id}");
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Expected version: %d", version);
+                        dbResult = database()->updateMemberIfVersion(member, version);
+                    }
+                    else
+                    {
+                        dbResult = database()->updateMember(member);
+                    }
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "New member data:");
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - ID: %d", member->id.operator v_uint32());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - First Name: %s", member->firstName->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Last Name: %s", member->lastName->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Email: %s", member->email->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Phone Number: %s", member->phoneNumber->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Birth Date: %s", member->birthDate->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Create Date: %s", member->createDate->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Notes: %s", member->notes->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "  - Active: %s", member->active ? "true" : "false");
+                    /* The UPDATE returns the row as GET /api/member/{id} reads it, so the response needs no further query */
+                    auto updated = dbResult->fetch<oatpp::Vector<oatpp::Object<UpdatedMemberDto>>>();
+                    if (updated->size() != 1)
+                    {
+                        return m_errors->createResponse(conditional ? primus::error::Error::MemberChanged : primus::error::Error::MemberNotFound);
                     }
 
-                    auto dbResult = m_database->updateMember(member);
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    directory()->setActive(member->id, static_cast<bool>(member->active));
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::Member);
+                    publishMember("updated", member->id, member);
 
-                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Updated member with id: %d", member->id.operator v_uint32());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Updated member with id: %d to version %d", member->id.operator v_uint32(), updated[0]->version.operator v_uint32());
                     
-                    return getMemberById(member->id);
+                    return createMemberResponse(updated[0]);
                 }
 
-                ENDPOINT("GET", "/api/members/count/{attribute}", getMemberCount, PATH(oatpp::String, attribute))
+                ENDPOINT("GET", "/api/members/count/{attribute}", getMemberCount, PATH(oatpp::String, attribute),
+                    BUNDLE(oatpp::UInt32, resolved, primus::attribute::bundleKey),
+                    REQUEST(std::shared_ptr<IncomingRequest>, request))
                 {
                     
+                    /* Resolved by the AttributeInterceptor, an unknown attribute never gets here */
+                    auto counted = primus::attribute::fromBundle(resolved);
 
-                    std::shared_ptr<oatpp::orm::QueryResult> dbResult;
-
-                    if (attribute == oatpp::String("all"))
-                    {
-                        dbResult = m_database->getMemberCountAll();
-                    }
-                    else if (attribute == oatpp::String("active"))
+                    std::string key = cacheKey(request);
+                    auto cached = m_responseCache->get(key);
+                    if (cached)
                     {
-                        dbResult = m_database->getMemberCountActive();
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Serving count of %s members from response cache", attribute->c_str());
+                        return createCachedResponse(request, cached);
                     }
-                    else if (attribute == oatpp::String("inactive"))
-                    {
-                        dbResult = m_database->getMemberCountInactive();
-                    }
-                    else
+                    auto ticket = m_responseCache->openTicket(tenantScope(), { primus::cache::Table::Member });
+
+                    std::function<std::shared_ptr<oatpp::orm::QueryResult>()> query;
+                    switch (counted)
                     {
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received count request for members with attribute %s, which is not an available attribute", attribute->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Returning CODE 500: Bad Request. Available options: all, active, inactive");
-
-                        auto status = primus::dto::StatusDto::createShared();
-                        status->code = 404;
-                        status->message = "Received request for a count of members with invalid attribute. Available options: all, active, inactive";
-                        status->status = "INVALID ATTRIBUTE";
-                        return createDtoResponse(Status::CODE_404, status);
+                    case primus::attribute::Attribute::Active:
+                        query = [&]() { return database()->getMemberCountActive(); };
+                        break;
+                    case primus::attribute::Attribute::Inactive:
+                        query = [&]() { return database()->getMemberCountInactive(); };
+                        break;
+                    default:
+                        query = [&]() { return database()->getMemberCountAll(); };
+                        break;
                     }
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get count of %s members", attribute->c_str());
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
-                    auto count = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
+                    return createCoalescedDtoResponse(request, key, ticket, [&]() -> oatpp::Void {
+                        auto dbResult = query();
+                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
-                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Processed request to get count of %s members. Total count: %d", attribute->c_str(), count[0]->value.operator v_uint32());
-                    
-                    return createDtoResponse(Status::CODE_200, count[0]);
+                        auto count = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
+
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Processed request to get count of %s members. Total count: %d", attribute->c_str(), count[0]->value.operator v_uint32());
+
+                        return count[0];
+                    });
                 }
 
                 ENDPOINT("POST", "/api/member/{memberId}/department/add/{departmentId}", createMemberDepartmentAssociation, PATH(oatpp::UInt32, memberId), PATH(oatpp::UInt32, departmentId))
@@ -343,22 +862,21 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to add member with id %d to department with id %d", memberId.operator v_uint32(), departmentId.operator v_uint32());
 
                     std::shared_ptr<OutgoingResponse>           ret;
-                    oatpp::Vector<oatpp::Object<DepartmentDto>> departments;
                     oatpp::Vector<oatpp::Object<MemberDto>>     member;
                     std::shared_ptr<oatpp::orm::QueryResult>    dbResult;
 
 
-                    dbResult = m_database->getDepartmentById(departmentId);
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                    departments = dbResult->fetch<oatpp::Vector<oatpp::Object<DepartmentDto>>>();
-                    OATPP_ASSERT_HTTP(departments->size() != 0, Status::CODE_404, "Department not found");
-                    OATPP_ASSERT_HTTP(!(departments->size() > 1), Status::CODE_404, "Critical database error: More than 1 department with id %d", departmentId.operator v_uint32());
-                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Department found: %d | %s", departments[0]->id.operator v_uint32(), departments[0]->name->c_str());
-
+                    auto snapshot = referenceData()->get();
+                    const std::string* department = snapshot->findDepartment(departmentId);
+                    if (department == nullptr)
+                        return m_errors->createResponse(primus::error::Error::DepartmentNotFound);
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Department found: %d | %s", departmentId.operator v_uint32(), department->c_str());
 
+                    if (!directory()->exists(memberId))
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Creating member-department association");
-                    dbResult = m_database->associateDepartmentWithMember(departmentId, memberId);
+                    dbResult = database()->associateDepartmentWithMember(departmentId, memberId);
 
                     if (!dbResult->isSuccess())
                     {
@@ -373,6 +891,9 @@ namespace primus {
 
                         return createDtoResponse(Status::CODE_500, ret);
                     }
+                    directory()->addDepartment(memberId, departmentId);
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::DepartmentMember);
+                    publishAssociation("added", memberId, departmentId, nullptr);
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "member-department association successfully created");
 
                     auto status = primus::dto::StatusDto::createShared();
@@ -387,28 +908,29 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to remove member with id %d from department with id %d", memberId.operator v_uint32(), departmentId.operator v_uint32());
 
                     std::shared_ptr<OutgoingResponse>           ret;
-                    oatpp::Vector<oatpp::Object<DepartmentDto>> departments;
                     oatpp::Vector<oatpp::Object<MemberDto>>     member;
                     std::shared_ptr<oatpp::orm::QueryResult>    dbResult;
 
 
-                    dbResult = m_database->getDepartmentById(departmentId);
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                    departments = dbResult->fetch<oatpp::Vector<oatpp::Object<DepartmentDto>>>();
-                    OATPP_ASSERT_HTTP(departments->size() != 0, Status::CODE_404, "Department not found");
-                    OATPP_ASSERT_HTTP(!(departments->size() > 1), Status::CODE_404, "Critical database error: More than 1 department with id %d", departmentId.operator v_uint32());
-                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Department found: %d | %s", departments[0]->id.operator v_uint32(), departments[0]->name->c_str());
+                    auto snapshot = referenceData()->get();
+                    const std::string* department = snapshot->findDepartment(departmentId);
+                    if (department == nullptr)
+                        return m_errors->createResponse(primus::error::Error::DepartmentNotFound);
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Department found: %d | %s", departmentId.operator v_uint32(), department->c_str());
 
-                    auto memberStatus = primus::assert::assertMemberExists(memberId);
-                    if (memberStatus->code != 200)
-                        return createDtoResponse(Status::CODE_500, memberStatus);
+                    auto error = primus::assert::assertMemberExists(memberId);
+                    if (error != primus::error::Error::None)
+                        return m_errors->createResponse(error);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Disassociating member and department");
-                    dbResult = m_database->disassociateDepartmentFromMember(departmentId, memberId);
+                    dbResult = database()->disassociateDepartmentFromMember(departmentId, memberId);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    directory()->removeDepartment(memberId, departmentId);
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::DepartmentMember);
+                    publishAssociation("removed", memberId, departmentId, nullptr);
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "member and department successfully disassociated");
 
-                    memberStatus = primus::dto::StatusDto::createShared();
+                    auto memberStatus = primus::dto::StatusDto::createShared();
 
                     memberStatus->code = 200;
                     memberStatus->message = "member and department successfully disassociated";
@@ -427,44 +949,46 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "- Postal code: %s", address->postalCode->c_str());
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "- Country: %s", address->country->c_str());
 
-                    auto status = primus::assert::assertMemberExists(memberId);
-                    if (status->code != 200)
+                    auto error = primus::assert::assertMemberExists(memberId);
+                    if (error != primus::error::Error::None)
                     {
-                        return createDtoResponse(Status::CODE_500, status);
+                        return m_errors->createResponse(error);
                     }
 
-                    auto dbResult = m_database->createAddress(address);
+                    /*
+                     * Deduplicated by normalizedKey: the upsert returns the new or the existing row in one statement.
+                     * The rowid is cleared first on this connection, so only an insert leaves it set
+                     */
+                    oatpp::String normalizedKey = primus::database::AddressKey::of(address);
+                    auto connection = database()->getExecutor()->getConnection();
+                    sqlite3_set_last_insert_rowid(std::static_pointer_cast<oatpp::sqlite::Connection>(connection.object)->getHandle(), 0);
 
+                    auto dbResult = database()->createAddress(address, normalizedKey, connection);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
-                    oatpp::UInt32 addressId = oatpp::sqlite::Utils::getLastInsertRowId(dbResult->getConnection());
+                    auto foundAddresses = dbResult->fetch<oatpp::Vector<oatpp::Object<AddressDto>>>();
+                    OATPP_ASSERT_HTTP(foundAddresses->size() == 1, Status::CODE_500, "Unknown Error");
+                    oatpp::Object<AddressDto> retAddress = foundAddresses[0];
 
-                    oatpp::Vector<oatpp::Object<AddressDto>> foundAddresses;
-                    oatpp::Object<AddressDto> retAddress;
-
-                    if (addressId == 0)
+                    bool created = oatpp::sqlite::Utils::getLastInsertRowId(connection) != 0;
+                    if (created)
                     {
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Address already exists. Proceeding to return existing id");
-
-                        dbResult = m_database->findAddressByDetails(address->street, address->city, address->postalCode, address->country);
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Address created with id %d", retAddress->id.operator v_uint32());
+                        m_responseCache->invalidate(tenantScope(), primus::cache::Table::Address);
                     }
                     else
                     {
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Address created with id %d", addressId.operator v_uint32());
-
-                        dbResult = m_database->getAddressById(addressId);
+                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Address already exists. Proceeding to return existing id %d", retAddress->id.operator v_uint32());
                     }
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, "Unknown Error");
-
-                    foundAddresses = dbResult->fetch<oatpp::Vector<oatpp::Object<AddressDto>>>();
-                    retAddress = foundAddresses[0];
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Creating member-address association");
-                    dbResult = m_database->associateAddressWithMember(retAddress->id, memberId);
+                    dbResult = database()->associateAddressWithMember(retAddress->id, memberId);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, "Unknown Error");
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::AddressMember);
+                    publishAssociation("added", memberId, nullptr, retAddress->id);
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "member-address association was successfully created");
 
-                    return createDtoResponse(addressId == 0 ? Status::CODE_200 : Status::CODE_201, retAddress);
+                    return createDtoResponse(created ? Status::CODE_201 : Status::CODE_200, retAddress);
                 }
                 ENDPOINT("DELETE", "/api/member/{memberId}/address/remove/{addressId}", deleteMemberAddressDisassociation, PATH(oatpp::UInt32, memberId), PATH(oatpp::UInt32, addressId))
                 {
@@ -477,28 +1001,35 @@ namespace primus {
                     std::shared_ptr<oatpp::orm::QueryResult>    dbResult;
 
 
-                    dbResult = m_database->getAddressById(addressId);
+                    dbResult = database()->getAddressById(addressId);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
                     addresses = dbResult->fetch<oatpp::Vector<oatpp::Object<AddressDto>>>();
-                    OATPP_ASSERT_HTTP(addresses->size() != 0, Status::CODE_404, "address not found");
-                    OATPP_ASSERT_HTTP(!(addresses->size() > 1), Status::CODE_404, "Critical database error: More than 1 address with id %d", departmentId.operator v_uint32());
+                    if (addresses->size() == 0)
+                        return m_errors->createResponse(primus::error::Error::AddressNotFound);
+                    if (addresses->size() > 1)
+                    {
+                        OATPP_LOGE(primus::constants::apicontroller::member_endpoint::logName, "Critical database error: More than 1 address with id %d", addressId.operator v_uint32());
+                        return m_errors->createResponse(primus::error::Error::AddressNotUnique);
+                    }
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Address found");
 
                     {
-                        auto status = primus::assert::assertMemberExists(memberId);
-                        if (status->code != 200)
+                        auto error = primus::assert::assertMemberExists(memberId);
+                        if (error != primus::error::Error::None)
                         {
-                            return createDtoResponse(Status::CODE_500, status);
+                            return m_errors->createResponse(error);
                         }
                     }
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Disassociating member and address");
-                    dbResult = m_database->disassociateAddressFromMember(addressId, memberId);
+                    dbResult = database()->disassociateAddressFromMember(addressId, memberId);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::AddressMember);
+                    publishAssociation("removed", memberId, nullptr, addressId);
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "member and department successfully disassociated");
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Checking for other members using the address...");
-                    dbResult = m_database->getMembersByAddress(addressId);
+                    dbResult = database()->getMembersByAddress(addressId);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
                     member = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
@@ -509,8 +1040,9 @@ namespace primus {
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "No other member using the address.");
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Proceeding with deletion of address");
 
-                        dbResult = m_database->deleteAddress(addressId);
+                        dbResult = database()->deleteAddress(addressId);
                         OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                        m_responseCache->invalidate(tenantScope(), primus::cache::Table::Address);
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Address has been deleted");
                     }
                     else
@@ -531,17 +1063,19 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request set member attendance for member with id %d", memberId.operator v_uint32());
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Date of attendance: %s", dateOfAttendance->c_str());
 
-                    std::shared_ptr<oatpp::orm::QueryResult> dbResult = m_database->getMemberById(memberId);
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                    oatpp::Vector<oatpp::Object<MemberDto>> members = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
-                    OATPP_ASSERT_HTTP(members->size() > 0, Status::CODE_404, "Member not found");
-                    OATPP_ASSERT_HTTP(members->size() < 2, Status::CODE_500, "Critical database error: more than one member with given id");
+                    if (!directory()->exists(memberId))
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member found");
 
-                    dbResult = m_database->createMemberAttendance(memberId, dateOfAttendance);
+                    // Archived years are closed, an attendance added to one would never be read from the Attendance table
+                    OATPP_ASSERT_HTTP(primus::tenant::CurrentTenant::get() || !m_archive->isArchived(std::atoi(dateOfAttendance->c_str())), Status::CODE_409, "The year of the attendance is archived");
+
+                    std::shared_ptr<oatpp::orm::QueryResult> dbResult = database()->createMemberAttendance(memberId, dateOfAttendance);
                     auto foo = dbResult->getErrorMessage();
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::Attendance);
+                    publishAttendance("added", memberId, dateOfAttendance);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member attendance was set for date %s", dateOfAttendance->c_str());
 
@@ -557,17 +1091,18 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request remove member attendance for member with id %d", memberId.operator v_uint32());
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Date of attendance: %s", dateOfAttendance->c_str());
 
-                    std::shared_ptr<oatpp::orm::QueryResult> dbResult = m_database->getMemberById(memberId); // Wheather or not the member exists
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-
-                    auto members = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
-                    OATPP_ASSERT_HTTP(members->size() > 0, Status::CODE_404, "Member not found");
-                    OATPP_ASSERT_HTTP(members->size() < 2, Status::CODE_500, "Critical database error: more than one member with given id");
+                    if (!directory()->exists(memberId)) // Wheather or not the member exists
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member found");
 
-                    dbResult = m_database->deleteMemberAttendance(memberId, dateOfAttendance);
+                    // Archived years are closed, their attendances are no longer in the Attendance table
+                    OATPP_ASSERT_HTTP(primus::tenant::CurrentTenant::get() || !m_archive->isArchived(std::atoi(dateOfAttendance->c_str())), Status::CODE_409, "The year of the attendance is archived");
+
+                    std::shared_ptr<oatpp::orm::QueryResult> dbResult = database()->deleteMemberAttendance(memberId, dateOfAttendance);
                     OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    m_responseCache->invalidate(tenantScope(), primus::cache::Table::Attendance);
+                    publishAttendance("removed", memberId, dateOfAttendance);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member attendance was removed for date %s", dateOfAttendance->c_str());
 
@@ -578,58 +1113,59 @@ namespace primus {
                     return createDtoResponse(Status::CODE_200, status);
                 }
 
+                ENDPOINT("GET", "/api/member/{memberId}/attendance/history/{fromYear}/{toYear}", getMemberAttendanceHistory,
+                    PATH(oatpp::UInt32, memberId), PATH(oatpp::Int32, fromYear), PATH(oatpp::Int32, toYear), QUERY(oatpp::UInt32, limit), QUERY(oatpp::UInt32, offset))
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get the attendances of member id %d from %d to %d. Limit: %d, Offset: %d",
+                        memberId.operator v_uint32(), fromYear.operator v_int32(), toYear.operator v_int32(), limit.operator v_uint32(), offset.operator v_uint32());
+
+                    OATPP_ASSERT_HTTP(!primus::tenant::CurrentTenant::get(), Status::CODE_501, "The attendance history is not available in multi-tenant mode");
+                    OATPP_ASSERT_HTTP(fromYear >= 1900 && toYear <= 9999 && fromYear <= toYear, Status::CODE_400, "Invalid range of years");
+                    if (!directory()->exists(memberId))
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
+
+                    /* Attaches only the archived years of the range */
+                    auto history = m_archive->openHistory(fromYear, toYear);
+
+                    char from[16];
+                    char until[16];
+                    std::snprintf(from, sizeof(from), "%04d-01-01", fromYear.operator v_int32());
+                    std::snprintf(until, sizeof(until), "%04d-01-01", toYear.operator v_int32() + 1);
+
+                    auto dbResult = history->getAttendanceHistoryOfMember(memberId, from, until, limit, offset);
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+
+                    auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<DateDto>>>();
+
+                    auto page = PageDto<oatpp::Object<DateDto>>::createShared();
+
+                    page->offset = offset;
+                    page->limit = limit;
+                    page->count = items->size();
+                    page->items = items;
+
+                    return createDtoResponse(Status::CODE_200, page);
+                }
+
                 ENDPOINT("GET", "/api/member/{memberId}/fee", getMemberFee,
                     PATH(oatpp::UInt32, memberId))
                 {
                     
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to calculate the member fee for member with id %d.", memberId.operator v_uint32());
 
-                    std::shared_ptr<oatpp::orm::QueryResult> dbResult;
-                    oatpp::Vector<oatpp::Object<MemberDto>> members;
-                    oatpp::Vector<oatpp::Object<DepartmentDto>> departments;
                     auto memberFee = UInt32Dto::createShared();
 
-                    dbResult = m_database->getMemberById(memberId);
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-
-                    members = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
-                    OATPP_ASSERT_HTTP(members->size() > 0, Status::CODE_404, "Member not found");
-                    OATPP_ASSERT_HTTP(members->size() < 2, Status::CODE_500, "Critical database error: more than one member with given id");
+                    v_uint32 departmentCount;
+                    v_uint32 firstDepartment;
+                    if (!directory()->getFeeDepartments(memberId, departmentCount, firstDepartment))
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
 
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member was found.", memberId.operator v_uint32());
 
-                    dbResult = m_database->getMemberDepartments(memberId, oatpp::UInt32(3), oatpp::UInt32(static_cast<unsigned int>(0)));
-                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                    departments = dbResult->fetch<oatpp::Vector<oatpp::Object<DepartmentDto>>>();
-
-                    if (departments->size() < 1) // No department
-                        memberFee->value = primus::constants::pricing::DepartmentPrices::None;
-                    else if (departments->size() > 1) // multiple departments
-                        memberFee->value = primus::constants::pricing::DepartmentPrices::Multiple;
-                    else if (departments->size() == 1) // Only one department
-                        switch (departments[0]->id)
-                        {
-                        case 1: // Bogenschiessen
-                            memberFee->value = primus::constants::pricing::DepartmentPrices::Bogenschiessen;
-                            break;
-                        case 2: // Luftdruck
-                            memberFee->value = primus::constants::pricing::DepartmentPrices::Luftdruck;
-                            break;
-                        case 3: // Schusswaffen
-                            memberFee->value = primus::constants::pricing::DepartmentPrices::Schusswaffen;
-                            break;
-                        }
-                    else
-                    {
-                        auto status = primus::dto::StatusDto::createShared();
-
-                        status->status = "UNKNOWN ERROR";
-                        status->code = 500;
-                        status->message = "Failed while trying to determine membership fee";
-                        return createDtoResponse(Status::CODE_500, status);
-                    }
+                    memberFee->value = referenceData()->get()->calculateFee(departmentCount, firstDepartment);
 
-                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member is in %d departments.", departments->size());
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member is in %d departments.", departmentCount);
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Fee is %d euro", memberFee->value.operator v_uint32());
 
                     
@@ -638,26 +1174,27 @@ namespace primus {
                 }
 
                 ENDPOINT("GET", "/api/member/{memberId}/list/{attribute}", getMemberList,
-                    PATH(oatpp::UInt32, memberId), PATH(oatpp::String, attribute), QUERY(oatpp::UInt32, limit), QUERY(oatpp::UInt32, offset))
+                    PATH(oatpp::UInt32, memberId), PATH(oatpp::String, attribute), QUERY(oatpp::UInt32, limit), QUERY(oatpp::UInt32, offset),
+                    BUNDLE(oatpp::UInt32, resolved, primus::attribute::bundleKey))
                 {
                     
 
                     std::shared_ptr<oatpp::orm::QueryResult> dbResult;
                     std::shared_ptr<OutgoingResponse> ret;
 
-                    {
-                        std::shared_ptr<oatpp::orm::QueryResult> dbResult = m_database->getMemberById(memberId);
-                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                        oatpp::Vector<oatpp::Object<MemberDto>> members = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
-                        OATPP_ASSERT_HTTP(members->size() > 0, Status::CODE_404, "Member not found");
-                        OATPP_ASSERT_HTTP(members->size() < 2, Status::CODE_500, "Critical database error: more than one member with given id");
-                    }
+                    /* Resolved by the AttributeInterceptor, an unknown attribute never gets here */
+                    auto association = primus::attribute::fromBundle(resolved);
+
+                    if (!directory()->exists(memberId))
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
 
-                    if (attribute == oatpp::String("addresses"))
+                    switch (association)
+                    {
+                    case primus::attribute::Attribute::Addresses:
                     {
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list addresses associated with member id %d. Limit: %d, Offset: %d", memberId.operator v_uint32(), limit.operator v_uint32(), offset.operator v_uint32());
 
-                        dbResult = m_database->getMemberAddresses(memberId, limit, offset);
+                        dbResult = database()->getMemberAddresses(memberId, limit, offset);
                         OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
                         auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<AddressDto>>>();
@@ -672,12 +1209,13 @@ namespace primus {
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Processed request to get a list of members with %s. Limit: %d, Offset: %d. Returned %d items", attribute->c_str(), limit.operator v_uint32(), offset.operator v_uint32(), page->count.operator v_uint32());
 
                         ret = createDtoResponse(Status::CODE_200, page);
+                        break;
                     }
-                    else if (attribute == oatpp::String("departments"))
+                    case primus::attribute::Attribute::Departments:
                     {
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list departments associated with member id %d. Limit: %d, Offset: %d", memberId.operator v_uint32(), limit.operator v_uint32(), offset.operator v_uint32());
 
-                        dbResult = m_database->getMemberDepartments(memberId, limit, offset);
+                        dbResult = database()->getMemberDepartments(memberId, limit, offset);
                         OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
 
                         auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<DepartmentDto>>>();
@@ -691,15 +1229,13 @@ namespace primus {
                         page->items = items;
 
                         ret = createDtoResponse(Status::CODE_200, page);
+                        break;
                     }
-                    else if (attribute == oatpp::String("attendances"))
+                    default:
                     {
                         OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list attendances associated with member id %d. Limit: %d, Offset: %d", memberId.operator v_uint32(), limit.operator v_uint32(), offset.operator v_uint32());
 
-                        dbResult = m_database->getAttendancesOfMember(memberId, limit, offset);
-                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-
-                        auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<DateDto>>>();
+                        auto items = fetchAttendancesOfMember(memberId, limit, offset);
 
                         auto page = PageDto<oatpp::Object<DateDto>>::createShared();
 
@@ -709,22 +1245,8 @@ namespace primus {
                         page->items = items;
 
                         ret = createDtoResponse(Status::CODE_200, page);
+                        break;
                     }
-                    else
-                    {
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get a list of members with %s, which is not an available attribute", attribute->c_str());
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Returning CODE 500: Bad Request. Available options: addresses");
-
-                        auto status = primus::dto::StatusDto::createShared();
-
-                        oatpp::String verboseMessage = "Received request to get a list of members with invalid attribute: ";
-                        verboseMessage->append(attribute);
-
-
-                        status->code = 404;
-                        status->message = verboseMessage;
-                        status->status = "INVALID ATTRIBUTE";
-                        return createDtoResponse(Status::CODE_404, status);
                     }
 
                     
@@ -739,56 +1261,94 @@ namespace primus {
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to check if member with id %d", memberId.operator v_uint32());
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "is allowed to purchase a weapon");
                     {
-                        auto status = primus::assert::assertMemberExists(memberId);
+                        auto error = primus::assert::assertMemberExists(memberId);
 
-                        if (status->code != 200)
-                            return createDtoResponse(Status::CODE_500, status);
+                        if (error != primus::error::Error::None)
+                            return m_errors->createResponse(error);
                     }
                     OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member was found");
 
-                    {
-                        std::shared_ptr<oatpp::orm::QueryResult> dbResult;
-                        oatpp::Vector<oatpp::Object<UInt32Dto>> count;
-                        auto ret = BooleanDto::createShared();
+                    bool allowed = mayPurchaseWeapon(memberId);
+                    auto ret = BooleanDto::createShared();
+                    ret->value = allowed;
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Returning %s", allowed ? "true" : "false");
+
+                    return createDtoResponse(Status::CODE_200, ret);
+                }
+
+                ENDPOINT("GET", "/api/member/{memberId}/profile", getMemberProfile,
+                    PATH(oatpp::UInt32, memberId),
+                    REQUEST(std::shared_ptr<IncomingRequest>, request))
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Received request to get the profile of member with id %d", memberId.operator v_uint32());
+
+                    auto parsed = parseProfileSections(request->getQueryParameter("include"));
+                    if (!parsed.isOk())
+                        return m_errors->createResponse(parsed.getError());
+                    v_uint32 sections = parsed.getValue();
+                    const v_uint32 limit = primus::constants::apicontroller::member_endpoint::profile::sectionLimit;
+
+                    /* The one existence check of the profile, the sections below rely on it */
+                    if (!directory()->exists(memberId))
+                        return m_errors->createResponse(primus::error::Error::MemberNotFound);
+
+                    auto profile = MemberProfileDto::createShared();
+                    profile->id = memberId;
+
+                    /* Every query of the profile runs on this connection instead of checking one out per section */
+                    oatpp::provider::ResourceHandle<oatpp::orm::Connection> connection;
+                    if (sections & (ProfileMember | ProfileAddresses | ProfileDepartments | ProfileAttendances | ProfileWeaponPurchase))
+                        connection = database()->getExecutor()->getConnection();
 
-                        dbResult = m_database->getCountOfMemberAttendancesInLastYear(memberId);
+                    if (sections & ProfileMember)
+                    {
+                        auto dbResult = database()->getMemberById(memberId, connection);
                         OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                        count = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
 
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Checking first condition of weapon purchase...");
-                        OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member attended %d sessions last year.", count[0]->value.operator v_uint32());
+                        auto members = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
+                        if (members->size() != 1)
+                            return m_errors->createResponse(primus::error::Error::MemberNotFound);
+                        profile->member = members[0];
+                    }
 
-                        if (count[0]->value >= 18)
-                        {
-                            ret->value = true;
-                            OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Which allowes him to purchase a weapon");
-                            OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Returning true");
-                        }
-                        else
-                        {
-                            OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member does not have the yearly attendance to purchase a weapon");
-                            OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Checking for secondary-condition (monthly attendance x1)");
+                    if (sections & ProfileAddresses)
+                    {
+                        auto dbResult = database()->getMemberAddresses(memberId, limit, 0, connection);
+                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                        profile->addresses = dbResult->fetch<oatpp::Vector<oatpp::Object<AddressDto>>>();
+                    }
 
-                            dbResult = m_database->countDistinctAttendentMontsWithinLastYear(memberId);
-                            OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
-                            count = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
-
-                            if (count[0]->value == 12)
-                            {
-                                OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member attended at least one session per month");
-                                OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Returning true");
-                                ret->value = true;
-                            }
-                            else
-                            {
-                                OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Member attended less than one session per month");
-                                OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Returning false");
-                                ret->value = false;
-                            }
-                        }
+                    if (sections & ProfileDepartments)
+                    {
+                        auto dbResult = database()->getMemberDepartments(memberId, limit, 0, connection);
+                        OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                        profile->departments = dbResult->fetch<oatpp::Vector<oatpp::Object<DepartmentDto>>>();
+                    }
+
+                    if (sections & ProfileAttendances)
+                    {
+                        profile->attendances = fetchAttendancesOfMember(memberId, limit, 0, connection);
+                    }
 
-                        return createDtoResponse(Status::CODE_200, ret);
+                    if (sections & ProfileFee)
+                    {
+                        v_uint32 departmentCount;
+                        v_uint32 firstDepartment;
+                        directory()->getFeeDepartments(memberId, departmentCount, firstDepartment);
+                        profile->fee = referenceData()->get()->calculateFee(departmentCount, firstDepartment);
                     }
+
+                    if (sections & ProfileWeaponPurchase)
+                        profile->weaponPurchase = mayPurchaseWeapon(memberId, connection);
+
+                    if (sections & ProfileAvatar)
+                        profile->avatar = "/api/member/" + std::to_string(memberId.operator v_uint32()) + "/assets/profilepicture";
+
+                    OATPP_LOGI(primus::constants::apicontroller::member_endpoint::logName, "Processed request to get the profile of member with id %d", memberId.operator v_uint32());
+
+                    return createDtoResponse(Status::CODE_200, profile);
                 }
                 // Endpoint Infos
 
@@ -804,6 +1364,8 @@ namespace primus {
                     info->pathParams["attribute"].description = "Attribute to filter members (options: all, active, inactive, birthday)";
                     info->queryParams["limit"].description = "Maximum number of items to return";
                     info->queryParams["offset"].description = "Number of items to skip before starting to collect the response items";
+                    info->queryParams["fields"].description = "Comma separated member fields to return, e.g. id,firstName,lastName. Fields not named, and named fields which are null, are left out. All fields if omitted";
+                    info->queryParams["fields"].required = false;
                     info->addResponse<oatpp::Object<PageDto<oatpp::Vector<oatpp::Object<MemberDto>>>>>(Status::CODE_200, "application/json");
                     info->addResponse<Object<StatusDto>>(Status::CODE_404, "application/json");
                     info->addResponse<Object<StatusDto>>(Status::CODE_500, "application/json");
@@ -836,12 +1398,14 @@ namespace primus {
                 ENDPOINT_INFO(getMemberById) {
                     info->name = "getMemberById";
                     info->summary = "Get a member by ID";
-                    info->description = "This endpoint retrieves a member with the provided ID.";
+                    info->description = "This endpoint retrieves a member with the provided ID. The ETag header carries the version of the member; sent back as If-None-Match, the member is only sent if it changed since.";
                     info->path = "/api/member/{id}";
                     info->method = "GET";
                     info->addTag("Member");
                     info->pathParams["id"].description = "Identifier of the member to retrieve";
+                    info->headers.add<String>("If-None-Match").required = false;
                     info->addResponse<oatpp::Vector<oatpp::Object<MemberDto>>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_304, "text/plain");
                     info->addResponse<Object<StatusDto>>(Status::CODE_404, "application/json");
                     info->addResponse<Object<StatusDto>>(Status::CODE_500, "application/json");
                 }
@@ -864,12 +1428,15 @@ namespace primus {
                 {
                     info->name = "updateMember";
                     info->summary = "Update an existing member";
-                    info->description = "This endpoint updates an existing member with the provided data.";
+                    info->description = "This endpoint updates an existing member with the provided data. With If-Match set to the ETag of GET /api/member/{id}, the member is only updated if it was not changed since it was read.";
                     info->path = "/api/member";
                     info->method = "PUT";
                     info->addTag("Member");
                     info->bodyContentType = "application/json";
+                    info->headers.add<String>("If-Match").required = false;
                     info->addResponse<oatpp::Object<MemberDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<Object<StatusDto>>(Status::CODE_404, "application/json");
+                    info->addResponse<Object<StatusDto>>(Status::CODE_412, "application/json");
                     info->addResponse<Object<StatusDto>>(Status::CODE_500, "application/json");
                 }
 
@@ -924,7 +1491,7 @@ namespace primus {
                 {
                     info->name = "createMemberAddressAssociation";
                     info->summary = "Create association between member and address";
-                    info->description = "This endpoint creates an association between a member and an address.";
+                    info->description = "This endpoint creates an association between a member and an address. An address which exists already (ignoring case and whitespace) is reused and answered with 200, a new one with 201.";
                     info->path = "/api/member/{memberId}/address/add";
                     info->method = "POST";
                     info->addTag("Member");
@@ -947,6 +1514,7 @@ namespace primus {
                     info->pathParams["memberId"].description = "ID of the member";
                     info->pathParams["addressId"].description = "ID of the address";
                     info->addResponse<Object<StatusDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<Object<StatusDto>>(Status::CODE_404, "application/json");
                     info->addResponse<Object<StatusDto>>(Status::CODE_500, "application/json");
                 }
 
@@ -963,6 +1531,7 @@ namespace primus {
                     info->pathParams["dateOfAttendance"].description = "Date of the attendance (format: YYYY-MM-DD)";
                     info->addResponse<Object<StatusDto>>(Status::CODE_200, "application/json");
                     info->addResponse<Object<StatusDto>>(Status::CODE_404, "application/json");
+                    info->addResponse<String>(Status::CODE_409, "text/plain");
                     info->addResponse<Object<StatusDto>>(Status::CODE_500, "application/json");
                 }
 
@@ -979,6 +1548,27 @@ namespace primus {
                     info->pathParams["dateOfAttendance"].description = "Date of the attendance (format: YYYY-MM-DD)";
                     info->addResponse<Object<StatusDto>>(Status::CODE_200, "application/json");
                     info->addResponse<Object<StatusDto>>(Status::CODE_404, "application/json");
+                    info->addResponse<String>(Status::CODE_409, "text/plain");
+                    info->addResponse<Object<StatusDto>>(Status::CODE_500, "application/json");
+                }
+
+                ENDPOINT_INFO(getMemberAttendanceHistory)
+                {
+                    info->name = "getMemberAttendanceHistory";
+                    info->summary = "Get the attendances of a member within a range of years, archived years included";
+                    info->description = "This endpoint lists the attendances of a member from the first day of fromYear to the last day of toYear, newest first. Closed years are read from their archive files, at most 10 archived years per request.";
+                    info->path = "/api/member/{memberId}/attendance/history/{fromYear}/{toYear}";
+                    info->method = "GET";
+                    info->addTag("Member");
+                    info->addTag("Attendance");
+                    info->pathParams["memberId"].description = "ID of the member";
+                    info->pathParams["fromYear"].description = "First year of the range";
+                    info->pathParams["toYear"].description = "Last year of the range";
+                    info->queryParams["limit"].description = "Limit of items to retrieve";
+                    info->queryParams["offset"].description = "Offset for pagination";
+                    info->addResponse<Object<PageDto<oatpp::Object<DateDto>>>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_400, "text/plain");
+                    info->addResponse<Object<StatusDto>>(Status::CODE_404, "application/json");
                     info->addResponse<Object<StatusDto>>(Status::CODE_500, "application/json");
                 }
 
@@ -986,7 +1576,7 @@ namespace primus {
                 {
                     info->name = "getMemberFee";
                     info->summary = "Calculate the member fee for a member";
-                    info->description = "This endpoint calculates the membership fee for a member based on their department.";
+                    info->description = "This endpoint calculates the membership fee for a member based on their departments and the Pricing table.";
                     info->path = "/api/member/{memberId}/fee";
                     info->method = "GET";
                     info->addTag("Member");
@@ -1032,6 +1622,22 @@ namespace primus {
                     info->addResponse<Object<StatusDto>>(Status::CODE_500, "application/json");
                 }
 
+                ENDPOINT_INFO(getMemberProfile)
+                {
+                    info->name = "getMemberProfile";
+                    info->summary = "Get everything the profile page shows of a member";
+                    info->description = "This endpoint returns the member, its addresses, departments, latest attendances, fee, weapon purchase eligibility and the path of its profile picture in one response. The queries run on a single database connection after a single existence check.";
+                    info->path = "/api/member/{memberId}/profile";
+                    info->method = "GET";
+                    info->addTag("Member");
+                    info->pathParams["memberId"].description = "ID of the member";
+                    info->queryParams["include"].description = "Comma separated sections to return (member, addresses, departments, attendances, fee, weaponpurchase, avatar), all of them if omitted";
+                    info->queryParams["include"].required = false;
+                    info->addResponse<Object<MemberProfileDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_400, "text/plain");
+                    info->addResponse<String>(Status::CODE_404, "text/plain");
+                    info->addResponse<String>(Status::CODE_500, "text/plain");
+                }
 
             };
 
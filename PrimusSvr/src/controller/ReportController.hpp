@@ -0,0 +1,208 @@
+#ifndef REPORTCONTROLLER_HPP
+#define REPORTCONTROLLER_HPP
+
+#include <string>
+
+#include "oatpp/web/server/api/ApiController.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/core/macro/component.hpp"
+#include "database/AttendanceArchive.hpp"
+#include "database/ReferenceData.hpp"
+#include "database/ReportingDatabase.hpp"
+#include "dto/ReportDtos.hpp"
+#include "dto/StatusDto.hpp"
+#include "general/constants.hpp"
+#include "tenant/TenantRegistry.hpp"
+
+namespace primus {
+    namespace apicontroller {
+        namespace report_endpoint {
+
+#include OATPP_CODEGEN_BEGIN(ApiController) // Begin API Controller codegen
+
+            //  ____                       _    ____            _             _ _
+            // |  _ \ ___ _ __   ___  _ __| |_ / ___|___  _ __ | |_ _ __ ___ | | | ___ _ __
+            // | |_) / _ \ '_ \ / _ \| '__| __| |   / _ \| '_ \| __| '__/ _ \| | |/ _ \ '__|
+            // |  _ <  __/ |_) | (_) | |  | |_| |__| (_) | | | | |_| | | (_) | | |  __/ |
+            // |_| \_\___| .__/ \___/|_|   \__|\____\___/|_| |_|\__|_|  \___/|_|_|\___|_|
+            //           |_|
+            /**
+             * @brief Analytics endpoints, served from the reporting snapshot instead of the live database.
+             *
+             * Every response carries the age of the snapshot in its body and in the X-Data-Age header (seconds),
+             * changes younger than that are not part of the report.
+             */
+            class ReportController : public oatpp::web::server::api::ApiController
+            {
+                typedef primus::dto::report::AttendanceRowDto AttendanceRowDto;
+                typedef primus::dto::report::FeeRowDto FeeRowDto;
+                typedef primus::dto::report::WeaponPurchaseRowDto WeaponPurchaseRowDto;
+                typedef primus::dto::report::ReportDto<oatpp::Object<AttendanceRowDto>> AttendanceReportDto;
+                typedef primus::dto::report::ReportDto<oatpp::Object<FeeRowDto>> FeeReportDto;
+                typedef primus::dto::report::ReportDto<oatpp::Object<WeaponPurchaseRowDto>> WeaponPurchaseReportDto;
+                typedef primus::dto::StatusDto StatusDto;
+
+            private:
+                OATPP_COMPONENT(std::shared_ptr<primus::database::ReportingDatabase>, m_reporting);
+                OATPP_COMPONENT(std::shared_ptr<primus::database::AttendanceArchive>, m_archive);
+                OATPP_COMPONENT(std::shared_ptr<primus::component::ReferenceDataStore>, m_referenceData);
+
+                /**
+                 * The current reporting snapshot. It is taken of the default database only, a tenant gets no reports.
+                 */
+                std::shared_ptr<primus::database::ReportingSnapshot> acquireSnapshot()
+                {
+                    OATPP_ASSERT_HTTP(!primus::tenant::CurrentTenant::get(), Status::CODE_501, "Reports are not available in multi-tenant mode");
+                    return m_reporting->acquire();
+                }
+
+                /**
+                 * Fills in the snapshot of a report and answers with it
+                 */
+                template<class Report, class Items>
+                std::shared_ptr<OutgoingResponse> createReportResponse(const std::shared_ptr<primus::database::ReportingSnapshot>& snapshot, const Items& items)
+                {
+                    auto report = Report::createShared();
+                    report->generation = snapshot->getGeneration();
+                    report->snapshotCreated = snapshot->getCreated();
+                    report->dataAgeSeconds = snapshot->getAge();
+                    report->count = static_cast<v_uint32>(items->size());
+                    report->items = items;
+
+                    auto response = createDtoResponse(Status::CODE_200, report);
+                    response->putHeader("X-Data-Age", std::to_string(snapshot->getAge()));
+                    return response;
+                }
+
+            public:
+                ReportController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
+                    : oatpp::web::server::api::ApiController(objectMapper)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::report_endpoint::logName, "ReportController (oatpp::web::server::api::ApiController) initialized");
+
+                }
+
+                static std::shared_ptr<ReportController> createShared(
+                    OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper)
+                )
+                {
+                    return std::make_shared<ReportController>(objectMapper);
+                }
+
+                ENDPOINT("GET", "/api/reports/attendance/{year}", getAttendanceReport,
+                    PATH(oatpp::UInt32, year))
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::report_endpoint::logName, "Received request for the attendance report of %d", year.operator v_uint32());
+
+                    OATPP_ASSERT_HTTP(year >= 1900 && year <= 9999, Status::CODE_400, "Invalid year");
+
+                    auto snapshot = acquireSnapshot();
+
+                    /* A closed year is no longer in the snapshot, it is read from its archive */
+                    std::shared_ptr<primus::component::AttendanceHistoryClient> history;
+                    std::shared_ptr<oatpp::orm::QueryResult> dbResult;
+                    if (m_archive->isArchived(static_cast<v_int32>(*year)))
+                    {
+                        history = m_archive->openHistory(static_cast<v_int32>(*year), static_cast<v_int32>(*year));
+                        dbResult = history->getArchivedAttendanceReport(std::to_string(*year));
+                    }
+                    else
+                        dbResult = snapshot->getClient()->getAttendanceReport(std::to_string(*year));
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+
+                    auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<AttendanceRowDto>>>();
+
+                    OATPP_LOGI(primus::constants::apicontroller::report_endpoint::logName, "Processed request for the attendance report of %d: %d members, data is %ld s old",
+                        year.operator v_uint32(), static_cast<v_int32>(items->size()), static_cast<long>(snapshot->getAge()));
+
+                    return createReportResponse<AttendanceReportDto>(snapshot, items);
+
+                }
+
+                ENDPOINT("GET", "/api/reports/fees", getFeeRunReport)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::report_endpoint::logName, "Received request for the fee run");
+
+                    auto snapshot = acquireSnapshot();
+                    auto dbResult = snapshot->getClient()->getFeeRunReport();
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+
+                    /* Same pricing as getMemberFee of the MemberController, one snapshot for the whole run */
+                    auto referenceData = m_referenceData->get();
+                    auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<FeeRowDto>>>();
+                    for (auto& row : *items)
+                        row->fee = referenceData->calculateFee(row->departmentCount ? *row->departmentCount : 0, row->departmentId ? *row->departmentId : 0);
+
+                    OATPP_LOGI(primus::constants::apicontroller::report_endpoint::logName, "Processed request for the fee run: %d members, data is %ld s old",
+                        static_cast<v_int32>(items->size()), static_cast<long>(snapshot->getAge()));
+
+                    return createReportResponse<FeeReportDto>(snapshot, items);
+
+                }
+
+                ENDPOINT("GET", "/api/reports/weaponpurchase", getWeaponPurchaseReport)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::report_endpoint::logName, "Received request for the weapon purchase eligibility list");
+
+                    auto snapshot = acquireSnapshot();
+                    auto dbResult = snapshot->getClient()->getWeaponPurchaseReport();
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+
+                    auto items = dbResult->fetch<oatpp::Vector<oatpp::Object<WeaponPurchaseRowDto>>>();
+                    for (auto& row : *items)
+                        row->eligible = (row->attendances && *row->attendances >= 18) || (row->months && *row->months == 12);
+
+                    OATPP_LOGI(primus::constants::apicontroller::report_endpoint::logName, "Processed request for the weapon purchase eligibility list: %d members, data is %ld s old",
+                        static_cast<v_int32>(items->size()), static_cast<long>(snapshot->getAge()));
+
+                    return createReportResponse<WeaponPurchaseReportDto>(snapshot, items);
+
+                }
+
+                ENDPOINT_INFO(getAttendanceReport) {
+                    info->name = "getAttendanceReport";
+                    info->summary = "Attendance of every member within a year";
+                    info->description = "This endpoint counts the attended sessions and months of every member within the given year. It reads from the reporting snapshot, X-Data-Age states its age in seconds.";
+                    info->path = "/api/reports/attendance/{year}";
+                    info->method = "GET";
+                    info->addTag("Reports");
+                    info->pathParams["year"].description = "Calendar year, e.g. 2024";
+                    info->addResponse<Object<AttendanceReportDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_400, "text/plain");
+                    info->addResponse<String>(Status::CODE_503, "text/plain");
+                }
+
+                ENDPOINT_INFO(getFeeRunReport) {
+                    info->name = "getFeeRunReport";
+                    info->summary = "Membership fee of every active member";
+                    info->description = "This endpoint calculates the membership fee of every active member from their departments. It reads from the reporting snapshot, X-Data-Age states its age in seconds.";
+                    info->path = "/api/reports/fees";
+                    info->method = "GET";
+                    info->addTag("Reports");
+                    info->addResponse<Object<FeeReportDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_503, "text/plain");
+                }
+
+                ENDPOINT_INFO(getWeaponPurchaseReport) {
+                    info->name = "getWeaponPurchaseReport";
+                    info->summary = "Weapon purchase eligibility of every active member";
+                    info->description = "This endpoint checks for every active member whether they attended 18 sessions or at least one session per month within the last year. It reads from the reporting snapshot, X-Data-Age states its age in seconds.";
+                    info->path = "/api/reports/weaponpurchase";
+                    info->method = "GET";
+                    info->addTag("Reports");
+                    info->addResponse<Object<WeaponPurchaseReportDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_503, "text/plain");
+                }
+            };
+
+#include OATPP_CODEGEN_END(ApiController) // End API Controller codegen
+
+        } // namespace report_endpoint
+    } // namespace apicontroller
+} // namespace primus
+
+#endif // REPORTCONTROLLER_HPP
@@ -8,6 +8,8 @@
 #include <chrono>
 
 #include "general/constants.hpp"
+#include "general/errors.hpp"
+#include "tenant/TenantRegistry.hpp"
 
 namespace primus {
     namespace apicontroller {
@@ -21,6 +23,9 @@ namespace primus {
             // |____/ \__\__,_|\__|_|\___|\____\___/|_| |_|\__|_|  \___/|_|_|\___|_|   
             class StaticController : public oatpp::web::server::api::ApiController
             {
+            private:
+                OATPP_COMPONENT(std::shared_ptr<primus::error::ErrorResponses>, m_errors);
+
             public:
                 StaticController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
                     : oatpp::web::server::api::ApiController(objectMapper)
@@ -74,16 +79,8 @@ namespace primus {
                     {
                         OATPP_LOGI(primus::constants::apicontroller::static_endpoint::logName, "File at %s was not found", filePath.c_str());
 
-                        auto status = primus::dto::StatusDto::createShared();
-
-                        std::string verboseMessage = "File at \"";
-                        verboseMessage.append(filePath.c_str());
-                        verboseMessage.append("\" could not be found");
-
-                        status->code = 404;
-                        status->message = verboseMessage;
-                        status->status = "NOT FOUND";
-                        return createDtoResponse(Status::CODE_404, status);
+                        /* The path is logged, not sent: broken links and scanners get the same serialized answer */
+                        return m_errors->createResponse(primus::error::Error::FileNotFound);
                     }
                 }
 
@@ -119,9 +116,9 @@ namespace primus {
                         choice = millis % 2;
                     }
 
-                    auto userStatus = primus::assert::assertMemberExists(oatpp::utils::conversion::strToUInt32(memberId->c_str()));
+                    auto userError = primus::assert::assertMemberExists(oatpp::utils::conversion::strToUInt32(memberId->c_str()));
 
-                    if (userStatus->code != 200)
+                    if (userError != primus::error::Error::None)
                     {
                         OATPP_LOGI(primus::constants::apicontroller::static_endpoint::logName, "User does not exist. Returning default profile picture");
 
@@ -131,6 +128,8 @@ namespace primus {
                     else
                     {
                         OATPP_LOGI(primus::constants::apicontroller::static_endpoint::logName, "User found. Looking for profile picture within directory");
+                        /* Every club keeps its own pictures, the default avatars are shared */
+                        filePath = primus::tenant::CurrentTenant::getAssetsDirectory(USER_ASSETS) + "/";
                         filePath.append(memberId);
                         filePath.append(".jpg");
                     }
@@ -157,17 +156,7 @@ namespace primus {
                         {
                             OATPP_LOGE(primus::constants::apicontroller::static_endpoint::logName, "Default profile picture not found at %s", filePath2.c_str());
 
-                            auto status = primus::dto::StatusDto::createShared();
-
-                            oatpp::String verboseMessage = "No picture to serve. Looked at given paths: ";
-                            verboseMessage->append(filePath);
-                            verboseMessage->append("   |   ");
-                            verboseMessage->append(filePath2);
-
-                            status->code = 404;
-                            status->message = verboseMessage;
-                            status->status = "NOT FOUND";
-                            return createDtoResponse(Status::CODE_404, status);
+                            return m_errors->createResponse(primus::error::Error::PictureNotFound);
                         }
                         content << file2.rdbuf();
                     }
@@ -0,0 +1,226 @@
+#ifndef SYNCCONTROLLER_HPP
+#define SYNCCONTROLLER_HPP
+
+#include <string>
+
+#include "oatpp/web/server/api/ApiController.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/core/macro/component.hpp"
+#include "database/DatabaseClient.hpp"
+#include "dto/Int32Dto.hpp"
+#include "dto/SyncDto.hpp"
+#include "general/constants.hpp"
+#include "tenant/TenantRegistry.hpp"
+
+namespace primus {
+    namespace apicontroller {
+        namespace sync_endpoint {
+
+#include OATPP_CODEGEN_BEGIN(ApiController) // Begin API Controller codegen
+
+            //  ____                    ____            _             _ _
+            // / ___| _   _ _ __   ___ / ___|___  _ __ | |_ _ __ ___ | | | ___ _ __
+            // \___ \| | | | '_ \ / __| |   / _ \| '_ \| __| '__/ _ \| | |/ _ \ '__|
+            //  ___) | |_| | | | | (__| |__| (_) | | | | |_| | | (_) | | |  __/ |
+            // |____/ \__, |_| |_|\___|\____\___/|_| |_|\__|_|  \___/|_|_|\___|_|
+            //        |___/
+            /**
+             * @brief Delta sync of the members and their department and address memberships, for clients keeping
+             * a local copy such as the check-in kiosk.
+             *
+             * Every write to Member, Department_Member and Address_Member stamps the row with the next number of
+             * the change sequence (see 005_change_log.sql). A client bootstraps from a snapshot and then asks for
+             * the changes after the sequence number it got, which costs as many rows as changed since. The
+             * sequence number is read before the rows, so a row may arrive once more with the next sync; applying
+             * a sync is idempotent.
+             */
+            class SyncController : public oatpp::web::server::api::ApiController
+            {
+                typedef primus::dto::database::AddressMembershipDto AddressMembershipDto;
+                typedef primus::dto::database::ChangeLogEntryDto ChangeLogEntryDto;
+                typedef primus::dto::database::DepartmentMembershipDto DepartmentMembershipDto;
+                typedef primus::dto::database::MemberDto MemberDto;
+                typedef primus::dto::SyncDto SyncDto;
+                typedef primus::dto::UInt32Dto UInt32Dto;
+
+                /* Entities of the ChangeLog table */
+                enum Entity : v_uint32
+                {
+                    EntityMember        = 1,
+                    EntityDepartment    = 2,
+                    EntityAddress       = 3
+                };
+
+            private:
+                OATPP_COMPONENT(std::shared_ptr<primus::component::DatabaseClient>, m_database);
+
+                /**
+                 * The database of the current tenant, the default database without one
+                 */
+                const std::shared_ptr<primus::component::DatabaseClient>& database() const
+                {
+                    const auto& tenant = primus::tenant::CurrentTenant::get();
+                    return tenant ? tenant->getDatabase() : m_database;
+                }
+
+                /**
+                 * Fills in every member and membership
+                 */
+                void fillSnapshot(const oatpp::Object<SyncDto>& sync)
+                {
+                    sync->snapshot = true;
+
+                    auto dbResult = database()->getSyncMembers();
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    sync->members = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
+
+                    dbResult = database()->getDepartmentMemberships();
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    sync->departments = dbResult->fetch<oatpp::Vector<oatpp::Object<DepartmentMembershipDto>>>();
+
+                    dbResult = database()->getAddressMemberships();
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    sync->addresses = dbResult->fetch<oatpp::Vector<oatpp::Object<AddressMembershipDto>>>();
+
+                    sync->removedMembers = oatpp::Vector<oatpp::UInt32>::createShared();
+                    sync->removedDepartments = oatpp::Vector<oatpp::Object<DepartmentMembershipDto>>::createShared();
+                    sync->removedAddresses = oatpp::Vector<oatpp::Object<AddressMembershipDto>>::createShared();
+                }
+
+                /**
+                 * Fills in the changes after the sequence number since, up to the sequence number of the sync
+                 */
+                void fillDelta(const oatpp::Object<SyncDto>& sync, v_uint32 since)
+                {
+                    sync->snapshot = false;
+                    sync->members = oatpp::Vector<oatpp::Object<MemberDto>>::createShared();
+                    sync->removedMembers = oatpp::Vector<oatpp::UInt32>::createShared();
+                    sync->departments = oatpp::Vector<oatpp::Object<DepartmentMembershipDto>>::createShared();
+                    sync->removedDepartments = oatpp::Vector<oatpp::Object<DepartmentMembershipDto>>::createShared();
+                    sync->addresses = oatpp::Vector<oatpp::Object<AddressMembershipDto>>::createShared();
+                    sync->removedAddresses = oatpp::Vector<oatpp::Object<AddressMembershipDto>>::createShared();
+
+                    /* Nothing changed, the common case of a polling kiosk */
+                    if (since == sync->sequence.operator v_uint32())
+                        return;
+
+                    auto dbResult = database()->getChangedMembers(since);
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    sync->members = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
+
+                    dbResult = database()->getChangeLogEntries(since);
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    auto entries = dbResult->fetch<oatpp::Vector<oatpp::Object<ChangeLogEntryDto>>>();
+
+                    for (const auto& entry : *entries)
+                    {
+                        bool deleted = entry->deleted != nullptr && static_cast<bool>(entry->deleted);
+                        switch (entry->entity.operator v_uint32())
+                        {
+                        case EntityMember:
+                            sync->removedMembers->push_back(entry->memberId);
+                            break;
+                        case EntityDepartment:
+                        {
+                            auto membership = DepartmentMembershipDto::createShared();
+                            membership->memberId = entry->memberId;
+                            membership->departmentId = entry->relatedId;
+                            (deleted ? sync->removedDepartments : sync->departments)->push_back(membership);
+                            break;
+                        }
+                        case EntityAddress:
+                        {
+                            auto membership = AddressMembershipDto::createShared();
+                            membership->memberId = entry->memberId;
+                            membership->addressId = entry->relatedId;
+                            (deleted ? sync->removedAddresses : sync->addresses)->push_back(membership);
+                            break;
+                        }
+                        default:
+                            break;
+                        }
+                    }
+                }
+
+            public:
+                SyncController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
+                    : oatpp::web::server::api::ApiController(objectMapper)
+                {
+
+                    OATPP_LOGI(primus::constants::apicontroller::sync_endpoint::logName, "SyncController (oatpp::web::server::api::ApiController) initialized");
+
+                }
+
+                static std::shared_ptr<SyncController> createShared(
+                    OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper)
+                )
+                {
+                    return std::make_shared<SyncController>(objectMapper);
+                }
+
+                ENDPOINT("GET", "/api/sync", syncMembers,
+                    REQUEST(std::shared_ptr<IncomingRequest>, request))
+                {
+
+                    oatpp::String sinceParameter = request->getQueryParameter("since");
+                    bool hasSince = sinceParameter && !sinceParameter->empty();
+                    v_uint32 since = 0;
+                    if (hasSince)
+                    {
+                        bool success = false;
+                        since = oatpp::utils::conversion::strToUInt32(sinceParameter, success);
+                        OATPP_ASSERT_HTTP(success, Status::CODE_400, "since has to be a sequence number returned by an earlier sync");
+                    }
+
+                    /* Read before the rows: a change made meanwhile is sent again next time rather than missed */
+                    auto dbResult = database()->getChangeSequence();
+                    OATPP_ASSERT_HTTP(dbResult->isSuccess(), Status::CODE_500, dbResult->getErrorMessage());
+                    auto sequence = dbResult->fetch<oatpp::Vector<oatpp::Object<UInt32Dto>>>();
+                    OATPP_ASSERT_HTTP(sequence->size() == 1, Status::CODE_500, "Unknown error");
+
+                    auto sync = SyncDto::createShared();
+                    sync->sequence = sequence[0]->value;
+
+                    /* A sequence number ahead of the database, e.g. after a backup was restored, can not be continued */
+                    if (!hasSince || since > sync->sequence.operator v_uint32())
+                    {
+                        OATPP_LOGI(primus::constants::apicontroller::sync_endpoint::logName, "Received request to sync from %s, sending a snapshot at sequence number %d",
+                            hasSince ? sinceParameter->c_str() : "scratch", sync->sequence.operator v_uint32());
+                        fillSnapshot(sync);
+                    }
+                    else
+                    {
+                        fillDelta(sync, since);
+                        OATPP_LOGI(primus::constants::apicontroller::sync_endpoint::logName, "Processed request to sync from sequence number %d to %d. Members: %d, removed: %d, memberships: %d, removed: %d",
+                            since, sync->sequence.operator v_uint32(), static_cast<int>(sync->members->size()), static_cast<int>(sync->removedMembers->size()),
+                            static_cast<int>(sync->departments->size() + sync->addresses->size()), static_cast<int>(sync->removedDepartments->size() + sync->removedAddresses->size()));
+                    }
+
+                    return createDtoResponse(Status::CODE_200, sync);
+
+                }
+
+                // Endpoint Infos
+
+                ENDPOINT_INFO(syncMembers) {
+                    info->name = "syncMembers";
+                    info->summary = "Get the members and memberships changed since an earlier sync";
+                    info->description = "This endpoint returns every member and every department and address membership if called without ?since=, or only the rows created, changed or removed after the sequence number since. Keep the returned sequence number and pass it with the next sync. If snapshot is true, replace the local copy instead of applying the changes to it.";
+                    info->path = "/api/sync";
+                    info->method = "GET";
+                    info->addTag("Sync");
+                    info->queryParams["since"].description = "Sequence number returned by the last sync. A full snapshot if omitted";
+                    info->queryParams["since"].required = false;
+                    info->addResponse<Object<SyncDto>>(Status::CODE_200, "application/json");
+                    info->addResponse<String>(Status::CODE_400, "text/plain");
+                }
+            };
+
+#include OATPP_CODEGEN_END(ApiController) // End API Controller codegen
+
+        } // namespace sync_endpoint
+    } // namespace apicontroller
+} // namespace primus
+
+#endif // SYNCCONTROLLER_HPP
@@ -0,0 +1,303 @@
+#ifndef PRIMUS_ADDRESSDEDUPLICATOR_HPP
+#define PRIMUS_ADDRESSDEDUPLICATOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "oatpp/core/Types.hpp"
+
+#include "DatabaseClient.hpp"
+#include "cache/ResponseCache.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        //     _       _     _                   _  __
+        //    / \   __| | __| |_ __ ___  ___ ___| |/ /___ _   _
+        //   / _ \ / _` |/ _` | '__/ _ \/ __/ __| ' // _ \ | | |
+        //  / ___ \ (_| | (_| | | |  __/\__ \__ \ . \  __/ |_| |
+        // /_/   \_\__,_|\__,_|_|  \___||___/___/_|\_\___|\__, |
+        //                                                |___/
+        /**
+         * @brief The normalizedKey of an address, the column Address rows are deduplicated by.
+         *
+         * Every field is trimmed, runs of whitespace become a single space and letters are folded to lower case
+         * (ASCII and the Latin-1 letters of UTF-8, so "Hauptstraße" and "HAUPTSTRASSE" still differ, "Ä" and "ä"
+         * do not). The folded fields are hashed with 64 bit FNV-1a into 16 hex digits.
+         */
+        class AddressKey
+        {
+        private:
+            static const v_uint64 FNV_OFFSET = 14695981039346656037ULL;
+            static const v_uint64 FNV_PRIME  = 1099511628211ULL;
+
+            static bool isSpace(char c)
+            {
+                return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+            }
+
+            static v_uint64 hash(v_uint64 value, unsigned char c)
+            {
+                return (value ^ c) * FNV_PRIME;
+            }
+
+        public:
+            /**
+             * Folds a single field, see the class description
+             */
+            static std::string normalize(const oatpp::String& field)
+            {
+                std::string result;
+                if (field == nullptr)
+                    return result;
+
+                const std::string& text = *field;
+                result.reserve(text.size());
+
+                bool space = false;
+                for (std::size_t i = 0; i < text.size(); i++)
+                {
+                    unsigned char c = static_cast<unsigned char>(text[i]);
+
+                    if (isSpace(static_cast<char>(c)))
+                    {
+                        space = !result.empty();
+                        continue;
+                    }
+                    if (space)
+                    {
+                        result.push_back(' ');
+                        space = false;
+                    }
+
+                    if (c >= 'A' && c <= 'Z')
+                        c += 'a' - 'A';
+                    else if (c == 0xC3 && i + 1 < text.size())
+                    {
+                        /* U+00C0 to U+00DE without U+00D7 (multiplication sign): upper case Latin-1 letters */
+                        unsigned char next = static_cast<unsigned char>(text[i + 1]);
+                        if (next >= 0x80 && next <= 0x9E && next != 0x97)
+                            next += 0x20;
+                        result.push_back(static_cast<char>(c));
+                        result.push_back(static_cast<char>(next));
+                        i++;
+                        continue;
+                    }
+                    result.push_back(static_cast<char>(c));
+                }
+                return result;
+            }
+
+            /**
+             * The key of an address, written to Address.normalizedKey
+             */
+            static oatpp::String of(const oatpp::Object<primus::dto::database::AddressDto>& address)
+            {
+                std::string folded = normalize(address->street);
+                folded += '\x1f';
+                folded += address->houseNumber ? std::to_string(*address->houseNumber) : std::string();
+                folded += '\x1f';
+                folded += normalize(address->postalCode);
+                folded += '\x1f';
+                folded += normalize(address->city);
+                folded += '\x1f';
+                folded += normalize(address->country);
+
+                v_uint64 value = FNV_OFFSET;
+                for (char c : folded)
+                    value = hash(value, static_cast<unsigned char>(c));
+
+                char key[17];
+                std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(value));
+                return oatpp::String(key);
+            }
+        };
+
+        //     _       _     _                   ____           _             _ _           _
+        //    / \   __| | __| |_ __ ___  ___ ___|  _ \  ___  __| |_   _ _ __ | (_) ___ __ _| |_ ___  _ __
+        //   / _ \ / _` |/ _` | '__/ _ \/ __/ __| | | |/ _ \/ _` | | | | '_ \| | |/ __/ _` | __/ _ \| '__|
+        //  / ___ \ (_| | (_| | | |  __/\__ \__ \ |_| |  __/ (_| | |_| | |_) | | | (_| (_| | || (_) | |
+        // /_/   \_\__,_|\__,_|_|  \___||___/___/____/ \___|\__,_|\__,_| .__/|_|_|\___\__,_|\__\___/|_|
+        //                                                             |_|
+        /**
+         * @brief Gives the addresses written before the normalizedKey existed their key and merges duplicates.
+         *
+         * An address whose key is already taken is merged into the address holding it: its members move over
+         * and the row is deleted, one transaction per address. New addresses get their key from createAddress,
+         * so once every row has a key there is nothing left to do and a run returns right away.
+         */
+        class AddressDeduplicator
+        {
+        public:
+            typedef primus::dto::database::AddressDto AddressDto;
+
+            struct Result
+            {
+                v_uint32 keyed;     // Addresses which got their key
+                v_uint32 merged;    // Duplicates merged into an address with the same key
+                v_uint32 failed;    // Addresses left without a key, the next run tries again
+
+                Result() : keyed(0), merged(0), failed(0) {}
+            };
+
+        private:
+            std::shared_ptr<primus::component::DatabaseClient>  m_database;
+            std::shared_ptr<primus::cache::ResponseCache>       m_responseCache;
+            std::atomic<bool>                                   m_stopping;
+            std::thread                                         m_thread;
+
+        private:
+            bool merge(v_uint32 fromId, v_uint32 toId)
+            {
+                auto transaction = m_database->beginTransaction();
+
+                auto dbResult = m_database->moveAddressMembers(fromId, toId, transaction.getConnection());
+                if (dbResult->isSuccess())
+                    dbResult = m_database->deleteAddressMembers(fromId, transaction.getConnection());
+                if (dbResult->isSuccess())
+                    dbResult = m_database->deleteMergedAddress(fromId, transaction.getConnection());
+                if (dbResult->isSuccess())
+                    dbResult = transaction.commit();
+
+                if (!dbResult->isSuccess())
+                {
+                    OATPP_LOGE(primus::constants::database::address::logName, "Merging address %d into %d failed: %s", fromId, toId, dbResult->getErrorMessage()->c_str());
+                    return false;
+                }
+                return true;
+            }
+
+            /**
+             * Keys one address or merges it into the address already holding its key
+             */
+            void deduplicate(const oatpp::Object<AddressDto>& address, Result& result)
+            {
+                oatpp::String key = AddressKey::of(address);
+
+                /* A request may take the key between the lookup and the update, the second round merges then */
+                for (int round = 0; round < 2; round++)
+                {
+                    auto dbResult = m_database->getAddressByKey(key);
+                    if (!dbResult->isSuccess())
+                        break;
+                    auto holders = dbResult->fetch<oatpp::Vector<oatpp::Object<AddressDto>>>();
+
+                    if (holders->empty())
+                    {
+                        if (m_database->setAddressKey(address->id, key)->isSuccess())
+                        {
+                            result.keyed++;
+                            return;
+                        }
+                        continue;
+                    }
+
+                    if (merge(*address->id, *holders[0]->id))
+                    {
+                        OATPP_LOGI(primus::constants::database::address::logName, "Address %d merged into %d", *address->id, *holders[0]->id);
+                        result.merged++;
+                        return;
+                    }
+                    break;
+                }
+                result.failed++;
+            }
+
+        public:
+            /**
+             * @param responseCache Invalidated after merges in the scope of the default database, may be null for a
+             *                      database without cached responses
+             */
+            AddressDeduplicator(const std::shared_ptr<primus::component::DatabaseClient>& database,
+                                const std::shared_ptr<primus::cache::ResponseCache>& responseCache)
+                : m_database(database)
+                , m_responseCache(responseCache)
+                , m_stopping(false)
+            {}
+
+            AddressDeduplicator(const AddressDeduplicator&) = delete;
+            AddressDeduplicator& operator=(const AddressDeduplicator&) = delete;
+
+            ~AddressDeduplicator()
+            {
+                stop();
+            }
+
+            /**
+             * Keys and merges every address without a key, in batches with a pause in between so requests get
+             * the write lock
+             */
+            Result run()
+            {
+                Result result;
+                v_uint32 afterId = 0;
+
+                while (!m_stopping)
+                {
+                    auto dbResult = m_database->getAddressesWithoutKey(afterId, primus::constants::database::address::batchSize);
+                    if (!dbResult->isSuccess())
+                        throw std::runtime_error(std::string("[AddressDeduplicator::run()]: ") + dbResult->getErrorMessage()->c_str());
+                    auto addresses = dbResult->fetch<oatpp::Vector<oatpp::Object<AddressDto>>>();
+                    if (addresses->empty())
+                        break;
+
+                    v_uint32 merged = result.merged;
+                    for (auto& address : *addresses)
+                    {
+                        deduplicate(address, result);
+                        afterId = *address->id;
+                    }
+
+                    if (result.merged != merged && m_responseCache)
+                    {
+                        m_responseCache->invalidate(std::string(), primus::cache::Table::Address);
+                        m_responseCache->invalidate(std::string(), primus::cache::Table::AddressMember);
+                    }
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(primus::constants::database::address::batchPause));
+                }
+
+                if (result.keyed || result.merged || result.failed)
+                    OATPP_LOGI(primus::constants::database::address::logName, "Addresses keyed: %d, merged: %d, failed: %d", result.keyed, result.merged, result.failed);
+                return result;
+            }
+
+            /**
+             * Runs once on a thread of its own, the server keeps serving meanwhile
+             */
+            void start()
+            {
+                if (m_thread.joinable())
+                    return;
+
+                m_thread = std::thread([this] {
+                    try
+                    {
+                        run();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        OATPP_LOGE(primus::constants::database::address::logName, "Deduplicating the addresses failed: %s", e.what());
+                    }
+                });
+            }
+
+            void stop()
+            {
+                m_stopping = true;
+                if (m_thread.joinable())
+                    m_thread.join();
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_ADDRESSDEDUPLICATOR_HPP
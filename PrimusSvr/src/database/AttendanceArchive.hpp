@@ -0,0 +1,613 @@
+#ifndef PRIMUS_ATTENDANCEARCHIVE_HPP
+#define PRIMUS_ATTENDANCEARCHIVE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "oatpp-sqlite/orm.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include "AttendanceHistoryClient.hpp"
+#include "Executor.hpp"
+#include "QueryMonitor.hpp"
+#include "filesystemHelper.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        /**
+         * @brief Thrown if an archive run is requested while another one is still moving rows. Answered with 409.
+         */
+        class ArchiveInProgressError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            ArchiveInProgressError()
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_409, "An archive run is already in progress")
+            {}
+        };
+
+        /**
+         * Attaches a database file under the given schema name, the file name is bound and never quoted by hand
+         *
+         * @return The sqlite result code, SQLITE_DONE on success
+         *
+         */
+        inline int attachDatabase(sqlite3* handle, const std::string& file, const std::string& schema)
+        {
+            std::string sql = "ATTACH DATABASE ? AS " + schema + ";";
+
+            sqlite3_stmt* statement = nullptr;
+            int code = sqlite3_prepare_v2(handle, sql.c_str(), -1, &statement, nullptr);
+            if (code != SQLITE_OK)
+                return code;
+
+            sqlite3_bind_text(statement, 1, file.c_str(), -1, SQLITE_TRANSIENT);
+            code = sqlite3_step(statement);
+            sqlite3_finalize(statement);
+            return code;
+        }
+
+        //  _   _ _     _                    ____                            _   _             ____                 _     _
+        // | | | (_)___| |_ ___  _ __ _   _ / ___|___  _ __  _ __   ___  ___| |_(_) ___  _ __ |  _ \ _ __ _____   _(_) __| | ___ _ __
+        // | |_| | / __| __/ _ \| '__| | | | |   / _ \| '_ \| '_ \ / _ \/ __| __| |/ _ \| '_ \| |_) | '__/ _ \ \ / / |/ _` |/ _ \ '__|
+        // |  _  | \__ \ || (_) | |  | |_| | |__| (_) | | | | | | |  __/ (__| |_| | (_) | | | |  __/| | | (_) \ V /| | (_| |  __/ |
+        // |_| |_|_|___/\__\___/|_|   \__, |\____\___/|_| |_|_| |_|\___|\___|\__|_|\___/|_| |_|_|   |_|  \___/ \_/ |_|\__,_|\___|_|
+        //                            |___/
+        /**
+         * @brief Opens the database read-only with a set of archived years attached.
+         *
+         * Every connection gets the temporary view AttendanceHistory, the Attendance table united with the
+         * Attendance tables of the attached years. Rows which are still in the Attendance table while their
+         * year is being archived are taken from there only, so no attendance is counted twice. Without the hot
+         * years the view only unites the attached years, for reading more years than one connection can attach.
+         */
+        class HistoryConnectionProvider : public oatpp::provider::Provider<oatpp::sqlite::Connection>
+        {
+        private:
+            class ConnectionInvalidator : public oatpp::provider::Invalidator<oatpp::sqlite::Connection>
+            {
+            public:
+                void invalidate(const std::shared_ptr<oatpp::sqlite::Connection>& connection) override
+                {
+                    /* The connection closes its handle when the last reference is gone */
+                    (void) connection;
+                }
+            };
+
+            std::string                                         m_databaseFile;
+            std::vector<std::pair<v_int32, std::string>>        m_archives;
+            bool                                                m_includeHot;
+            std::shared_ptr<ConnectionInvalidator>              m_invalidator;
+
+            static void fail(sqlite3* handle, const std::string& message)
+            {
+                std::string error = handle ? sqlite3_errmsg(handle) : "out of memory";
+                sqlite3_close(handle);
+                throw std::runtime_error("[HistoryConnectionProvider::get()]: " + message + ": " + error);
+            }
+
+        public:
+            HistoryConnectionProvider(const std::string& databaseFile, const std::vector<std::pair<v_int32, std::string>>& archives, bool includeHot = true)
+                : m_databaseFile(databaseFile)
+                , m_archives(archives)
+                , m_includeHot(includeHot)
+                , m_invalidator(std::make_shared<ConnectionInvalidator>())
+            {}
+
+            oatpp::provider::ResourceHandle<oatpp::sqlite::Connection> get() override
+            {
+                sqlite3* handle = nullptr;
+                if (sqlite3_open_v2(m_databaseFile.c_str(), &handle, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+                    fail(handle, "Can't open " + m_databaseFile);
+
+                std::string view = m_includeHot ? "SELECT member_id, date FROM main.Attendance" : "";
+
+                for (const auto& archive : m_archives)
+                {
+                    /* Attached databases inherit the read-only flag of the connection */
+                    std::string schema = "y" + std::to_string(archive.first);
+                    if (attachDatabase(handle, archive.second, schema) != SQLITE_DONE)
+                        fail(handle, "Can't attach " + archive.second);
+
+                    view += std::string(view.empty() ? "" : " UNION ALL ") + "SELECT a.member_id, a.date FROM " + schema + ".Attendance AS a"
+                            " WHERE NOT EXISTS (SELECT 1 FROM main.Attendance AS m WHERE m.member_id = a.member_id AND m.date = a.date)";
+                }
+
+                if (sqlite3_exec(handle, ("CREATE TEMP VIEW AttendanceHistory AS " + view + ";").c_str(), nullptr, nullptr, nullptr) != SQLITE_OK)
+                    fail(handle, "Can't create the view AttendanceHistory");
+
+                return oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>(std::make_shared<oatpp::sqlite::ConnectionImpl>(handle), m_invalidator);
+            }
+
+            oatpp::async::CoroutineStarterForResult<const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>&> getAsync() override
+            {
+                throw std::runtime_error("[HistoryConnectionProvider::getAsync()]: Error. Not implemented!");
+            }
+
+            void stop() override
+            {}
+        };
+
+        //     _   _   _                 _                         _             _     _
+        //    / \ | |_| |_ ___ _ __   __| | __ _ _ __   ___ ___   / \   _ __ ___| |__ (_)_   _____
+        //   / _ \| __| __/ _ \ '_ \ / _` |/ _` | '_ \ / __/ _ \ / _ \ | '__/ __| '_ \| \ \ / / _ \
+        //  / ___ \ |_| ||  __/ | | | (_| | (_| | | | | (_|  __// ___ \| | | (__| | | | |\ V /  __/
+        // /_/   \_\__|\__\___|_| |_|\__,_|\__,_|_| |_|\___\___/_/   \_\_|  \___|_| |_|_| \_/ \___|
+        /**
+         * @brief Keeps the Attendance table small by moving closed years into one sqlite file per year.
+         *
+         * The Attendance table holds the current and the previous year, which is all the eligibility, list and
+         * count queries ever look at. Older years live in attendance-YYYY.sqlite and are only attached by the
+         * history queries which ask for them.
+         *
+         * Archiving runs while the server is serving. Rows are moved in small batches: a batch is first copied
+         * into the archive and committed there, then the rows found in the archive are deleted from the
+         * Attendance table. A run which is interrupted between the two steps leaves rows in both places, the
+         * next run skips the copies and finishes the deletes. Running it again is always safe.
+         */
+        class AttendanceArchive
+        {
+        public:
+            struct Configuration
+            {
+                std::string databaseFile;
+                std::string directory;
+                v_int32 hotYears;
+                v_uint32 batchSize;
+                std::chrono::milliseconds batchPause;
+                bool scheduled;
+                v_uint32 hour;
+
+                static Configuration fromEnvironment(const std::string& databaseFile, const std::string& directory)
+                {
+                    namespace defaults = primus::constants::database::archive;
+
+                    Configuration configuration;
+                    configuration.databaseFile = databaseFile;
+                    configuration.directory = primus::environment::getString("PRIMUS_ARCHIVE_DIRECTORY", directory);
+
+                    /* The weapon purchase rules look back one year, so the previous year always stays in the table */
+                    configuration.hotYears = static_cast<v_int32>(std::max<unsigned long>(2, primus::environment::getUInt("PRIMUS_ARCHIVE_HOT_YEARS", defaults::hotYears)));
+                    configuration.batchSize = static_cast<v_uint32>(std::max<unsigned long>(1, primus::environment::getUInt("PRIMUS_ARCHIVE_BATCH_SIZE", defaults::batchSize)));
+                    configuration.batchPause = std::chrono::milliseconds(primus::environment::getUInt("PRIMUS_ARCHIVE_BATCH_PAUSE_MS", defaults::batchPause));
+                    configuration.scheduled = primus::environment::getBool("PRIMUS_ARCHIVE_SCHEDULED", defaults::scheduled);
+                    configuration.hour = static_cast<v_uint32>(primus::environment::getUInt("PRIMUS_ARCHIVE_HOUR", defaults::hour) % 24);
+
+                    return configuration;
+                }
+            };
+
+            struct Year
+            {
+                v_int32 year;
+                std::string file;
+                v_uint64 bytes;
+            };
+
+            struct Result
+            {
+                std::vector<v_int32> years;
+                v_uint64 rows;
+                v_uint32 batches;
+                v_int64 durationMs;
+            };
+
+        private:
+            Configuration                   m_configuration;
+            std::shared_ptr<QueryMonitor>   m_monitor;
+            std::mutex                      m_runLock;
+            std::mutex                      m_scheduleLock;
+            std::condition_variable         m_scheduleCondition;
+            std::atomic<bool>               m_running;
+            std::thread                     m_scheduler;
+            std::atomic<v_int64>            m_lastRun;
+            std::atomic<bool>               m_hasArchives;   // Whether a read of all attendances has to reach into archives
+
+        private:
+            static std::string firstDayOf(v_int32 year)
+            {
+                char buffer[16];
+                std::snprintf(buffer, sizeof(buffer), "%04d-01-01", year);
+                return buffer;
+            }
+
+            static void execute(sqlite3* handle, const std::string& sql)
+            {
+                char* error = nullptr;
+                if (sqlite3_exec(handle, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK)
+                {
+                    std::string message = error ? error : sqlite3_errmsg(handle);
+                    sqlite3_free(error);
+                    throw std::runtime_error("[AttendanceArchive]: " + message);
+                }
+            }
+
+            /**
+             * Runs a statement with a range of dates and a row limit bound, returns the number of changed rows
+             */
+            static v_int32 executeBatch(sqlite3* handle, const char* sql, const std::string& from, const std::string& until, v_uint32 limit)
+            {
+                sqlite3_stmt* statement = nullptr;
+                if (sqlite3_prepare_v2(handle, sql, -1, &statement, nullptr) != SQLITE_OK)
+                    throw std::runtime_error(std::string("[AttendanceArchive]: ") + sqlite3_errmsg(handle));
+
+                sqlite3_bind_text(statement, 1, from.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(statement, 2, until.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_int64(statement, 3, limit);
+
+                int code = sqlite3_step(statement);
+                sqlite3_finalize(statement);
+                if (code != SQLITE_DONE)
+                    throw std::runtime_error(std::string("[AttendanceArchive]: ") + sqlite3_errmsg(handle));
+
+                return sqlite3_changes(handle);
+            }
+
+            /**
+             * Closed years which still have rows in the Attendance table, oldest first
+             */
+            std::vector<v_int32> findClosedYears(sqlite3* handle) const
+            {
+                std::vector<v_int32> years;
+                std::string sql = "SELECT DISTINCT strftime('%Y', date + 2440587.5) FROM main.Attendance "
+                                  "WHERE date < CAST(julianday('" + firstDayOf(getFirstHotYear()) + "') - 2440587.5 AS INTEGER) ORDER BY 1;";
+
+                sqlite3_stmt* statement = nullptr;
+                if (sqlite3_prepare_v2(handle, sql.c_str(), -1, &statement, nullptr) != SQLITE_OK)
+                    throw std::runtime_error(std::string("[AttendanceArchive]: ") + sqlite3_errmsg(handle));
+
+                while (sqlite3_step(statement) == SQLITE_ROW)
+                {
+                    const unsigned char* text = sqlite3_column_text(statement, 0);
+                    v_int32 year = text ? static_cast<v_int32>(std::atoi(reinterpret_cast<const char*>(text))) : 0;
+                    if (year > 0)
+                        years.push_back(year);
+                }
+                sqlite3_finalize(statement);
+                return years;
+            }
+
+            /**
+             * Moves the rows of one year batch by batch into its archive
+             */
+            v_uint64 moveYear(sqlite3* handle, v_int32 year, v_uint32& batches)
+            {
+                const std::string from = firstDayOf(year);
+                const std::string until = firstDayOf(year + 1);
+
+                if (attachDatabase(handle, getFile(year), "archive") != SQLITE_DONE)
+                    throw std::runtime_error("[AttendanceArchive]: Can't attach " + getFile(year) + ": " + sqlite3_errmsg(handle));
+
+                v_uint64 moved = 0;
+                try
+                {
+                    /* Without a rowid the archive is stored in primary key order, a member's year is a single range */
+                    execute(handle, "CREATE TABLE IF NOT EXISTS archive.Attendance ("
+                                    " member_id INTEGER NOT NULL, date INTEGER NOT NULL, PRIMARY KEY (member_id, date)) WITHOUT ROWID;");
+
+                    while (true)
+                    {
+                        /* Each statement commits on its own: the copy is durable in the archive before the delete */
+                        executeBatch(handle,
+                            "INSERT OR IGNORE INTO archive.Attendance (member_id, date) "
+                            " SELECT member_id, date FROM main.Attendance "
+                            " WHERE date >= CAST(julianday(?1) - 2440587.5 AS INTEGER) AND date < CAST(julianday(?2) - 2440587.5 AS INTEGER) LIMIT ?3;",
+                            from, until, m_configuration.batchSize);
+
+                        v_int32 deleted = executeBatch(handle,
+                            "DELETE FROM main.Attendance WHERE (member_id, date) IN ("
+                            " SELECT m.member_id, m.date FROM main.Attendance AS m "
+                            " JOIN archive.Attendance AS a ON a.member_id = m.member_id AND a.date = m.date "
+                            " WHERE m.date >= CAST(julianday(?1) - 2440587.5 AS INTEGER) AND m.date < CAST(julianday(?2) - 2440587.5 AS INTEGER) LIMIT ?3);",
+                            from, until, m_configuration.batchSize);
+
+                        batches++;
+                        moved += static_cast<v_uint64>(deleted);
+                        if (deleted == 0)
+                            break;
+
+                        std::this_thread::sleep_for(m_configuration.batchPause);
+                    }
+                }
+                catch (...)
+                {
+                    sqlite3_exec(handle, "DETACH DATABASE archive;", nullptr, nullptr, nullptr);
+                    throw;
+                }
+
+                execute(handle, "DETACH DATABASE archive;");
+                return moved;
+            }
+
+            /**
+             * Converts archives written before the day number migration (002_day_numbers.sql)
+             */
+            void upgradeArchives()
+            {
+                for (const Year& year : listYears())
+                {
+                    std::string file = m_configuration.directory + "/" + year.file;
+
+                    sqlite3* handle = nullptr;
+                    if (sqlite3_open_v2(file.c_str(), &handle, SQLITE_OPEN_READWRITE, nullptr) == SQLITE_OK)
+                    {
+                        if (sqlite3_exec(handle, "UPDATE Attendance SET date = CAST(julianday(date) - 2440587.5 AS INTEGER) WHERE typeof(date) = 'text';",
+                                         nullptr, nullptr, nullptr) != SQLITE_OK)
+                            OATPP_LOGE(primus::constants::database::archive::logName, "Can't convert the dates of %s: %s", file.c_str(), sqlite3_errmsg(handle));
+                        else if (sqlite3_changes(handle) > 0)
+                            OATPP_LOGI(primus::constants::database::archive::logName, "Converted %d dates of %s to day numbers", sqlite3_changes(handle), file.c_str());
+                    }
+                    sqlite3_close(handle);
+                }
+            }
+
+            void schedule()
+            {
+                std::unique_lock<std::mutex> guard(m_scheduleLock);
+
+                while (m_running)
+                {
+                    m_scheduleCondition.wait_for(guard, std::chrono::minutes(1));
+                    if (!m_running)
+                        break;
+
+                    std::time_t time = std::time(nullptr);
+                    std::tm local = primus::component::filesystem::localTime(time);
+
+                    /* Once a day, a new closed year only appears on the first of January */
+                    auto sinceLastRun = std::chrono::seconds(static_cast<v_int64>(time) - m_lastRun.load());
+                    if (static_cast<v_uint32>(local.tm_hour) != m_configuration.hour || sinceLastRun < std::chrono::hours(23))
+                        continue;
+
+                    guard.unlock();
+                    try
+                    {
+                        archiveClosedYears();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        OATPP_LOGE(primus::constants::database::archive::logName, "Scheduled archive run failed: %s", e.what());
+                    }
+                    guard.lock();
+                }
+            }
+
+        public:
+            AttendanceArchive(const Configuration& configuration, const std::shared_ptr<QueryMonitor>& monitor)
+                : m_configuration(configuration)
+                , m_monitor(monitor)
+                , m_running(false)
+                , m_lastRun(0)
+                , m_hasArchives(false)
+            {
+                primus::component::filesystem::makeDirectory(m_configuration.directory);
+                upgradeArchives();
+                m_hasArchives = !listYears().empty();
+            }
+
+            ~AttendanceArchive()
+            {
+                stop();
+            }
+
+            /**
+             * Starts the thread archiving closed years once a day, if enabled
+             */
+            void start()
+            {
+                if (!m_configuration.scheduled || m_running.exchange(true))
+                    return;
+
+                OATPP_LOGI(primus::constants::database::archive::logName, "Archiving years before %d daily at %02d:00 into %s",
+                    getFirstHotYear(), m_configuration.hour, m_configuration.directory.c_str());
+                m_scheduler = std::thread(&AttendanceArchive::schedule, this);
+            }
+
+            void stop()
+            {
+                if (!m_running.exchange(false))
+                    return;
+
+                m_scheduleCondition.notify_all();
+                if (m_scheduler.joinable())
+                    m_scheduler.join();
+            }
+
+            /**
+             * Oldest year kept in the Attendance table, every year before it is closed
+             */
+            v_int32 getFirstHotYear() const
+            {
+                std::tm local = primus::component::filesystem::localTime(std::time(nullptr));
+                return local.tm_year + 1900 - m_configuration.hotYears + 1;
+            }
+
+            std::string getFile(v_int32 year) const
+            {
+                return m_configuration.directory + "/" + primus::constants::database::archive::filePrefix + std::to_string(year) + primus::constants::database::archive::fileSuffix;
+            }
+
+            /**
+             * True if at least one year was archived, reads of all attendances then go through AttendanceHistory
+             */
+            bool hasArchivedYears() const
+            {
+                return m_hasArchives;
+            }
+
+            /**
+             * True if the year is closed and has an archive
+             */
+            bool isArchived(v_int32 year) const
+            {
+                return year < getFirstHotYear() && primus::component::filesystem::exists(getFile(year));
+            }
+
+            /**
+             * Moves every closed year out of the Attendance table. Resumes where an interrupted run stopped
+             *
+             * @throws ArchiveInProgressError if another run is moving rows
+             *
+             */
+            Result archiveClosedYears()
+            {
+                std::unique_lock<std::mutex> guard(m_runLock, std::try_to_lock);
+                if (!guard.owns_lock())
+                    throw ArchiveInProgressError();
+
+                auto started = std::chrono::steady_clock::now();
+
+                Result result;
+                result.rows = 0;
+                result.batches = 0;
+
+                sqlite3* handle = nullptr;
+                if (sqlite3_open_v2(m_configuration.databaseFile.c_str(), &handle, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK)
+                {
+                    std::string message = handle ? sqlite3_errmsg(handle) : "out of memory";
+                    sqlite3_close(handle);
+                    throw std::runtime_error("[AttendanceArchive::archiveClosedYears()]: Can't open database: " + message);
+                }
+
+                /* A batch waits for the writers of the server instead of failing */
+                sqlite3_busy_timeout(handle, static_cast<int>(primus::constants::database::query::busyTimeout));
+
+                try
+                {
+                    for (v_int32 year : findClosedYears(handle))
+                    {
+                        v_uint32 batches = 0;
+                        v_uint64 rows = moveYear(handle, year, batches);
+
+                        OATPP_LOGI(primus::constants::database::archive::logName, "Archived %lu attendances of %d in %d batches",
+                            static_cast<unsigned long>(rows), year, batches);
+
+                        result.years.push_back(year);
+                        result.rows += rows;
+                        result.batches += batches;
+                        m_hasArchives = true;
+                    }
+                }
+                catch (...)
+                {
+                    sqlite3_close(handle);
+                    throw;
+                }
+                sqlite3_close(handle);
+
+                result.durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+                m_lastRun = static_cast<v_int64>(std::time(nullptr));
+
+                return result;
+            }
+
+            /**
+             * All archived years, oldest first
+             */
+            std::vector<Year> listYears() const
+            {
+                std::vector<Year> years;
+                const std::string prefix = primus::constants::database::archive::filePrefix;
+                const std::string suffix = primus::constants::database::archive::fileSuffix;
+
+                for (const auto& name : primus::component::filesystem::listDirectory(m_configuration.directory))
+                {
+                    if (name.size() != prefix.size() + 4 + suffix.size()
+                        || name.compare(0, prefix.size(), prefix) != 0
+                        || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+                        continue;
+
+                    std::uint64_t bytes;
+                    std::int64_t modified;
+                    if (!primus::component::filesystem::fileStatus(m_configuration.directory + "/" + name, bytes, modified))
+                        continue;
+
+                    Year year;
+                    year.year = static_cast<v_int32>(std::atoi(name.c_str() + prefix.size()));
+                    year.file = name;
+                    year.bytes = static_cast<v_uint64>(bytes);
+                    years.push_back(year);
+                }
+
+                std::sort(years.begin(), years.end(), [](const Year& a, const Year& b) { return a.year < b.year; });
+                return years;
+            }
+
+            /**
+             * A client for the view AttendanceHistory, covering the Attendance table and the archived years of the range
+             *
+             * @throws HttpError 400 if the range spans more archived years than one connection can attach
+             *
+             */
+            std::shared_ptr<primus::component::AttendanceHistoryClient> openHistory(v_int32 fromYear, v_int32 toYear) const
+            {
+                std::vector<std::pair<v_int32, std::string>> archives;
+                for (const Year& year : listYears())
+                {
+                    if (year.year >= fromYear && year.year <= toYear)
+                        archives.push_back(std::make_pair(year.year, m_configuration.directory + "/" + year.file));
+                }
+
+                OATPP_ASSERT_HTTP(archives.size() <= primus::constants::database::archive::maxAttached, oatpp::web::protocol::http::Status::CODE_400,
+                    "The range spans too many archived years, at most 10 per request");
+
+                auto provider = std::make_shared<HistoryConnectionProvider>(m_configuration.databaseFile, archives);
+                return std::make_shared<primus::component::AttendanceHistoryClient>(std::make_shared<Executor>(provider, m_monitor));
+            }
+
+            /**
+             * Clients for the view AttendanceHistory covering every year, newest first. The first one covers the
+             * Attendance table and the newest archived years, every further one the next older archived years,
+             * as many as one connection can attach
+             */
+            std::vector<std::shared_ptr<primus::component::AttendanceHistoryClient>> openFullHistory() const
+            {
+                std::vector<std::shared_ptr<primus::component::AttendanceHistoryClient>> clients;
+                std::vector<Year> years = listYears();
+
+                std::vector<std::pair<v_int32, std::string>> archives;
+                for (auto year = years.rbegin(); year != years.rend(); year++)
+                {
+                    archives.push_back(std::make_pair(year->year, m_configuration.directory + "/" + year->file));
+
+                    if (archives.size() == primus::constants::database::archive::maxAttached || year + 1 == years.rend())
+                    {
+                        auto provider = std::make_shared<HistoryConnectionProvider>(m_configuration.databaseFile, archives, clients.empty());
+                        clients.push_back(std::make_shared<primus::component::AttendanceHistoryClient>(std::make_shared<Executor>(provider, m_monitor)));
+                        archives.clear();
+                    }
+                }
+
+                if (clients.empty())
+                {
+                    auto provider = std::make_shared<HistoryConnectionProvider>(m_configuration.databaseFile, archives);
+                    clients.push_back(std::make_shared<primus::component::AttendanceHistoryClient>(std::make_shared<Executor>(provider, m_monitor)));
+                }
+                return clients;
+            }
+
+            const Configuration& getConfiguration() const
+            {
+                return m_configuration;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_ATTENDANCEARCHIVE_HPP
@@ -0,0 +1,97 @@
+#ifndef ATTENDANCE_HISTORY_CLIENT
+#define ATTENDANCE_HISTORY_CLIENT
+
+#include "oatpp-sqlite/orm.hpp"
+#include "oatpp/orm/DbClient.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace component
+    {
+#include OATPP_CODEGEN_BEGIN(DbClient) //<- Begin Codegen
+        //     _   _   _                 _                      _   _ _     _                    ____ _ _            _
+        //    / \ | |_| |_ ___ _ __   __| | __ _ _ __   ___ ___| | | (_)___| |_ ___  _ __ _   _ / ___| (_) ___ _ __ | |_
+        //   / _ \| __| __/ _ \ '_ \ / _` |/ _` | '_ \ / __/ _ \ |_| | / __| __/ _ \| '__| | | | |   | | |/ _ \ '_ \| __|
+        //  / ___ \ |_| ||  __/ | | | (_| | (_| | | | | (_|  __/  _  | \__ \ || (_) | |  | |_| | |___| | |  __/ | | | |_
+        // /_/   \_\__|\__\___|_| |_|\__,_|\__,_|_| |_|\___\___|_| |_|_|___/\__\___/|_|   \__, |\____|_|_|\___|_| |_|\__|
+        //                                                                                |___/
+        /**
+         * @brief Client for attendance queries reaching into archived years.
+         *
+         * Runs on a connection of primus::database::AttendanceArchive which attaches the archived years of the
+         * request and unites them with the Attendance table in the temporary view AttendanceHistory.
+         */
+        class AttendanceHistoryClient : public oatpp::orm::DbClient
+        {
+        public:
+            AttendanceHistoryClient(const std::shared_ptr<oatpp::orm::Executor>& executor)
+                : oatpp::orm::DbClient(executor)
+            {}
+
+            /**
+            * Attendances of a member within a date range, newest first
+            *
+            * @param from First day of the range, "YYYY-MM-DD"
+            * @param until Day after the range, "YYYY-MM-DD"
+            *
+            */
+            QUERY(getAttendanceHistoryOfMember,
+                " SELECT date(AttendanceHistory.date + 2440587.5) AS date FROM AttendanceHistory "
+                " WHERE member_id = :member_id "
+                " AND AttendanceHistory.date >= CAST(julianday(:from) - 2440587.5 AS INTEGER) "
+                " AND AttendanceHistory.date < CAST(julianday(:until) - 2440587.5 AS INTEGER) "
+                " ORDER BY AttendanceHistory.date DESC "
+                " LIMIT :limit OFFSET :offset;",
+                PARAM(oatpp::UInt32, member_id),
+                PARAM(oatpp::String, from),
+                PARAM(oatpp::String, until),
+                PARAM(oatpp::UInt32, limit),
+                PARAM(oatpp::UInt32, offset));
+
+            /**
+            * Attendances of a member over every year the view covers, newest first
+            */
+            QUERY(getAllAttendancesOfMember,
+                " SELECT date(AttendanceHistory.date + 2440587.5) AS date FROM AttendanceHistory "
+                " WHERE member_id = :member_id "
+                " ORDER BY AttendanceHistory.date DESC "
+                " LIMIT :limit OFFSET :offset;",
+                PARAM(oatpp::UInt32, member_id),
+                PARAM(oatpp::UInt32, limit),
+                PARAM(oatpp::UInt32, offset));
+
+            /**
+            * Number of attendances of a member over every year the view covers
+            */
+            QUERY(getAttendanceCountOfMember,
+                " SELECT COUNT(*) AS value FROM AttendanceHistory WHERE member_id = :member_id;",
+                PARAM(oatpp::UInt32, member_id));
+
+            /**
+            * Same as getAttendanceReport of the ReportingClient, for a year which is archived
+            *
+            * @param year The year as four digits, e.g. "2004"
+            *
+            */
+            QUERY(getArchivedAttendanceReport,
+                " SELECT Member.id AS memberId, Member.firstName, Member.lastName, "
+                " COUNT(AttendanceHistory.date) AS attendances, "
+                " COUNT(DISTINCT strftime('%m', AttendanceHistory.date + 2440587.5)) AS months "
+                " FROM Member "
+                " LEFT JOIN AttendanceHistory ON AttendanceHistory.member_id = Member.id "
+                " AND AttendanceHistory.date >= CAST(julianday(:year || '-01-01') - 2440587.5 AS INTEGER) "
+                " AND AttendanceHistory.date < CAST(julianday(:year || '-01-01', '+1 year') - 2440587.5 AS INTEGER) "
+                " GROUP BY Member.id "
+                " ORDER BY Member.lastName, Member.firstName;",
+                PARAM(oatpp::String, year));
+        };
+
+#include OATPP_CODEGEN_END(DbClient) ///< End code-gen section
+
+    } // namespace component
+} // namespace primus
+
+#endif //ATTENDANCE_HISTORY_CLIENT
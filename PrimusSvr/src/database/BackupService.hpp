@@ -0,0 +1,395 @@
+#ifndef PRIMUS_BACKUPSERVICE_HPP
+#define PRIMUS_BACKUPSERVICE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "oatpp-sqlite/orm.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include "filesystemHelper.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        /**
+         * @brief Thrown if a backup is requested while another one is still running. Answered with 409.
+         */
+        class BackupInProgressError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            BackupInProgressError()
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_409, "A backup is already running")
+            {}
+        };
+
+        //  ____             _                ____                  _
+        // | __ )  __ _  ___| | ___   _ _ __ / ___|  ___ _ ____   _(_) ___ ___
+        // |  _ \ / _` |/ __| |/ / | | | '_ \\___ \ / _ \ '__\ \ / / |/ __/ _ \
+        // | |_) | (_| | (__|   <| |_| | |_) |___) |  __/ |   \ V /| | (_|  __/
+        // |____/ \__,_|\___|_|\_\\__,_| .__/|____/ \___|_|    \_/ |_|\___\___|
+        //                             |_|
+        /**
+         * @brief Online backups of the database with the sqlite backup API.
+         *
+         * A backup copies a bounded number of pages per step and sleeps between steps, so writers only wait for
+         * the lock of a single step. Snapshots are written to a temporary file and renamed once complete, a
+         * half written snapshot therefore never carries the final name. Only the newest snapshots are kept.
+         *
+         * Scheduled backups run once per interval at a configured hour of the day, outside of the training
+         * sessions in the evening.
+         */
+        class BackupService
+        {
+        public:
+            struct Configuration
+            {
+                std::string databaseFile;
+                std::string directory;
+                int pagesPerStep;
+                std::chrono::milliseconds stepPause;
+                v_uint32 keep;
+                bool scheduled;
+                v_uint32 hour;
+                std::chrono::hours interval;
+
+                static Configuration fromEnvironment(const std::string& databaseFile, const std::string& directory)
+                {
+                    namespace defaults = primus::constants::database::backup;
+
+                    Configuration configuration;
+                    configuration.databaseFile = databaseFile;
+                    configuration.directory = primus::environment::getString("PRIMUS_BACKUP_DIRECTORY", directory);
+                    configuration.pagesPerStep = static_cast<int>(primus::environment::getUInt("PRIMUS_BACKUP_PAGES_PER_STEP", defaults::pagesPerStep));
+                    configuration.stepPause = std::chrono::milliseconds(primus::environment::getUInt("PRIMUS_BACKUP_STEP_PAUSE_MS", defaults::stepPause));
+                    configuration.keep = static_cast<v_uint32>(primus::environment::getUInt("PRIMUS_BACKUP_KEEP", defaults::keep));
+                    configuration.scheduled = primus::environment::getBool("PRIMUS_BACKUP_SCHEDULED", defaults::scheduled);
+                    configuration.hour = static_cast<v_uint32>(primus::environment::getUInt("PRIMUS_BACKUP_HOUR", defaults::hour) % 24);
+                    configuration.interval = std::chrono::hours(std::max<unsigned long>(1, primus::environment::getUInt("PRIMUS_BACKUP_INTERVAL_HOURS", defaults::intervalHours)));
+
+                    if (configuration.pagesPerStep <= 0)
+                        configuration.pagesPerStep = 1;
+                    if (configuration.keep == 0)
+                        configuration.keep = 1;
+
+                    return configuration;
+                }
+            };
+
+            struct Snapshot
+            {
+                std::string file;
+                v_uint64 bytes;
+                v_int64 created;
+            };
+
+            struct Result
+            {
+                Snapshot snapshot;
+                v_int32 pages;
+                v_int32 steps;
+                v_int64 durationMs;
+                v_uint32 removed;
+            };
+
+        private:
+            Configuration               m_configuration;
+            std::mutex                  m_runLock;
+            std::mutex                  m_scheduleLock;
+            std::condition_variable     m_scheduleCondition;
+            std::atomic<bool>           m_running;
+            std::thread                 m_scheduler;
+            std::atomic<v_int64>        m_lastBackup;
+
+        private:
+            static std::string timestamp(std::time_t time)
+            {
+                std::tm local = primus::component::filesystem::localTime(time);
+
+                char buffer[32];
+                std::strftime(buffer, sizeof(buffer), "%Y%m%d-%H%M%S", &local);
+                return buffer;
+            }
+
+            static bool isSnapshot(const std::string& name)
+            {
+                const std::string prefix = primus::constants::database::backup::filePrefix;
+                const std::string suffix = primus::constants::database::backup::fileSuffix;
+                return name.size() > prefix.size() + suffix.size()
+                    && name.compare(0, prefix.size(), prefix) == 0
+                    && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+            }
+
+            /**
+             * Removes all but the newest snapshots
+             */
+            v_uint32 applyRetention()
+            {
+                std::vector<Snapshot> snapshots = listSnapshots();
+                v_uint32 removed = 0;
+
+                for (std::size_t i = m_configuration.keep; i < snapshots.size(); i++)
+                {
+                    if (std::remove((m_configuration.directory + "/" + snapshots[i].file).c_str()) == 0)
+                        removed++;
+                }
+                return removed;
+            }
+
+            void schedule()
+            {
+                std::unique_lock<std::mutex> guard(m_scheduleLock);
+
+                while (m_running)
+                {
+                    m_scheduleCondition.wait_for(guard, std::chrono::minutes(1));
+                    if (!m_running)
+                        break;
+
+                    auto now = std::chrono::system_clock::now();
+                    std::time_t time = std::chrono::system_clock::to_time_t(now);
+                    std::tm local = primus::component::filesystem::localTime(time);
+
+                    /* One hour of slack, so a daily backup does not drift to the next day */
+                    auto sinceLastBackup = std::chrono::seconds(static_cast<v_int64>(time) - m_lastBackup.load());
+                    if (static_cast<v_uint32>(local.tm_hour) != m_configuration.hour || sinceLastBackup < m_configuration.interval - std::chrono::hours(1))
+                        continue;
+
+                    guard.unlock();
+                    try
+                    {
+                        createSnapshot();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        OATPP_LOGE(primus::constants::database::backup::logName, "Scheduled backup failed: %s", e.what());
+                    }
+                    guard.lock();
+                }
+            }
+
+        public:
+            BackupService(const Configuration& configuration)
+                : m_configuration(configuration)
+                , m_running(false)
+                , m_lastBackup(0)
+            {
+                primus::component::filesystem::makeDirectory(m_configuration.directory);
+
+                auto snapshots = listSnapshots();
+                if (!snapshots.empty())
+                    m_lastBackup = snapshots.front().created;
+            }
+
+            ~BackupService()
+            {
+                stop();
+            }
+
+            /**
+             * Starts the scheduler thread if scheduled backups are enabled
+             */
+            void start()
+            {
+                if (!m_configuration.scheduled || m_running.exchange(true))
+                    return;
+
+                OATPP_LOGI(primus::constants::database::backup::logName, "Scheduled backups every %ld h at %02d:00 into %s, keeping %d",
+                    static_cast<long>(m_configuration.interval.count()), m_configuration.hour, m_configuration.directory.c_str(), m_configuration.keep);
+                m_scheduler = std::thread(&BackupService::schedule, this);
+            }
+
+            void stop()
+            {
+                if (!m_running.exchange(false))
+                    return;
+
+                m_scheduleCondition.notify_all();
+                if (m_scheduler.joinable())
+                    m_scheduler.join();
+            }
+
+            /**
+             * Copies a database page range by page range into the destination file. Writers only wait for the
+             * lock of a single step. A write through another connection restarts the copy, after
+             * primus::constants::database::backup::maxRestarts restarts the rest is copied in one step, holding
+             * the read lock until the copy is complete
+             *
+             * @param databaseFile Path of the source database
+             * @param destination Path of the copy, created if missing
+             * @param pagesPerStep Pages copied while holding the read lock
+             * @param stepPause Pause between two steps
+             * @param pages Set to the page count of the copy
+             * @param steps Incremented for every step
+             *
+             */
+            static void copy(const std::string& databaseFile, const std::string& destination, int pagesPerStep,
+                             std::chrono::milliseconds stepPause, v_int32& pages, v_int32& steps)
+            {
+                sqlite3* source = nullptr;
+                sqlite3* target = nullptr;
+
+                if (sqlite3_open_v2(databaseFile.c_str(), &source, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK
+                    || sqlite3_open_v2(destination.c_str(), &target, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK)
+                {
+                    std::string message = source ? sqlite3_errmsg(source) : "out of memory";
+                    if (target)
+                        message = sqlite3_errmsg(target);
+                    sqlite3_close(source);
+                    sqlite3_close(target);
+                    throw std::runtime_error("[BackupService::copy()]: Can't open database: " + message);
+                }
+
+                sqlite3_backup* backup = sqlite3_backup_init(target, "main", source, "main");
+                if (backup == nullptr)
+                {
+                    std::string message = sqlite3_errmsg(target);
+                    sqlite3_close(source);
+                    sqlite3_close(target);
+                    throw std::runtime_error("[BackupService::copy()]: Can't start backup: " + message);
+                }
+
+                int code;
+                int restarts = 0;
+                int remaining = -1;
+                do
+                {
+                    code = sqlite3_backup_step(backup, restarts < primus::constants::database::backup::maxRestarts ? pagesPerStep : -1);
+                    steps++;
+
+                    /* The rollback journal gives no snapshot to copy from, a write starts the copy over */
+                    if (code == SQLITE_OK)
+                    {
+                        int left = sqlite3_backup_remaining(backup);
+                        if (remaining >= 0 && left > remaining)
+                            restarts++;
+                        remaining = left;
+                    }
+
+                    /* Yield between steps, so writers get the lock */
+                    if (code == SQLITE_OK || code == SQLITE_BUSY || code == SQLITE_LOCKED)
+                        std::this_thread::sleep_for(stepPause);
+
+                } while (code == SQLITE_OK || code == SQLITE_BUSY || code == SQLITE_LOCKED);
+
+                if (restarts >= primus::constants::database::backup::maxRestarts)
+                    OATPP_LOGW(primus::constants::database::backup::logName, "Copy of %s restarted %d times by writes, copied the rest in one step",
+                        databaseFile.c_str(), restarts);
+
+                pages = sqlite3_backup_pagecount(backup);
+                sqlite3_backup_finish(backup);
+
+                std::string message = sqlite3_errmsg(target);
+                sqlite3_close(source);
+                sqlite3_close(target);
+
+                if (code != SQLITE_DONE)
+                    throw std::runtime_error("[BackupService::copy()]: Backup failed: " + message);
+            }
+
+            /**
+             * Writes a consistent snapshot of the database while the server keeps running
+             *
+             * @throws BackupInProgressError if another backup is running
+             *
+             */
+            Result createSnapshot()
+            {
+                std::unique_lock<std::mutex> guard(m_runLock, std::try_to_lock);
+                if (!guard.owns_lock())
+                    throw BackupInProgressError();
+
+                auto started = std::chrono::steady_clock::now();
+                std::time_t now = std::time(nullptr);
+
+                Result result;
+                result.pages = 0;
+                result.steps = 0;
+                result.snapshot.file = primus::constants::database::backup::filePrefix + timestamp(now) + primus::constants::database::backup::fileSuffix;
+                result.snapshot.created = static_cast<v_int64>(now);
+
+                std::string file = m_configuration.directory + "/" + result.snapshot.file;
+                std::string temporary = file + ".tmp";
+
+                OATPP_LOGI(primus::constants::database::backup::logName, "Starting backup into %s", file.c_str());
+
+                try
+                {
+                    copy(m_configuration.databaseFile, temporary, m_configuration.pagesPerStep, m_configuration.stepPause, result.pages, result.steps);
+                }
+                catch (...)
+                {
+                    std::remove(temporary.c_str());
+                    throw;
+                }
+
+                if (std::rename(temporary.c_str(), file.c_str()) != 0)
+                {
+                    std::remove(temporary.c_str());
+                    throw std::runtime_error("[BackupService::createSnapshot()]: Can't rename snapshot to " + file);
+                }
+
+                std::uint64_t bytes = 0;
+                std::int64_t modified = 0;
+                result.snapshot.bytes = primus::component::filesystem::fileStatus(file, bytes, modified) ? static_cast<v_uint64>(bytes) : 0;
+                result.durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+                result.removed = applyRetention();
+                m_lastBackup = static_cast<v_int64>(now);
+
+                OATPP_LOGI(primus::constants::database::backup::logName, "Backup %s written: %d pages in %d steps, %ld ms, %d old snapshots removed",
+                    result.snapshot.file.c_str(), result.pages, result.steps, static_cast<long>(result.durationMs), result.removed);
+
+                return result;
+            }
+
+            /**
+             * All complete snapshots, newest first
+             */
+            std::vector<Snapshot> listSnapshots() const
+            {
+                std::vector<Snapshot> snapshots;
+
+                for (const auto& name : primus::component::filesystem::listDirectory(m_configuration.directory))
+                {
+                    if (!isSnapshot(name))
+                        continue;
+
+                    std::uint64_t bytes;
+                    std::int64_t modified;
+                    if (!primus::component::filesystem::fileStatus(m_configuration.directory + "/" + name, bytes, modified))
+                        continue;
+
+                    Snapshot snapshot;
+                    snapshot.file = name;
+                    snapshot.bytes = static_cast<v_uint64>(bytes);
+                    snapshot.created = static_cast<v_int64>(modified);
+                    snapshots.push_back(snapshot);
+                }
+
+                /* The timestamp in the name sorts chronologically */
+                std::sort(snapshots.begin(), snapshots.end(), [](const Snapshot& a, const Snapshot& b) { return a.file > b.file; });
+                return snapshots;
+            }
+
+            const Configuration& getConfiguration() const
+            {
+                return m_configuration;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_BACKUPSERVICE_HPP
@@ -0,0 +1,627 @@
+#ifndef PRIMUS_CONNECTIONPOOL_HPP
+#define PRIMUS_CONNECTIONPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "oatpp-sqlite/orm.hpp"
+#include "oatpp/core/provider/Provider.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include "QueryDeadline.hpp"
+#include "StatementCache.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        /**
+         * @brief Thrown if no pooled connection became available within the checkout timeout.
+         * Derives from HttpError, so the controllers answer with 503 without any extra handling.
+         */
+        class PoolExhaustedError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            PoolExhaustedError()
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_503, "No database connection available")
+            {}
+        };
+
+        //  ____             _  ____             __ _                       _   _
+        // |  _ \ ___   ___ | |/ ___|___  _ __  / _(_) __ _ _   _ _ __ __ _| |_(_) ___  _ __
+        // | |_) / _ \ / _ \| | |   / _ \| '_ \| |_| |/ _` | | | | '__/ _` | __| |/ _ \| '_ \
+        // |  __/ (_) | (_) | | |__| (_) | | | |  _| | (_| | |_| | | | (_| | |_| | (_) | | | |
+        // |_|   \___/ \___/|_|\____\___/|_| |_|_| |_|\__, |\__,_|_|  \__,_|\__|_|\___/|_| |_|
+        //                                            |___/
+        /**
+         * @brief Settings of the database connection pool. Defaults live in constants.hpp.
+         */
+        struct PoolConfiguration
+        {
+            v_uint32 maxConnections;
+            v_uint32 minConnections;
+            std::chrono::seconds connectionTtl;
+            v_uint32 warmupConnections;
+            std::chrono::milliseconds checkoutTimeout;      // 0 waits until the request deadline
+            bool adaptive;
+            std::chrono::milliseconds adaptiveInterval;
+            v_uint32 statementCacheSize;
+
+            static PoolConfiguration fromEnvironment()
+            {
+                namespace defaults = primus::constants::database::pool;
+
+                PoolConfiguration configuration;
+                configuration.maxConnections = static_cast<v_uint32>(primus::environment::getUInt("PRIMUS_DB_POOL_SIZE", defaults::maxConnections));
+                configuration.minConnections = static_cast<v_uint32>(primus::environment::getUInt("PRIMUS_DB_POOL_MIN_SIZE", defaults::minConnections));
+                configuration.connectionTtl = std::chrono::seconds(primus::environment::getUInt("PRIMUS_DB_POOL_TTL_SECONDS", defaults::connectionTtl));
+                configuration.warmupConnections = static_cast<v_uint32>(primus::environment::getUInt("PRIMUS_DB_POOL_WARMUP", defaults::warmupConnections));
+                configuration.checkoutTimeout = std::chrono::milliseconds(primus::environment::getUInt("PRIMUS_DB_POOL_CHECKOUT_TIMEOUT_MS", defaults::checkoutTimeout));
+                configuration.adaptive = primus::environment::getBool("PRIMUS_DB_POOL_ADAPTIVE", defaults::adaptive);
+                configuration.adaptiveInterval = std::chrono::milliseconds(primus::environment::getUInt("PRIMUS_DB_POOL_ADAPTIVE_INTERVAL_MS", defaults::adaptiveInterval));
+                configuration.statementCacheSize = static_cast<v_uint32>(primus::environment::getUInt("PRIMUS_DB_STATEMENT_CACHE_SIZE", defaults::statementCacheSize));
+
+                if (configuration.maxConnections == 0)
+                    configuration.maxConnections = 1;
+                if (configuration.minConnections == 0 || configuration.minConnections > configuration.maxConnections)
+                    configuration.minConnections = configuration.maxConnections;
+                if (configuration.warmupConnections > configuration.maxConnections)
+                    configuration.warmupConnections = configuration.maxConnections;
+
+                return configuration;
+            }
+        };
+
+        //  ____             _ __  __      _        _
+        // |  _ \ ___   ___ | |  \/  | ___| |_ _ __(_) ___ ___
+        // | |_) / _ \ / _ \| | |\/| |/ _ \ __| '__| |/ __/ __|
+        // |  __/ (_) | (_) | | |  | |  __/ |_| |  | | (__\__ \
+        // |_|   \___/ \___/|_|_|  |_|\___|\__|_|  |_|\___|___/
+        /**
+         * @brief Counters shared by the pool and the connection provider below it.
+         */
+        struct PoolMetrics
+        {
+            std::atomic<v_uint64> checkouts;
+            std::atomic<v_uint64> timeouts;
+            std::atomic<v_uint64> waitMicrosTotal;
+            std::atomic<v_uint64> waitMicrosMax;
+            std::atomic<v_int64>  inUse;
+            std::atomic<v_int64>  peakInUse;
+            std::atomic<v_int64>  waiting;
+            std::atomic<v_uint64> opened;
+            std::atomic<v_uint64> closed;
+            std::atomic<v_uint64> reopens;
+            std::atomic<v_int64>  pendingReopens;
+
+            PoolMetrics()
+                : checkouts(0), timeouts(0), waitMicrosTotal(0), waitMicrosMax(0)
+                , inUse(0), peakInUse(0), waiting(0)
+                , opened(0), closed(0), reopens(0), pendingReopens(0)
+            {}
+
+            void recordWait(v_uint64 micros)
+            {
+                waitMicrosTotal += micros;
+                v_uint64 currentMax = waitMicrosMax.load();
+                while (micros > currentMax && !waitMicrosMax.compare_exchange_weak(currentMax, micros)) {}
+            }
+
+            void recordCheckout()
+            {
+                checkouts++;
+                v_int64 current = ++inUse;
+                v_int64 peak = peakInUse.load();
+                while (current > peak && !peakInUse.compare_exchange_weak(peak, current)) {}
+            }
+        };
+
+        //   ____                  _   _                ____                _     _
+        //  / ___|___  _   _ _ __ | |_(_)_ __   __ _   |  _ \ _ __ _____   _(_) __| | ___ _ __
+        // | |   / _ \| | | | '_ \| __| | '_ \ / _` |  | |_) | '__/ _ \ \ / / |/ _` |/ _ \ '__|
+        // | |__| (_) | |_| | | | | |_| | | | | (_| |  |  __/| | | (_) \ V /| | (_| |  __/ |
+        //  \____\___/ \__,_|_| |_|\__|_|_| |_|\__, |  |_|   |_|  \___/ \_/ |_|\__,_|\___|_|
+        //                                     |___/
+        /**
+         * @brief Wraps the sqlite ConnectionProvider and counts physical opens, closes and reopens.
+         * A reopen is an open that replaces a connection closed earlier (TTL expiry or invalidation).
+         * Also registers the statement cache of every connection and finalizes it before the connection closes.
+         */
+        class CountingConnectionProvider : public oatpp::provider::Provider<oatpp::sqlite::Connection>
+        {
+        private:
+            class CountingInvalidator : public oatpp::provider::Invalidator<oatpp::sqlite::Connection>
+            {
+            private:
+                std::shared_ptr<oatpp::provider::Invalidator<oatpp::sqlite::Connection>> m_invalidator;
+                std::shared_ptr<PoolMetrics> m_metrics;
+                std::shared_ptr<StatementCacheRegistry> m_statementCaches;
+
+            public:
+                CountingInvalidator(const std::shared_ptr<oatpp::provider::Invalidator<oatpp::sqlite::Connection>>& invalidator,
+                                    const std::shared_ptr<PoolMetrics>& metrics,
+                                    const std::shared_ptr<StatementCacheRegistry>& statementCaches)
+                    : m_invalidator(invalidator)
+                    , m_metrics(metrics)
+                    , m_statementCaches(statementCaches)
+                {}
+
+                void invalidate(const std::shared_ptr<oatpp::sqlite::Connection>& connection) override
+                {
+                    m_statementCaches->close(connection->getHandle());
+                    m_metrics->closed++;
+                    m_metrics->pendingReopens++;
+                    m_invalidator->invalidate(connection);
+                }
+            };
+
+            /**
+             * @brief Opens a connection through the provider without blocking the executor thread, counted like get()
+             */
+            class GetCoroutine : public oatpp::async::CoroutineWithResult<GetCoroutine, const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>&>
+            {
+            private:
+                std::shared_ptr<oatpp::provider::Provider<oatpp::sqlite::Connection>> m_provider;
+                std::shared_ptr<PoolMetrics> m_metrics;
+                std::shared_ptr<StatementCacheRegistry> m_statementCaches;
+
+            public:
+                GetCoroutine(const std::shared_ptr<oatpp::provider::Provider<oatpp::sqlite::Connection>>& provider,
+                             const std::shared_ptr<PoolMetrics>& metrics,
+                             const std::shared_ptr<StatementCacheRegistry>& statementCaches)
+                    : m_provider(provider)
+                    , m_metrics(metrics)
+                    , m_statementCaches(statementCaches)
+                {}
+
+                Action act() override
+                {
+                    return m_provider->getAsync().callbackTo(&GetCoroutine::onConnection);
+                }
+
+                Action onConnection(const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>& connection)
+                {
+                    if (!connection)
+                        return _return(connection);
+                    return _return(count(connection, m_metrics, m_statementCaches));
+                }
+            };
+
+            std::shared_ptr<oatpp::provider::Provider<oatpp::sqlite::Connection>> m_provider;
+            std::shared_ptr<PoolMetrics> m_metrics;
+            std::shared_ptr<StatementCacheRegistry> m_statementCaches;
+
+            /**
+             * Counts a newly opened connection, as a reopen if it replaces one closed earlier. The pending reopens
+             * are only taken while above 0, so concurrent opens never drive them negative
+             */
+            static oatpp::provider::ResourceHandle<oatpp::sqlite::Connection> count(const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>& connection,
+                                                                                    const std::shared_ptr<PoolMetrics>& metrics,
+                                                                                    const std::shared_ptr<StatementCacheRegistry>& statementCaches)
+            {
+                statementCaches->open(connection.object->getHandle());
+                metrics->opened++;
+
+                v_int64 pending = metrics->pendingReopens.load();
+                while (pending > 0 && !metrics->pendingReopens.compare_exchange_weak(pending, pending - 1)) {}
+                if (pending > 0)
+                    metrics->reopens++;
+
+                return oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>(
+                    connection.object, std::make_shared<CountingInvalidator>(connection.invalidator, metrics, statementCaches));
+            }
+
+        public:
+            CountingConnectionProvider(const std::shared_ptr<oatpp::provider::Provider<oatpp::sqlite::Connection>>& provider,
+                                       const std::shared_ptr<PoolMetrics>& metrics,
+                                       const std::shared_ptr<StatementCacheRegistry>& statementCaches)
+                : m_provider(provider)
+                , m_metrics(metrics)
+                , m_statementCaches(statementCaches)
+            {}
+
+            oatpp::provider::ResourceHandle<oatpp::sqlite::Connection> get() override
+            {
+                auto connection = m_provider->get();
+                if (!connection)
+                    return connection;
+                return count(connection, m_metrics, m_statementCaches);
+            }
+
+            oatpp::async::CoroutineStarterForResult<const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>&> getAsync() override
+            {
+                return GetCoroutine::startForResult(m_provider, m_metrics, m_statementCaches);
+            }
+
+            void stop() override
+            {
+                m_provider->stop();
+            }
+        };
+
+        //  ___           _                                       _           _ ____             _
+        // |_ _|_ __  ___| |_ _ __ _   _ _ __ ___   ___ _ __ | |_ ___  __| |  _ \ ___   ___ | |
+        //  | || '_ \/ __| __| '__| | | | '_ ` _ \ / _ \ '_ \| __/ _ \/ _` | |_) / _ \ / _ \| |
+        //  | || | | \__ \ |_| |  | |_| | | | | | |  __/ | | | ||  __/ (_| |  __/ (_) | (_) | |
+        // |___|_| |_|___/\__|_|   \__,_|_| |_| |_|\___|_| |_|\__\___|\__,_|_|   \___/ \___/|_|
+        /**
+         * @brief Provider in front of the oatpp ConnectionPool which measures checkouts and optionally adapts
+         * the number of concurrently used connections to the observed queueing.
+         *
+         * The underlying pool is created with the configured maximum. In adaptive mode this class admits at most
+         * getLimit() concurrent checkouts and moves that limit between the configured minimum and maximum;
+         * connections above the limit stay idle and are closed by the pool once their TTL expires.
+         */
+        class InstrumentedConnectionPool : public oatpp::provider::Provider<oatpp::sqlite::Connection>
+        {
+        public:
+            /**
+             * @brief Connection handed out to the executor. Returns the pooled connection when destroyed.
+             */
+            class PooledConnection : public oatpp::sqlite::Connection
+            {
+            private:
+                oatpp::provider::ResourceHandle<oatpp::sqlite::Connection> m_connection;
+                std::shared_ptr<StatementCache> m_statementCache;
+                std::weak_ptr<InstrumentedConnectionPool> m_pool;   // A connection may outlive the pool, e.g. held by a detached thread at shutdown
+
+            public:
+                PooledConnection(const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>& connection, const std::shared_ptr<InstrumentedConnectionPool>& pool)
+                    : m_connection(connection)
+                    , m_statementCache(pool->m_statementCaches->find(connection.object->getHandle()))
+                    , m_pool(pool)
+                {}
+
+                ~PooledConnection() override
+                {
+                    m_statementCache = nullptr;
+                    m_connection = nullptr;
+
+                    auto pool = m_pool.lock();
+                    if (pool)
+                        pool->release();
+                }
+
+                sqlite3* getHandle() override
+                {
+                    return m_connection.object->getHandle();
+                }
+
+                /**
+                 * Prepared statements of the physical connection, nullptr if the connection was not opened by the pool
+                 */
+                const std::shared_ptr<StatementCache>& getStatementCache() const
+                {
+                    return m_statementCache;
+                }
+
+                void invalidate()
+                {
+                    m_connection.invalidate();
+                }
+            };
+
+        private:
+            class PooledConnectionInvalidator : public oatpp::provider::Invalidator<oatpp::sqlite::Connection>
+            {
+            public:
+                void invalidate(const std::shared_ptr<oatpp::sqlite::Connection>& connection) override
+                {
+                    std::static_pointer_cast<PooledConnection>(connection)->invalidate();
+                }
+            };
+
+            /**
+             * @brief Checks a connection out of the oatpp pool without blocking the executor thread, measured like get()
+             */
+            class GetCoroutine : public oatpp::async::CoroutineWithResult<GetCoroutine, const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>&>
+            {
+            private:
+                std::shared_ptr<InstrumentedConnectionPool> m_instrumented;
+                std::chrono::steady_clock::time_point       m_start;
+                bool                                        m_settled;
+
+                /**
+                 * Ends the wait once, whether the checkout ended in a connection or in an error
+                 */
+                void settle(bool checkedOut)
+                {
+                    if (m_settled)
+                        return;
+                    m_settled = true;
+
+                    m_instrumented->m_metrics->waiting--;
+                    m_instrumented->m_metrics->recordWait(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+                    if (checkedOut)
+                    {
+                        m_instrumented->m_metrics->recordCheckout();
+                        return;
+                    }
+
+                    m_instrumented->releaseAdmission();
+                    m_instrumented->m_metrics->timeouts++;
+                    OATPP_LOGE(primus::constants::database::pool::logName, "Async connection checkout failed after %ld ms",
+                        static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count()));
+                }
+
+            public:
+                GetCoroutine(const std::shared_ptr<InstrumentedConnectionPool>& instrumented)
+                    : m_instrumented(instrumented)
+                    , m_start(std::chrono::steady_clock::now())
+                    , m_settled(false)
+                {}
+
+                Action act() override
+                {
+                    m_instrumented->m_metrics->waiting++;
+                    m_instrumented->admitWithoutWaiting();
+                    return m_instrumented->m_pool->getAsync().callbackTo(&GetCoroutine::onConnection);
+                }
+
+                Action onConnection(const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>& connection)
+                {
+                    if (!connection)
+                    {
+                        settle(false);
+                        return error<oatpp::async::Error>("[InstrumentedConnectionPool::getAsync()]: Error. Connection checkout failed");
+                    }
+
+                    settle(true);
+                    return _return(oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>(
+                        std::make_shared<PooledConnection>(connection, m_instrumented), m_instrumented->m_invalidator));
+                }
+
+                Action handleError(Error* error) override
+                {
+                    settle(false);
+                    return error;
+                }
+            };
+
+        private:
+            std::shared_ptr<oatpp::sqlite::ConnectionPool>  m_pool;
+            std::shared_ptr<PoolMetrics>                    m_metrics;
+            std::shared_ptr<StatementCacheRegistry>         m_statementCaches;
+            std::shared_ptr<PooledConnectionInvalidator>    m_invalidator;
+            PoolConfiguration                               m_configuration;
+
+            std::mutex                                      m_admissionLock;
+            std::condition_variable                         m_admissionCondition;
+            v_uint32                                        m_limit;
+            v_uint32                                        m_admitted;
+
+            std::atomic<bool>                               m_running;
+            std::thread                                     m_adaptiveThread;
+
+            std::weak_ptr<InstrumentedConnectionPool>       m_self;     // Handed to the connections, set by createShared
+
+        private:
+            bool admit(const std::chrono::steady_clock::time_point& deadline)
+            {
+                std::unique_lock<std::mutex> guard(m_admissionLock);
+                if (!m_admissionCondition.wait_until(guard, deadline, [this]() { return m_admitted < m_limit || !m_running; }))
+                    return false;
+                m_admitted++;
+                return true;
+            }
+
+            void release()
+            {
+                m_metrics->inUse--;
+                {
+                    std::lock_guard<std::mutex> guard(m_admissionLock);
+                    m_admitted--;
+                }
+                m_admissionCondition.notify_one();
+            }
+
+            /**
+             * Admits an async checkout at once, a coroutine must not block the executor thread. The oatpp pool
+             * below still bounds it by the maximum and waits for a connection asynchronously
+             */
+            void admitWithoutWaiting()
+            {
+                std::lock_guard<std::mutex> guard(m_admissionLock);
+                m_admitted++;
+            }
+
+            void releaseAdmission()
+            {
+                {
+                    std::lock_guard<std::mutex> guard(m_admissionLock);
+                    m_admitted--;
+                }
+                m_admissionCondition.notify_one();
+            }
+
+            /**
+             * Grows the limit while requests queue for a connection and shrinks it while most admitted
+             * connections stay unused
+             */
+            void adapt()
+            {
+                v_uint64 lastCheckouts = m_metrics->checkouts;
+                v_uint64 lastWait = m_metrics->waitMicrosTotal;
+
+                while (m_running)
+                {
+                    std::this_thread::sleep_for(m_configuration.adaptiveInterval);
+
+                    v_uint64 checkouts = m_metrics->checkouts;
+                    v_uint64 wait = m_metrics->waitMicrosTotal;
+                    v_uint64 averageWait = checkouts > lastCheckouts ? (wait - lastWait) / (checkouts - lastCheckouts) : 0;
+                    v_int64 peak = m_metrics->peakInUse.exchange(m_metrics->inUse);
+                    lastCheckouts = checkouts;
+                    lastWait = wait;
+
+                    std::lock_guard<std::mutex> guard(m_admissionLock);
+                    v_uint32 previous = m_limit;
+
+                    if ((averageWait > primus::constants::database::pool::adaptiveWaitTarget || m_metrics->waiting > 0) && m_limit < m_configuration.maxConnections)
+                        m_limit++;
+                    else if (peak < static_cast<v_int64>(m_limit) / 2 && m_limit > m_configuration.minConnections)
+                        m_limit--;
+
+                    if (m_limit != previous)
+                    {
+                        OATPP_LOGI(primus::constants::database::pool::logName, "Adaptive pool limit %d -> %d (average wait %lu us, peak in use %ld)",
+                            previous, m_limit, static_cast<unsigned long>(averageWait), static_cast<long>(peak));
+                        m_admissionCondition.notify_all();
+                    }
+                }
+            }
+
+        public:
+            InstrumentedConnectionPool(const std::shared_ptr<oatpp::sqlite::ConnectionPool>& pool,
+                                       const std::shared_ptr<PoolMetrics>& metrics,
+                                       const std::shared_ptr<StatementCacheRegistry>& statementCaches,
+                                       const PoolConfiguration& configuration)
+                : m_pool(pool)
+                , m_metrics(metrics)
+                , m_statementCaches(statementCaches)
+                , m_invalidator(std::make_shared<PooledConnectionInvalidator>())
+                , m_configuration(configuration)
+                , m_limit(configuration.adaptive ? configuration.minConnections : configuration.maxConnections)
+                , m_admitted(0)
+                , m_running(true)
+            {
+                if (m_configuration.adaptive)
+                    m_adaptiveThread = std::thread(&InstrumentedConnectionPool::adapt, this);
+            }
+
+            ~InstrumentedConnectionPool() override
+            {
+                stop();
+            }
+
+            /**
+             * Creates the pool: sqlite ConnectionProvider -> CountingConnectionProvider -> oatpp ConnectionPool -> this
+             *
+             * @param databaseFile Path of the sqlite database
+             * @param configuration Pool settings
+             *
+             */
+            static std::shared_ptr<InstrumentedConnectionPool> createShared(const oatpp::String& databaseFile, const PoolConfiguration& configuration)
+            {
+                auto metrics = std::make_shared<PoolMetrics>();
+                auto statementCaches = std::make_shared<StatementCacheRegistry>(configuration.statementCacheSize);
+                auto connectionProvider = std::make_shared<CountingConnectionProvider>(std::make_shared<oatpp::sqlite::ConnectionProvider>(databaseFile), metrics, statementCaches);
+
+                /* Admission bounds the wait of a checkout, the oatpp pool below it never needs to wait longer than a request */
+                auto pool = oatpp::sqlite::ConnectionPool::createShared(connectionProvider,
+                    configuration.maxConnections,
+                    configuration.connectionTtl,
+                    configuration.checkoutTimeout.count() > 0 ? configuration.checkoutTimeout : std::chrono::milliseconds(primus::constants::database::query::requestTimeout));
+
+                auto instrumented = std::make_shared<InstrumentedConnectionPool>(pool, metrics, statementCaches, configuration);
+                instrumented->m_self = instrumented;
+                return instrumented;
+            }
+
+            /**
+             * Opens connections up front so the first requests do not pay for opening the database file and
+             * parsing the schema
+             *
+             * @param count Number of connections to open
+             *
+             */
+            void warmUp(v_uint32 count)
+            {
+                std::vector<oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>> connections;
+
+                for (v_uint32 i = 0; i < count; i++)
+                {
+                    auto connection = m_pool->get();
+                    if (!connection)
+                        break;
+
+                    sqlite3_exec(connection.object->getHandle(), "SELECT COUNT(*) FROM sqlite_master;", nullptr, nullptr, nullptr);
+                    connections.push_back(connection);
+                }
+
+                OATPP_LOGI(primus::constants::database::pool::logName, "Pool warmed up with %d connections (max %d, TTL %lds, adaptive %s)",
+                    static_cast<int>(connections.size()), m_configuration.maxConnections,
+                    static_cast<long>(m_configuration.connectionTtl.count()), m_configuration.adaptive ? "on" : "off");
+            }
+
+            oatpp::provider::ResourceHandle<oatpp::sqlite::Connection> get() override
+            {
+                auto start = std::chrono::steady_clock::now();
+
+                /* A checkout timeout of 0 waits as long as the request may, outside of a request as long as one may */
+                auto deadline = RequestDeadline::get();
+                if (m_configuration.checkoutTimeout.count() > 0)
+                    deadline = std::min(start + m_configuration.checkoutTimeout, deadline);
+                else if (deadline == std::chrono::steady_clock::time_point::max())
+                    deadline = start + std::chrono::milliseconds(primus::constants::database::query::requestTimeout);
+
+                m_metrics->waiting++;
+                bool admitted = admit(deadline);
+                auto connection = admitted ? m_pool->get() : oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>(nullptr);
+                m_metrics->waiting--;
+
+                m_metrics->recordWait(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+                if (!connection)
+                {
+                    if (admitted)
+                        releaseAdmission();
+                    m_metrics->timeouts++;
+                    OATPP_LOGE(primus::constants::database::pool::logName, "Connection checkout timed out after %ld ms",
+                        static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()));
+                    throw PoolExhaustedError();
+                }
+
+                m_metrics->recordCheckout();
+                return oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>(std::make_shared<PooledConnection>(connection, m_self.lock()), m_invalidator);
+            }
+
+            oatpp::async::CoroutineStarterForResult<const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>&> getAsync() override
+            {
+                return GetCoroutine::startForResult(m_self.lock());
+            }
+
+            void stop() override
+            {
+                if (!m_running.exchange(false))
+                    return;
+
+                m_admissionCondition.notify_all();
+                if (m_adaptiveThread.joinable())
+                    m_adaptiveThread.join();
+                m_pool->stop();
+            }
+
+            const std::shared_ptr<PoolMetrics>& getMetrics() const
+            {
+                return m_metrics;
+            }
+
+            const std::shared_ptr<StatementCacheRegistry>& getStatementCaches() const
+            {
+                return m_statementCaches;
+            }
+
+            const PoolConfiguration& getConfiguration() const
+            {
+                return m_configuration;
+            }
+
+            v_uint32 getLimit()
+            {
+                std::lock_guard<std::mutex> guard(m_admissionLock);
+                return m_limit;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_CONNECTIONPOOL_HPP
@@ -7,6 +7,7 @@
 #include "oatpp/core/macro/codegen.hpp"
 
 #include "dto/DatabaseDtos.hpp"
+#include "dto/Int32Dto.hpp"
 #include "general/constants.hpp"
 
 namespace primus
@@ -21,12 +22,17 @@ namespace primus
         // |____/ \__,_|\__\__,_|_.__/ \__,_|___/\___|\____|_|_|\___|_| |_|\__|
         /**
          * @brief DatabaseClient class represents a client to interact with the database.
+         *
+         * Dates are stored as day numbers (days since 1970-01-01, see 002_day_numbers.sql). The queries convert
+         * at the boundary: parameters with CAST(julianday(:date) - 2440587.5 AS INTEGER), results with
+         * date(day + 2440587.5) or through MemberView, so the dtos keep their YYYY-MM-DD strings.
          */
         class DatabaseClient : public oatpp::orm::DbClient
         {
             typedef primus::dto::database::AddressDto       AddressDto;
             typedef primus::dto::database::DepartmentDto    DepartmentDto;
             typedef primus::dto::database::MemberDto        MemberDto;
+            typedef primus::dto::database::PricingRuleDto   PricingRuleDto;
         public:
             /**
              * Constructor to initialize the DatabaseClient.
@@ -41,10 +47,24 @@ namespace primus
 
                 oatpp::orm::SchemaMigration migration(executor);
                 migration.addFile(1 /* start from version 1 */, DATABASE_MIGRATIONS "/001_init.sql");
+                migration.addFile(2, DATABASE_MIGRATIONS "/002_day_numbers.sql");
+                migration.addFile(3, DATABASE_MIGRATIONS "/003_pricing.sql");
+                migration.addFile(4, DATABASE_MIGRATIONS "/004_address_key.sql");
+                migration.addFile(5, DATABASE_MIGRATIONS "/005_change_log.sql");
+                migration.addFile(6, DATABASE_MIGRATIONS "/006_member_version.sql");
                 migration.migrate(); // <-- run migrations. This guy will throw on error.
 
                 auto version = executor->getSchemaVersion();
                 OATPP_LOGI(primus::constants::databaseclient::logName,"Migration - OK. Version=%lld.", version);
+
+                auto dbResult = getInvalidDateCount();
+                if (dbResult->isSuccess())
+                {
+                    auto invalid = dbResult->fetch<oatpp::Vector<oatpp::Object<primus::dto::UInt32Dto>>>();
+                    if (invalid->size() == 1 && invalid[0]->value != nullptr && *invalid[0]->value > 0)
+                        OATPP_LOGW(primus::constants::databaseclient::logName, "%d rows with unparsable dates are kept in Member_InvalidDate and Attendance_InvalidDate (see 002_day_numbers.sql)",
+                            *invalid[0]->value);
+                }
             }
 
             //                           _               
@@ -59,7 +79,7 @@ namespace primus
             * @param id The member id
             * 
             */
-            QUERY(getMemberById, "SELECT * from Member WHERE id = :id;", PARAM(oatpp::UInt32, id));
+            QUERY(getMemberById, "SELECT * from MemberView WHERE id = :id;", PARAM(oatpp::UInt32, id));
 
 
             /**
@@ -70,33 +90,82 @@ namespace primus
             */
             QUERY(createMember,
                 "INSERT INTO Member (firstName, lastName, email, phoneNumber, birthDate, createDate, notes, active) "
-                "SELECT :member.firstName, :member.lastName, :member.email, :member.phoneNumber, :member.birthDate, DATE('now'), :member.notes, :member.active "
-                "WHERE NOT EXISTS (SELECT 1 FROM Member WHERE firstName = :member.firstName AND lastName = :member.lastName AND email = :member.email AND birthDate = :member.birthDate);",
+                "SELECT :member.firstName, :member.lastName, :member.email, :member.phoneNumber, "
+                "CAST(julianday(:member.birthDate) - 2440587.5 AS INTEGER), CAST(julianday('now') - 2440587.5 AS INTEGER), :member.notes, :member.active "
+                "WHERE NOT EXISTS (SELECT 1 FROM Member WHERE firstName = :member.firstName AND lastName = :member.lastName AND email = :member.email "
+                "AND birthDate = CAST(julianday(:member.birthDate) - 2440587.5 AS INTEGER));",
                 PARAM(oatpp::Object<MemberDto>, member));
 
 
+            /**
+            * Updates a member, whatever its version
+            *
+            * @param member A dto containing the mebers data
+            * @return The updated member with its new version, nothing if the member does not exist
+            *
+            */
             QUERY(updateMember,
                 "UPDATE Member SET "
                 "firstName = :member.firstName, "
                 "lastName = :member.lastName, "
                 "email = :member.email, "
                 "phoneNumber = :member.phoneNumber, "
-                "birthDate = :member.birthDate, "
+                "birthDate = CAST(julianday(:member.birthDate) - 2440587.5 AS INTEGER), "
                 "notes = :member.notes, "
-                "active = :member.active "
-                "WHERE id = :member.id;",
+                "active = :member.active, "
+                "version = version + 1 "
+                "WHERE id = :member.id "
+                "RETURNING id, firstName, lastName, email, phoneNumber, "
+                "date(birthDate + 2440587.5) AS birthDate, date(createDate + 2440587.5) AS createDate, notes, active, version;",
                 PARAM(oatpp::Object<MemberDto>, member));
 
+            /**
+            * Updates a member if it still has the version the client read (If-Match)
+            *
+            * @param member A dto containing the mebers data
+            * @param version The version the client read
+            * @return The updated member with its new version, nothing if the member does not exist or has another version
+            *
+            */
+            QUERY(updateMemberIfVersion,
+                "UPDATE Member SET "
+                "firstName = :member.firstName, "
+                "lastName = :member.lastName, "
+                "email = :member.email, "
+                "phoneNumber = :member.phoneNumber, "
+                "birthDate = CAST(julianday(:member.birthDate) - 2440587.5 AS INTEGER), "
+                "notes = :member.notes, "
+                "active = :member.active, "
+                "version = version + 1 "
+                "WHERE id = :member.id AND version = :version "
+                "RETURNING id, firstName, lastName, email, phoneNumber, "
+                "date(birthDate + 2440587.5) AS birthDate, date(createDate + 2440587.5) AS createDate, notes, active, version;",
+                PARAM(oatpp::Object<MemberDto>, member),
+                PARAM(oatpp::UInt32, version));
+
+            /**
+            * Retrieves the version of a member, its ETag
+            *
+            * @param id The member id
+            *
+            */
+            QUERY(getMemberVersion, "SELECT version AS value FROM Member WHERE id = :id;", PARAM(oatpp::UInt32, id));
+
             QUERY(findMemberIdByDetails,
-                "SELECT * FROM Member WHERE firstName = :firstName AND lastName = :lastName AND email = :email AND birthDate = :birthDate;",
+                "SELECT * FROM MemberView WHERE firstName = :firstName AND lastName = :lastName AND email = :email AND birthDate = date(:birthDate);",
                 PARAM(oatpp::String, firstName),
                 PARAM(oatpp::String, lastName),
                 PARAM(oatpp::String, email),
                 PARAM(oatpp::String, birthDate));
 
-            QUERY(activateMember, "UPDATE Member SET active = 1 WHERE id = :id;", PARAM(oatpp::UInt32, id));
+            QUERY(activateMember, "UPDATE Member SET active = 1, version = version + 1 WHERE id = :id;", PARAM(oatpp::UInt32, id));
+
+            QUERY(deactivateMember, "UPDATE Member SET active = 0, version = version + 1 WHERE id = :id;", PARAM(oatpp::UInt32, id));
 
-            QUERY(deactivateMember, "UPDATE Member SET active = 0 WHERE id = :id;", PARAM(oatpp::UInt32, id));
+            /**
+            * Retrieves id and active flag of every member. Used to load the MemberDirectory
+            */
+            QUERY(getMemberDirectoryEntries, "SELECT id, active FROM Member;");
 
             //                           _                                       _       
             //  _ __ ___   ___ _ __ ___ | |__   ___ _ __    ___ ___  _   _ _ __ | |_ ___ 
@@ -117,20 +186,20 @@ namespace primus
             // |_| |_| |_|\___|_| |_| |_|_.__/ \___|_|    |_|_|___/\__|___/
 
             QUERY(getMembersWithUpcomingBirthday,
-                "SELECT * from Member m "
+                "SELECT * from MemberView m "
                 "WHERE active = 1 AND strftime('%m-%d', m.birthDate) >= strftime('%m-%d', 'now') "
                 "ORDER BY strftime('%m-%d', m.birthDate) ASC; ",
                 PARAM(oatpp::UInt32, limit),
                 PARAM(oatpp::UInt32, offset));
 
             QUERY(getAllMembers,
-                " SELECT * FROM Member "
+                " SELECT * FROM MemberView "
                 " LIMIT :limit OFFSET :offset;",
                 PARAM(oatpp::UInt32, limit),
                 PARAM(oatpp::UInt32, offset));
 
             QUERY(getActiveMembers,
-                " SELECT * FROM Member "
+                " SELECT * FROM MemberView "
                 " WHERE active = 1 "
                 " ORDER BY id "
                 " LIMIT :limit OFFSET :offset;",
@@ -138,16 +207,46 @@ namespace primus
                 PARAM(oatpp::UInt32, offset));
 
             QUERY(getInactiveMembers,
-                " SELECT * FROM Member "
+                " SELECT * FROM MemberView "
                 " WHERE active = 0 "
                 " ORDER BY id "
                 " LIMIT :limit OFFSET :offset;",
                 PARAM(oatpp::UInt32, limit),
                 PARAM(oatpp::UInt32, offset));
 
-            QUERY(getMembersByAddress, "SELECT Member.* FROM Member INNER JOIN Address_Member ON Member.id = Address_Member.member_id WHERE Address_Member.address_id = :addressId;", PARAM(oatpp::UInt32, addressId));
+            /**
+            * Same as the member list queries above, reading only some columns of MemberView
+            *
+            * @param list all, active, inactive or birthday
+            * @param columns SQL column list built from checked field names, see primus::dto::FieldSelection
+            *
+            */
+            std::shared_ptr<oatpp::orm::QueryResult> getMemberListColumns(const oatpp::String& list, const std::string& columns,
+                                                                          const oatpp::UInt32& limit, const oatpp::UInt32& offset,
+                                                                          const oatpp::provider::ResourceHandle<oatpp::orm::Connection>& connection = nullptr)
+            {
+                std::string query = " SELECT " + columns + " FROM MemberView m ";
+                if (list == "active")
+                    query += " WHERE active = 1 ORDER BY id LIMIT :limit OFFSET :offset;";
+                else if (list == "inactive")
+                    query += " WHERE active = 0 ORDER BY id LIMIT :limit OFFSET :offset;";
+                else if (list == "birthday")
+                    query += " WHERE active = 1 AND strftime('%m-%d', m.birthDate) >= strftime('%m-%d', 'now') ORDER BY strftime('%m-%d', m.birthDate) ASC;";
+                else
+                    query += " LIMIT :limit OFFSET :offset;";
+
+                /* Named like a QUERY so it gets a timeout and statistics, each column list is a statement of its own */
+                auto queryTemplate = getExecutor()->parseQueryTemplate("getMemberListColumns", query, {}, true);
+
+                std::unordered_map<oatpp::String, oatpp::Void> params;
+                params["limit"] = limit;
+                params["offset"] = offset;
+                return getExecutor()->execute(queryTemplate, params, nullptr, connection);
+            }
+
+            QUERY(getMembersByAddress, "SELECT MemberView.* FROM MemberView INNER JOIN Address_Member ON MemberView.id = Address_Member.member_id WHERE Address_Member.address_id = :addressId;", PARAM(oatpp::UInt32, addressId));
             
-            QUERY(getMembersByDepartment, "SELECT Member.* FROM Member INNER JOIN Department_Member ON Member.id = Department_Member.member_id WHERE Department_Member.department_id = :departmentId;", PARAM(oatpp::UInt32, departmentId));
+            QUERY(getMembersByDepartment, "SELECT MemberView.* FROM MemberView INNER JOIN Department_Member ON MemberView.id = Department_Member.member_id WHERE Department_Member.department_id = :departmentId;", PARAM(oatpp::UInt32, departmentId));
 
             //                           _                 _        __           
             //  _ __ ___   ___ _ __ ___ | |__   ___ _ __  (_)_ __  / _| ___  ___ 
@@ -162,7 +261,7 @@ namespace primus
                 PARAM(oatpp::UInt32, id));
 
             QUERY(getMemberAddresses,
-                " SELECT a.* FROM Address a "
+                " SELECT a.* FROM AddressView a "
                 " INNER JOIN Address_Member am ON a.id = am.address_id "
                 " WHERE am.member_id = :id "
                 " ORDER BY a.id "
@@ -194,37 +293,94 @@ namespace primus
                 " ORDER BY id ASC",
                 PARAM(oatpp::UInt32, id));
 
+            /**
+            * Retrieves every department. Used to load the ReferenceData
+            */
+            QUERY(getAllDepartments, "SELECT * FROM Department ORDER BY id;");
+
+            //             _      _             
+            //  _ __  _ __(_) ___(_)_ __   __ _ 
+            // | '_ \| '__| |/ __| | '_ \ / _` |
+            // | |_) | |  | | (__| | | | | (_| |
+            // | .__/|_|  |_|\___|_|_| |_|\__, |
+            // |_|                        |___/ 
+
+            /**
+            * Retrieves every pricing rule. Used to load the ReferenceData
+            */
+            QUERY(getPricingRules, "SELECT rule, department_id AS departmentId, fee FROM Pricing ORDER BY rule, department_id;");
+
+            QUERY(deletePricingRules, "DELETE FROM Pricing;");
+
+            QUERY(createPricingRule,
+                "INSERT INTO Pricing (rule, department_id, fee) "
+                "VALUES (:pricingRule.rule, :pricingRule.departmentId, :pricingRule.fee);",
+                PARAM(oatpp::Object<PricingRuleDto>, pricingRule));
+
             //            _     _                   
             //   __ _  __| | __| |_ __ ___  ___ ___ 
             //  / _` |/ _` |/ _` | '__/ _ \/ __/ __|
             // | (_| | (_| | (_| | | |  __/\__ \__ \
             //  \__,_|\__,_|\__,_|_|  \___||___/___/
 
+            /**
+            * Inserts the address, or on a conflict in the unique index Address_normalizedKey touches the existing one,
+            * and returns the row either way. Only an insert sets the last insert rowid of the connection
+            *
+            * @param normalizedKey primus::database::AddressKey::of(address)
+            *
+            */
             QUERY(createAddress,
-                " INSERT INTO Address (postalCode, city, country, houseNumber, street) "
-                " SELECT :address.postalCode, :address.city, :address.country, :address.houseNumber, :address.street "
-                " WHERE NOT EXISTS (SELECT 1 FROM Address WHERE postalCode = :address.postalCode AND city = :address.city AND country = :address.country AND houseNumber = :address.houseNumber AND street = :address.street);",
-                PARAM(oatpp::Object<AddressDto>, address));
+                " INSERT INTO Address (postalCode, city, country, houseNumber, street, normalizedKey) "
+                " VALUES (:address.postalCode, :address.city, :address.country, :address.houseNumber, :address.street, :normalizedKey) "
+                " ON CONFLICT (normalizedKey) DO UPDATE SET normalizedKey = excluded.normalizedKey "
+                " RETURNING id, postalCode, city, country, houseNumber, street;",
+                PARAM(oatpp::Object<AddressDto>, address),
+                PARAM(oatpp::String, normalizedKey));
 
-            QUERY(getAddressById, "SELECT * FROM Address WHERE id = :id;", PARAM(oatpp::UInt32, id));
+            QUERY(getAddressById, "SELECT * FROM AddressView WHERE id = :id;", PARAM(oatpp::UInt32, id));
 
             QUERY(updateAddress,
                 "UPDATE Address SET "
                 "street = :address.street, "
+                "houseNumber = :address.houseNumber, "
                 "city = :address.city, "
-                "zipCode = :address.zipCode, "
-                "country = :address.country "
+                "postalCode = :address.postalCode, "
+                "country = :address.country, "
+                "normalizedKey = :normalizedKey "
                 "WHERE id = :address.id;",
-                PARAM(oatpp::Object<AddressDto>, address));
+                PARAM(oatpp::Object<AddressDto>, address),
+                PARAM(oatpp::String, normalizedKey));
 
             QUERY(deleteAddress, "DELETE FROM Address WHERE id = :id AND id NOT IN (SELECT address_id FROM Address_Member);", PARAM(oatpp::UInt32, id));
 
-            QUERY(findAddressByDetails,
-                "SELECT * FROM Address WHERE street = :street AND city = :city AND postalCode = :postalCode AND country = :country;",
-                PARAM(oatpp::String, street),
-                PARAM(oatpp::String, city),
-                PARAM(oatpp::String, postalCode),
-                PARAM(oatpp::String, country));
+            /**
+            * Addresses written before the normalizedKey existed, in id order. Used by the AddressDeduplicator
+            */
+            QUERY(getAddressesWithoutKey,
+                " SELECT id, postalCode, city, country, houseNumber, street FROM Address "
+                " WHERE normalizedKey IS NULL AND id > :afterId "
+                " ORDER BY id "
+                " LIMIT :limit;",
+                PARAM(oatpp::UInt32, afterId),
+                PARAM(oatpp::UInt32, limit));
+
+            QUERY(getAddressByKey, "SELECT id, postalCode, city, country, houseNumber, street FROM Address WHERE normalizedKey = :normalizedKey;", PARAM(oatpp::String, normalizedKey));
+
+            QUERY(setAddressKey, "UPDATE Address SET normalizedKey = :normalizedKey WHERE id = :id;", PARAM(oatpp::UInt32, id), PARAM(oatpp::String, normalizedKey));
+
+            /**
+            * Moves the members of a duplicate address to the address it is merged into
+            */
+            QUERY(moveAddressMembers,
+                " INSERT OR IGNORE INTO Address_Member (address_id, member_id) "
+                " SELECT :toId, member_id FROM Address_Member WHERE address_id = :fromId;",
+                PARAM(oatpp::UInt32, fromId),
+                PARAM(oatpp::UInt32, toId));
+
+            QUERY(deleteAddressMembers, "DELETE FROM Address_Member WHERE address_id = :addressId;", PARAM(oatpp::UInt32, addressId));
+
+            QUERY(deleteMergedAddress, "DELETE FROM Address WHERE id = :id;", PARAM(oatpp::UInt32, id));
 
             //        _   _                 _                      
             //   __ _| |_| |_ ___ _ __   __| | __ _ _ __   ___ ___ 
@@ -234,20 +390,20 @@ namespace primus
 
             QUERY(createMemberAttendance,
                 "INSERT INTO Attendance (member_id, date) "
-                "VALUES (:member_id, :date); ",
+                "VALUES (:member_id, CAST(julianday(:date) - 2440587.5 AS INTEGER)); ",
                 PARAM(oatpp::UInt32, member_id),
                 PARAM(oatpp::String, date));
 
             QUERY(deleteMemberAttendance,
                 "DELETE FROM Attendance "
-                "WHERE member_id = :member_id AND date = :date;",
+                "WHERE member_id = :member_id AND date = CAST(julianday(:date) - 2440587.5 AS INTEGER);",
                 PARAM(oatpp::UInt32, member_id),
                 PARAM(oatpp::String, date));
 
             QUERY(getAttendancesOfMember,
-                " SELECT date FROM Attendance "
+                " SELECT date(Attendance.date + 2440587.5) AS date FROM Attendance "
                 " WHERE member_id = :member_id "
-                " ORDER BY date DESC "
+                " ORDER BY Attendance.date DESC "
                 " LIMIT :limit OFFSET :offset;",
                 PARAM(oatpp::UInt32, member_id),
                 PARAM(oatpp::UInt32, limit),
@@ -255,8 +411,8 @@ namespace primus
 
             QUERY(getMembersByAttendanceDate,
                 " SELECT member_id as value FROM Attendance "
-                " WHERE date = :date "
-                " ORDER BY date "
+                " WHERE date = CAST(julianday(:dateOfAttendance) - 2440587.5 AS INTEGER) "
+                " ORDER BY member_id "
                 " LIMIT :limit OFFSET :offset;",
                 PARAM(oatpp::String, dateOfAttendance),
                 PARAM(oatpp::UInt32, limit),
@@ -270,6 +426,10 @@ namespace primus
             //  _/ |\__,_|_| |_|\___|\__|_|\___/|_| |_|  \__\__,_|_.__/|_|\___||___/
             // |__/                                                                 
 
+            QUERY(getDepartmentMemberships, "SELECT member_id AS memberId, department_id AS departmentId FROM Department_Member;");
+
+            QUERY(getAddressMemberships, "SELECT member_id AS memberId, address_id AS addressId FROM Address_Member;");
+
             QUERY(associateAddressWithMember, "INSERT INTO Address_Member (address_id, member_id) VALUES (:addressId, :memberId);", PARAM(oatpp::UInt32, addressId), PARAM(oatpp::UInt32, memberId));
             QUERY(disassociateAddressFromMember, "DELETE FROM Address_Member WHERE address_id = :addressId AND member_id = :memberId;", PARAM(oatpp::UInt32, addressId), PARAM(oatpp::UInt32, memberId));
 
@@ -288,15 +448,59 @@ namespace primus
 
             QUERY(getCountOfMemberAttendancesInLastYear,
                 " SELECT COUNT(*) as value "
-                " FROM Attendance WHERE member_id = :memberId AND date >= DATE('now', '-1 year');",
+                " FROM Attendance WHERE member_id = :memberId AND date >= CAST(julianday('now', '-1 year') - 2440587.5 AS INTEGER);",
                 PARAM(oatpp::UInt32, memberId));
 
             QUERY(countDistinctAttendentMontsWithinLastYear,
-                " SELECT COUNT(DISTINCT strftime('%m', date)) AS value "
+                " SELECT COUNT(DISTINCT strftime('%m', date + 2440587.5)) AS value "
                 " FROM Attendance "
-                " WHERE date >= DATE('now', '-1 year') "
+                " WHERE date >= CAST(julianday('now', '-1 year') - 2440587.5 AS INTEGER) "
                 " AND member_id = :memberId; ",
                 PARAM(oatpp::UInt32, memberId));
+
+            //  ___ _   _ _ __   ___
+            // / __| | | | '_ \ / __|
+            // \__ \ |_| | | | | (__
+            // |___/\__, |_| |_|\___|
+            //      |___/
+
+            /**
+            * Latest sequence number of the ChangeLog, 0 before the first change (see 005_change_log.sql)
+            */
+            QUERY(getChangeSequence, "SELECT COALESCE(MAX(seq), 0) AS value FROM ChangeLog;");
+
+            /**
+            * Members changed after a sequence number, as they are now
+            *
+            * @param since Sequence number the client has seen
+            *
+            */
+            QUERY(getChangedMembers,
+                "SELECT MemberView.* FROM ChangeLog c INNER JOIN MemberView ON MemberView.id = c.member_id "
+                "WHERE c.seq > :since AND c.entity = 1 AND c.deleted = 0 ORDER BY c.seq;",
+                PARAM(oatpp::UInt32, since));
+
+            /**
+            * Tombstones of members and the department and address memberships added or removed after a sequence number
+            *
+            * @param since Sequence number the client has seen
+            *
+            */
+            QUERY(getChangeLogEntries,
+                "SELECT seq, entity, member_id AS memberId, related_id AS relatedId, deleted FROM ChangeLog "
+                "WHERE seq > :since AND (entity <> 1 OR deleted = 1) ORDER BY seq;",
+                PARAM(oatpp::UInt32, since));
+
+            /**
+            * Every member, the snapshot a client starts its delta sync from
+            */
+            QUERY(getSyncMembers, "SELECT * FROM MemberView ORDER BY id;");
+
+            /**
+            * Rows the day number migration could not convert, kept aside (see 002_day_numbers.sql)
+            */
+            QUERY(getInvalidDateCount,
+                "SELECT (SELECT COUNT(*) FROM Member_InvalidDate) + (SELECT COUNT(*) FROM Attendance_InvalidDate) AS value;");
         };
 
 #include OATPP_CODEGEN_END(DbClient) ///< End code-gen section
@@ -305,4 +509,4 @@ namespace primus
     } // namespace component
 } // namespace primus
 
-#endif //DATABASE_CLIENT
\ No newline at end of file
+#endif //DATABASE_CLIENT
\ No newline at end of file
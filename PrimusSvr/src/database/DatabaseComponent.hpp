@@ -3,8 +3,17 @@
 
 #include "oatpp/core/macro/component.hpp"
 
+#include "AddressDeduplicator.hpp"
+#include "AttendanceArchive.hpp"
+#include "BackupService.hpp"
+#include "ConnectionPool.hpp"
 #include "DatabaseClient.hpp"
+#include "Executor.hpp"
+#include "MemberDirectory.hpp"
+#include "ReferenceData.hpp"
+#include "ReportingDatabase.hpp"
 #include "filesystemHelper.hpp"
+#include "tenant/TenantRegistry.hpp"
 
 namespace primus
 {
@@ -21,17 +30,26 @@ namespace primus
          */
         class DatabaseComponent {
         public:
+            // Create instrumented connection pool, sized by the environment (see constants.hpp for the defaults)
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::database::InstrumentedConnectionPool>, connectionPool)([] {
+
+                auto configuration = primus::database::PoolConfiguration::fromEnvironment();
+                return primus::database::InstrumentedConnectionPool::createShared(DATABASE_FILE, configuration);
+
+                }());
+
             // Create database connection provider component
             OATPP_CREATE_COMPONENT(std::shared_ptr<oatpp::provider::Provider<oatpp::sqlite::Connection>>, dbConnectionProvider)([] {
 
-                /* Create database-specific ConnectionProvider */
-                auto connectionProvider = std::make_shared<oatpp::sqlite::ConnectionProvider>(DATABASE_FILE);
+                /* Get instrumented ConnectionPool component */
+                OATPP_COMPONENT(std::shared_ptr<primus::database::InstrumentedConnectionPool>, connectionPool);
+                return std::static_pointer_cast<oatpp::provider::Provider<oatpp::sqlite::Connection>>(connectionPool);
 
-                /* Create database-specific ConnectionPool */
-                return oatpp::sqlite::ConnectionPool::createShared(connectionProvider,
-                    10 /* max-connections */,
-                    std::chrono::seconds(5) /* connection TTL */);
+                }());
 
+            // Create query statistics and slow query log
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::database::QueryMonitor>, queryMonitor)([] {
+                return std::make_shared<primus::database::QueryMonitor>();
                 }());
 
             // Create database client
@@ -40,11 +58,128 @@ namespace primus
                 /* Get database ConnectionProvider component */
                 OATPP_COMPONENT(std::shared_ptr<oatpp::provider::Provider<oatpp::sqlite::Connection>>, connectionProvider);
 
-                /* Create database-specific Executor */
-                auto executor = std::make_shared<oatpp::sqlite::Executor>(connectionProvider);
+                /* Get QueryMonitor component */
+                OATPP_COMPONENT(std::shared_ptr<primus::database::QueryMonitor>, queryMonitor);
+
+                /* Create database-specific Executor, it reuses the prepared statements of each connection and reports every query */
+                auto executor = std::make_shared<primus::database::Executor>(connectionProvider, queryMonitor);
+
+                /* Create MyClient database client, this runs the migrations */
+                auto client = std::make_shared<DatabaseClient>(executor);
+
+                /* Open the first connections before the server accepts requests */
+                OATPP_COMPONENT(std::shared_ptr<primus::database::InstrumentedConnectionPool>, connectionPool);
+                connectionPool->warmUp(connectionPool->getConfiguration().warmupConnections);
+
+                return client;
+
+                }());
+
+            // Create address deduplicator and key the addresses written before normalizedKey existed
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::database::AddressDeduplicator>, addressDeduplicator)([] {
+
+                /* Get database client component, the deduplicator needs the migrated Address table */
+                OATPP_COMPONENT(std::shared_ptr<DatabaseClient>, database);
+
+                /* Get ResponseCache component, merged addresses change cached pages */
+                OATPP_COMPONENT(std::shared_ptr<primus::cache::ResponseCache>, responseCache);
+
+                auto deduplicator = std::make_shared<primus::database::AddressDeduplicator>(database, responseCache);
+                deduplicator->start();
+                return deduplicator;
+
+                }());
+
+            // Create backup service and start the scheduled backups
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::database::BackupService>, backupService)([] {
+
+                auto configuration = primus::database::BackupService::Configuration::fromEnvironment(DATABASE_FILE, BACKUP_DIRECTORY);
+                auto backupService = std::make_shared<primus::database::BackupService>(configuration);
+                backupService->start();
+                return backupService;
+
+                }());
+
+            // Create attendance archive and move the closed years out of the Attendance table once a day
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::database::AttendanceArchive>, attendanceArchive)([] {
+
+                /* Get database client component, the archive needs the migrated Attendance table */
+                OATPP_COMPONENT(std::shared_ptr<DatabaseClient>, database);
+
+                /* Get QueryMonitor component */
+                OATPP_COMPONENT(std::shared_ptr<primus::database::QueryMonitor>, queryMonitor);
+
+                auto configuration = primus::database::AttendanceArchive::Configuration::fromEnvironment(DATABASE_FILE, ARCHIVE_DIRECTORY);
+                auto archive = std::make_shared<primus::database::AttendanceArchive>(configuration, queryMonitor);
+                archive->start();
+                return archive;
+
+                }());
+
+            // Create the reporting snapshot for the analytics endpoints and keep refreshing it
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::database::ReportingDatabase>, reportingDatabase)([] {
+
+                /* Get database client component, the snapshot is taken after the migrations ran */
+                OATPP_COMPONENT(std::shared_ptr<DatabaseClient>, database);
+
+                /* Get QueryMonitor component */
+                OATPP_COMPONENT(std::shared_ptr<primus::database::QueryMonitor>, queryMonitor);
+
+                auto configuration = primus::database::ReportingDatabase::Configuration::fromEnvironment(DATABASE_FILE, REPORTING_DIRECTORY);
+                auto reportingDatabase = std::make_shared<primus::database::ReportingDatabase>(configuration, queryMonitor);
+
+                /* Without a snapshot the reports answer 503 until the next refresh, the server starts regardless */
+                try
+                {
+                    reportingDatabase->refresh();
+                }
+                catch (const std::exception& e)
+                {
+                    OATPP_LOGE(primus::constants::database::reporting::logName, "Taking the first reporting snapshot failed: %s", e.what());
+                }
+
+                reportingDatabase->start();
+                return reportingDatabase;
+
+                }());
+
+            // Create in-memory member directory
+            OATPP_CREATE_COMPONENT(std::shared_ptr<MemberDirectory>, memberDirectory)([] {
+
+                /* Get database client component */
+                OATPP_COMPONENT(std::shared_ptr<DatabaseClient>, database);
+
+                /* Load the directory once, the controllers keep it current afterwards */
+                auto directory = std::make_shared<MemberDirectory>();
+                directory->load(database);
+                return directory;
+
+                }());
+
+            // Create reference data (departments and pricing)
+            OATPP_CREATE_COMPONENT(std::shared_ptr<ReferenceDataStore>, referenceData)([] {
+
+                /* Get database client component */
+                OATPP_COMPONENT(std::shared_ptr<DatabaseClient>, database);
+
+                /* Load the snapshot once, it is only replaced by the admin endpoints */
+                auto referenceData = std::make_shared<ReferenceDataStore>(database);
+                referenceData->load();
+                return referenceData;
+
+                }());
+
+            // Create tenant registry, without PRIMUS_MULTI_TENANT every request uses the database above
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::tenant::TenantRegistry>, tenantRegistry)([] {
+
+                /* Get QueryMonitor component, the tenants report their queries to the same statistics */
+                OATPP_COMPONENT(std::shared_ptr<primus::database::QueryMonitor>, queryMonitor);
 
-                /* Create MyClient database client */
-                return std::make_shared<DatabaseClient>(executor);
+                auto configuration = primus::tenant::TenantRegistry::Configuration::fromEnvironment(TENANT_DIRECTORY);
+                auto poolConfiguration = primus::database::PoolConfiguration::fromEnvironment();
+                auto registry = std::make_shared<primus::tenant::TenantRegistry>(configuration, poolConfiguration, queryMonitor);
+                registry->start();
+                return registry;
 
                 }());
 
@@ -0,0 +1,343 @@
+#ifndef PRIMUS_EXECUTOR_HPP
+#define PRIMUS_EXECUTOR_HPP
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "oatpp-sqlite/orm.hpp"
+#include "oatpp-sqlite/mapping/ResultMapper.hpp"
+#include "oatpp-sqlite/mapping/Serializer.hpp"
+#include "oatpp-sqlite/ql_template/Parser.hpp"
+
+#include "ConnectionPool.hpp"
+#include "QueryDeadline.hpp"
+#include "QueryMonitor.hpp"
+#include "StatementCache.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        /**
+         * @brief What the executor knows about a query besides its statement.
+         */
+        struct QueryContext
+        {
+            std::string                             name;
+            QueryDeadline                           deadline;
+            std::shared_ptr<QueryMonitor>           monitor;
+            QueryMonitor::Counters*                 counters;
+            std::chrono::steady_clock::time_point   started;
+            v_uint64                                poolWaitMicros;
+        };
+
+        //   ____           _              _  ___                        ____                 _ _
+        //  / ___|__ _  ___| |__   ___  __| |/ _ \ _   _  ___ _ __ _   _|  _ \ ___  ___ _   _| | |_
+        // | |   / _` |/ __| '_ \ / _ \/ _` | | | | | | |/ _ \ '__| | | | |_) / _ \/ __| | | | | __|
+        // | |__| (_| | (__| | | |  __/ (_| | |_| | |_| |  __/ |  | |_| |  _ <  __/\__ \ |_| | | |_
+        //  \____\__,_|\___|_| |_|\___|\__,_|\__\_\\__,_|\___|_|   \__, |_| \_\___||___/\__,_|_|\__|
+        //                                                         |___/
+        /**
+         * @brief QueryResult on a statement borrowed from a StatementCache.
+         * Behaves like oatpp::sqlite::QueryResult, but gives the statement back instead of finalizing it,
+         * runs every step of the statement under the deadline of its query and reports it to the QueryMonitor.
+         */
+        class CachedQueryResult : public oatpp::orm::QueryResult
+        {
+        private:
+            sqlite3_stmt*                                               m_statement;
+            bool                                                        m_cached;
+            std::shared_ptr<StatementCache>                             m_statementCache;
+            oatpp::provider::ResourceHandle<oatpp::orm::Connection>     m_connection;
+            std::shared_ptr<oatpp::sqlite::mapping::ResultMapper>       m_resultMapper;
+            oatpp::sqlite::mapping::ResultMapper::ResultData            m_resultData;
+            QueryContext                                                m_context;
+            v_uint64                                                    m_activeMicros;
+
+        private:
+            /**
+             * @brief Keeps the deadline armed on the connection while the statement steps.
+             */
+            class ArmedDeadline
+            {
+            private:
+                const CachedQueryResult* m_result;
+
+            public:
+                ArmedDeadline(const CachedQueryResult* result)
+                    : m_result(result)
+                {
+                    m_result->m_context.deadline.arm(sqlite3_db_handle(m_result->m_statement));
+                }
+
+                ~ArmedDeadline()
+                {
+                    m_result->m_context.deadline.disarm(sqlite3_db_handle(m_result->m_statement));
+                }
+            };
+
+            void checkDeadline() const
+            {
+                if (!m_resultData.isSuccess)
+                    m_context.deadline.check(sqlite3_db_handle(m_statement), m_context.name);
+            }
+
+            static v_uint64 microsSince(const std::chrono::steady_clock::time_point& start)
+            {
+                return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            }
+
+        public:
+            CachedQueryResult(sqlite3_stmt* statement,
+                              bool cached,
+                              const std::shared_ptr<StatementCache>& statementCache,
+                              const oatpp::provider::ResourceHandle<oatpp::orm::Connection>& connection,
+                              const std::shared_ptr<oatpp::sqlite::mapping::ResultMapper>& resultMapper,
+                              const std::shared_ptr<const oatpp::data::mapping::TypeResolver>& typeResolver,
+                              const QueryContext& context)
+                : m_statement(statement)
+                , m_cached(cached)
+                , m_statementCache(statementCache)
+                , m_connection(connection)
+                , m_resultMapper(resultMapper)
+                , m_resultData(statement, typeResolver)
+                , m_context(context)
+                , m_activeMicros(0)
+            {}
+
+            /**
+             * Runs the statement up to the first row. Called once all parameters are bound
+             */
+            void start()
+            {
+                {
+                    ArmedDeadline armed(this);
+                    m_resultData.init();
+                }
+                m_activeMicros += microsSince(m_context.started);
+                checkDeadline();
+            }
+
+            ~CachedQueryResult() override
+            {
+                if (m_context.monitor)
+                {
+                    try
+                    {
+                        m_context.monitor->record(*m_context.counters, m_context.name, m_statement, m_activeMicros,
+                            static_cast<v_uint64>(m_resultData.rowIndex), m_context.poolWaitMicros, m_resultData.isSuccess);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        OATPP_LOGE(primus::constants::database::monitor::logName, "Failed to record query '%s': %s", m_context.name.c_str(), e.what());
+                    }
+                }
+
+                if (m_statementCache)
+                    m_statementCache->release(m_statement, m_cached);
+                else
+                    sqlite3_finalize(m_statement);
+            }
+
+            oatpp::provider::ResourceHandle<oatpp::orm::Connection> getConnection() const override
+            {
+                return m_connection;
+            }
+
+            bool isSuccess() const override
+            {
+                return m_resultData.isSuccess;
+            }
+
+            oatpp::String getErrorMessage() const override
+            {
+                if (!m_resultData.isSuccess)
+                    return sqlite3_errmsg(sqlite3_db_handle(m_statement));
+                return nullptr;
+            }
+
+            v_int64 getPosition() const override
+            {
+                return m_resultData.rowIndex;
+            }
+
+            v_int64 getKnownCount() const override
+            {
+                return -1;
+            }
+
+            bool hasMoreToFetch() const override
+            {
+                return m_resultData.hasMore;
+            }
+
+            oatpp::Void fetch(const oatpp::Type* const type, v_int64 count) override
+            {
+                auto started = std::chrono::steady_clock::now();
+                oatpp::Void rows;
+                {
+                    ArmedDeadline armed(this);
+                    rows = m_resultMapper->readRows(&m_resultData, type, count);
+                }
+                m_activeMicros += microsSince(started);
+                checkDeadline();
+                return rows;
+            }
+
+            /**
+             * Index of the column named name, -1 if the query has none
+             */
+            int getColumnIndex(const char* name) const
+            {
+                for (int column = 0; column < sqlite3_column_count(m_statement); column++)
+                {
+                    if (std::strcmp(sqlite3_column_name(m_statement, column), name) == 0)
+                        return column;
+                }
+                return -1;
+            }
+
+            /**
+             * Hands every remaining row to visit as the stepped statement instead of mapping it to a DTO, see
+             * RowDecoder. Column values read from the statement are only valid during the call
+             */
+            template<class Visit>
+            void forEachRow(const Visit& visit)
+            {
+                auto started = std::chrono::steady_clock::now();
+                {
+                    ArmedDeadline armed(this);
+                    while (m_resultData.hasMore)
+                    {
+                        visit(m_statement);
+                        m_resultData.next();
+                    }
+                }
+                m_activeMicros += microsSince(started);
+                checkDeadline();
+            }
+        };
+
+        //  _____                     _
+        // | ____|_  _____  ___ _   _| |_ ___  _ __
+        // |  _| \ \/ / _ \/ __| | | | __/ _ \| '__|
+        // | |___ >  <  __/ (__| |_| | || (_) | |
+        // |_____/_/\_\___|\___|\__,_|\__\___/|_|
+        /**
+         * @brief sqlite Executor which reuses prepared statements and bounds the runtime of every query.
+         *
+         * Every QUERY of the DatabaseClient is looked up in the statement cache of the connection it runs on,
+         * keyed by its prepared template. A hit skips parsing and planning, the statement is only rebound.
+         * Connections which were not handed out by the InstrumentedConnectionPool prepare a private statement.
+         *
+         * Each query gets a deadline from its name (see QueryTimeouts), capped by the deadline of the request.
+         * A query running past it is interrupted (504), one waiting too long for a lock gives up (503).
+         *
+         * Every finished query is reported to the QueryMonitor under its name.
+         */
+        class Executor : public oatpp::sqlite::Executor
+        {
+        private:
+            std::shared_ptr<oatpp::sqlite::mapping::ResultMapper>   m_resultMapper;
+            oatpp::sqlite::mapping::Serializer                      m_serializer;
+            QueryTimeouts                                           m_timeouts;
+            std::shared_ptr<QueryMonitor>                           m_monitor;
+
+        private:
+            /**
+             * Binds the parameters of a query, resolving nested names like :member.firstName
+             */
+            void bindParams(sqlite3_stmt* statement,
+                            const oatpp::data::share::StringTemplate& queryTemplate,
+                            const std::unordered_map<oatpp::String, oatpp::Void>& params,
+                            const std::shared_ptr<const oatpp::data::mapping::TypeResolver>& typeResolver)
+            {
+                oatpp::data::mapping::TypeResolver::Cache cache;
+
+                for (v_uint32 i = 0; i < queryTemplate.getTemplateVariables().size(); i++)
+                {
+                    const auto& variable = queryTemplate.getTemplateVariables()[i];
+                    auto queryParameter = parseQueryParameter(variable.name);
+
+                    auto param = params.find(queryParameter.name);
+                    if (param == params.end())
+                        throw std::runtime_error(std::string("[primus::database::Executor::bindParams()]: Parameter not found: ") + variable.name->c_str());
+
+                    auto value = typeResolver->resolveObjectPropertyValue(param->second, queryParameter.propertyPath, cache);
+                    if (value.getValueType()->classId.id == oatpp::Void::Class::CLASS_ID.id)
+                        throw std::runtime_error(std::string("[primus::database::Executor::bindParams()]: Parameter could not be resolved: ") + variable.name->c_str());
+
+                    m_serializer.serialize(statement, i + 1, value);
+                }
+            }
+
+        public:
+            Executor(const std::shared_ptr<oatpp::provider::Provider<oatpp::sqlite::Connection>>& connectionProvider,
+                     const std::shared_ptr<QueryMonitor>& monitor)
+                : oatpp::sqlite::Executor(connectionProvider)
+                , m_resultMapper(std::make_shared<oatpp::sqlite::mapping::ResultMapper>())
+                , m_monitor(monitor)
+            {}
+
+            std::shared_ptr<oatpp::orm::QueryResult> execute(const oatpp::data::share::StringTemplate& queryTemplate,
+                                                             const std::unordered_map<oatpp::String, oatpp::Void>& params,
+                                                             const std::shared_ptr<const oatpp::data::mapping::TypeResolver>& typeResolver,
+                                                             const oatpp::provider::ResourceHandle<oatpp::orm::Connection>& connection) override
+            {
+                QueryContext context;
+                context.started = std::chrono::steady_clock::now();
+
+                auto activeConnection = connection ? connection : getConnection();
+                context.poolWaitMicros = connection ? 0 : std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - context.started).count();
+
+                auto extra = std::static_pointer_cast<oatpp::sqlite::ql_template::Parser::TemplateExtra>(queryTemplate.getExtraData());
+                if (!extra)
+                    return oatpp::sqlite::Executor::execute(queryTemplate, params, typeResolver, activeConnection);
+
+                context.name = extra->templateName ? *extra->templateName : std::string("query");
+                context.deadline = QueryDeadline(m_timeouts.get(extra->templateName));
+                context.monitor = m_monitor;
+                context.counters = m_monitor ? &m_monitor->getCounters(context.name) : nullptr;
+                context.started = std::chrono::steady_clock::now();
+
+                if (context.deadline.isExpired())
+                    throw QueryTimeoutError(context.name);
+
+                auto pooledConnection = std::dynamic_pointer_cast<InstrumentedConnectionPool::PooledConnection>(activeConnection.object);
+                std::shared_ptr<StatementCache> statementCache = pooledConnection ? pooledConnection->getStatementCache() : nullptr;
+                auto resolver = typeResolver ? typeResolver : getDefaultTypeResolver();
+
+                bool cached = false;
+                sqlite3_stmt* statement = nullptr;
+                if (statementCache)
+                {
+                    statement = statementCache->acquire(*extra->preparedTemplate, cached);
+                }
+                else
+                {
+                    auto handle = std::static_pointer_cast<oatpp::sqlite::Connection>(activeConnection.object)->getHandle();
+                    sqlite3_prepare_v2(handle, extra->preparedTemplate->c_str(), static_cast<int>(extra->preparedTemplate->size()), &statement, nullptr);
+                }
+
+                if (statement == nullptr)
+                {
+                    auto handle = std::static_pointer_cast<oatpp::sqlite::Connection>(activeConnection.object)->getHandle();
+                    throw std::runtime_error(std::string("[primus::database::Executor::execute()]: Can't prepare '") + context.name + "': " + sqlite3_errmsg(handle));
+                }
+
+                auto result = std::make_shared<CachedQueryResult>(statement, cached, statementCache, activeConnection, m_resultMapper, resolver, context);
+
+                /* result owns the statement from here on, a failing bind gives it back to the cache */
+                bindParams(statement, queryTemplate, params, resolver);
+                result->start();
+
+                return result;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_EXECUTOR_HPP
@@ -0,0 +1,320 @@
+#ifndef MEMBERDIRECTORY_HPP
+#define MEMBERDIRECTORY_HPP
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "oatpp/core/Types.hpp"
+
+#include "DatabaseClient.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace component
+    {
+        //  __  __                _               ____  _               _
+        // |  \/  | ___ _ __ ___ | |__   ___ _ __|  _ \(_)_ __ ___  ___| |_ ___  _ __ _   _
+        // | |\/| |/ _ \ '_ ` _ \| '_ \ / _ \ '__| | | | | '__/ _ \/ __| __/ _ \| '__| | | |
+        // | |  | |  __/ | | | | | |_) |  __/ |  | |_| | | | |  __/ (__| || (_) | |  | |_| |
+        // |_|  |_|\___|_| |_| |_|_.__/ \___|_|  |____/|_|_|  \___|\___|\__\___/|_|   \__, |
+        //                                                                            |___/
+        /**
+         * @brief In-memory index of all members, loaded once at startup and kept current by the write paths.
+         *
+         * The directory is a structure-of-arrays indexed by member id: an existence bitmap, an active bitmap
+         * and one department bitset per member (bit n-1 is set if the member belongs to department n).
+         * Existence checks and department lookups therefore never touch the database.
+         *
+         * Departments with an id beyond the bitset are kept in a set per member aside of it, so no membership is lost.
+         */
+        class MemberDirectory
+        {
+        public:
+            typedef v_uint32 DepartmentSet;
+
+        private:
+            static const v_uint32 BITS_PER_WORD = 64;
+
+            mutable std::mutex          m_lock;
+            std::vector<v_uint64>       m_exists;
+            std::vector<v_uint64>       m_active;
+            std::vector<DepartmentSet>  m_departments;
+            std::map<v_uint32, std::set<v_uint32>> m_overflowDepartments;   // Member id -> department ids beyond the bitset
+            v_uint32                    m_memberCount;
+            v_uint32                    m_activeCount;
+
+        private:
+            static bool testBit(const std::vector<v_uint64>& bitmap, v_uint32 id)
+            {
+                v_uint32 word = id / BITS_PER_WORD;
+                return word < bitmap.size() && (bitmap[word] >> (id % BITS_PER_WORD)) & 1;
+            }
+
+            static void writeBit(std::vector<v_uint64>& bitmap, v_uint32 id, bool value)
+            {
+                v_uint64 mask = v_uint64(1) << (id % BITS_PER_WORD);
+                if (value)
+                    bitmap[id / BITS_PER_WORD] |= mask;
+                else
+                    bitmap[id / BITS_PER_WORD] &= ~mask;
+            }
+
+            static bool fitsBitset(v_uint32 departmentId)
+            {
+                return departmentId > 0 && departmentId <= sizeof(DepartmentSet) * 8;
+            }
+
+            static DepartmentSet departmentBit(v_uint32 departmentId)
+            {
+                if (!fitsBitset(departmentId))
+                    return 0;
+                return DepartmentSet(1) << (departmentId - 1);
+            }
+
+            void addDepartmentUnlocked(v_uint32 id, v_uint32 departmentId)
+            {
+                if (fitsBitset(departmentId))
+                    m_departments[id] |= departmentBit(departmentId);
+                else
+                    m_overflowDepartments[id].insert(departmentId);
+            }
+
+            void ensureCapacity(v_uint32 id)
+            {
+                if (id < m_departments.size())
+                    return;
+
+                std::size_t size = m_departments.empty() ? 1024 : m_departments.size();
+                while (size <= id)
+                    size *= 2;
+
+                m_departments.resize(size, 0);
+                m_exists.resize((size + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+                m_active.resize((size + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+            }
+
+            void setMemberUnlocked(v_uint32 id, bool active)
+            {
+                ensureCapacity(id);
+
+                if (!testBit(m_exists, id))
+                {
+                    writeBit(m_exists, id, true);
+                    m_memberCount++;
+                }
+                if (testBit(m_active, id) != active)
+                {
+                    writeBit(m_active, id, active);
+                    active ? m_activeCount++ : m_activeCount--;
+                }
+            }
+
+        public:
+            MemberDirectory()
+                : m_memberCount(0)
+                , m_activeCount(0)
+            {}
+
+            /**
+             * Replaces the content of the directory with the current state of the database
+             *
+             * @param database The client used to read Member and Department_Member
+             *
+             */
+            void load(const std::shared_ptr<DatabaseClient>& database)
+            {
+                typedef primus::dto::database::MemberDto MemberDto;
+                typedef primus::dto::database::DepartmentMembershipDto DepartmentMembershipDto;
+
+                auto dbResult = database->getMemberDirectoryEntries();
+                if (!dbResult->isSuccess())
+                    throw std::runtime_error(std::string("[MemberDirectory::load()]: ") + dbResult->getErrorMessage()->c_str());
+                auto members = dbResult->fetch<oatpp::Vector<oatpp::Object<MemberDto>>>();
+
+                dbResult = database->getDepartmentMemberships();
+                if (!dbResult->isSuccess())
+                    throw std::runtime_error(std::string("[MemberDirectory::load()]: ") + dbResult->getErrorMessage()->c_str());
+                auto memberships = dbResult->fetch<oatpp::Vector<oatpp::Object<DepartmentMembershipDto>>>();
+
+                std::lock_guard<std::mutex> guard(m_lock);
+
+                m_exists.clear();
+                m_active.clear();
+                m_departments.clear();
+                m_overflowDepartments.clear();
+                m_memberCount = 0;
+                m_activeCount = 0;
+
+                for (auto& member : *members)
+                    setMemberUnlocked(*member->id, static_cast<bool>(member->active));
+
+                v_uint32 overflowMemberships = 0;
+                for (auto& membership : *memberships)
+                {
+                    if (!testBit(m_exists, *membership->memberId))
+                        continue;
+
+                    addDepartmentUnlocked(*membership->memberId, *membership->departmentId);
+                    if (!fitsBitset(*membership->departmentId))
+                        overflowMemberships++;
+                }
+
+                OATPP_LOGI(primus::constants::databaseclient::logName, "MemberDirectory loaded. Members: %d, active: %d, memberships: %d",
+                    m_memberCount, m_activeCount, static_cast<int>(memberships->size()));
+                if (overflowMemberships > 0)
+                    OATPP_LOGW(primus::constants::databaseclient::logName, "MemberDirectory keeps %d memberships of departments with an id above %d outside of the bitset",
+                        overflowMemberships, static_cast<int>(sizeof(DepartmentSet) * 8));
+            }
+
+            bool exists(const oatpp::UInt32& id) const
+            {
+                if (id == nullptr)
+                    return false;
+                std::lock_guard<std::mutex> guard(m_lock);
+                return testBit(m_exists, *id);
+            }
+
+            bool isActive(const oatpp::UInt32& id) const
+            {
+                if (id == nullptr)
+                    return false;
+                std::lock_guard<std::mutex> guard(m_lock);
+                return testBit(m_active, *id);
+            }
+
+            /**
+             * Reads what the fee of a member depends on under one lock, so a concurrent write cannot pair the count
+             * of one state with the first department of another. Both include the departments beyond the bitset
+             *
+             * @param count Number of departments of the member
+             * @param first Id of the lowest department of the member, 0 if there is none
+             *
+             * @return false, with count and first 0, if the member does not exist
+             */
+            bool getFeeDepartments(const oatpp::UInt32& id, v_uint32& count, v_uint32& first) const
+            {
+                count = 0;
+                first = 0;
+                if (id == nullptr)
+                    return false;
+                std::lock_guard<std::mutex> guard(m_lock);
+                if (!testBit(m_exists, *id))
+                    return false;
+
+                auto overflow = m_overflowDepartments.find(*id);
+                bool hasOverflow = overflow != m_overflowDepartments.end() && !overflow->second.empty();
+
+                count = countDepartments(m_departments[*id]) + (hasOverflow ? static_cast<v_uint32>(overflow->second.size()) : 0);
+                if (m_departments[*id] != 0)
+                    first = firstDepartment(m_departments[*id]);
+                else if (hasOverflow)
+                    first = *overflow->second.begin();
+                return true;
+            }
+
+            v_uint32 getMemberCount() const
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                return m_memberCount;
+            }
+
+            v_uint32 getActiveCount() const
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                return m_activeCount;
+            }
+
+            //                 _ _         _                 _
+            // __      ___ __(_) |_ ___  | |__   ___   ___ | | _____
+            // \ \ /\ / / '__| | __/ _ \ | '_ \ / _ \ / _ \| |/ / __|
+            //  \ V  V /| |  | | ||  __/ | | | | (_) | (_) |   <\__ \
+            //   \_/\_/ |_|  |_|\__\___| |_| |_|\___/ \___/|_|\_\___/
+
+            void setMember(const oatpp::UInt32& id, bool active)
+            {
+                if (id == nullptr)
+                    return;
+                std::lock_guard<std::mutex> guard(m_lock);
+                setMemberUnlocked(*id, active);
+            }
+
+            void setActive(const oatpp::UInt32& id, bool active)
+            {
+                if (id == nullptr)
+                    return;
+                std::lock_guard<std::mutex> guard(m_lock);
+                if (testBit(m_exists, *id))
+                    setMemberUnlocked(*id, active);
+            }
+
+            void addDepartment(const oatpp::UInt32& id, v_uint32 departmentId)
+            {
+                if (id == nullptr)
+                    return;
+                std::lock_guard<std::mutex> guard(m_lock);
+                if (!testBit(m_exists, *id))
+                    return;
+
+                if (!fitsBitset(departmentId))
+                    OATPP_LOGW(primus::constants::databaseclient::logName, "MemberDirectory keeps department %d of member %d outside of the bitset", departmentId, *id);
+                addDepartmentUnlocked(*id, departmentId);
+            }
+
+            void removeDepartment(const oatpp::UInt32& id, v_uint32 departmentId)
+            {
+                if (id == nullptr)
+                    return;
+                std::lock_guard<std::mutex> guard(m_lock);
+                if (!testBit(m_exists, *id))
+                    return;
+
+                if (fitsBitset(departmentId))
+                {
+                    m_departments[*id] &= ~departmentBit(departmentId);
+                    return;
+                }
+
+                auto overflow = m_overflowDepartments.find(*id);
+                if (overflow == m_overflowDepartments.end())
+                    return;
+                overflow->second.erase(departmentId);
+                if (overflow->second.empty())
+                    m_overflowDepartments.erase(overflow);
+            }
+
+            //  _          _
+            // | |__   ___| |_ __   ___ _ __ ___
+            // | '_ \ / _ \ | '_ \ / _ \ '__/ __|
+            // | | | |  __/ | |_) |  __/ |  \__ \
+            // |_| |_|\___|_| .__/ \___|_|  |___/
+            //              |_|
+
+            static v_uint32 countDepartments(DepartmentSet departments)
+            {
+                v_uint32 count = 0;
+                for (; departments != 0; departments &= departments - 1)
+                    count++;
+                return count;
+            }
+
+            /**
+             * Returns the id of the lowest department within the set, or 0 if the set is empty
+             */
+            static v_uint32 firstDepartment(DepartmentSet departments)
+            {
+                for (v_uint32 departmentId = 1; departments != 0; departmentId++, departments >>= 1)
+                {
+                    if (departments & 1)
+                        return departmentId;
+                }
+                return 0;
+            }
+        };
+
+    } // namespace component
+} // namespace primus
+
+#endif // MEMBERDIRECTORY_HPP
@@ -0,0 +1,270 @@
+#ifndef PRIMUS_QUERYDEADLINE_HPP
+#define PRIMUS_QUERYDEADLINE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "oatpp-sqlite/orm.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        /**
+         * @brief Thrown if a query ran past its deadline and was interrupted. Answered with 504.
+         */
+        class QueryTimeoutError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            QueryTimeoutError(const std::string& queryName)
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_504, "Query '" + queryName + "' exceeded its deadline")
+            {}
+        };
+
+        /**
+         * @brief Thrown if a request ran past its deadline while waiting for the work of another request. Answered with 504.
+         */
+        class RequestTimeoutError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            RequestTimeoutError(const std::string& waitedFor)
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_504, "Request exceeded its deadline waiting for " + waitedFor)
+            {}
+        };
+
+        /**
+         * @brief Thrown if a query could not get a database lock before its deadline. Answered with 503.
+         */
+        class DatabaseBusyError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            DatabaseBusyError(const std::string& queryName)
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_503, "Database is busy, query '" + queryName + "' gave up waiting for a lock")
+            {}
+        };
+
+        //  ____                            _   ____                 _ _ _
+        // |  _ \ ___  __ _ _   _  ___  ___| |_|  _ \  ___  __ _  __| | (_)_ __   ___
+        // | |_) / _ \/ _` | | | |/ _ \/ __| __| | | |/ _ \/ _` |/ _` | | | '_ \ / _ \
+        // |  _ <  __/ (_| | |_| |  __/\__ \ |_| |_| |  __/ (_| | (_| | | | | | |  __/
+        // |_| \_\___|\__, |\__,_|\___||___/\__|____/ \___|\__,_|\__,_|_|_|_| |_|\___|
+        //               |_|
+        /**
+         * @brief Deadline of the request handled by the current thread.
+         *
+         * The HttpConnectionHandler serves a connection on one thread, so a thread local is enough to hand the
+         * deadline from the request interceptor down to the executor and the connection pool.
+         */
+        class RequestDeadline
+        {
+        private:
+            static std::chrono::steady_clock::time_point& current()
+            {
+                static thread_local std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+                return deadline;
+            }
+
+        public:
+            /**
+             * @brief Sets the deadline for its lifetime and restores the previous one afterwards.
+             */
+            class Scope
+            {
+            private:
+                std::chrono::steady_clock::time_point m_previous;
+
+            public:
+                Scope(std::chrono::milliseconds timeout)
+                    : m_previous(current())
+                {
+                    current() = std::chrono::steady_clock::now() + timeout;
+                }
+
+                ~Scope()
+                {
+                    current() = m_previous;
+                }
+            };
+
+            static void set(std::chrono::milliseconds timeout)
+            {
+                current() = std::chrono::steady_clock::now() + timeout;
+            }
+
+            /**
+             * Hands the deadline of a request to another thread working on it
+             */
+            static void set(std::chrono::steady_clock::time_point deadline)
+            {
+                current() = deadline;
+            }
+
+            static void clear()
+            {
+                current() = std::chrono::steady_clock::time_point::max();
+            }
+
+            static std::chrono::steady_clock::time_point get()
+            {
+                return current();
+            }
+        };
+
+        //   ___                        ____                 _ _ _
+        //  / _ \ _   _  ___ _ __ _   _|  _ \  ___  __ _  __| | (_)_ __   ___
+        // | | | | | | |/ _ \ '__| | | | | | |/ _ \/ _` |/ _` | | | '_ \ / _ \
+        // | |_| | |_| |  __/ |  | |_| | |_| |  __/ (_| | (_| | | | | | |  __/
+        //  \__\_\\__,_|\___|_|   \__, |____/ \___|\__,_|\__,_|_|_|_| |_|\___|
+        //                        |___/
+        /**
+         * @brief Point in time a single query has to finish by, enforced on its connection with the sqlite
+         * progress handler (running statements) and the busy timeout (waiting for locks).
+         */
+        class QueryDeadline
+        {
+        private:
+            std::chrono::steady_clock::time_point m_deadline;
+
+            static int onProgress(void* data)
+            {
+                auto deadline = static_cast<const std::chrono::steady_clock::time_point*>(data);
+                return std::chrono::steady_clock::now() >= *deadline ? 1 : 0;
+            }
+
+        public:
+            QueryDeadline()
+                : m_deadline(std::chrono::steady_clock::time_point::max())
+            {}
+
+            /**
+             * The earlier of the query timeout and the deadline of the current request
+             */
+            QueryDeadline(std::chrono::milliseconds timeout)
+                : m_deadline(std::min(std::chrono::steady_clock::now() + timeout, RequestDeadline::get()))
+            {}
+
+            bool isExpired() const
+            {
+                return std::chrono::steady_clock::now() >= m_deadline;
+            }
+
+            /**
+             * Installs the progress handler and the busy timeout on the connection.
+             * The deadline has to outlive the armed connection, disarm() removes the handler again
+             */
+            void arm(sqlite3* handle) const
+            {
+                if (m_deadline == std::chrono::steady_clock::time_point::max())
+                    return;
+
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - std::chrono::steady_clock::now()).count();
+                auto busyTimeout = std::min<long long>(std::max<long long>(remaining, 1), primus::constants::database::query::busyTimeout);
+
+                sqlite3_busy_timeout(handle, static_cast<int>(busyTimeout));
+                sqlite3_progress_handler(handle, primus::constants::database::query::progressInterval, &QueryDeadline::onProgress, const_cast<std::chrono::steady_clock::time_point*>(&m_deadline));
+            }
+
+            void disarm(sqlite3* handle) const
+            {
+                sqlite3_progress_handler(handle, 0, nullptr, nullptr);
+            }
+
+            /**
+             * Turns an interrupted or locked out statement into the matching typed error. Other errors are left
+             * to the caller, which reports them through QueryResult::getErrorMessage()
+             */
+            void check(sqlite3* handle, const std::string& queryName) const
+            {
+                int code = sqlite3_errcode(handle);
+
+                if (code == SQLITE_INTERRUPT)
+                {
+                    OATPP_LOGW(primus::constants::databaseclient::logName, "Query '%s' interrupted after exceeding its deadline", queryName.c_str());
+                    throw QueryTimeoutError(queryName);
+                }
+
+                if (code == SQLITE_BUSY || code == SQLITE_LOCKED)
+                {
+                    OATPP_LOGW(primus::constants::databaseclient::logName, "Query '%s' gave up waiting for a database lock", queryName.c_str());
+                    throw DatabaseBusyError(queryName);
+                }
+            }
+        };
+
+        //   ___                        _____ _                            _
+        //  / _ \ _   _  ___ _ __ _   _|_   _(_)_ __ ___   ___  ___  _   _| |_ ___
+        // | | | | | | |/ _ \ '__| | | | | | | | '_ ` _ \ / _ \/ _ \| | | | __/ __|
+        // | |_| | |_| |  __/ |  | |_| | | | | | | | | | |  __/ (_) | |_| | |_\__ \
+        //  \__\_\\__,_|\___|_|   \__, | |_| |_|_| |_| |_|\___|\___/ \__,_|\__|___/
+        //                        |___/
+        /**
+         * @brief Timeout of every query by name, e.g. "getMembersWithUpcomingBirthday=2000".
+         *
+         * Overrides come from constants.hpp first and PRIMUS_DB_QUERY_TIMEOUTS second, queries without an
+         * override use PRIMUS_DB_QUERY_TIMEOUT_MS.
+         */
+        class QueryTimeouts
+        {
+        private:
+            std::chrono::milliseconds                                   m_defaultTimeout;
+            std::unordered_map<std::string, std::chrono::milliseconds>  m_timeouts;
+
+        public:
+            QueryTimeouts()
+                : m_defaultTimeout(primus::environment::getUInt("PRIMUS_DB_QUERY_TIMEOUT_MS", primus::constants::database::query::defaultTimeout))
+            {
+                parse(primus::constants::database::query::timeoutOverrides);
+                parse(primus::environment::getString("PRIMUS_DB_QUERY_TIMEOUTS", ""));
+            }
+
+            /**
+             * Adds overrides from a comma separated list of name=milliseconds pairs
+             */
+            void parse(const std::string& overrides)
+            {
+                std::istringstream stream(overrides);
+                std::string pair;
+
+                while (std::getline(stream, pair, ','))
+                {
+                    auto separator = pair.find('=');
+                    if (separator == std::string::npos || separator == 0)
+                        continue;
+
+                    char* end = nullptr;
+                    std::string value = pair.substr(separator + 1);
+                    unsigned long milliseconds = std::strtoul(value.c_str(), &end, 10);
+                    if (end == value.c_str() || *end != '\0')
+                    {
+                        OATPP_LOGW(primus::constants::databaseclient::logName, "Ignoring invalid query timeout '%s'", pair.c_str());
+                        continue;
+                    }
+
+                    m_timeouts[pair.substr(0, separator)] = std::chrono::milliseconds(milliseconds);
+                }
+            }
+
+            std::chrono::milliseconds get(const oatpp::String& queryName) const
+            {
+                if (queryName)
+                {
+                    auto found = m_timeouts.find(*queryName);
+                    if (found != m_timeouts.end())
+                        return found->second;
+                }
+                return m_defaultTimeout;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_QUERYDEADLINE_HPP
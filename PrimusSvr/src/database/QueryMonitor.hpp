@@ -0,0 +1,310 @@
+#ifndef PRIMUS_QUERYMONITOR_HPP
+#define PRIMUS_QUERYMONITOR_HPP
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "oatpp-sqlite/orm.hpp"
+
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        //   ___                        __  __             _ _
+        //  / _ \ _   _  ___ _ __ _   _|  \/  | ___  _ __ (_) |_ ___  _ __
+        // | | | | | | |/ _ \ '__| | | | |\/| |/ _ \| '_ \| | __/ _ \| '__|
+        // | |_| | |_| |  __/ |  | |_| | |  | | (_) | | | | | || (_) | |
+        //  \__\_\\__,_|\___|_|   \__, |_|  |_|\___/|_| |_|_|\__\___/|_|
+        //                        |___/
+        /**
+         * @brief Statistics of every named QUERY and a log of the slowest calls.
+         *
+         * The executor reports each finished query: time spent executing and fetching, rows returned and the
+         * time it waited for a pooled connection. Calls above the slow query threshold are kept with their
+         * bound parameters and the EXPLAIN QUERY PLAN of the statement.
+         *
+         * Plans are cached per database file and SQL text, since one named query may prepare different SQL, e.g.
+         * a column list chosen per request. An ANALYZE run through the executor can change every plan, it
+         * drops the cache.
+         */
+        class QueryMonitor
+        {
+        public:
+            static const v_uint32 BUCKET_COUNT = 14;
+
+            /**
+             * Upper bounds of the latency histogram in microseconds, the last bucket is unbounded
+             */
+            static const v_uint64* getBucketBounds()
+            {
+                static const v_uint64 bounds[BUCKET_COUNT] = {
+                    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, ~v_uint64(0)
+                };
+                return bounds;
+            }
+
+            struct Counters
+            {
+                std::atomic<v_uint64> calls;
+                std::atomic<v_uint64> failures;
+                std::atomic<v_uint64> slowCalls;
+                std::atomic<v_uint64> rows;
+                std::atomic<v_uint64> totalMicros;
+                std::atomic<v_uint64> maxMicros;
+                std::atomic<v_uint64> poolWaitMicros;
+                std::atomic<v_uint64> buckets[BUCKET_COUNT];
+
+                Counters()
+                    : calls(0), failures(0), slowCalls(0), rows(0), totalMicros(0), maxMicros(0), poolWaitMicros(0)
+                {
+                    for (auto& bucket : buckets)
+                        bucket.store(0);
+                }
+
+                /**
+                 * Upper bound of the bucket the given share of all calls falls into, e.g. 0.95 for p95
+                 */
+                v_uint64 percentile(double share) const
+                {
+                    v_uint64 total = 0;
+                    for (auto& bucket : buckets)
+                        total += bucket.load();
+                    if (total == 0)
+                        return 0;
+
+                    v_uint64 rank = static_cast<v_uint64>(share * total);
+                    v_uint64 seen = 0;
+                    for (v_uint32 i = 0; i < BUCKET_COUNT; i++)
+                    {
+                        seen += buckets[i].load();
+                        if (seen > rank)
+                            return i + 1 < BUCKET_COUNT ? getBucketBounds()[i] : maxMicros.load();
+                    }
+                    return maxMicros.load();
+                }
+            };
+
+            struct SlowQuery
+            {
+                std::string name;
+                std::string sql;
+                std::string plan;
+                v_uint64 micros;
+                v_uint64 rows;
+                v_uint64 poolWaitMicros;
+                v_int64 timestamp;
+            };
+
+        private:
+            std::mutex                                          m_lock;
+            std::map<std::string, std::unique_ptr<Counters>>    m_counters;
+            std::mutex                                          m_planLock;
+            std::map<std::string, std::string>                  m_plans;        // Database file and SQL text -> plan
+            std::mutex                                          m_slowLock;
+            std::deque<SlowQuery>                               m_slowQueries;
+            v_uint64                                            m_slowThresholdMicros;
+            std::size_t                                         m_slowLogSize;
+
+        private:
+            static std::string explain(sqlite3_stmt* statement)
+            {
+                std::string plan;
+                const char* sql = sqlite3_sql(statement);
+                if (sql == nullptr)
+                    return plan;
+
+                std::string explainSql = std::string("EXPLAIN QUERY PLAN ") + sql;
+                sqlite3_stmt* explainStatement = nullptr;
+                if (sqlite3_prepare_v2(sqlite3_db_handle(statement), explainSql.c_str(), -1, &explainStatement, nullptr) != SQLITE_OK)
+                    return plan;
+
+                while (sqlite3_step(explainStatement) == SQLITE_ROW)
+                {
+                    const unsigned char* detail = sqlite3_column_text(explainStatement, 3);
+                    if (detail == nullptr)
+                        continue;
+                    if (!plan.empty())
+                        plan.push_back('\n');
+                    plan.append(reinterpret_cast<const char*>(detail));
+                }
+
+                sqlite3_finalize(explainStatement);
+                return plan;
+            }
+
+            /**
+             * Whether or not the statement is an ANALYZE, which changes the statistics the planner chooses by
+             */
+            static bool isAnalyze(sqlite3_stmt* statement)
+            {
+                const char* sql = sqlite3_sql(statement);
+                if (sql == nullptr)
+                    return false;
+
+                while (std::isspace(static_cast<unsigned char>(*sql)))
+                    sql++;
+                return sqlite3_strnicmp(sql, "ANALYZE", 7) == 0 && !std::isalnum(static_cast<unsigned char>(sql[7])) && sql[7] != '_';
+            }
+
+            /**
+             * The plan of the statement, captured on the first slow call of its SQL text on its database
+             */
+            std::string getPlan(sqlite3_stmt* statement)
+            {
+                const char* sql = sqlite3_sql(statement);
+                const char* file = sqlite3_db_filename(sqlite3_db_handle(statement), "main");
+                if (sql == nullptr)
+                    return std::string();
+
+                std::string key = std::string(file != nullptr ? file : "") + "\n" + sql;
+
+                std::lock_guard<std::mutex> guard(m_planLock);
+                auto found = m_plans.find(key);
+                if (found != m_plans.end())
+                    return found->second;
+
+                std::string plan = explain(statement);
+                m_plans[key] = plan;
+                return plan;
+            }
+
+            static std::string expandedSql(sqlite3_stmt* statement)
+            {
+                std::string sql;
+                char* expanded = sqlite3_expanded_sql(statement);
+                if (expanded != nullptr)
+                {
+                    sql = expanded;
+                    sqlite3_free(expanded);
+                }
+                else if (sqlite3_sql(statement) != nullptr)
+                {
+                    sql = sqlite3_sql(statement);
+                }
+                return sql;
+            }
+
+        public:
+            QueryMonitor()
+                : m_slowThresholdMicros(primus::environment::getUInt("PRIMUS_DB_SLOW_QUERY_MS", primus::constants::database::monitor::slowQueryThreshold) * 1000)
+                , m_slowLogSize(primus::constants::database::monitor::slowQueryLogSize)
+            {}
+
+            /**
+             * Counters of a query. The reference stays valid for the lifetime of the monitor
+             */
+            Counters& getCounters(const std::string& name)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                auto& counters = m_counters[name];
+                if (!counters)
+                    counters.reset(new Counters());
+                return *counters;
+            }
+
+            /**
+             * Called by the executor when a query result is released, before its statement is reset
+             *
+             * @param counters Counters of the query
+             * @param name Name of the query
+             * @param statement The statement, still holding its bound parameters
+             * @param micros Time spent executing and fetching
+             * @param rows Rows fetched
+             * @param poolWaitMicros Time spent waiting for the connection
+             * @param success Whether or not the statement completed without error
+             *
+             */
+            void record(Counters& counters, const std::string& name, sqlite3_stmt* statement, v_uint64 micros, v_uint64 rows, v_uint64 poolWaitMicros, bool success)
+            {
+                counters.calls++;
+                counters.rows += rows;
+                counters.totalMicros += micros;
+                counters.poolWaitMicros += poolWaitMicros;
+                if (!success)
+                    counters.failures++;
+
+                if (success && isAnalyze(statement))
+                    forgetPlans();
+
+                v_uint64 currentMax = counters.maxMicros.load();
+                while (micros > currentMax && !counters.maxMicros.compare_exchange_weak(currentMax, micros)) {}
+
+                v_uint32 bucket = 0;
+                while (micros > getBucketBounds()[bucket])
+                    bucket++;
+                counters.buckets[bucket]++;
+
+                if (micros < m_slowThresholdMicros)
+                    return;
+
+                counters.slowCalls++;
+
+                SlowQuery slowQuery;
+                slowQuery.name = name;
+                slowQuery.sql = expandedSql(statement);
+                slowQuery.micros = micros;
+                slowQuery.rows = rows;
+                slowQuery.poolWaitMicros = poolWaitMicros;
+                slowQuery.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+                /* The plan of a statement does not change with its parameters, so it is captured once per SQL text */
+                slowQuery.plan = getPlan(statement);
+
+                OATPP_LOGW(primus::constants::database::monitor::logName, "Slow query '%s' took %lu us (%lu rows, %lu us pool wait): %s",
+                    name.c_str(), static_cast<unsigned long>(micros), static_cast<unsigned long>(rows), static_cast<unsigned long>(poolWaitMicros), slowQuery.sql.c_str());
+
+                std::lock_guard<std::mutex> guard(m_slowLock);
+                m_slowQueries.push_front(slowQuery);
+                if (m_slowQueries.size() > m_slowLogSize)
+                    m_slowQueries.pop_back();
+            }
+
+            /**
+             * Drops the cached plans, for paths running ANALYZE on a connection of their own
+             */
+            void forgetPlans()
+            {
+                std::lock_guard<std::mutex> guard(m_planLock);
+                m_plans.clear();
+            }
+
+            /**
+             * Calls the function for the counters of every query, ordered by name
+             */
+            template<class Function>
+            void forEach(Function function)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                for (auto& counters : m_counters)
+                    function(counters.first, *counters.second);
+            }
+
+            /**
+             * The slow query log, newest first
+             */
+            std::vector<SlowQuery> getSlowQueries()
+            {
+                std::lock_guard<std::mutex> guard(m_slowLock);
+                return std::vector<SlowQuery>(m_slowQueries.begin(), m_slowQueries.end());
+            }
+
+            v_uint64 getSlowThresholdMicros() const
+            {
+                return m_slowThresholdMicros;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_QUERYMONITOR_HPP
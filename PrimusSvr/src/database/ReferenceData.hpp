@@ -0,0 +1,333 @@
+#ifndef REFERENCEDATA_HPP
+#define REFERENCEDATA_HPP
+
+#include <atomic>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include "DatabaseClient.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace component
+    {
+        /**
+         * @brief Thrown if a new pricing table is incomplete or names an unknown rule or department. Answered with 400.
+         */
+        class InvalidPricingError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            InvalidPricingError(const std::string& message)
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_400, message)
+            {}
+        };
+
+        //  ____       __                              ____        _
+        // |  _ \ ___ / _| ___ _ __ ___ _ __   ___ ___|  _ \  __ _| |_ __ _
+        // | |_) / _ \ |_ / _ \ '__/ _ \ '_ \ / __/ _ \ | | |/ _` | __/ _` |
+        // |  _ <  __/  _|  __/ | |  __/ | | | (_|  __/ |_| | (_| | || (_| |
+        // |_| \_\___|_|  \___|_|  \___|_| |_|\___\___|____/ \__,_|\__\__,_|
+        /**
+         * @brief Immutable snapshot of the reference data: the departments and the pricing table.
+         *
+         * A snapshot is never changed once it is built. An update builds a new one and the ReferenceDataStore
+         * swaps it in, requests still holding the previous one finish with it.
+         */
+        class ReferenceData
+        {
+        public:
+            struct PricingRule
+            {
+                std::string rule;
+                v_uint32    departmentId;
+                v_uint32    fee;
+            };
+
+        private:
+            v_uint64                        m_generation;
+            v_int64                         m_loaded;
+            std::map<v_uint32, std::string> m_departments;
+            std::vector<PricingRule>        m_pricing;
+            std::map<v_uint32, v_uint32>    m_singleFees;
+            v_uint32                        m_noneFee;
+            v_uint32                        m_multipleFee;
+
+        public:
+            /**
+             * @throws std::runtime_error if the pricing table has no none or no multiple rule
+             */
+            ReferenceData(v_uint64 generation, const std::map<v_uint32, std::string>& departments, const std::vector<PricingRule>& pricing)
+                : m_generation(generation)
+                , m_loaded(static_cast<v_int64>(std::time(nullptr)))
+                , m_departments(departments)
+                , m_pricing(pricing)
+                , m_noneFee(0)
+                , m_multipleFee(0)
+            {
+                bool none = false;
+                bool multiple = false;
+
+                for (const PricingRule& rule : m_pricing)
+                {
+                    if (rule.rule == primus::constants::database::referencedata::noneRule)
+                    {
+                        m_noneFee = rule.fee;
+                        none = true;
+                    }
+                    else if (rule.rule == primus::constants::database::referencedata::multipleRule)
+                    {
+                        m_multipleFee = rule.fee;
+                        multiple = true;
+                    }
+                    else if (rule.rule == primus::constants::database::referencedata::singleRule)
+                        m_singleFees[rule.departmentId] = rule.fee;
+                }
+
+                if (!none || !multiple)
+                    throw std::runtime_error("[ReferenceData::ReferenceData()]: The Pricing table needs a none and a multiple rule");
+            }
+
+            /**
+             * Checks a new pricing table before it is written: exactly one none and one multiple rule and one
+             * single rule for every known department, nothing else
+             *
+             * @throws InvalidPricingError naming the first problem found
+             */
+            void validate(const std::vector<PricingRule>& pricing) const
+            {
+                v_uint32 none = 0;
+                v_uint32 multiple = 0;
+                std::set<v_uint32> single;
+
+                for (const PricingRule& rule : pricing)
+                {
+                    if (rule.rule == primus::constants::database::referencedata::noneRule)
+                        none++;
+                    else if (rule.rule == primus::constants::database::referencedata::multipleRule)
+                        multiple++;
+                    else if (rule.rule == primus::constants::database::referencedata::singleRule)
+                    {
+                        if (m_departments.find(rule.departmentId) == m_departments.end())
+                            throw InvalidPricingError("Single rule for unknown department " + std::to_string(rule.departmentId));
+                        if (!single.insert(rule.departmentId).second)
+                            throw InvalidPricingError("More than one single rule for department " + std::to_string(rule.departmentId));
+                        continue;
+                    }
+                    else
+                        throw InvalidPricingError("Unknown pricing rule '" + rule.rule + "'");
+
+                    if (rule.departmentId != 0)
+                        throw InvalidPricingError("The " + rule.rule + " rule must not name a department");
+                }
+
+                if (none != 1 || multiple != 1)
+                    throw InvalidPricingError("Exactly one none and one multiple rule are required");
+                if (single.size() != m_departments.size())
+                    throw InvalidPricingError("Every department needs a single rule");
+            }
+
+            v_uint64 getGeneration() const
+            {
+                return m_generation;
+            }
+
+            /**
+             * Unix time the snapshot was loaded
+             */
+            v_int64 getLoaded() const
+            {
+                return m_loaded;
+            }
+
+            const std::map<v_uint32, std::string>& getDepartments() const
+            {
+                return m_departments;
+            }
+
+            const std::vector<PricingRule>& getPricing() const
+            {
+                return m_pricing;
+            }
+
+            /**
+             * Name of a department, or nullptr if there is no department with this id
+             */
+            const std::string* findDepartment(const oatpp::UInt32& departmentId) const
+            {
+                if (departmentId == nullptr)
+                    return nullptr;
+                auto department = m_departments.find(*departmentId);
+                return department == m_departments.end() ? nullptr : &department->second;
+            }
+
+            /**
+             * Membership fee of a member
+             *
+             * @param departmentCount Number of departments the member belongs to
+             * @param departmentId The department if there is exactly one
+             *
+             */
+            v_uint32 calculateFee(v_uint32 departmentCount, v_uint32 departmentId) const
+            {
+                if (departmentCount < 1)
+                    return m_noneFee;
+                if (departmentCount > 1)
+                    return m_multipleFee;
+
+                auto fee = m_singleFees.find(departmentId);
+                return fee == m_singleFees.end() ? m_noneFee : fee->second;
+            }
+        };
+
+        //  ____       __                              ____        _        ____  _
+        // |  _ \ ___ / _| ___ _ __ ___ _ __   ___ ___|  _ \  __ _| |_ __ _/ ___|| |_ ___  _ __ ___
+        // | |_) / _ \ |_ / _ \ '__/ _ \ '_ \ / __/ _ \ | | |/ _` | __/ _` \___ \| __/ _ \| '__/ _ \
+        // |  _ <  __/  _|  __/ | |  __/ | | | (_|  __/ |_| | (_| | || (_| |___) | || (_) | | |  __/
+        // |_| \_\___|_|  \___|_|  \___|_| |_|\___\___|____/ \__,_|\__\__,_|____/ \__\___/|_|  \___|
+        /**
+         * @brief Holds the current ReferenceData of one database.
+         *
+         * Readers take the snapshot with an atomic load and never wait. Reloads and pricing updates are
+         * serialized, build a new snapshot and publish it with an atomic store (read-copy-update).
+         */
+        class ReferenceDataStore
+        {
+        public:
+            typedef primus::dto::database::PricingRuleDto PricingRuleDto;
+
+        private:
+            std::shared_ptr<DatabaseClient>         m_database;
+            std::shared_ptr<const ReferenceData>    m_current;
+            v_uint64                                m_generation;
+            std::mutex                              m_writeLock;
+
+        private:
+            std::shared_ptr<const ReferenceData> loadUnlocked()
+            {
+                typedef primus::dto::database::DepartmentDto DepartmentDto;
+
+                auto dbResult = m_database->getAllDepartments();
+                if (!dbResult->isSuccess())
+                    throw std::runtime_error(std::string("[ReferenceDataStore::load()]: ") + dbResult->getErrorMessage()->c_str());
+                auto departmentRows = dbResult->fetch<oatpp::Vector<oatpp::Object<DepartmentDto>>>();
+
+                dbResult = m_database->getPricingRules();
+                if (!dbResult->isSuccess())
+                    throw std::runtime_error(std::string("[ReferenceDataStore::load()]: ") + dbResult->getErrorMessage()->c_str());
+                auto pricingRows = dbResult->fetch<oatpp::Vector<oatpp::Object<PricingRuleDto>>>();
+
+                std::map<v_uint32, std::string> departments;
+                for (auto& department : *departmentRows)
+                    departments[*department->id] = department->name ? department->name->c_str() : "";
+
+                std::vector<ReferenceData::PricingRule> pricing;
+                for (auto& row : *pricingRows)
+                {
+                    ReferenceData::PricingRule rule;
+                    rule.rule = row->rule->c_str();
+                    rule.departmentId = row->departmentId ? *row->departmentId : 0;
+                    rule.fee = row->fee ? *row->fee : 0;
+                    pricing.push_back(rule);
+                }
+
+                auto referenceData = std::make_shared<const ReferenceData>(++m_generation, departments, pricing);
+                std::atomic_store(&m_current, referenceData);
+
+                OATPP_LOGI(primus::constants::database::referencedata::logName, "ReferenceData generation %lu loaded. Departments: %d, pricing rules: %d",
+                    static_cast<unsigned long>(m_generation), static_cast<int>(departments.size()), static_cast<int>(pricing.size()));
+                return referenceData;
+            }
+
+        public:
+            ReferenceDataStore(const std::shared_ptr<DatabaseClient>& database)
+                : m_database(database)
+                , m_generation(0)
+            {}
+
+            /**
+             * Reads Department and Pricing into a new snapshot and publishes it
+             *
+             * @throws std::runtime_error if the database cannot be read
+             */
+            std::shared_ptr<const ReferenceData> load()
+            {
+                std::lock_guard<std::mutex> guard(m_writeLock);
+                return loadUnlocked();
+            }
+
+            /**
+             * The current snapshot, valid for as long as the caller keeps it
+             */
+            std::shared_ptr<const ReferenceData> get() const
+            {
+                return std::atomic_load(&m_current);
+            }
+
+            /**
+             * Replaces the Pricing table in one transaction and publishes the new snapshot
+             *
+             * @throws InvalidPricingError if the table is incomplete
+             * @throws std::runtime_error if writing fails, the previous table and snapshot stay in place
+             */
+            std::shared_ptr<const ReferenceData> updatePricing(const oatpp::Vector<oatpp::Object<PricingRuleDto>>& rows)
+            {
+                if (rows == nullptr)
+                    throw InvalidPricingError("No pricing rules given");
+
+                std::vector<ReferenceData::PricingRule> pricing;
+                for (auto& row : *rows)
+                {
+                    if (row == nullptr || row->rule == nullptr || row->fee == nullptr)
+                        throw InvalidPricingError("Every pricing rule needs a rule and a fee");
+
+                    ReferenceData::PricingRule rule;
+                    rule.rule = row->rule->c_str();
+                    rule.departmentId = row->departmentId ? *row->departmentId : 0;
+                    rule.fee = *row->fee;
+                    pricing.push_back(rule);
+                }
+
+                std::lock_guard<std::mutex> guard(m_writeLock);
+
+                get()->validate(pricing);
+
+                auto transaction = m_database->beginTransaction();
+
+                auto dbResult = m_database->deletePricingRules(transaction.getConnection());
+                if (!dbResult->isSuccess())
+                    throw std::runtime_error(std::string("[ReferenceDataStore::updatePricing()]: ") + dbResult->getErrorMessage()->c_str());
+
+                for (auto& row : *rows)
+                {
+                    auto rule = PricingRuleDto::createShared();
+                    rule->rule = row->rule;
+                    rule->departmentId = row->departmentId ? row->departmentId : oatpp::UInt32(0);
+                    rule->fee = row->fee;
+
+                    dbResult = m_database->createPricingRule(rule, transaction.getConnection());
+                    if (!dbResult->isSuccess())
+                        throw std::runtime_error(std::string("[ReferenceDataStore::updatePricing()]: ") + dbResult->getErrorMessage()->c_str());
+                }
+
+                dbResult = transaction.commit();
+                if (!dbResult->isSuccess())
+                    throw std::runtime_error(std::string("[ReferenceDataStore::updatePricing()]: ") + dbResult->getErrorMessage()->c_str());
+
+                return loadUnlocked();
+            }
+        };
+
+    } // namespace component
+} // namespace primus
+
+#endif // REFERENCEDATA_HPP
@@ -0,0 +1,87 @@
+#ifndef REPORTING_CLIENT
+#define REPORTING_CLIENT
+
+#include "oatpp-sqlite/orm.hpp"
+#include "oatpp/orm/DbClient.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include "dto/ReportDtos.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace component
+    {
+#include OATPP_CODEGEN_BEGIN(DbClient) //<- Begin Codegen
+        //  ____                       _   _              ____ _ _            _
+        // |  _ \ ___ _ __   ___  _ __| |_(_)_ __   __ _ / ___| (_) ___ _ __ | |_
+        // | |_) / _ \ '_ \ / _ \| '__| __| | '_ \ / _` | |   | | |/ _ \ '_ \| __|
+        // |  _ <  __/ |_) | (_) | |  | |_| | | | | (_| | |___| | |  __/ | | | |_
+        // |_| \_\___| .__/ \___/|_|   \__|_|_| |_|\__, |\____|_|_|\___|_| |_|\__|
+        //           |_|                           |___/
+        /**
+         * @brief Client for the heavy aggregate queries of the reports.
+         *
+         * Runs against a read-only reporting snapshot, never against the live database, so it neither migrates
+         * the schema nor writes. A report scans every member and their attendances; on the snapshot it cannot
+         * hold locks or connections the member endpoints are waiting for.
+         */
+        class ReportingClient : public oatpp::orm::DbClient
+        {
+        public:
+            ReportingClient(const std::shared_ptr<oatpp::orm::Executor>& executor)
+                : oatpp::orm::DbClient(executor)
+            {}
+
+            /**
+            * Attended sessions and months of every member within a calendar year
+            *
+            * @param year The year as four digits, e.g. "2024"
+            *
+            */
+            QUERY(getAttendanceReport,
+                " SELECT Member.id AS memberId, Member.firstName, Member.lastName, "
+                " COUNT(Attendance.date) AS attendances, "
+                " COUNT(DISTINCT strftime('%m', Attendance.date + 2440587.5)) AS months "
+                " FROM Member "
+                " LEFT JOIN Attendance ON Attendance.member_id = Member.id "
+                " AND Attendance.date >= CAST(julianday(:year || '-01-01') - 2440587.5 AS INTEGER) "
+                " AND Attendance.date < CAST(julianday(:year || '-01-01', '+1 year') - 2440587.5 AS INTEGER) "
+                " GROUP BY Member.id "
+                " ORDER BY Member.lastName, Member.firstName;",
+                PARAM(oatpp::String, year));
+
+            /**
+            * Department count and lowest department of every active member, the fee is derived from both
+            */
+            QUERY(getFeeRunReport,
+                " SELECT Member.id AS memberId, Member.firstName, Member.lastName, "
+                " COUNT(Department_Member.department_id) AS departmentCount, "
+                " MIN(Department_Member.department_id) AS departmentId "
+                " FROM Member "
+                " LEFT JOIN Department_Member ON Department_Member.member_id = Member.id "
+                " WHERE Member.active = 1 "
+                " GROUP BY Member.id "
+                " ORDER BY Member.lastName, Member.firstName;");
+
+            /**
+            * Attended sessions and months of every active member within the last year, same rules as
+            * canMemberBuyWeapon of the MemberController
+            */
+            QUERY(getWeaponPurchaseReport,
+                " SELECT Member.id AS memberId, Member.firstName, Member.lastName, "
+                " COUNT(Attendance.date) AS attendances, "
+                " COUNT(DISTINCT strftime('%m', Attendance.date + 2440587.5)) AS months "
+                " FROM Member "
+                " LEFT JOIN Attendance ON Attendance.member_id = Member.id AND Attendance.date >= CAST(julianday('now', '-1 year') - 2440587.5 AS INTEGER) "
+                " WHERE Member.active = 1 "
+                " GROUP BY Member.id "
+                " ORDER BY Member.lastName, Member.firstName;");
+        };
+
+#include OATPP_CODEGEN_END(DbClient) ///< End code-gen section
+
+    } // namespace component
+} // namespace primus
+
+#endif //REPORTING_CLIENT
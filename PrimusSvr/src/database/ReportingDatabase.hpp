@@ -0,0 +1,405 @@
+#ifndef PRIMUS_REPORTINGDATABASE_HPP
+#define PRIMUS_REPORTINGDATABASE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "oatpp-sqlite/orm.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include "BackupService.hpp"
+#include "Executor.hpp"
+#include "QueryMonitor.hpp"
+#include "ReportingClient.hpp"
+#include "filesystemHelper.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        /**
+         * @brief Thrown if a report is requested before the first reporting snapshot was taken. Answered with 503.
+         */
+        class ReportingUnavailableError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            ReportingUnavailableError()
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_503, "The reporting snapshot is not available yet")
+            {}
+        };
+
+        //  ____                _  ___        _        ____                            _   _             ____                 _     _
+        // |  _ \ ___  __ _  __| |/ _ \ _ __ | |_   _ / ___|___  _ __  _ __   ___  ___| |_(_) ___  _ __ |  _ \ _ __ _____   _(_) __| | ___ _ __
+        // | |_) / _ \/ _` |/ _` | | | | '_ \| | | | | |   / _ \| '_ \| '_ \ / _ \/ __| __| |/ _ \| '_ \| |_) | '__/ _ \ \ / / |/ _` |/ _ \ '__|
+        // |  _ <  __/ (_| | (_| | |_| | | | | | |_| | |__| (_) | | | | | | |  __/ (__| |_| | (_) | | | |  __/| | | (_) \ V /| | (_| |  __/ |
+        // |_| \_\___|\__,_|\__,_|\___/|_| |_|_|\__, |\____\___/|_| |_|_| |_|\___|\___|\__|_|\___/|_| |_|_|   |_|  \___/ \_/ |_|\__,_|\___|_|
+        //                                      |___/
+        /**
+         * @brief Opens a reporting snapshot read-only and immutable.
+         *
+         * With immutable=1 sqlite skips all file locking and change detection, which is only correct because a
+         * snapshot file is never written again once it carries its final name. The whole file is mapped into
+         * memory, so repeated reports are served from the page cache without read() calls.
+         */
+        class ReadOnlyConnectionProvider : public oatpp::provider::Provider<oatpp::sqlite::Connection>
+        {
+        private:
+            class ConnectionInvalidator : public oatpp::provider::Invalidator<oatpp::sqlite::Connection>
+            {
+            public:
+                void invalidate(const std::shared_ptr<oatpp::sqlite::Connection>& connection) override
+                {
+                    /* The connection closes its handle when the last reference is gone */
+                    (void) connection;
+                }
+            };
+
+            std::string                                 m_uri;
+            v_uint64                                    m_mmapSize;
+            std::shared_ptr<ConnectionInvalidator>      m_invalidator;
+
+            static std::string toUri(const std::string& file)
+            {
+                std::string uri = "file:";
+                for (char c : file)
+                {
+                    if (c == '?')
+                        uri.append("%3f");
+                    else if (c == '#')
+                        uri.append("%23");
+                    else if (c == '%')
+                        uri.append("%25");
+                    else
+                        uri.push_back(c);
+                }
+                return uri + "?mode=ro&immutable=1";
+            }
+
+        public:
+            ReadOnlyConnectionProvider(const std::string& file, v_uint64 mmapSize)
+                : m_uri(toUri(file))
+                , m_mmapSize(mmapSize)
+                , m_invalidator(std::make_shared<ConnectionInvalidator>())
+            {}
+
+            oatpp::provider::ResourceHandle<oatpp::sqlite::Connection> get() override
+            {
+                sqlite3* handle = nullptr;
+                if (sqlite3_open_v2(m_uri.c_str(), &handle, SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, nullptr) != SQLITE_OK)
+                {
+                    std::string message = handle ? sqlite3_errmsg(handle) : "out of memory";
+                    sqlite3_close(handle);
+                    throw std::runtime_error("[ReadOnlyConnectionProvider::get()]: Can't open " + m_uri + ": " + message);
+                }
+
+                std::string mmap = "PRAGMA mmap_size = " + std::to_string(m_mmapSize) + ";";
+                sqlite3_exec(handle, mmap.c_str(), nullptr, nullptr, nullptr);
+
+                return oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>(std::make_shared<oatpp::sqlite::ConnectionImpl>(handle), m_invalidator);
+            }
+
+            oatpp::async::CoroutineStarterForResult<const oatpp::provider::ResourceHandle<oatpp::sqlite::Connection>&> getAsync() override
+            {
+                throw std::runtime_error("[ReadOnlyConnectionProvider::getAsync()]: Error. Not implemented!");
+            }
+
+            void stop() override
+            {}
+        };
+
+        //  ____                       _   _             ____                        _           _
+        // |  _ \ ___ _ __   ___  _ __| |_(_)_ __   __ _/ ___| _ __   __ _ _ __  ___| |__   ___ | |_
+        // | |_) / _ \ '_ \ / _ \| '__| __| | '_ \ / _` \___ \| '_ \ / _` | '_ \/ __| '_ \ / _ \| __|
+        // |  _ <  __/ |_) | (_) | |  | |_| | | | | (_| |___) | | | | (_| | |_) \__ \ | | | (_) | |_
+        // |_| \_\___| .__/ \___/|_|   \__|_|_| |_|\__, |____/|_| |_|\__,_| .__/|___/_| |_|\___/ \__|
+        //           |_|                           |___/                  |_|
+        /**
+         * @brief One generation of the reporting database: the snapshot file, its connection pool and client.
+         *
+         * Requests keep the generation they started with alive. The last one to let go stops the pool and
+         * removes the file, a refresh therefore never pulls the data from under a running report.
+         */
+        class ReportingSnapshot
+        {
+        private:
+            std::string                                                                 m_file;
+            v_uint64                                                                    m_generation;
+            v_int64                                                                     m_created;
+            std::shared_ptr<oatpp::provider::Provider<oatpp::sqlite::Connection>>       m_pool;
+            std::shared_ptr<primus::component::ReportingClient>                         m_client;
+
+        public:
+            ReportingSnapshot(const std::string& file, v_uint64 generation, v_int64 created, v_uint32 maxConnections,
+                              std::chrono::seconds connectionTtl, v_uint64 mmapSize, const std::shared_ptr<QueryMonitor>& monitor)
+                : m_file(file)
+                , m_generation(generation)
+                , m_created(created)
+            {
+                auto provider = std::make_shared<ReadOnlyConnectionProvider>(file, mmapSize);
+                m_pool = oatpp::sqlite::ConnectionPool::createShared(provider, maxConnections, connectionTtl);
+
+                /* Same executor as the live database: deadlines per query and statistics in the QueryMonitor */
+                m_client = std::make_shared<primus::component::ReportingClient>(std::make_shared<Executor>(m_pool, monitor));
+            }
+
+            ReportingSnapshot(const ReportingSnapshot&) = delete;
+            ReportingSnapshot& operator=(const ReportingSnapshot&) = delete;
+
+            ~ReportingSnapshot()
+            {
+                m_client.reset();
+                m_pool->stop();
+                std::remove(m_file.c_str());
+            }
+
+            const std::shared_ptr<primus::component::ReportingClient>& getClient() const
+            {
+                return m_client;
+            }
+
+            v_uint64 getGeneration() const
+            {
+                return m_generation;
+            }
+
+            /**
+             * Unix time the snapshot was taken
+             */
+            v_int64 getCreated() const
+            {
+                return m_created;
+            }
+
+            /**
+             * Seconds since the snapshot was taken
+             */
+            v_int64 getAge() const
+            {
+                return static_cast<v_int64>(std::time(nullptr)) - m_created;
+            }
+        };
+
+        //  ____                       _   _             ____        _        _
+        // |  _ \ ___ _ __   ___  _ __| |_(_)_ __   __ _|  _ \  __ _| |_ __ _| |__   __ _ ___  ___
+        // | |_) / _ \ '_ \ / _ \| '__| __| | '_ \ / _` | | | |/ _` | __/ _` | '_ \ / _` / __|/ _ \
+        // |  _ <  __/ |_) | (_) | |  | |_| | | | | (_| | |_| | (_| | || (_| | |_) | (_| \__ \  __/
+        // |_| \_\___| .__/ \___/|_|   \__|_|_| |_|\__, |____/ \__,_|\__\__,_|_.__/ \__,_|___/\___|
+        //           |_|                           |___/
+        /**
+         * @brief Read-only copy of the database for the analytics endpoints.
+         *
+         * Reports aggregate over every member and attendance. Run on the live database they would hold
+         * pooled connections for seconds and compete with the member endpoints for the file. Instead they read
+         * from a snapshot taken with the backup API (see BackupService::copy), opened immutable through a
+         * pool of its own. The snapshot is replaced periodically; a report states how old its data is.
+         */
+        class ReportingDatabase
+        {
+        public:
+            struct Configuration
+            {
+                std::string databaseFile;
+                std::string directory;
+                std::chrono::minutes refreshInterval;
+                v_uint32 maxConnections;
+                std::chrono::seconds connectionTtl;
+                v_uint64 mmapSize;
+                int pagesPerStep;
+                std::chrono::milliseconds stepPause;
+
+                static Configuration fromEnvironment(const std::string& databaseFile, const std::string& directory)
+                {
+                    namespace defaults = primus::constants::database::reporting;
+
+                    Configuration configuration;
+                    configuration.databaseFile = databaseFile;
+                    configuration.directory = primus::environment::getString("PRIMUS_REPORTING_DIRECTORY", directory);
+                    configuration.refreshInterval = std::chrono::minutes(std::max<unsigned long>(1, primus::environment::getUInt("PRIMUS_REPORTING_REFRESH_MINUTES", defaults::refreshMinutes)));
+                    configuration.maxConnections = static_cast<v_uint32>(std::max<unsigned long>(1, primus::environment::getUInt("PRIMUS_REPORTING_POOL_SIZE", defaults::maxConnections)));
+                    configuration.connectionTtl = std::chrono::seconds(defaults::connectionTtl);
+                    configuration.mmapSize = primus::environment::getUInt("PRIMUS_REPORTING_MMAP_BYTES", defaults::mmapSize);
+                    configuration.pagesPerStep = static_cast<int>(primus::environment::getUInt("PRIMUS_BACKUP_PAGES_PER_STEP", primus::constants::database::backup::pagesPerStep));
+                    configuration.stepPause = std::chrono::milliseconds(primus::environment::getUInt("PRIMUS_BACKUP_STEP_PAUSE_MS", primus::constants::database::backup::stepPause));
+
+                    if (configuration.pagesPerStep <= 0)
+                        configuration.pagesPerStep = 1;
+
+                    return configuration;
+                }
+            };
+
+        private:
+            Configuration                           m_configuration;
+            std::shared_ptr<QueryMonitor>           m_monitor;
+            std::shared_ptr<ReportingSnapshot>      m_current;
+            std::atomic<v_uint64>                   m_generation;
+            std::mutex                              m_refreshLock;
+            std::mutex                              m_scheduleLock;
+            std::condition_variable                 m_scheduleCondition;
+            std::atomic<bool>                       m_running;
+            std::thread                             m_scheduler;
+
+        private:
+            static bool isSnapshot(const std::string& name)
+            {
+                const std::string prefix = primus::constants::database::reporting::filePrefix;
+                return name.size() > prefix.size() && name.compare(0, prefix.size(), prefix) == 0;
+            }
+
+            /**
+             * Removes snapshots (and half written ones) a previous run left behind
+             */
+            void removeStale()
+            {
+                for (const auto& name : primus::component::filesystem::listDirectory(m_configuration.directory))
+                {
+                    if (isSnapshot(name))
+                        std::remove((m_configuration.directory + "/" + name).c_str());
+                }
+            }
+
+            void schedule()
+            {
+                std::unique_lock<std::mutex> guard(m_scheduleLock);
+
+                while (m_running)
+                {
+                    m_scheduleCondition.wait_for(guard, m_configuration.refreshInterval);
+                    if (!m_running)
+                        break;
+
+                    guard.unlock();
+                    try
+                    {
+                        refresh();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        OATPP_LOGE(primus::constants::database::reporting::logName, "Refreshing the reporting snapshot failed: %s", e.what());
+                    }
+                    guard.lock();
+                }
+            }
+
+        public:
+            ReportingDatabase(const Configuration& configuration, const std::shared_ptr<QueryMonitor>& monitor)
+                : m_configuration(configuration)
+                , m_monitor(monitor)
+                , m_generation(0)
+                , m_running(false)
+            {
+                primus::component::filesystem::makeDirectory(m_configuration.directory);
+                removeStale();
+            }
+
+            ~ReportingDatabase()
+            {
+                stop();
+            }
+
+            /**
+             * Starts the thread replacing the snapshot every refresh interval
+             */
+            void start()
+            {
+                if (m_running.exchange(true))
+                    return;
+
+                OATPP_LOGI(primus::constants::database::reporting::logName, "Refreshing the reporting snapshot every %ld min into %s",
+                    static_cast<long>(m_configuration.refreshInterval.count()), m_configuration.directory.c_str());
+                m_scheduler = std::thread(&ReportingDatabase::schedule, this);
+            }
+
+            void stop()
+            {
+                if (!m_running.exchange(false))
+                    return;
+
+                m_scheduleCondition.notify_all();
+                if (m_scheduler.joinable())
+                    m_scheduler.join();
+            }
+
+            /**
+             * Takes a new snapshot and switches all following reports to it. Reports already running finish on
+             * the previous snapshot
+             *
+             * @return The new snapshot
+             *
+             */
+            std::shared_ptr<ReportingSnapshot> refresh()
+            {
+                std::lock_guard<std::mutex> guard(m_refreshLock);
+
+                auto started = std::chrono::steady_clock::now();
+                v_uint64 generation = ++m_generation;
+                std::string file = m_configuration.directory + "/" + primus::constants::database::reporting::filePrefix + std::to_string(generation) + primus::constants::database::reporting::fileSuffix;
+                std::string temporary = file + ".tmp";
+
+                v_int32 pages = 0;
+                v_int32 steps = 0;
+                try
+                {
+                    BackupService::copy(m_configuration.databaseFile, temporary, m_configuration.pagesPerStep, m_configuration.stepPause, pages, steps);
+                }
+                catch (...)
+                {
+                    std::remove(temporary.c_str());
+                    throw;
+                }
+
+                /* The copy is consistent as of its last step */
+                v_int64 created = static_cast<v_int64>(std::time(nullptr));
+
+                /* Immutable connections must never see the file change, so it is only opened under its final name */
+                if (std::rename(temporary.c_str(), file.c_str()) != 0)
+                {
+                    std::remove(temporary.c_str());
+                    throw std::runtime_error("[ReportingDatabase::refresh()]: Can't rename snapshot to " + file);
+                }
+
+                auto snapshot = std::make_shared<ReportingSnapshot>(file, generation, created, m_configuration.maxConnections,
+                    m_configuration.connectionTtl, m_configuration.mmapSize, m_monitor);
+                std::atomic_store(&m_current, snapshot);
+
+                OATPP_LOGI(primus::constants::database::reporting::logName, "Reporting snapshot %lu taken: %d pages in %ld ms",
+                    static_cast<unsigned long>(generation), pages,
+                    static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count()));
+
+                return snapshot;
+            }
+
+            /**
+             * The current snapshot. Hold on to it for the whole report, so every query reads the same data
+             *
+             * @throws ReportingUnavailableError if no snapshot was taken yet
+             *
+             */
+            std::shared_ptr<ReportingSnapshot> acquire() const
+            {
+                auto snapshot = std::atomic_load(&m_current);
+                if (!snapshot)
+                    throw ReportingUnavailableError();
+                return snapshot;
+            }
+
+            const Configuration& getConfiguration() const
+            {
+                return m_configuration;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_REPORTINGDATABASE_HPP
@@ -0,0 +1,304 @@
+#ifndef PRIMUS_ROWARENA_HPP
+#define PRIMUS_ROWARENA_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "oatpp/core/Types.hpp"
+
+#include "Executor.hpp"
+#include "dto/DatabaseDtos.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        //     _
+        //    / \   _ __ ___ _ __   __ _
+        //   / _ \ | '__/ _ \ '_ \ / _` |
+        //  / ___ \| | |  __/ | | | (_| |
+        // /_/   \_\_|  \___|_| |_|\__,_|
+        /**
+         * @brief Monotonic allocator for the text of decoded rows.
+         *
+         * Memory is handed out from chunks and only returned when the arena goes away, so decoding a page
+         * costs one allocation per chunk instead of one per field. An arena belongs to a single request.
+         */
+        class Arena
+        {
+        private:
+            struct Chunk
+            {
+                std::unique_ptr<char[]> data;
+                std::size_t             size;
+                std::size_t             used;
+            };
+
+            std::vector<Chunk>  m_chunks;
+            std::size_t         m_chunkSize;
+            std::size_t         m_bytes;
+
+        public:
+            /**
+             * @param chunkSize Size of the first and every further chunk, a larger value is taken for larger copies
+             */
+            explicit Arena(std::size_t chunkSize = primus::constants::database::arena::chunkSize)
+                : m_chunkSize(std::max<std::size_t>(chunkSize, 1))
+                , m_bytes(0)
+            {}
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            /**
+             * Copies size bytes into the arena, valid as long as the arena lives
+             */
+            const char* copy(const void* data, std::size_t size)
+            {
+                if (size == 0)
+                    return "";
+
+                if (m_chunks.empty() || m_chunks.back().size - m_chunks.back().used < size)
+                {
+                    Chunk chunk;
+                    chunk.size = std::max(m_chunkSize, size);
+                    chunk.data.reset(new char[chunk.size]);
+                    chunk.used = 0;
+                    m_chunks.push_back(std::move(chunk));
+                }
+
+                Chunk& chunk = m_chunks.back();
+                char* target = chunk.data.get() + chunk.used;
+                std::memcpy(target, data, size);
+                chunk.used += size;
+                m_bytes += size;
+                return target;
+            }
+
+            /**
+             * Chunks allocated so far, each one a single heap allocation
+             */
+            std::size_t getChunkCount() const
+            {
+                return m_chunks.size();
+            }
+
+            std::size_t getBytesUsed() const
+            {
+                return m_bytes;
+            }
+        };
+
+        /**
+         * @brief Text column of a decoded row, owned by an Arena. A null data pointer is SQL NULL.
+         */
+        struct TextView
+        {
+            const char* data;
+            v_uint32    size;
+
+            TextView() : data(nullptr), size(0) {}
+
+            explicit operator bool() const
+            {
+                return data != nullptr;
+            }
+        };
+
+        /**
+         * @brief Value column of a decoded row, not present for SQL NULL.
+         */
+        template<class T>
+        struct ValueView
+        {
+            T       value;
+            bool    present;
+
+            ValueView() : value(), present(false) {}
+            ValueView(T v) : value(v), present(true) {}
+
+            explicit operator bool() const
+            {
+                return present;
+            }
+        };
+
+        /**
+         * Wraps an optional oatpp::UInt32, e.g. a query parameter
+         */
+        inline ValueView<v_uint32> valueOf(const oatpp::UInt32& value)
+        {
+            return value ? ValueView<v_uint32>(*value) : ValueView<v_uint32>();
+        }
+
+        //  __  __                _               ____
+        // |  \/  | ___ _ __ ___ | |__   ___ _ __|  _ \ _____      __
+        // | |\/| |/ _ \ '_ ` _ \| '_ \ / _ \ '__| |_) / _ \ \ /\ / /
+        // | |  | |  __/ | | | | | |_) |  __/ |  |  _ < (_) \ V  V /
+        // |_|  |_|\___|_| |_| |_|_.__/ \___|_|  |_| \_\___/ \_/\_/
+        /**
+         * @brief A row of MemberView decoded without a MemberDto, see RowDecoder.
+         *
+         * Lists the same fields under the same names as the MemberDto, so it encodes to the same JSON.
+         */
+        struct MemberRow
+        {
+            typedef primus::dto::database::MemberDto Dto;
+
+            ValueView<v_uint32> id;
+            TextView            firstName;
+            TextView            lastName;
+            TextView            email;
+            TextView            phoneNumber;
+            TextView            birthDate;
+            TextView            createDate;
+            TextView            notes;
+            ValueView<bool>     active;
+
+            /**
+             * Calls visitor(name, field) for every field, in the order of the MemberDto
+             */
+            template<class Row, class Visitor>
+            static void visit(Row& row, Visitor& visitor)
+            {
+                visitor("id", row.id);
+                visitor("firstName", row.firstName);
+                visitor("lastName", row.lastName);
+                visitor("email", row.email);
+                visitor("phoneNumber", row.phoneNumber);
+                visitor("birthDate", row.birthDate);
+                visitor("createDate", row.createDate);
+                visitor("notes", row.notes);
+                visitor("active", row.active);
+            }
+        };
+
+        /**
+         * @brief A page of decoded rows, the flat counterpart of primus::dto::PageDto.
+         */
+        template<class RowT>
+        struct RowPage
+        {
+            ValueView<v_uint32> offset;
+            ValueView<v_uint32> limit;
+            ValueView<v_uint32> count;
+            std::vector<RowT>   items;
+
+            template<class Page, class Visitor>
+            static void visit(Page& page, Visitor& visitor)
+            {
+                visitor("offset", page.offset);
+                visitor("limit", page.limit);
+                visitor("count", page.count);
+                visitor("items", page.items);
+            }
+        };
+
+        //  ____               ____                     _
+        // |  _ \ _____      _|  _ \  ___  ___ ___   __| | ___ _ __
+        // | |_) / _ \ \ /\ / / | | |/ _ \/ __/ _ \ / _` |/ _ \ '__|
+        // |  _ < (_) \ V  V /| |_| |  __/ (_| (_) | (_| |  __/ |
+        // |_| \_\___/ \_/\_/ |____/ \___|\___\___/ \__,_|\___|_|
+        /**
+         * @brief Decodes the rows of a query straight from its statement into flat rows whose text lives in
+         * an Arena.
+         *
+         * Columns are matched to the fields of the row by name once, a field without a column stays null
+         * (like the fields a ?fields= projection does not select). NULL columns stay null, integers are read
+         * as such, text is copied into the arena.
+         */
+        template<class RowT>
+        class RowDecoder
+        {
+        private:
+            CachedQueryResult&  m_result;
+            Arena&              m_arena;
+            std::vector<int>    m_columns;      // Column of each field of the row, -1 if the query has none
+            sqlite3_stmt*       m_statement;
+            std::size_t         m_field;
+
+            struct ColumnResolver
+            {
+                const CachedQueryResult&    result;
+                std::vector<int>&           columns;
+
+                template<class Field>
+                void operator()(const char* name, Field&)
+                {
+                    columns.push_back(result.getColumnIndex(name));
+                }
+            };
+
+            int nextColumn()
+            {
+                int column = m_columns[m_field++];
+                return column >= 0 && sqlite3_column_type(m_statement, column) != SQLITE_NULL ? column : -1;
+            }
+
+        public:
+            RowDecoder(CachedQueryResult& result, Arena& arena)
+                : m_result(result)
+                , m_arena(arena)
+                , m_statement(nullptr)
+                , m_field(0)
+            {
+                RowT row;
+                ColumnResolver resolver = { result, m_columns };
+                RowT::visit(row, resolver);
+            }
+
+            void operator()(const char*, TextView& field)
+            {
+                int column = nextColumn();
+                if (column < 0)
+                    return;
+
+                const unsigned char* text = sqlite3_column_text(m_statement, column);
+                v_uint32 size = static_cast<v_uint32>(sqlite3_column_bytes(m_statement, column));
+                field.data = m_arena.copy(text, size);
+                field.size = size;
+            }
+
+            void operator()(const char*, ValueView<v_uint32>& field)
+            {
+                int column = nextColumn();
+                if (column >= 0)
+                    field = ValueView<v_uint32>(static_cast<v_uint32>(sqlite3_column_int64(m_statement, column)));
+            }
+
+            void operator()(const char*, ValueView<bool>& field)
+            {
+                int column = nextColumn();
+                if (column >= 0)
+                    field = ValueView<bool>(sqlite3_column_int64(m_statement, column) != 0);
+            }
+
+            /**
+             * Decodes every remaining row of the result
+             *
+             * @param expected Rows to reserve room for, e.g. the limit of the page
+             */
+            std::vector<RowT> decode(std::size_t expected)
+            {
+                std::vector<RowT> rows;
+                rows.reserve(expected);
+
+                m_result.forEachRow([&](sqlite3_stmt* statement) {
+                    m_statement = statement;
+                    m_field = 0;
+                    rows.push_back(RowT());
+                    RowT::visit(rows.back(), *this);
+                });
+                return rows;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_ROWARENA_HPP
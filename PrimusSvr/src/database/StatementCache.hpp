@@ -0,0 +1,263 @@
+#ifndef PRIMUS_STATEMENTCACHE_HPP
+#define PRIMUS_STATEMENTCACHE_HPP
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "oatpp-sqlite/orm.hpp"
+
+namespace primus
+{
+    namespace database
+    {
+        /**
+         * @brief Counters of all statement caches, shared by every pooled connection.
+         */
+        struct StatementCacheMetrics
+        {
+            std::atomic<v_uint64> hits;
+            std::atomic<v_uint64> misses;
+            std::atomic<v_uint64> evictions;
+            std::atomic<v_uint64> bypasses;
+            std::atomic<v_int64>  cached;
+
+            StatementCacheMetrics()
+                : hits(0), misses(0), evictions(0), bypasses(0), cached(0)
+            {}
+        };
+
+        //  ____  _        _                            _    ____           _
+        // / ___|| |_ __ _| |_ ___ _ __ ___   ___ _ __ | |_ / ___|__ _  ___| |__   ___
+        // \___ \| __/ _` | __/ _ \ '_ ` _ \ / _ \ '_ \| __| |   / _` |/ __| '_ \ / _ \
+        //  ___) | || (_| | ||  __/ | | | | |  __/ | | | |_| |__| (_| | (__| | | |  __/
+        // |____/ \__\__,_|\__\___|_| |_| |_|\___|_| |_|\__|\____\__,_|\___|_| |_|\___|
+        /**
+         * @brief Prepared statements of one sqlite connection, keyed by the prepared query template.
+         *
+         * A connection is only used by one thread at a time, so the cache needs no lock of its own.
+         * Statements are handed out with acquire() and given back with release(), which resets them and clears
+         * their bindings. If a statement is still in use (a second result of the same query on the same
+         * connection) a private statement is prepared and finalized on release.
+         */
+        class StatementCache
+        {
+        private:
+            struct Entry
+            {
+                std::string sql;
+                sqlite3_stmt* statement;
+                bool inUse;
+            };
+
+            typedef std::list<Entry> LruList;
+
+            sqlite3*                                                m_handle;
+            std::size_t                                             m_capacity;
+            std::shared_ptr<StatementCacheMetrics>                  m_metrics;
+            LruList                                                 m_lru;
+            std::unordered_map<std::string, LruList::iterator>      m_index;
+
+        private:
+            /**
+             * Finalizes least recently used statements until there is room for one more.
+             * Statements in use are skipped, so the cache may exceed its capacity for a moment
+             */
+            void evict()
+            {
+                auto it = m_lru.end();
+                while (m_lru.size() >= m_capacity && it != m_lru.begin())
+                {
+                    --it;
+                    if (it->inUse)
+                        continue;
+
+                    sqlite3_finalize(it->statement);
+                    m_index.erase(it->sql);
+                    it = m_lru.erase(it);
+                    m_metrics->evictions++;
+                    m_metrics->cached--;
+                }
+            }
+
+        public:
+            StatementCache(sqlite3* handle, std::size_t capacity, const std::shared_ptr<StatementCacheMetrics>& metrics)
+                : m_handle(handle)
+                , m_capacity(capacity)
+                , m_metrics(metrics)
+            {}
+
+            StatementCache(const StatementCache&) = delete;
+            StatementCache& operator=(const StatementCache&) = delete;
+
+            ~StatementCache()
+            {
+                clear();
+            }
+
+            /**
+             * Returns a statement for the query, preparing it only if it is not cached yet
+             *
+             * @param sql The prepared query template
+             * @param cached Set to true if the statement belongs to the cache and has to be given back with release()
+             *
+             */
+            sqlite3_stmt* acquire(const std::string& sql, bool& cached)
+            {
+                auto found = m_index.find(sql);
+                if (found != m_index.end())
+                {
+                    if (!found->second->inUse)
+                    {
+                        m_lru.splice(m_lru.begin(), m_lru, found->second);
+                        found->second->inUse = true;
+                        m_metrics->hits++;
+                        cached = true;
+                        return found->second->statement;
+                    }
+
+                    m_metrics->bypasses++;
+                    cached = false;
+                    sqlite3_stmt* statement = nullptr;
+                    sqlite3_prepare_v2(m_handle, sql.c_str(), static_cast<int>(sql.size()), &statement, nullptr);
+                    return statement;
+                }
+
+                m_metrics->misses++;
+                sqlite3_stmt* statement = nullptr;
+                if (sqlite3_prepare_v2(m_handle, sql.c_str(), static_cast<int>(sql.size()), &statement, nullptr) != SQLITE_OK || m_capacity == 0)
+                {
+                    cached = false;
+                    return statement;
+                }
+
+                evict();
+
+                Entry entry;
+                entry.sql = sql;
+                entry.statement = statement;
+                entry.inUse = true;
+                m_lru.push_front(entry);
+                m_index[sql] = m_lru.begin();
+                m_metrics->cached++;
+
+                cached = true;
+                return statement;
+            }
+
+            /**
+             * Gives a statement back. Cached statements are reset for the next use, all others are finalized
+             */
+            void release(sqlite3_stmt* statement, bool cached)
+            {
+                if (!cached)
+                {
+                    sqlite3_finalize(statement);
+                    return;
+                }
+
+                sqlite3_reset(statement);
+                sqlite3_clear_bindings(statement);
+
+                for (auto& entry : m_lru)
+                {
+                    if (entry.statement == statement)
+                    {
+                        entry.inUse = false;
+                        return;
+                    }
+                }
+
+                /* The cache was cleared while the statement was in use */
+                sqlite3_finalize(statement);
+            }
+
+            /**
+             * Finalizes every cached statement. Has to happen before the connection is closed
+             */
+            void clear()
+            {
+                for (auto& entry : m_lru)
+                    sqlite3_finalize(entry.statement);
+                m_metrics->cached -= static_cast<v_int64>(m_lru.size());
+                m_lru.clear();
+                m_index.clear();
+            }
+
+            std::size_t size() const
+            {
+                return m_lru.size();
+            }
+        };
+
+        //  ____  _        _                            _    ____           _          ____            _     _
+        // / ___|| |_ __ _| |_ ___ _ __ ___   ___ _ __ | |_ / ___|__ _  ___| |__   ___|  _ \ ___  __ _(_)___| |_ _ __ _   _
+        // \___ \| __/ _` | __/ _ \ '_ ` _ \ / _ \ '_ \| __| |   / _` |/ __| '_ \ / _ \ |_) / _ \/ _` | / __| __| '__| | | |
+        //  ___) | || (_| | ||  __/ | | | | |  __/ | | | |_| |__| (_| | (__| | | |  __/  _ <  __/ (_| | \__ \ |_| |  | |_| |
+        // |____/ \__\__,_|\__\___|_| |_| |_|\___|_| |_|\__|\____\__,_|\___|_| |_|\___|_| \_\___|\__, |_|___/\__|_|   \__, |
+        //                                                                                        |___/                |___/
+        /**
+         * @brief Finds the statement cache of a connection by its sqlite handle.
+         *
+         * The oatpp ConnectionPool hides the physical connection behind its own proxy, so the cache cannot be
+         * reached through the connection object. Caches are registered when a connection is opened and
+         * removed (and finalized) right before it is closed.
+         */
+        class StatementCacheRegistry
+        {
+        private:
+            std::mutex                                                      m_lock;
+            std::unordered_map<sqlite3*, std::shared_ptr<StatementCache>>   m_caches;
+            std::shared_ptr<StatementCacheMetrics>                          m_metrics;
+            std::size_t                                                     m_capacity;
+
+        public:
+            StatementCacheRegistry(std::size_t capacity)
+                : m_metrics(std::make_shared<StatementCacheMetrics>())
+                , m_capacity(capacity)
+            {}
+
+            void open(sqlite3* handle)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_caches[handle] = std::make_shared<StatementCache>(handle, m_capacity, m_metrics);
+            }
+
+            void close(sqlite3* handle)
+            {
+                std::shared_ptr<StatementCache> cache;
+                {
+                    std::lock_guard<std::mutex> guard(m_lock);
+                    auto found = m_caches.find(handle);
+                    if (found == m_caches.end())
+                        return;
+                    cache = found->second;
+                    m_caches.erase(found);
+                }
+                cache->clear();
+            }
+
+            std::shared_ptr<StatementCache> find(sqlite3* handle)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                auto found = m_caches.find(handle);
+                return found == m_caches.end() ? nullptr : found->second;
+            }
+
+            const std::shared_ptr<StatementCacheMetrics>& getMetrics() const
+            {
+                return m_metrics;
+            }
+
+            std::size_t getCapacity() const
+            {
+                return m_capacity;
+            }
+        };
+
+    } // namespace database
+} // namespace primus
+
+#endif // PRIMUS_STATEMENTCACHE_HPP
@@ -0,0 +1,592 @@
+#ifndef ADMINDTOS_HPP
+#define ADMINDTOS_HPP
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include "DatabaseDtos.hpp"
+
+namespace primus
+{
+    namespace dto
+    {
+        namespace admin
+        {
+#include OATPP_CODEGEN_BEGIN(DTO)
+            //  ____             _ ____  _        _   _     _   _          ____  _
+            // |  _ \ ___   ___ | / ___|| |_ __ _| |_(_)___| |_(_) ___ ___|  _ \| |_ ___
+            // | |_) / _ \ / _ \| \___ \| __/ _` | __| / __| __| |/ __/ __| | | | __/ _ \
+            // |  __/ (_) | (_) | |___) | || (_| | |_| \__ \ |_| | (__\__ \ |_| | || (_) |
+            // |_|   \___/ \___/|_|____/ \__\__,_|\__|_|___/\__|_|\___|___/____/ \__\___/
+            /**
+             * @brief DTO class representing the state of the database connection pool.
+             */
+            class PoolStatisticsDto : public oatpp::DTO
+            {
+                DTO_INIT(PoolStatisticsDto, DTO);
+
+                DTO_FIELD_INFO(maxConnections) {
+                    info->description = "Configured maximum number of pooled connections";
+                }
+                DTO_FIELD(oatpp::UInt32, maxConnections);
+
+                DTO_FIELD_INFO(minConnections) {
+                    info->description = "Lower bound of the adaptive limit";
+                }
+                DTO_FIELD(oatpp::UInt32, minConnections);
+
+                DTO_FIELD_INFO(limit) {
+                    info->description = "Number of connections currently allowed to be in use";
+                }
+                DTO_FIELD(oatpp::UInt32, limit);
+
+                DTO_FIELD_INFO(adaptive) {
+                    info->description = "Whether or not the limit adapts to the load";
+                }
+                DTO_FIELD(oatpp::Boolean, adaptive);
+
+                DTO_FIELD_INFO(connectionTtlSeconds) {
+                    info->description = "Time after which an idle connection is closed";
+                }
+                DTO_FIELD(oatpp::UInt64, connectionTtlSeconds);
+
+                DTO_FIELD_INFO(inUse) {
+                    info->description = "Connections currently checked out";
+                }
+                DTO_FIELD(oatpp::Int64, inUse);
+
+                DTO_FIELD_INFO(peakInUse) {
+                    info->description = "Highest number of connections checked out at once since the last adaptive step";
+                }
+                DTO_FIELD(oatpp::Int64, peakInUse);
+
+                DTO_FIELD_INFO(waiting) {
+                    info->description = "Requests currently waiting for a connection";
+                }
+                DTO_FIELD(oatpp::Int64, waiting);
+
+                DTO_FIELD_INFO(checkouts) {
+                    info->description = "Total number of successful checkouts";
+                }
+                DTO_FIELD(oatpp::UInt64, checkouts);
+
+                DTO_FIELD_INFO(timeouts) {
+                    info->description = "Checkouts which timed out and were answered with 503";
+                }
+                DTO_FIELD(oatpp::UInt64, timeouts);
+
+                DTO_FIELD_INFO(averageWaitMicros) {
+                    info->description = "Average time spent waiting for a connection in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, averageWaitMicros);
+
+                DTO_FIELD_INFO(maxWaitMicros) {
+                    info->description = "Longest time spent waiting for a connection in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, maxWaitMicros);
+
+                DTO_FIELD_INFO(opened) {
+                    info->description = "Physical connections opened";
+                }
+                DTO_FIELD(oatpp::UInt64, opened);
+
+                DTO_FIELD_INFO(closed) {
+                    info->description = "Physical connections closed";
+                }
+                DTO_FIELD(oatpp::UInt64, closed);
+
+                DTO_FIELD_INFO(reopens) {
+                    info->description = "Connections opened to replace a closed one";
+                }
+                DTO_FIELD(oatpp::UInt64, reopens);
+
+            };
+
+            //  ____  _        _                            _    ____           _          ____  _        _   _     _   _          ____  _
+            // / ___|| |_ __ _| |_ ___ _ __ ___   ___ _ __ | |_ / ___|__ _  ___| |__   ___/ ___|| |_ __ _| |_(_)___| |_(_) ___ ___|  _ \| |_ ___
+            // \___ \| __/ _` | __/ _ \ '_ ` _ \ / _ \ '_ \| __| |   / _` |/ __| '_ \ / _ \___ \| __/ _` | __| / __| __| |/ __/ __| | | | __/ _ \
+            //  ___) | || (_| | ||  __/ | | | | |  __/ | | | |_| |__| (_| | (__| | | |  __/___) | || (_| | |_| \__ \ |_| | (__\__ \ |_| | || (_) |
+            // |____/ \__\__,_|\__\___|_| |_| |_|\___|_| |_|\__|\____\__,_|\___|_| |_|\___|____/ \__\__,_|\__|_|___/\__|_|\___|___/____/ \__\___/
+            /**
+             * @brief DTO class representing the counters of the prepared statement caches.
+             */
+            class StatementCacheStatisticsDto : public oatpp::DTO
+            {
+                DTO_INIT(StatementCacheStatisticsDto, DTO);
+
+                DTO_FIELD_INFO(capacity) {
+                    info->description = "Prepared statements kept per connection";
+                }
+                DTO_FIELD(oatpp::UInt64, capacity);
+
+                DTO_FIELD_INFO(cached) {
+                    info->description = "Prepared statements currently cached over all connections";
+                }
+                DTO_FIELD(oatpp::Int64, cached);
+
+                DTO_FIELD_INFO(hits) {
+                    info->description = "Queries which reused a prepared statement";
+                }
+                DTO_FIELD(oatpp::UInt64, hits);
+
+                DTO_FIELD_INFO(misses) {
+                    info->description = "Queries which had to prepare their statement";
+                }
+                DTO_FIELD(oatpp::UInt64, misses);
+
+                DTO_FIELD_INFO(bypasses) {
+                    info->description = "Queries which found their statement in use and prepared a private one";
+                }
+                DTO_FIELD(oatpp::UInt64, bypasses);
+
+                DTO_FIELD_INFO(evictions) {
+                    info->description = "Statements finalized to make room for another one";
+                }
+                DTO_FIELD(oatpp::UInt64, evictions);
+
+                DTO_FIELD_INFO(hitRatio) {
+                    info->description = "Share of queries served from the cache";
+                }
+                DTO_FIELD(oatpp::Float64, hitRatio);
+
+            };
+
+            //   ___                        ____  _        _   _     _   _          ____  _
+            //  / _ \ _   _  ___ _ __ _   _/ ___|| |_ __ _| |_(_)___| |_(_) ___ ___|  _ \| |_ ___
+            // | | | | | | |/ _ \ '__| | | \___ \| __/ _` | __| / __| __| |/ __/ __| | | | __/ _ \
+            // | |_| | |_| |  __/ |  | |_| |___) | || (_| | |_| \__ \ |_| | (__\__ \ |_| | || (_) |
+            //  \__\_\\__,_|\___|_|   \__, |____/ \__\__,_|\__|_|___/\__|_|\___|___/____/ \__\___/
+            //                        |___/
+            /**
+             * @brief DTO class representing the statistics of one named query.
+             */
+            class QueryStatisticsDto : public oatpp::DTO
+            {
+                DTO_INIT(QueryStatisticsDto, DTO);
+
+                DTO_FIELD_INFO(name) {
+                    info->description = "Name of the QUERY in the DatabaseClient";
+                }
+                DTO_FIELD(oatpp::String, name);
+
+                DTO_FIELD_INFO(calls) {
+                    info->description = "Number of executions";
+                }
+                DTO_FIELD(oatpp::UInt64, calls);
+
+                DTO_FIELD_INFO(failures) {
+                    info->description = "Executions which ended with an error";
+                }
+                DTO_FIELD(oatpp::UInt64, failures);
+
+                DTO_FIELD_INFO(timeouts) {
+                    info->description = "Waiting requests which reached their deadline before the query finished and were answered with 504";
+                }
+                DTO_FIELD(oatpp::UInt64, timeouts);
+
+                DTO_FIELD_INFO(slowCalls) {
+                    info->description = "Executions above the slow query threshold";
+                }
+                DTO_FIELD(oatpp::UInt64, slowCalls);
+
+                DTO_FIELD_INFO(rows) {
+                    info->description = "Rows returned over all executions";
+                }
+                DTO_FIELD(oatpp::UInt64, rows);
+
+                DTO_FIELD_INFO(averageMicros) {
+                    info->description = "Average time spent executing and fetching in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, averageMicros);
+
+                DTO_FIELD_INFO(p50Micros) {
+                    info->description = "Median latency, upper bound of its histogram bucket in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, p50Micros);
+
+                DTO_FIELD_INFO(p95Micros) {
+                    info->description = "95th percentile latency, upper bound of its histogram bucket in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, p95Micros);
+
+                DTO_FIELD_INFO(p99Micros) {
+                    info->description = "99th percentile latency, upper bound of its histogram bucket in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, p99Micros);
+
+                DTO_FIELD_INFO(maxMicros) {
+                    info->description = "Slowest execution in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, maxMicros);
+
+                DTO_FIELD_INFO(averagePoolWaitMicros) {
+                    info->description = "Average time spent waiting for a pooled connection in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, averagePoolWaitMicros);
+
+                DTO_FIELD_INFO(histogram) {
+                    info->description = "Executions per latency bucket, see histogramBounds";
+                }
+                DTO_FIELD(oatpp::Vector<oatpp::UInt64>, histogram);
+
+            };
+
+            //  ____  _                  ___                        ____  _
+            // / ___|| | _____      __  / _ \ _   _  ___ _ __ _   _|  _ \| |_ ___
+            // \___ \| |/ _ \ \ /\ / / | | | | | | |/ _ \ '__| | | | | | | __/ _ \
+            //  ___) | | (_) \ V  V /  | |_| | |_| |  __/ |  | |_| | |_| | || (_) |
+            // |____/|_|\___/ \_/\_/    \__\_\\__,_|\___|_|   \__, |____/ \__\___/
+            //                                               |___/
+            /**
+             * @brief DTO class representing one entry of the slow query log.
+             */
+            class SlowQueryDto : public oatpp::DTO
+            {
+                DTO_INIT(SlowQueryDto, DTO);
+
+                DTO_FIELD_INFO(name) {
+                    info->description = "Name of the QUERY in the DatabaseClient";
+                }
+                DTO_FIELD(oatpp::String, name);
+
+                DTO_FIELD_INFO(sql) {
+                    info->description = "Statement with its bound parameters";
+                }
+                DTO_FIELD(oatpp::String, sql);
+
+                DTO_FIELD_INFO(plan) {
+                    info->description = "Output of EXPLAIN QUERY PLAN, one step per line";
+                }
+                DTO_FIELD(oatpp::String, plan);
+
+                DTO_FIELD_INFO(micros) {
+                    info->description = "Time spent executing and fetching in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, micros);
+
+                DTO_FIELD_INFO(rows) {
+                    info->description = "Rows returned";
+                }
+                DTO_FIELD(oatpp::UInt64, rows);
+
+                DTO_FIELD_INFO(poolWaitMicros) {
+                    info->description = "Time spent waiting for a pooled connection in microseconds";
+                }
+                DTO_FIELD(oatpp::UInt64, poolWaitMicros);
+
+                DTO_FIELD_INFO(timestamp) {
+                    info->description = "Time the query finished in milliseconds since the epoch";
+                }
+                DTO_FIELD(oatpp::Int64, timestamp);
+
+            };
+
+            //   ___                        ____                       _   ____  _
+            //  / _ \ _   _  ___ _ __ _   _|  _ \ ___ _ __   ___  _ __| |_|  _ \| |_ ___
+            // | | | | | | |/ _ \ '__| | | | |_) / _ \ '_ \ / _ \| '__| __| | | | __/ _ \
+            // | |_| | |_| |  __/ |  | |_| |  _ <  __/ |_) | (_) | |  | |_| |_| | || (_) |
+            //  \__\_\\__,_|\___|_|   \__, |_| \_\___| .__/ \___/|_|   \__|____/ \__\___/
+            //                        |___/          |_|
+            /**
+             * @brief DTO class representing the statistics of all queries.
+             */
+            class QueryReportDto : public oatpp::DTO
+            {
+                DTO_INIT(QueryReportDto, DTO);
+
+                DTO_FIELD_INFO(slowQueryThresholdMicros) {
+                    info->description = "Executions taking longer are written to the slow query log";
+                }
+                DTO_FIELD(oatpp::UInt64, slowQueryThresholdMicros);
+
+                DTO_FIELD_INFO(histogramBounds) {
+                    info->description = "Upper bounds of the latency buckets in microseconds, the last one is unbounded";
+                }
+                DTO_FIELD(oatpp::Vector<oatpp::UInt64>, histogramBounds);
+
+                DTO_FIELD_INFO(queries) {
+                    info->description = "Statistics per query, ordered by name";
+                }
+                DTO_FIELD(oatpp::Vector<oatpp::Object<QueryStatisticsDto>>, queries);
+
+            };
+
+            //  ____                        _           _   ____  _
+            // / ___| _ __   __ _ _ __  ___| |__   ___ | |_|  _ \| |_ ___
+            // \___ \| '_ \ / _` | '_ \/ __| '_ \ / _ \| __| | | | __/ _ \
+            //  ___) | | | | (_| | |_) \__ \ | | | (_) | |_| |_| | || (_) |
+            // |____/|_| |_|\__,_| .__/|___/_| |_|\___/ \__|____/ \__\___/
+            //                   |_|
+            /**
+             * @brief DTO class representing a database snapshot written by the backup service.
+             */
+            class SnapshotDto : public oatpp::DTO
+            {
+                DTO_INIT(SnapshotDto, DTO);
+
+                DTO_FIELD_INFO(file) {
+                    info->description = "File name within the backup directory";
+                }
+                DTO_FIELD(oatpp::String, file);
+
+                DTO_FIELD_INFO(bytes) {
+                    info->description = "Size of the snapshot";
+                }
+                DTO_FIELD(oatpp::UInt64, bytes);
+
+                DTO_FIELD_INFO(created) {
+                    info->description = "Time the snapshot was written in seconds since the epoch";
+                }
+                DTO_FIELD(oatpp::Int64, created);
+
+            };
+
+            //  ____             _                ____  _
+            // | __ )  __ _  ___| | ___   _ _ __ |  _ \| |_ ___
+            // |  _ \ / _` |/ __| |/ / | | | '_ \| | | | __/ _ \
+            // | |_) | (_| | (__|   <| |_| | |_) | |_| | || (_) |
+            // |____/ \__,_|\___|_|\_\\__,_| .__/|____/ \__\___/
+            //                             |_|
+            /**
+             * @brief DTO class representing the outcome of a backup.
+             */
+            class BackupDto : public oatpp::DTO
+            {
+                DTO_INIT(BackupDto, DTO);
+
+                DTO_FIELD_INFO(snapshot) {
+                    info->description = "The snapshot which was written";
+                }
+                DTO_FIELD(oatpp::Object<SnapshotDto>, snapshot);
+
+                DTO_FIELD_INFO(pages) {
+                    info->description = "Pages copied";
+                }
+                DTO_FIELD(oatpp::Int32, pages);
+
+                DTO_FIELD_INFO(steps) {
+                    info->description = "Backup steps needed, each one holds the read lock for a bounded number of pages";
+                }
+                DTO_FIELD(oatpp::Int32, steps);
+
+                DTO_FIELD_INFO(durationMs) {
+                    info->description = "Duration of the backup in milliseconds";
+                }
+                DTO_FIELD(oatpp::Int64, durationMs);
+
+                DTO_FIELD_INFO(removed) {
+                    info->description = "Old snapshots removed by the retention policy";
+                }
+                DTO_FIELD(oatpp::UInt32, removed);
+
+            };
+
+            //  ____                       _   _             ____                        _           _   ____  _
+            // |  _ \ ___ _ __   ___  _ __| |_(_)_ __   __ _/ ___| _ __   __ _ _ __  ___| |__   ___ | |_|  _ \| |_ ___
+            // | |_) / _ \ '_ \ / _ \| '__| __| | '_ \ / _` \___ \| '_ \ / _` | '_ \/ __| '_ \ / _ \| __| | | | __/ _ \
+            // |  _ <  __/ |_) | (_) | |  | |_| | | | | (_| |___) | | | | (_| | |_) \__ \ | | | (_) | |_| |_| | || (_) |
+            // |_| \_\___| .__/ \___/|_|   \__|_|_| |_|\__, |____/|_| |_|\__,_| .__/|___/_| |_|\___/ \__|____/ \__\___/
+            //           |_|                           |___/                  |_|
+            /**
+             * @brief DTO class representing the reporting snapshot the analytics endpoints read from.
+             */
+            class ReportingSnapshotDto : public oatpp::DTO
+            {
+                DTO_INIT(ReportingSnapshotDto, DTO);
+
+                DTO_FIELD_INFO(generation) {
+                    info->description = "Generation of the snapshot, incremented by every refresh";
+                }
+                DTO_FIELD(oatpp::UInt64, generation);
+
+                DTO_FIELD_INFO(created) {
+                    info->description = "Unix time the snapshot was taken";
+                }
+                DTO_FIELD(oatpp::Int64, created);
+
+                DTO_FIELD_INFO(ageSeconds) {
+                    info->description = "Seconds since the snapshot was taken";
+                }
+                DTO_FIELD(oatpp::Int64, ageSeconds);
+
+            };
+
+            //     _             _     _               ___   __              ____  _
+            //    / \   _ __ ___| |__ (_)_   _____  __| \ \ / /__  __ _ _ __|  _ \| |_ ___
+            //   / _ \ | '__/ __| '_ \| \ \ / / _ \/ _` |\ V / _ \/ _` | '__| | | | __/ _ \
+            //  / ___ \| | | (__| | | | |\ V /  __/ (_| | | |  __/ (_| | |  | |_| | || (_) |
+            // /_/   \_\_|  \___|_| |_|_| \_/ \___|\__,_| |_|\___|\__,_|_|  |____/ \__\___/
+            /**
+             * @brief DTO class representing the archive file of one closed year.
+             */
+            class ArchivedYearDto : public oatpp::DTO
+            {
+                DTO_INIT(ArchivedYearDto, DTO);
+
+                DTO_FIELD(oatpp::Int32, year);
+
+                DTO_FIELD_INFO(file) {
+                    info->description = "File name within the archive directory";
+                }
+                DTO_FIELD(oatpp::String, file);
+
+                DTO_FIELD_INFO(bytes) {
+                    info->description = "Size of the archive file";
+                }
+                DTO_FIELD(oatpp::UInt64, bytes);
+
+            };
+
+            //     _             _     _           ____              ____  _
+            //    / \   _ __ ___| |__ (_)_   _____|  _ \ _   _ _ __ |  _ \| |_ ___
+            //   / _ \ | '__/ __| '_ \| \ \ / / _ \ |_) | | | | '_ \| | | | __/ _ \
+            //  / ___ \| | | (__| | | | |\ V /  __/  _ <| |_| | | | | |_| | || (_) |
+            // /_/   \_\_|  \___|_| |_|_| \_/ \___|_| \_\\__,_|_| |_|____/ \__\___/
+            /**
+             * @brief DTO class representing the outcome of one archive run.
+             */
+            class ArchiveRunDto : public oatpp::DTO
+            {
+                DTO_INIT(ArchiveRunDto, DTO);
+
+                DTO_FIELD_INFO(firstHotYear) {
+                    info->description = "Oldest year kept in the Attendance table";
+                }
+                DTO_FIELD(oatpp::Int32, firstHotYear);
+
+                DTO_FIELD_INFO(years) {
+                    info->description = "Closed years whose attendances were moved by this run";
+                }
+                DTO_FIELD(oatpp::Vector<oatpp::Int32>, years);
+
+                DTO_FIELD_INFO(rows) {
+                    info->description = "Attendances moved into the archives";
+                }
+                DTO_FIELD(oatpp::UInt64, rows);
+
+                DTO_FIELD_INFO(batches) {
+                    info->description = "Batches needed, each one holds the write lock for a bounded number of rows";
+                }
+                DTO_FIELD(oatpp::UInt32, batches);
+
+                DTO_FIELD_INFO(durationMs) {
+                    info->description = "Duration of the run in milliseconds";
+                }
+                DTO_FIELD(oatpp::Int64, durationMs);
+
+            };
+
+            //  ____       __                              ____        _        ____  _
+            // |  _ \ ___ / _| ___ _ __ ___ _ __   ___ ___|  _ \  __ _| |_ __ _|  _ \| |_ ___
+            // | |_) / _ \ |_ / _ \ '__/ _ \ '_ \ / __/ _ \ | | |/ _` | __/ _` | | | | __/ _ \
+            // |  _ <  __/  _|  __/ | |  __/ | | | (_|  __/ |_| | (_| | || (_| | |_| | || (_) |
+            // |_| \_\___|_|  \___|_|  \___|_| |_|\___\___|____/ \__,_|\__\__,_|____/ \__\___/
+            /**
+             * @brief DTO class representing the reference data snapshot: departments and pricing table.
+             */
+            class ReferenceDataDto : public oatpp::DTO
+            {
+                DTO_INIT(ReferenceDataDto, DTO);
+
+                DTO_FIELD_INFO(generation) {
+                    info->description = "Generation of the snapshot, incremented by every reload and pricing update";
+                }
+                DTO_FIELD(oatpp::UInt64, generation);
+
+                DTO_FIELD_INFO(loaded) {
+                    info->description = "Unix time the snapshot was loaded";
+                }
+                DTO_FIELD(oatpp::Int64, loaded);
+
+                DTO_FIELD_INFO(departments) {
+                    info->description = "Departments of the club";
+                }
+                DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::DepartmentDto>>, departments);
+
+                DTO_FIELD_INFO(pricing) {
+                    info->description = "Pricing table the membership fees are calculated from";
+                }
+                DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::PricingRuleDto>>, pricing);
+
+            };
+
+            //   ____           _          ____  _        _   _     _   _          ____  _
+            //  / ___|__ _  ___| |__   ___/ ___|| |_ __ _| |_(_)___| |_(_) ___ ___|  _ \| |_ ___
+            // | |   / _` |/ __| '_ \ / _ \___ \| __/ _` | __| / __| __| |/ __/ __| | | | __/ _ \
+            // | |__| (_| | (__| | | |  __/___) | || (_| | |_| \__ \ |_| | (__\__ \ |_| | || (_) |
+            //  \____\__,_|\___|_| |_|\___|____/ \__\__,_|\__|_|___/\__|_|\___|___/____/ \__\___/
+            /**
+             * @brief DTO class representing the counters of the response cache and of the request coalescing.
+             */
+            class CacheStatisticsDto : public oatpp::DTO
+            {
+                DTO_INIT(CacheStatisticsDto, DTO);
+
+                DTO_FIELD_INFO(hits) {
+                    info->description = "Requests answered from the response cache";
+                }
+                DTO_FIELD(oatpp::UInt64, hits);
+
+                DTO_FIELD_INFO(misses) {
+                    info->description = "Requests which found no cached response";
+                }
+                DTO_FIELD(oatpp::UInt64, misses);
+
+                DTO_FIELD_INFO(stores) {
+                    info->description = "Responses stored in the response cache";
+                }
+                DTO_FIELD(oatpp::UInt64, stores);
+
+                DTO_FIELD_INFO(rejectedStores) {
+                    info->description = "Responses not stored because a table they read changed meanwhile";
+                }
+                DTO_FIELD(oatpp::UInt64, rejectedStores);
+
+                DTO_FIELD_INFO(invalidations) {
+                    info->description = "Table invalidations caused by writes";
+                }
+                DTO_FIELD(oatpp::UInt64, invalidations);
+
+                DTO_FIELD_INFO(entries) {
+                    info->description = "Responses currently cached";
+                }
+                DTO_FIELD(oatpp::UInt64, entries);
+
+                DTO_FIELD_INFO(coalescingWindowMs) {
+                    info->description = "Age up to which a running query is joined by identical requests, 0 if coalescing is off";
+                }
+                DTO_FIELD(oatpp::UInt64, coalescingWindowMs);
+
+                DTO_FIELD_INFO(leaders) {
+                    info->description = "Queries run on behalf of coalesced requests";
+                }
+                DTO_FIELD(oatpp::UInt64, leaders);
+
+                DTO_FIELD_INFO(followers) {
+                    info->description = "Requests which waited for the query of an identical request instead of running their own";
+                }
+                DTO_FIELD(oatpp::UInt64, followers);
+
+                DTO_FIELD_INFO(bypasses) {
+                    info->description = "Requests which found a running query too old or behind a write and ran their own";
+                }
+                DTO_FIELD(oatpp::UInt64, bypasses);
+
+                DTO_FIELD_INFO(failures) {
+                    info->description = "Coalesced queries which failed, every waiting request received the error";
+                }
+                DTO_FIELD(oatpp::UInt64, failures);
+
+                DTO_FIELD_INFO(inFlight) {
+                    info->description = "Queries currently running with requests able to join them";
+                }
+                DTO_FIELD(oatpp::UInt64, inFlight);
+
+            };
+
+#include OATPP_CODEGEN_END(DTO)
+        } // namespace admin
+    } // namespace dto
+} // namespace primus
+
+#endif // ADMINDTOS_HPP
@@ -0,0 +1,78 @@
+#ifndef BATCHDTOS_HPP
+#define BATCHDTOS_HPP
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+namespace primus
+{
+    namespace dto
+    {
+        namespace batch
+        {
+#include OATPP_CODEGEN_BEGIN(DTO)
+            //  ____        _       _     ____                            _   ____  _
+            // | __ )  __ _| |_ ___| |__ |  _ \ ___  __ _ _   _  ___  ___| |_|  _ \| |_ ___
+            // |  _ \ / _` | __/ __| '_ \| |_) / _ \/ _` | | | |/ _ \/ __| __| | | | __/ _ \
+            // | |_) | (_| | || (__| | | |  _ <  __/ (_| | |_| |  __/\__ \ |_| |_| | || (_) |
+            // |____/ \__,_|\__\___|_| |_|_| \_\___|\__, |\__,_|\___||___/\__|____/ \__\___/
+            //                                         |_|
+            /**
+             * @brief DTO class representing one sub-request of POST /api/batch.
+             */
+            class BatchRequestDto : public oatpp::DTO
+            {
+                DTO_INIT(BatchRequestDto, DTO);
+
+                DTO_FIELD_INFO(method) {
+                    info->description = "HTTP method of the sub-request, e.g. GET";
+                }
+                DTO_FIELD(oatpp::String, method);
+
+                DTO_FIELD_INFO(path) {
+                    info->description = "Path of the sub-request including its query, e.g. /api/members/count/active";
+                }
+                DTO_FIELD(oatpp::String, path);
+
+                DTO_FIELD_INFO(body) {
+                    info->description = "Body of the sub-request as a string, e.g. the JSON of a member";
+                }
+                DTO_FIELD(oatpp::String, body);
+
+            };
+
+            //  ____        _       _     ____                 _ _   ____  _
+            // | __ )  __ _| |_ ___| |__ |  _ \ ___  ___ _   _| | |_|  _ \| |_ ___
+            // |  _ \ / _` | __/ __| '_ \| |_) / _ \/ __| | | | | __| | | | __/ _ \
+            // | |_) | (_| | || (__| | | |  _ <  __/\__ \ |_| | | |_| |_| | || (_) |
+            // |____/ \__,_|\__\___|_| |_|_| \_\___||___/\__,_|_|\__|____/ \__\___/
+            /**
+             * @brief DTO class representing the response to one sub-request, in the order of the sub-requests.
+             */
+            class BatchResultDto : public oatpp::DTO
+            {
+                DTO_INIT(BatchResultDto, DTO);
+
+                DTO_FIELD_INFO(status) {
+                    info->description = "HTTP status code of the sub-request";
+                }
+                DTO_FIELD(oatpp::Int32, status);
+
+                DTO_FIELD_INFO(contentType) {
+                    info->description = "Content type of the body";
+                }
+                DTO_FIELD(oatpp::String, contentType);
+
+                DTO_FIELD_INFO(body) {
+                    info->description = "JSON bodies are embedded as they are, text bodies as a string, other bodies are null";
+                }
+                DTO_FIELD(oatpp::Any, body);
+
+            };
+
+#include OATPP_CODEGEN_END(DTO)
+        } // namespace batch
+    } // namespace dto
+} // namespace primus
+
+#endif // BATCHDTOS_HPP
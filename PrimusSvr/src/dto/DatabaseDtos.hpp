@@ -98,6 +98,111 @@ namespace primus
 
             };
 
+            //  ____                        _                        _   __  __                _                   _     _       ____  _        
+            // |  _ \  ___ _ __   __ _ _ __| |_ _ __ ___   ___ _ __ | |_|  \/  | ___ _ __ ___ | |__   ___ _ __ ___| |__ (_)_ __ |  _ \| |_ ___  
+            // | | | |/ _ \ '_ \ / _` | '__| __| '_ ` _ \ / _ \ '_ \| __| |\/| |/ _ \ '_ ` _ \| '_ \ / _ \ '__/ __| '_ \| | '_ \| | | | __/ _ \ 
+            // | |_| |  __/ |_) | (_| | |  | |_| | | | | |  __/ | | | |_| |  | |  __/ | | | | | |_) |  __/ |  \__ \ | | | | |_) | |_| | || (_) |
+            // |____/ \___| .__/ \__,_|_|   \__|_| |_| |_|\___|_| |_|\__|_|  |_|\___|_| |_| |_|_.__/ \___|_|  |___/_| |_|_| .__/|____/ \__\___/ 
+            //            |_|                                                                                           |_|                  
+            /**
+             * @brief DTO class representing a single row of the Department_Member junction table.
+             */
+            class DepartmentMembershipDto : public oatpp::DTO
+            {
+
+                DTO_INIT(DepartmentMembershipDto, DTO /* extends */)
+
+                DTO_FIELD_INFO(memberId) {
+                    info->description = "Identifier of the member";
+                }
+                DTO_FIELD(oatpp::UInt32, memberId);
+
+                DTO_FIELD_INFO(departmentId) {
+                    info->description = "Identifier of the department";
+                }
+                DTO_FIELD(oatpp::UInt32, departmentId);
+
+            };
+
+            //     _       _     _                   __  __                _                   _     _       ____  _
+            //    / \   __| | __| |_ __ ___  ___ ___|  \/  | ___ _ __ ___ | |__   ___ _ __ ___| |__ (_)_ __ |  _ \| |_ ___
+            //   / _ \ / _` |/ _` | '__/ _ \/ __/ __| |\/| |/ _ \ '_ ` _ \| '_ \ / _ \ '__/ __| '_ \| | '_ \| | | | __/ _ \
+            //  / ___ \ (_| | (_| | | |  __/\__ \__ \ |  | |  __/ | | | | | |_) |  __/ |  \__ \ | | | | |_) | |_| | || (_) |
+            // /_/   \_\__,_|\__,_|_|  \___||___/___/_|  |_|\___|_| |_| |_|_.__/ \___|_|  |___/_| |_|_| .__/|____/ \__\___/
+            //                                                                                        |_|
+            /**
+             * @brief DTO class representing a single row of the Address_Member junction table.
+             */
+            class AddressMembershipDto : public oatpp::DTO
+            {
+
+                DTO_INIT(AddressMembershipDto, DTO /* extends */)
+
+                DTO_FIELD_INFO(memberId) {
+                    info->description = "Identifier of the member";
+                }
+                DTO_FIELD(oatpp::UInt32, memberId);
+
+                DTO_FIELD_INFO(addressId) {
+                    info->description = "Identifier of the address";
+                }
+                DTO_FIELD(oatpp::UInt32, addressId);
+
+            };
+
+            //   ____ _                            _                _____       _              ____  _
+            //  / ___| |__   __ _ _ __   __ _  ___| |    ___   __ _| ____|_ __ | |_ _ __ _   _|  _ \| |_ ___
+            // | |   | '_ \ / _` | '_ \ / _` |/ _ \ |   / _ \ / _` |  _| | '_ \| __| '__| | | | | | | __/ _ \
+            // | |___| | | | (_| | | | | (_| |  __/ |__| (_) | (_| | |___| | | | |_| |  | |_| | |_| | || (_) |
+            //  \____|_| |_|\__,_|_| |_|\__, |\___|_____\___/ \__, |_____|_| |_|\__|_|   \__, |____/ \__\___/
+            //                          |___/                 |___/                      |___/
+            /**
+             * @brief DTO class representing a single row of the ChangeLog table, see 005_change_log.sql.
+             */
+            class ChangeLogEntryDto : public oatpp::DTO
+            {
+
+                DTO_INIT(ChangeLogEntryDto, DTO /* extends */)
+
+                DTO_FIELD(oatpp::UInt32, seq);
+                DTO_FIELD(oatpp::UInt32, entity);
+                DTO_FIELD(oatpp::UInt32, memberId);
+                DTO_FIELD(oatpp::UInt32, relatedId);
+                DTO_FIELD(oatpp::Boolean, deleted);
+
+            };
+
+            //  ____       _      _             ____        _      ____  _
+            // |  _ \ _ __(_) ___(_)_ __   __ _|  _ \ _   _| | ___|  _ \| |_ ___
+            // | |_) | '__| |/ __| | '_ \ / _` | |_) | | | | |/ _ \ | | | __/ _ \
+            // |  __/| |  | | (__| | | | | (_| |  _ <| |_| | |  __/ |_| | || (_) |
+            // |_|   |_|  |_|\___|_|_| |_|\__, |_| \_\\__,_|_|\___|____/ \__\___/
+            //                            |___/
+            /**
+             * @brief DTO class representing a single row of the Pricing table.
+             */
+            class PricingRuleDto : public oatpp::DTO
+            {
+
+                DTO_INIT(PricingRuleDto, DTO /* extends */)
+
+                DTO_FIELD_INFO(rule) {
+                    info->description = "none (no department), multiple (more than one department) or single (exactly the department departmentId)";
+                }
+                DTO_FIELD(oatpp::String, rule);
+
+                DTO_FIELD_INFO(departmentId) {
+                    info->description = "Department of a single rule, 0 for the other rules";
+                }
+                DTO_FIELD(oatpp::UInt32, departmentId);
+
+                DTO_FIELD_INFO(fee) {
+                    info->description = "Membership fee in euro";
+                }
+                DTO_FIELD(oatpp::UInt32, fee);
+
+            };
+
             //  __  __                _               ____  _        
             // |  \/  | ___ _ __ ___ | |__   ___ _ __|  _ \| |_ ___  
             // | |\/| |/ _ \ '_ ` _ \| '_ \ / _ \ '__| | | | __/ _ \ 
@@ -156,6 +261,26 @@ namespace primus
                 DTO_FIELD(oatpp::Boolean, active) = true;
 
             };
+
+            //  _   _           _       _           _ __  __                _               ____  _
+            // | | | |_ __   __| | __ _| |_ ___  __| |  \/  | ___ _ __ ___ | |__   ___ _ __|  _ \| |_ ___
+            // | | | | '_ \ / _` |/ _` | __/ _ \/ _` | |\/| |/ _ \ '_ ` _ \| '_ \ / _ \ '__| | | | __/ _ \
+            // | |_| | |_) | (_| | (_| | ||  __/ (_| | |  | |  __/ | | | | | |_) |  __/ |  | |_| | || (_) |
+            //  \___/| .__/ \__,_|\__,_|\__\___|\__,_|_|  |_|\___|_| |_| |_|_.__/ \___|_|  |____/ \__\___/
+            //       |_|
+            /**
+             * @brief A member as an UPDATE returns it, with the version it was given.
+             */
+            class UpdatedMemberDto : public MemberDto
+            {
+                DTO_INIT(UpdatedMemberDto, MemberDto /* extends */);
+
+                DTO_FIELD_INFO(version) {
+                    info->description = "Version of the member after the update, its ETag";
+                }
+                DTO_FIELD(oatpp::UInt32, version);
+
+            };
 #include OATPP_CODEGEN_END(DTO)
         } // namespace database
     } // namespace dto
@@ -0,0 +1,102 @@
+#ifndef EVENTDTOS_HPP
+#define EVENTDTOS_HPP
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+namespace primus
+{
+    namespace dto
+    {
+        namespace events
+        {
+#include OATPP_CODEGEN_BEGIN(DTO)
+            //   ____ _                            _____                 _   ____  _
+            //  / ___| |__   __ _ _ __   __ _  ___| ____|_   _____ _ __ | |_|  _ \| |_ ___
+            // | |   | '_ \ / _` | '_ \ / _` |/ _ \  _| \ \ / / _ \ '_ \| __| | | | __/ _ \
+            // | |___| | | | (_| | | | | (_| |  __/ |___ \ V /  __/ | | | |_| |_| | || (_) |
+            //  \____|_| |_|\__,_|_| |_|\__, |\___|_____| \_/ \___|_| |_|\__|____/ \__\___/
+            //                          |___/
+            /**
+             * @brief DTO class representing the data of one event of GET /api/events.
+             */
+            class ChangeEventDto : public oatpp::DTO
+            {
+                DTO_INIT(ChangeEventDto, DTO);
+
+                DTO_FIELD_INFO(type) {
+                    info->description = "What happened, e.g. created, updated, activated, added or removed";
+                }
+                DTO_FIELD(oatpp::String, type);
+
+                DTO_FIELD_INFO(memberId) {
+                    info->description = "Member the event is about, not set for count events";
+                }
+                DTO_FIELD(oatpp::UInt32, memberId);
+
+                DTO_FIELD_INFO(data) {
+                    info->description = "The member after the change, the association or attendance changed, or the new counts";
+                }
+                DTO_FIELD(oatpp::Any, data);
+
+            };
+
+            //     _                       _       _   _              ____ _                            ____  _
+            //    / \   ___ ___  ___   ___(_) __ _| |_(_) ___  _ __  / ___| |__   __ _ _ __   __ _  ___|  _ \| |_ ___
+            //   / _ \ / __/ __|/ _ \ / __| |/ _` | __| |/ _ \| '_ \| |   | '_ \ / _` | '_ \ / _` |/ _ \ | | | __/ _ \
+            //  / ___ \\__ \__ \ (_) | (__| | (_| | |_| | (_) | | | | |___| | | | (_| | | | | (_| |  __/ |_| | || (_) |
+            // /_/   \_\___/___/\___/ \___|_|\__,_|\__|_|\___/|_| |_|\____|_| |_|\__,_|_| |_|\__, |\___|____/ \__\___/
+            //                                                                               |___/
+            /**
+             * @brief DTO class representing the department or address a member was added to or removed from.
+             */
+            class AssociationChangeDto : public oatpp::DTO
+            {
+                DTO_INIT(AssociationChangeDto, DTO);
+
+                DTO_FIELD(oatpp::UInt32, departmentId);
+                DTO_FIELD(oatpp::UInt32, addressId);
+
+            };
+
+            //     _   _   _                 _                       ____ _                            ____  _
+            //    / \ | |_| |_ ___ _ __   __| | __ _ _ __   ___ ___ / ___| |__   __ _ _ __   __ _  ___|  _ \| |_ ___
+            //   / _ \| __| __/ _ \ '_ \ / _` |/ _` | '_ \ / __/ _ \ |   | '_ \ / _` | '_ \ / _` |/ _ \ | | | __/ _ \
+            //  / ___ \ |_| ||  __/ | | | (_| | (_| | | | | (_|  __/ |___| | | | (_| | | | | (_| |  __/ |_| | || (_) |
+            // /_/   \_\__|\__\___|_| |_|\__,_|\__,_|_| |_|\___\___|\____|_| |_|\__,_|_| |_|\__, |\___|____/ \__\___/
+            //                                                                              |___/
+            /**
+             * @brief DTO class representing the attendance added or removed.
+             */
+            class AttendanceChangeDto : public oatpp::DTO
+            {
+                DTO_INIT(AttendanceChangeDto, DTO);
+
+                DTO_FIELD(oatpp::String, date);
+
+            };
+
+            //  __  __                _                ____                  _       ____  _
+            // |  \/  | ___ _ __ ___ | |__   ___ _ __ / ___|___  _   _ _ __ | |_ ___|  _ \| |_ ___
+            // | |\/| |/ _ \ '_ ` _ \| '_ \ / _ \ '__| |   / _ \| | | | '_ \| __/ __| | | | __/ _ \
+            // | |  | |  __/ | | | | | |_) |  __/ |  | |__| (_) | |_| | | | | |_\__ \ |_| | || (_) |
+            // |_|  |_|\___|_| |_| |_|_.__/ \___|_|   \____\___/ \__,_|_| |_|\__|___/____/ \__\___/
+            /**
+             * @brief DTO class representing the member counts after a change, as GET /api/members/count/{attribute} returns them.
+             */
+            class MemberCountsDto : public oatpp::DTO
+            {
+                DTO_INIT(MemberCountsDto, DTO);
+
+                DTO_FIELD(oatpp::UInt32, all);
+                DTO_FIELD(oatpp::UInt32, active);
+                DTO_FIELD(oatpp::UInt32, inactive);
+
+            };
+
+#include OATPP_CODEGEN_END(DTO)
+        } // namespace events
+    } // namespace dto
+} // namespace primus
+
+#endif // EVENTDTOS_HPP
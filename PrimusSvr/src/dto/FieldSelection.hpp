@@ -0,0 +1,113 @@
+#ifndef FIELDSELECTION_HPP
+#define FIELDSELECTION_HPP
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "oatpp/core/Types.hpp"
+
+#include "general/errors.hpp"
+
+namespace primus
+{
+    namespace dto
+    {
+        //  _____ _      _     _ ____       _           _   _
+        // |  ___(_) ___| | __| / ___|  ___| | ___  ___| |_(_) ___  _ __
+        // | |_  | |/ _ \ |/ _` \___ \ / _ \ |/ _ \/ __| __| |/ _ \| '_ \
+        // |  _| | |  __/ | (_| |___) |  __/ |  __/ (__| |_| | (_) | | | |
+        // |_|   |_|\___|_|\__,_|____/ \___|_|\___|\___|\__|_|\___/|_| |_|
+        /**
+        * @brief Fields of a DTO picked by a ?fields= list, checked against the fields the DTO declares.
+        *
+        * The selection names the columns a query reads (the DTO fields map one to one onto the columns of its
+        * view) and clears every other field of the fetched rows, so an ObjectMapper which skips null fields
+        * leaves them out of the response.
+        */
+        template<class DtoT>
+        class FieldSelection
+        {
+        private:
+            typedef oatpp::data::mapping::type::BaseObject BaseObject;
+            typedef oatpp::data::mapping::type::__class::AbstractObject::PolymorphicDispatcher Dispatcher;
+
+            std::vector<BaseObject::Property*>  m_selected;
+            std::vector<BaseObject::Property*>  m_cleared;
+
+            FieldSelection() = default;
+
+        public:
+            typedef primus::error::Result<std::shared_ptr<FieldSelection>> Selected;
+
+            /**
+             * @param fields Comma separated field names, e.g. "id,firstName,lastName"
+             *
+             * @return NoFieldsSelected if no field is named, UnknownField if one is not declared by the DTO
+             */
+            static Selected select(const oatpp::String& fields)
+            {
+                std::unordered_set<std::string> names;
+                std::size_t begin = 0;
+                while (fields && begin <= fields->size())
+                {
+                    std::size_t end = fields->find(',', begin);
+                    if (end == std::string::npos)
+                        end = fields->size();
+                    std::string name = fields->substr(begin, end - begin);
+                    begin = end + 1;
+
+                    if (!name.empty())
+                        names.insert(name);
+                }
+
+                if (names.empty())
+                    return Selected::fail(primus::error::Error::NoFieldsSelected);
+
+                std::shared_ptr<FieldSelection> selection(new FieldSelection());
+                auto dispatcher = static_cast<const Dispatcher*>(oatpp::Object<DtoT>::Class::getType()->polymorphicDispatcher);
+                for (BaseObject::Property* property : dispatcher->getProperties()->getList())
+                {
+                    if (names.erase(property->name))
+                        selection->m_selected.push_back(property);
+                    else
+                        selection->m_cleared.push_back(property);
+                }
+
+                if (!names.empty())
+                    return Selected::fail(primus::error::Error::UnknownField);
+                return Selected::ok(selection);
+            }
+
+            /**
+             * The selected fields as an SQL column list in the order the DTO declares them, e.g. "id", "lastName"
+             */
+            std::string getColumns() const
+            {
+                std::string columns;
+                for (BaseObject::Property* property : m_selected)
+                {
+                    if (!columns.empty())
+                        columns += ", ";
+                    columns += "\"" + std::string(property->name) + "\"";
+                }
+                return columns;
+            }
+
+            /**
+             * Sets every field which is not selected to null, including those with a default value
+             */
+            void apply(const oatpp::Vector<oatpp::Object<DtoT>>& rows) const
+            {
+                for (auto& row : *rows)
+                {
+                    for (BaseObject::Property* property : m_cleared)
+                        property->set(static_cast<BaseObject*>(row.get()), nullptr);
+                }
+            }
+        };
+
+    } // namespace dto
+} // namespace primus
+
+#endif // FIELDSELECTION_HPP
@@ -0,0 +1,76 @@
+#ifndef MEMBERPROFILEDTO_HPP
+#define MEMBERPROFILEDTO_HPP
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include "DatabaseDtos.hpp"
+
+namespace primus
+{
+    namespace dto
+    {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+        //  __  __                _               ____             __ _ _      ____  _
+        // |  \/  | ___ _ __ ___ | |__   ___ _ __|  _ \ _ __ ___  / _(_) | ___|  _ \| |_ ___
+        // | |\/| |/ _ \ '_ ` _ \| '_ \ / _ \ '__| |_) | '__/ _ \| |_| | |/ _ \ | | | __/ _ \
+        // | |  | |  __/ | | | | | |_) |  __/ |  |  __/| | | (_) |  _| | |  __/ |_| | || (_) |
+        // |_|  |_|\___|_| |_| |_|_.__/ \___|_|  |_|   |_|  \___/|_| |_|_|\___|____/ \__\___/
+        /**
+        * @brief DTO class representing everything the profile page shows of a member. Sections left out by
+        * ?include= are null.
+        */
+        class MemberProfileDto : public oatpp::DTO
+        {
+
+            DTO_INIT(MemberProfileDto, DTO);
+
+            DTO_FIELD_INFO(id) {
+                info->description = "Identifier of the member";
+            }
+            DTO_FIELD(oatpp::UInt32, id);
+
+            DTO_FIELD_INFO(member) {
+                info->description = "The member, as returned by GET /api/member/{id}";
+            }
+            DTO_FIELD(oatpp::Object<primus::dto::database::MemberDto>, member);
+
+            DTO_FIELD_INFO(addresses) {
+                info->description = "Addresses of the member";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::AddressDto>>, addresses);
+
+            DTO_FIELD_INFO(departments) {
+                info->description = "Departments the member belongs to";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::DepartmentDto>>, departments);
+
+            DTO_FIELD_INFO(attendances) {
+                info->description = "Latest attendances of the member, newest first";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::DateDto>>, attendances);
+
+            DTO_FIELD_INFO(fee) {
+                info->description = "Membership fee in euro";
+            }
+            DTO_FIELD(oatpp::UInt32, fee);
+
+            DTO_FIELD_INFO(weaponPurchase) {
+                info->description = "Whether or not the attendance of the last year allows the member to purchase a weapon";
+            }
+            DTO_FIELD(oatpp::Boolean, weaponPurchase);
+
+            DTO_FIELD_INFO(avatar) {
+                info->description = "Path of the profile picture";
+            }
+            DTO_FIELD(oatpp::String, avatar);
+
+        };
+
+#include OATPP_CODEGEN_END(DTO)
+
+    } // namespace dto
+} // namespace primus
+
+#endif // MEMBERPROFILEDTO_HPP
@@ -0,0 +1,163 @@
+#ifndef REPORTDTOS_HPP
+#define REPORTDTOS_HPP
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+namespace primus
+{
+    namespace dto
+    {
+        namespace report
+        {
+#include OATPP_CODEGEN_BEGIN(DTO)
+            //  ____                       _   ____  _
+            // |  _ \ ___ _ __   ___  _ __| |_|  _ \| |_ ___
+            // | |_) / _ \ '_ \ / _ \| '__| __| | | | __/ _ \
+            // |  _ <  __/ |_) | (_) | |  | |_| |_| | || (_) |
+            // |_| \_\___| .__/ \___/|_|   \__|____/ \__\___/
+            //           |_|
+            /**
+             * @brief DTO class wrapping the rows of a report together with the age of the data they were read from.
+             */
+            template<class T>
+            class ReportDto : public oatpp::DTO
+            {
+                DTO_INIT(ReportDto, DTO);
+
+                DTO_FIELD_INFO(generation) {
+                    info->description = "Generation of the reporting snapshot the report was read from";
+                }
+                DTO_FIELD(oatpp::UInt64, generation);
+
+                DTO_FIELD_INFO(snapshotCreated) {
+                    info->description = "Unix time the reporting snapshot was taken";
+                }
+                DTO_FIELD(oatpp::Int64, snapshotCreated);
+
+                DTO_FIELD_INFO(dataAgeSeconds) {
+                    info->description = "Seconds since the reporting snapshot was taken, changes made since then are not included";
+                }
+                DTO_FIELD(oatpp::Int64, dataAgeSeconds);
+
+                DTO_FIELD_INFO(count) {
+                    info->description = "Number of rows";
+                }
+                DTO_FIELD(oatpp::UInt32, count);
+
+                DTO_FIELD_INFO(items) {
+                    info->description = "Rows of the report";
+                }
+                DTO_FIELD(oatpp::Vector<T>, items);
+            };
+
+            //     _   _   _                 _                      ____               ____  _
+            //    / \ | |_| |_ ___ _ __   __| | __ _ _ __   ___ ___|  _ \ _____      _|  _ \| |_ ___
+            //   / _ \| __| __/ _ \ '_ \ / _` |/ _` | '_ \ / __/ _ \ |_) / _ \ \ /\ / / | | | __/ _ \
+            //  / ___ \ |_| ||  __/ | | | (_| | (_| | | | | (_|  __/  _ < (_) \ V  V /| |_| | || (_) |
+            // /_/   \_\__|\__\___|_| |_|\__,_|\__,_|_| |_|\___\___|_| \_\___/ \_/\_/ |____/ \__\___/
+            /**
+             * @brief DTO class representing the attendance of one member within a year.
+             */
+            class AttendanceRowDto : public oatpp::DTO
+            {
+                DTO_INIT(AttendanceRowDto, DTO);
+
+                DTO_FIELD_INFO(memberId) {
+                    info->description = "Id of the member";
+                }
+                DTO_FIELD(oatpp::UInt32, memberId);
+
+                DTO_FIELD(oatpp::String, firstName);
+                DTO_FIELD(oatpp::String, lastName);
+
+                DTO_FIELD_INFO(attendances) {
+                    info->description = "Number of attended sessions";
+                }
+                DTO_FIELD(oatpp::UInt32, attendances);
+
+                DTO_FIELD_INFO(months) {
+                    info->description = "Number of distinct months with at least one attended session";
+                }
+                DTO_FIELD(oatpp::UInt32, months);
+            };
+
+            //  _____         ____               ____  _
+            // |  ___|__  ___|  _ \ _____      _|  _ \| |_ ___
+            // | |_ / _ \/ _ \ |_) / _ \ \ /\ / / | | | __/ _ \
+            // |  _|  __/  __/  _ < (_) \ V  V /| |_| | || (_) |
+            // |_|  \___|\___|_| \_\___/ \_/\_/ |____/ \__\___/
+            /**
+             * @brief DTO class representing the membership fee of one active member.
+             */
+            class FeeRowDto : public oatpp::DTO
+            {
+                DTO_INIT(FeeRowDto, DTO);
+
+                DTO_FIELD_INFO(memberId) {
+                    info->description = "Id of the member";
+                }
+                DTO_FIELD(oatpp::UInt32, memberId);
+
+                DTO_FIELD(oatpp::String, firstName);
+                DTO_FIELD(oatpp::String, lastName);
+
+                DTO_FIELD_INFO(departmentCount) {
+                    info->description = "Number of departments the member belongs to";
+                }
+                DTO_FIELD(oatpp::UInt32, departmentCount);
+
+                DTO_FIELD_INFO(departmentId) {
+                    info->description = "Lowest department id of the member, null without a department";
+                }
+                DTO_FIELD(oatpp::UInt32, departmentId);
+
+                DTO_FIELD_INFO(fee) {
+                    info->description = "Membership fee in euro";
+                }
+                DTO_FIELD(oatpp::UInt32, fee);
+            };
+
+            // __        __                           ____                 _                    ____               ____  _
+            // \ \      / /__  __ _ _ __   ___  _ __ |  _ \ _   _ _ __ ___| |__   __ _ ___  ___|  _ \ _____      _|  _ \| |_ ___
+            //  \ \ /\ / / _ \/ _` | '_ \ / _ \| '_ \| |_) | | | | '__/ __| '_ \ / _` / __|/ _ \ |_) / _ \ \ /\ / / | | | __/ _ \
+            //   \ V  V /  __/ (_| | |_) | (_) | | | |  __/| |_| | | | (__| | | | (_| \__ \  __/  _ < (_) \ V  V /| |_| | || (_) |
+            //    \_/\_/ \___|\__,_| .__/ \___/|_| |_|_|    \__,_|_|  \___|_| |_|\__,_|___/\___|_| \_\___/ \_/\_/ |____/ \__\___/
+            //                     |_|
+            /**
+             * @brief DTO class representing whether an active member may purchase a weapon.
+             */
+            class WeaponPurchaseRowDto : public oatpp::DTO
+            {
+                DTO_INIT(WeaponPurchaseRowDto, DTO);
+
+                DTO_FIELD_INFO(memberId) {
+                    info->description = "Id of the member";
+                }
+                DTO_FIELD(oatpp::UInt32, memberId);
+
+                DTO_FIELD(oatpp::String, firstName);
+                DTO_FIELD(oatpp::String, lastName);
+
+                DTO_FIELD_INFO(attendances) {
+                    info->description = "Number of attended sessions within the last year";
+                }
+                DTO_FIELD(oatpp::UInt32, attendances);
+
+                DTO_FIELD_INFO(months) {
+                    info->description = "Number of distinct months with an attended session within the last year";
+                }
+                DTO_FIELD(oatpp::UInt32, months);
+
+                DTO_FIELD_INFO(eligible) {
+                    info->description = "True if the member attended 18 sessions or at least one session per month";
+                }
+                DTO_FIELD(oatpp::Boolean, eligible);
+            };
+#include OATPP_CODEGEN_END(DTO)
+
+        } // namespace report
+    } // namespace dto
+} // namespace primus
+
+#endif // REPORTDTOS_HPP
@@ -0,0 +1,76 @@
+#ifndef SYNCDTO_HPP
+#define SYNCDTO_HPP
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include "DatabaseDtos.hpp"
+
+namespace primus
+{
+    namespace dto
+    {
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+        //  ____                   ____  _
+        // / ___| _   _ _ __   ___|  _ \| |_ ___
+        // \___ \| | | | '_ \ / __| | | | __/ _ \
+        //  ___) | |_| | | | | (__| |_| | || (_) |
+        // |____/ \__, |_| |_|\___|____/ \__\___/
+        //        |___/
+        /**
+        * @brief DTO class representing the answer of GET /api/sync: a full snapshot, or the changes after the
+        * sequence number a client has seen.
+        */
+        class SyncDto : public oatpp::DTO
+        {
+
+            DTO_INIT(SyncDto, DTO);
+
+            DTO_FIELD_INFO(sequence) {
+                info->description = "Sequence number the data is current to, passed as ?since= by the next sync";
+            }
+            DTO_FIELD(oatpp::UInt32, sequence);
+
+            DTO_FIELD_INFO(snapshot) {
+                info->description = "True if this is a full snapshot replacing the local copy, false if it is a delta applied to it";
+            }
+            DTO_FIELD(oatpp::Boolean, snapshot);
+
+            DTO_FIELD_INFO(members) {
+                info->description = "Members created or changed, inactive ones included. Every member in a snapshot";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::MemberDto>>, members);
+
+            DTO_FIELD_INFO(removedMembers) {
+                info->description = "Identifiers of the members deleted";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::UInt32>, removedMembers);
+
+            DTO_FIELD_INFO(departments) {
+                info->description = "Department memberships added. Every membership in a snapshot";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::DepartmentMembershipDto>>, departments);
+
+            DTO_FIELD_INFO(removedDepartments) {
+                info->description = "Department memberships removed";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::DepartmentMembershipDto>>, removedDepartments);
+
+            DTO_FIELD_INFO(addresses) {
+                info->description = "Address memberships added. Every membership in a snapshot";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::AddressMembershipDto>>, addresses);
+
+            DTO_FIELD_INFO(removedAddresses) {
+                info->description = "Address memberships removed";
+            }
+            DTO_FIELD(oatpp::Vector<oatpp::Object<primus::dto::database::AddressMembershipDto>>, removedAddresses);
+
+        };
+#include OATPP_CODEGEN_END(DTO)
+
+    } // namespace dto
+} // namespace primus
+
+#endif // SYNCDTO_HPP
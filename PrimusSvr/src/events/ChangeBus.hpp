@@ -0,0 +1,353 @@
+#ifndef CHANGEBUS_HPP
+#define CHANGEBUS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+
+#include "dto/EventDtos.hpp"
+#include "general/constants.hpp"
+#include "tenant/TenantRegistry.hpp"
+
+namespace primus
+{
+    namespace events
+    {
+        /**
+         * @brief Topics a client of GET /api/events can subscribe to, combined as a mask.
+         */
+        enum Topic : v_uint32
+        {
+            TopicMember         = 1 << 0,   // Members created, updated, activated or deactivated
+            TopicAttendance     = 1 << 1,   // Attendances added or removed
+            TopicAssociation    = 1 << 2,   // Members added to or removed from departments and addresses
+            TopicCount          = 1 << 3,   // Member counts after a change
+            TopicAll            = (1 << 4) - 1
+        };
+
+        /**
+         * Name of a topic, the event name of the stream and the name used by ?topics=
+         */
+        inline const char* topicName(Topic topic)
+        {
+            switch (topic)
+            {
+            case TopicMember:       return "member";
+            case TopicAttendance:   return "attendance";
+            case TopicAssociation:  return "association";
+            case TopicCount:        return "count";
+            default:                return "unknown";
+            }
+        }
+
+        /**
+         * Parses a comma separated list of topic names into a mask, 0 if a name is unknown. No list means every topic.
+         */
+        inline v_uint32 parseTopics(const oatpp::String& list)
+        {
+            if (!list || list->empty())
+                return TopicAll;
+
+            v_uint32 mask = 0;
+            std::size_t begin = 0;
+            while (begin <= list->size())
+            {
+                std::size_t end = list->find(',', begin);
+                if (end == std::string::npos)
+                    end = list->size();
+
+                std::string name = list->substr(begin, end - begin);
+                v_uint32 topic = 0;
+                for (v_uint32 bit = 1; bit < TopicAll; bit <<= 1)
+                {
+                    if (name == topicName(static_cast<Topic>(bit)))
+                        topic = bit;
+                }
+                if (topic == 0)
+                    return 0;
+
+                mask |= topic;
+                begin = end + 1;
+            }
+            return mask;
+        }
+
+        /**
+         * @brief One change, shared by the queues of all subscribers it is delivered to.
+         */
+        struct ChangeEvent
+        {
+            v_uint64    id;     // Increasing over all events of the process, the id: of the stream
+            Topic       topic;
+            std::string type;
+            std::string key;    // Entity the event is about, a queued event with the same key and type is superseded
+            std::string data;   // JSON of a ChangeEventDto
+        };
+
+        //  ____        _                   _       _   _
+        // / ___| _   _| |__  ___  ___ _ __(_)_ __ | |_(_) ___  _ __
+        // \___ \| | | | '_ \/ __|/ __| '__| | '_ \| __| |/ _ \| '_ \
+        //  ___) | |_| | |_) \__ \ (__| |  | | |_) | |_| | (_) | | | |
+        // |____/ \__,_|_.__/|___/\___|_|  |_| .__/ \__|_|\___/|_| |_|
+        //                                   |_|
+        /**
+         * @brief Bounded queue of the events for one client of GET /api/events.
+         *
+         * A publisher never waits for a slow client. An event superseding a queued one (same key and type,
+         * e.g. the counts or a member updated twice) replaces it. If the queue is still full, the oldest event
+         * is dropped and the client is told to resync, i.e. to fetch what it shows again.
+         */
+        class Subscription
+        {
+        private:
+            const std::string   m_tenant;
+            const v_uint32      m_topics;
+            const std::size_t   m_capacity;
+
+            mutable std::mutex                              m_lock;
+            std::condition_variable                         m_condition;
+            std::deque<std::shared_ptr<const ChangeEvent>>  m_queue;
+            v_uint64                                        m_dropped;     // Since the last resync
+            v_uint64                                        m_coalesced;
+            bool                                            m_closed;
+
+        public:
+            Subscription(const std::string& tenant, v_uint32 topics, std::size_t capacity)
+                : m_tenant(tenant)
+                , m_topics(topics)
+                , m_capacity(capacity < 1 ? 1 : capacity)
+                , m_dropped(0)
+                , m_coalesced(0)
+                , m_closed(false)
+            {}
+
+            bool wants(const std::string& tenant, Topic topic) const
+            {
+                return (m_topics & topic) != 0 && m_tenant == tenant;
+            }
+
+            void offer(const std::shared_ptr<const ChangeEvent>& event)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(m_lock);
+                    if (m_closed)
+                        return;
+
+                    for (auto it = m_queue.begin(); it != m_queue.end(); ++it)
+                    {
+                        if ((*it)->key == event->key && (*it)->type == event->type)
+                        {
+                            m_queue.erase(it);
+                            m_coalesced++;
+                            break;
+                        }
+                    }
+
+                    if (m_queue.size() >= m_capacity)
+                    {
+                        m_queue.pop_front();
+                        m_dropped++;
+                    }
+                    m_queue.push_back(event);
+                }
+                m_condition.notify_one();
+            }
+
+            /**
+             * Waits for the next event
+             *
+             * @param timeout Longest wait, nullptr is returned after it
+             * @param dropped Set to the events dropped since the last call that set it, the caller sends a resync
+             * before the events still queued
+             * @return The next event, nullptr after the timeout, once closed or if events were dropped
+             */
+            std::shared_ptr<const ChangeEvent> next(std::chrono::milliseconds timeout, v_uint64& dropped)
+            {
+                std::unique_lock<std::mutex> guard(m_lock);
+                m_condition.wait_for(guard, timeout, [this] { return m_closed || m_dropped > 0 || !m_queue.empty(); });
+
+                dropped = m_dropped;
+                if (m_dropped > 0)
+                {
+                    m_dropped = 0;
+                    return nullptr;
+                }
+                if (m_closed || m_queue.empty())
+                    return nullptr;
+
+                auto event = m_queue.front();
+                m_queue.pop_front();
+                return event;
+            }
+
+            void close()
+            {
+                {
+                    std::lock_guard<std::mutex> guard(m_lock);
+                    m_closed = true;
+                    m_queue.clear();
+                }
+                m_condition.notify_all();
+            }
+
+            bool isClosed() const
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                return m_closed;
+            }
+
+            v_uint64 getCoalesced() const
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                return m_coalesced;
+            }
+        };
+
+        //   ____ _                            ____
+        //  / ___| |__   __ _ _ __   __ _  ___| __ ) _   _ ___
+        // | |   | '_ \ / _` | '_ \ / _` |/ _ \  _ \| | | / __|
+        // | |___| | | | (_| | | | | (_| |  __/ |_) | |_| \__ \
+        //  \____|_| |_|\__,_|_| |_|\__, |\___|____/ \__,_|___/
+        //                          |___/
+        /**
+         * @brief In-process bus the write endpoints publish their changes to, delivered to the subscriptions
+         * of GET /api/events.
+         *
+         * Events are published after the write succeeded and belong to the tenant of the current request, a
+         * subscription only gets the events of its own tenant. Nothing is serialized while nobody listens.
+         * Events are not kept, a client reconnecting after a gap fetches what it shows again.
+         */
+        class ChangeBus
+        {
+        private:
+            mutable std::mutex                          m_lock;
+            std::vector<std::weak_ptr<Subscription>>    m_subscriptions;
+            std::atomic<v_uint64>                       m_lastId;
+            std::atomic<v_uint64>                       m_published;
+            std::size_t                                 m_queueSize;
+            std::size_t                                 m_maxSubscribers;
+
+            std::shared_ptr<oatpp::parser::json::mapping::ObjectMapper> m_mapper;
+
+            static std::string currentTenant()
+            {
+                const auto& tenant = primus::tenant::CurrentTenant::get();
+                return tenant ? tenant->getName() : std::string();
+            }
+
+            /**
+             * Drops the subscriptions whose stream has ended, the lock has to be held
+             */
+            void prune()
+            {
+                auto end = m_subscriptions.begin();
+                for (auto it = m_subscriptions.begin(); it != m_subscriptions.end(); ++it)
+                {
+                    auto subscription = it->lock();
+                    if (subscription && !subscription->isClosed())
+                        *end++ = *it;
+                }
+                m_subscriptions.erase(end, m_subscriptions.end());
+            }
+
+        public:
+            ChangeBus(std::size_t queueSize, std::size_t maxSubscribers)
+                : m_lastId(0)
+                , m_published(0)
+                , m_queueSize(queueSize)
+                , m_maxSubscribers(maxSubscribers)
+                , m_mapper(oatpp::parser::json::mapping::ObjectMapper::createShared())
+            {
+                m_mapper->getSerializer()->getConfig()->includeNullFields = false;
+            }
+
+            /**
+             * Subscribes the current tenant to the given topics
+             *
+             * @return The subscription, nullptr if maxSubscribers streams are open already
+             */
+            std::shared_ptr<Subscription> subscribe(v_uint32 topics)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                prune();
+                if (m_subscriptions.size() >= m_maxSubscribers)
+                    return nullptr;
+
+                auto subscription = std::make_shared<Subscription>(currentTenant(), topics, m_queueSize);
+                m_subscriptions.push_back(subscription);
+                return subscription;
+            }
+
+            /**
+             * Publishes a change of the current tenant
+             *
+             * @param key Entity the change is about, see ChangeEvent::key
+             * @param data The member, association, attendance or counts, serialized into the event
+             */
+            void publish(Topic topic, const std::string& type, const std::string& key, const oatpp::UInt32& memberId, const oatpp::Void& data)
+            {
+                std::string tenant = currentTenant();
+                std::vector<std::shared_ptr<Subscription>> receivers;
+                {
+                    std::lock_guard<std::mutex> guard(m_lock);
+                    for (const auto& weak : m_subscriptions)
+                    {
+                        auto subscription = weak.lock();
+                        if (subscription && subscription->wants(tenant, topic))
+                            receivers.push_back(subscription);
+                    }
+                }
+                if (receivers.empty())
+                    return;
+
+                auto dto = primus::dto::events::ChangeEventDto::createShared();
+                dto->type = type;
+                dto->memberId = memberId;
+                if (data)
+                    dto->data = oatpp::Any(data);
+
+                auto event = std::make_shared<ChangeEvent>();
+                event->id = ++m_lastId;
+                event->topic = topic;
+                event->type = type;
+                event->key = key;
+                event->data = m_mapper->writeToString(dto);
+
+                for (const auto& subscription : receivers)
+                    subscription->offer(event);
+                m_published++;
+            }
+
+            std::size_t getSubscriberCount() const
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                std::size_t count = 0;
+                for (const auto& weak : m_subscriptions)
+                {
+                    if (!weak.expired())
+                        count++;
+                }
+                return count;
+            }
+
+            /**
+             * Events published to at least one subscriber
+             */
+            v_uint64 getPublished() const
+            {
+                return m_published;
+            }
+        };
+
+    } // namespace events
+} // namespace primus
+
+#endif // CHANGEBUS_HPP
@@ -0,0 +1,37 @@
+#ifndef EVENTCOMPONENT_HPP
+#define EVENTCOMPONENT_HPP
+
+#include "oatpp/core/macro/component.hpp"
+
+#include "ChangeBus.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace component
+    {
+        //  _____                 _    ____                                             _
+        // | ____|_   _____ _ __ | |_ / ___|___  _ __ ___  _ __   ___  _ __   ___ _ __ | |_
+        // |  _| \ \ / / _ \ '_ \| __| |   / _ \| '_ ` _ \| '_ \ / _ \| '_ \ / _ \ '_ \| __|
+        // | |___ \ V /  __/ | | | |_| |__| (_) | | | | | | |_) | (_) | | | |  __/ | | | |_
+        // |_____| \_/ \___|_| |_|\__|\____\___/|_| |_| |_| .__/ \___/|_| |_|\___|_| |_|\__|
+        //                                                |_|
+        /**
+         * @brief Event component responsible for creating the change bus behind GET /api/events.
+         */
+        class EventComponent {
+        public:
+            // Create change bus the write endpoints publish to
+            OATPP_CREATE_COMPONENT(std::shared_ptr<primus::events::ChangeBus>, changeBus)([] {
+                return std::make_shared<primus::events::ChangeBus>(
+                    primus::environment::getUInt("PRIMUS_EVENTS_QUEUE_SIZE", primus::constants::events::queueSize),
+                    primus::environment::getUInt("PRIMUS_EVENTS_MAX_SUBSCRIBERS", primus::constants::events::maxSubscribers));
+                }());
+
+        };
+
+    } //namespace component
+} // namespace primus
+
+#endif // EVENTCOMPONENT_HPP
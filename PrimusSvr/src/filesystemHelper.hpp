@@ -4,11 +4,20 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cstdint>
+#include <ctime>
+#include <vector>
 
 #ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX    // Keeps std::min and std::max usable next to Windows.h
+#endif
 #include <Windows.h>
 #include <direct.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 #elif __linux__
+#include <dirent.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
@@ -57,6 +66,109 @@ namespace primus {
             //                 return false;
             //             }
             //         }
+
+            inline bool isDirectory(const std::string& path)
+            {
+#ifdef _WIN32
+                struct _stat64 info;
+                return _stat64(path.c_str(), &info) == 0 && (info.st_mode & _S_IFDIR) != 0;
+#elif __linux__
+                struct stat info;
+                return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+            }
+
+            /**
+             * Creates a directory, its parent has to exist
+             *
+             * @return Whether the directory exists afterwards
+             */
+            inline bool makeDirectory(const std::string& path)
+            {
+#ifdef _WIN32
+                _mkdir(path.c_str());
+#elif __linux__
+                mkdir(path.c_str(), 0755);
+#endif
+                return isDirectory(path);
+            }
+
+            /**
+             * Size and modification time of a file
+             *
+             * @return False if the file does not exist
+             */
+            inline bool fileStatus(const std::string& path, std::uint64_t& bytes, std::int64_t& modified)
+            {
+#ifdef _WIN32
+                struct _stat64 info;
+                if (_stat64(path.c_str(), &info) != 0)
+                    return false;
+#elif __linux__
+                struct stat info;
+                if (stat(path.c_str(), &info) != 0)
+                    return false;
+#endif
+                bytes = static_cast<std::uint64_t>(info.st_size);
+                modified = static_cast<std::int64_t>(info.st_mtime);
+                return true;
+            }
+
+            inline bool exists(const std::string& path)
+            {
+                std::uint64_t bytes;
+                std::int64_t modified;
+                return fileStatus(path, bytes, modified);
+            }
+
+            /**
+             * Names of the entries of a directory, without "." and "..". Empty if the directory can't be read
+             */
+            inline std::vector<std::string> listDirectory(const std::string& path)
+            {
+                std::vector<std::string> names;
+#ifdef _WIN32
+                WIN32_FIND_DATAA entry;
+                HANDLE directory = FindFirstFileA((path + "\\*").c_str(), &entry);
+                if (directory == INVALID_HANDLE_VALUE)
+                    return names;
+
+                do
+                {
+                    std::string name = entry.cFileName;
+                    if (name != "." && name != "..")
+                        names.push_back(name);
+                } while (FindNextFileA(directory, &entry));
+                FindClose(directory);
+#elif __linux__
+                DIR* directory = opendir(path.c_str());
+                if (directory == nullptr)
+                    return names;
+
+                while (struct dirent* entry = readdir(directory))
+                {
+                    std::string name = entry->d_name;
+                    if (name != "." && name != "..")
+                        names.push_back(name);
+                }
+                closedir(directory);
+#endif
+                return names;
+            }
+
+            /**
+             * Converts a time to the local calendar time, thread safe on both platforms
+             */
+            inline std::tm localTime(std::time_t time)
+            {
+                std::tm local;
+#ifdef _WIN32
+                localtime_s(&local, &time);
+#elif __linux__
+                localtime_r(&time, &local);
+#endif
+                return local;
+            }
         } // filesystem
     } // namespace component
 } // Namespace primus
@@ -9,55 +9,29 @@
 #include "dto/Int32Dto.hpp"
 #include "dto/BooleanDto.hpp"
 #include "general/constants.hpp"
+#include "general/errors.hpp"
 #include "dto/DatabaseDtos.hpp"
+#include "database/MemberDirectory.hpp"
+#include "tenant/TenantRegistry.hpp"
 
 namespace primus
 {
     namespace assert
     {
-        oatpp::Object<primus::dto::StatusDto> assertMemberExists(const oatpp::UInt32 memberId)
+        /**
+         * Checks wheather or not a member exists. The check is answered by the in-memory MemberDirectory
+         * and does not touch the database. In multi-tenant mode the directory of the current tenant is asked.
+         *
+         * @return Error::None, or Error::MemberNotFound to be answered by primus::error::ErrorResponses
+         */
+        primus::error::Error assertMemberExists(const oatpp::UInt32 memberId)
         {
-            OATPP_COMPONENT(std::shared_ptr<primus::component::DatabaseClient>, m_database);
+            OATPP_COMPONENT(std::shared_ptr<primus::component::MemberDirectory>, m_directory);
 
-            oatpp::Object<primus::dto::StatusDto> ret = primus::dto::StatusDto::createShared();
+            const auto& tenant = primus::tenant::CurrentTenant::get();
+            const auto& directory = tenant ? tenant->getDirectory() : m_directory;
 
-            auto dbResult = m_database->getMemberById(memberId);
-
-            ret->code = 500;
-            ret->message = "Unknown error";
-            ret->status = "During check for wheather or not a member exists an unknown error accourd";
-
-            if (!dbResult->isSuccess())
-            {
-                ret->code = 500;
-                ret->message = dbResult->getErrorMessage();
-                ret->status = "Failed to ask for member at database";
-            } 
-            else
-            {
-                auto member = dbResult->fetch<oatpp::Vector<oatpp::Object<primus::dto::database::MemberDto>>>();
-
-                if (member->size() == 0)
-                {
-                    ret->code = 404;
-                    ret->message = "Database request was successfully executed. The retrieved data did not include a member";
-                    ret->status = "Member could not be found";
-                }
-                else if(member->size() > 1)
-                {
-                    OATPP_LOGE("Primus Assertion: ", "CRITICAL DATABASE ERROR: MORE THAN ONE USER WITH ID %d", memberId.operator v_uint32());
-                    ret->code = 500;
-                    ret->message = "During check for wheather a user exists, the retrieved data contained 2 seperate MemberDtos";
-                    ret->status = "CRITICAL DATABASE ERROR: MORE THAN ONE USER";
-                }
-                else
-                {
-                    ret->code = 200;
-                    ret->message = "OK";
-                    ret->status = "Member was found";
-                }
-            }
-            return ret;
+            return directory->exists(memberId) ? primus::error::Error::None : primus::error::Error::MemberNotFound;
         }
     }   // Namespace asserts
 }   // Namespace primus
@@ -0,0 +1,155 @@
+#ifndef PRIMUSATTRIBUTES_HPP
+#define PRIMUSATTRIBUTES_HPP
+
+#include <cstring>
+#include <vector>
+
+#include "oatpp/core/Types.hpp"
+
+namespace primus
+{
+    namespace attribute
+    {
+        /**
+         * @brief The {attribute} path segments of the member lists and counts, e.g. /api/members/list/active.
+         */
+        enum class Attribute : v_uint32
+        {
+            Unknown,
+            All,
+            Active,
+            Inactive,
+            Birthday,
+            Addresses,
+            Departments,
+            Attendances,
+            Count
+        };
+
+        constexpr v_uint32 bit(Attribute attribute)
+        {
+            return 1u << static_cast<v_uint32>(attribute);
+        }
+
+        /* Bundle data of a request holding its resolved attribute, see primus::interceptor::AttributeInterceptor */
+        const char bundleKey[] = "attribute";
+
+        /* The attributes each endpoint accepts */
+        const v_uint32 memberLists      = bit(Attribute::All) | bit(Attribute::Active) | bit(Attribute::Inactive) | bit(Attribute::Birthday);
+        const v_uint32 memberCounts     = bit(Attribute::All) | bit(Attribute::Active) | bit(Attribute::Inactive);
+        const v_uint32 associationLists = bit(Attribute::Addresses) | bit(Attribute::Departments) | bit(Attribute::Attendances);
+
+        /**
+         * The path segment of an attribute
+         */
+        inline const char* name(Attribute attribute)
+        {
+            static const char* const names[] = { "", "all", "active", "inactive", "birthday", "addresses", "departments", "attendances" };
+            static_assert(sizeof(names) / sizeof(names[0]) == static_cast<std::size_t>(Attribute::Count), "Every attribute needs its name");
+
+            return names[static_cast<v_uint32>(attribute)];
+        }
+
+        //     _   _   _        _ _           _      _____     _
+        //    / \ | |_| |_ _ __(_) |__  _   _| |_ __|_   _| __(_) ___
+        //   / _ \| __| __| '__| | '_ \| | | | __/ _ \| || '__| |/ _ \
+        //  / ___ \ |_| |_| |  | | |_) | |_| | ||  __/| || |  | |  __/
+        // /_/   \_\__|\__|_|  |_|_.__/ \__,_|\__\___||_||_|  |_|\___|
+        /**
+         * @brief Prefix trie of the attribute names, built once.
+         *
+         * A segment is resolved by one step per character and rejected at the first one no name continues
+         * with, instead of being compared against every name in turn.
+         */
+        class AttributeTrie
+        {
+        private:
+            struct Node
+            {
+                v_uint8     children[26];   // Index of the node following a letter, 0 for none as the root follows none
+                Attribute   attribute;
+
+                Node() : attribute(Attribute::Unknown)
+                {
+                    std::memset(children, 0, sizeof(children));
+                }
+            };
+
+            std::vector<Node> m_nodes;
+
+            void insert(Attribute attribute)
+            {
+                v_uint8 node = 0;
+                for (const char* c = name(attribute); *c != '\0'; c++)
+                {
+                    v_uint8 child = m_nodes[node].children[*c - 'a'];
+                    if (child == 0)
+                    {
+                        child = static_cast<v_uint8>(m_nodes.size());
+                        m_nodes[node].children[*c - 'a'] = child;
+                        m_nodes.push_back(Node());
+                    }
+                    node = child;
+                }
+                m_nodes[node].attribute = attribute;
+            }
+
+            AttributeTrie()
+                : m_nodes(1)
+            {
+                for (v_uint32 attribute = 1; attribute < static_cast<v_uint32>(Attribute::Count); attribute++)
+                    insert(static_cast<Attribute>(attribute));
+            }
+
+        public:
+            static const AttributeTrie& get()
+            {
+                static const AttributeTrie trie;
+                return trie;
+            }
+
+            /**
+             * The attribute a path segment names, Attribute::Unknown for any other segment
+             */
+            Attribute find(const oatpp::String& segment) const
+            {
+                if (!segment)
+                    return Attribute::Unknown;
+
+                v_uint8 node = 0;
+                for (const char c : *segment)
+                {
+                    if (c < 'a' || c > 'z')
+                        return Attribute::Unknown;
+                    node = m_nodes[node].children[c - 'a'];
+                    if (node == 0)
+                        return Attribute::Unknown;
+                }
+                return m_nodes[node].attribute;
+            }
+        };
+
+        /**
+         * Resolves the {attribute} of a request once, before it is routed
+         *
+         * @param accepted The attributes of the endpoint, e.g. memberLists
+         * @return The attribute, Attribute::Unknown if the segment names none of the accepted ones
+         */
+        inline Attribute resolve(const oatpp::String& segment, v_uint32 accepted)
+        {
+            Attribute attribute = AttributeTrie::get().find(segment);
+            return (bit(attribute) & accepted) != 0 ? attribute : Attribute::Unknown;
+        }
+
+        /**
+         * The attribute the AttributeInterceptor resolved, as an endpoint reads it from the bundle data
+         */
+        inline Attribute fromBundle(const oatpp::UInt32& resolved)
+        {
+            return resolved ? static_cast<Attribute>(*resolved) : Attribute::Unknown;
+        }
+
+    } // namespace attribute
+} // namespace primus
+
+#endif // PRIMUSATTRIBUTES_HPP
@@ -10,17 +10,12 @@ namespace primus
 		const std::size_t logNameLength = 20;
 		const std::size_t logSeperationLength = 60;
 
-		namespace pricing
+		namespace cache
 		{
-			enum DepartmentPrices
-			{
-				Bogenschiessen = 8,
-				Luftdruck = 10,
-				Schusswaffen = 15,
-				Multiple = 20,
-				None = 0
-			};
-		}
+			const std::size_t maxEntries			 = 256;		// Entries kept by the response cache before the least recently used one is evicted
+			const std::size_t compressionThreshold = 1024;	// Bodies smaller than this are not worth a gzip variant
+			const unsigned long singleFlightWindow = 2000;	// PRIMUS_SINGLE_FLIGHT_WINDOW_MS, age up to which a running computation is joined by identical requests (0 disables)
+		} // Namespace cache
 
 		namespace main
 		{
@@ -28,6 +23,152 @@ namespace primus
 			const char logSeperation[logSeperationLength] = "-----------------------------";
 		} // Namespace main
 
+		namespace database
+		{
+			namespace pool
+			{
+				const char logName[logNameLength] = "ConnectionPool     ";
+
+				// Defaults, each one can be overridden by the environment variable named in the comment
+				const unsigned long maxConnections	   = 10;	// PRIMUS_DB_POOL_SIZE
+				const unsigned long minConnections	   = 2;		// PRIMUS_DB_POOL_MIN_SIZE (lower bound of the adaptive mode)
+				const unsigned long connectionTtl	   = 600;	// PRIMUS_DB_POOL_TTL_SECONDS
+				const unsigned long warmupConnections  = 4;		// PRIMUS_DB_POOL_WARMUP
+				const unsigned long checkoutTimeout	   = 5000;	// PRIMUS_DB_POOL_CHECKOUT_TIMEOUT_MS
+				const bool			adaptive		   = false;	// PRIMUS_DB_POOL_ADAPTIVE
+				const unsigned long adaptiveInterval   = 5000;	// PRIMUS_DB_POOL_ADAPTIVE_INTERVAL_MS
+				const unsigned long adaptiveWaitTarget = 2000;	// Average checkout wait in microseconds above which the adaptive mode grows the pool
+				const unsigned long statementCacheSize = 64;	// PRIMUS_DB_STATEMENT_CACHE_SIZE, prepared statements kept per connection (0 disables the cache)
+			} // Namespace pool
+
+			namespace query
+			{
+				const unsigned long defaultTimeout   = 5000;	// PRIMUS_DB_QUERY_TIMEOUT_MS, deadline of a query without its own entry below
+				const unsigned long busyTimeout      = 1000;	// Longest single wait for a database lock, shortened further by the deadline
+				const int			progressInterval = 1000;	// Virtual machine instructions between two deadline checks
+				const unsigned long requestTimeout   = 10000;	// PRIMUS_REQUEST_TIMEOUT_MS, shared by all queries of one request
+
+				// Deadlines by query name, extended or overridden by PRIMUS_DB_QUERY_TIMEOUTS (same format)
+				const char timeoutOverrides[] = "getMemberDirectoryEntries=30000,getDepartmentMemberships=30000,getMembersWithUpcomingBirthday=2000,getMembersByAttendanceDate=2000,"
+											  "getAttendanceReport=30000,getFeeRunReport=30000,getWeaponPurchaseReport=30000,getArchivedAttendanceReport=30000,"
+											  "getSyncMembers=30000,getAddressMemberships=30000";
+			} // Namespace query
+
+			namespace monitor
+			{
+				const char logName[logNameLength] = "QueryMonitor       ";
+
+				const unsigned long slowQueryThreshold = 100;	// PRIMUS_DB_SLOW_QUERY_MS, queries taking longer end up in the slow query log
+				const std::size_t	slowQueryLogSize   = 100;	// Slow queries kept, the oldest one is dropped first
+			} // Namespace monitor
+
+			namespace backup
+			{
+				const char logName[logNameLength] = "BackupService      ";
+
+				const char			filePrefix[]  = "primus-";	// Snapshots are named primus-YYYYmmdd-HHMMSS.sqlite
+				const char			fileSuffix[]  = ".sqlite";
+				const unsigned long pagesPerStep  = 64;			// PRIMUS_BACKUP_PAGES_PER_STEP, pages copied while holding the read lock
+				const unsigned long stepPause	  = 20;			// PRIMUS_BACKUP_STEP_PAUSE_MS, pause between two steps
+				const unsigned long keep		  = 7;			// PRIMUS_BACKUP_KEEP, snapshots kept, older ones are removed
+				const bool			scheduled	  = true;		// PRIMUS_BACKUP_SCHEDULED
+				const unsigned long hour		  = 3;			// PRIMUS_BACKUP_HOUR, local hour of the scheduled backup, far from the evening trainings
+				const unsigned long intervalHours = 24;			// PRIMUS_BACKUP_INTERVAL_HOURS
+				const int			maxRestarts	  = 3;			// Restarts of a copy by concurrent writes before the rest is copied in one step
+			} // Namespace backup
+
+			namespace reporting
+			{
+				const char logName[logNameLength] = "ReportingDatabase  ";
+
+				const char			filePrefix[]	= "reporting-";	// Snapshots are named reporting-<generation>.sqlite
+				const char			fileSuffix[]	= ".sqlite";
+				const unsigned long refreshMinutes	= 15;			// PRIMUS_REPORTING_REFRESH_MINUTES, age after which the reporting snapshot is replaced
+				const unsigned long maxConnections	= 4;			// PRIMUS_REPORTING_POOL_SIZE, reports are few but long running
+				const unsigned long mmapSize		= 268435456;	// PRIMUS_REPORTING_MMAP_BYTES, the snapshot never changes, so it is read through the page cache
+				const unsigned long connectionTtl	= 600;			// Seconds an idle reporting connection stays open
+			} // Namespace reporting
+
+			namespace archive
+			{
+				const char logName[logNameLength] = "AttendanceArchive  ";
+
+				const char			filePrefix[] = "attendance-";	// Archives are named attendance-YYYY.sqlite, one per closed year
+				const char			fileSuffix[] = ".sqlite";
+				const unsigned long hotYears	 = 2;				// PRIMUS_ARCHIVE_HOT_YEARS, years kept in the Attendance table, the current one included
+				const unsigned long batchSize	 = 500;				// PRIMUS_ARCHIVE_BATCH_SIZE, rows moved per transaction
+				const unsigned long batchPause	 = 50;				// PRIMUS_ARCHIVE_BATCH_PAUSE_MS, pause between two batches
+				const bool			scheduled	 = true;			// PRIMUS_ARCHIVE_SCHEDULED, move closed years once a day
+				const unsigned long hour		 = 4;				// PRIMUS_ARCHIVE_HOUR, local hour of the scheduled run, after the backup
+				const unsigned long maxAttached	 = 10;				// Archived years one history query may span, the attach limit of sqlite
+			} // Namespace archive
+
+			namespace address
+			{
+				const char logName[logNameLength] = "AddressDeduplicator";
+
+				const unsigned long batchSize  = 100;	// Addresses keyed or merged per batch by the AddressDeduplicator
+				const unsigned long batchPause = 50;	// Milliseconds between two batches, requests get the write lock in between
+			} // Namespace address
+
+			namespace arena
+			{
+				const std::size_t	 chunkSize	  = 65536;	// Bytes of an Arena chunk, the text of a page of rows usually fits into one
+				const std::size_t	 rowBytes	  = 256;		// Estimated JSON bytes of a member row, sizes the output buffer of a page
+				const unsigned long reservedRows = 500;		// Rows reserved up front at most, however large the requested limit
+			} // Namespace arena
+
+			namespace referencedata
+			{
+				const char logName[logNameLength] = "ReferenceData      ";
+
+				// Rules of the Pricing table, the fees themselves live in the database
+				const char noneRule[]	  = "none";		// Member without a department
+				const char multipleRule[] = "multiple";	// Member of more than one department
+				const char singleRule[]	  = "single";	// Member of exactly the department of the rule
+			} // Namespace referencedata
+		} // Namespace database
+
+		namespace tenant
+		{
+			const char logName[logNameLength] = "TenantRegistry     ";
+
+			// Defaults, each one can be overridden by the environment variable named in the comment
+			const bool			enabled			= false;				// PRIMUS_MULTI_TENANT, serve one database per club from one process
+			const bool			byHost			= true;					// PRIMUS_TENANT_BY_HOST, fall back to the first label of the Host header
+			const unsigned long maxOpen			= 16;					// PRIMUS_TENANT_MAX_OPEN, open tenants before the least recently used one is closed
+			const unsigned long idleMinutes		= 30;					// PRIMUS_TENANT_IDLE_MINUTES, tenants unused this long are closed
+			const unsigned long maxConnections	= 4;					// PRIMUS_TENANT_POOL_SIZE, connections per tenant pool
+			const std::size_t	maxNameLength	= 63;					// A tenant name is a single DNS label
+			const char			header[]		= "X-Tenant";			// Request header naming the tenant explicitly
+			const char			databaseFile[]	= "database.sqlite";	// <tenant directory>/database.sqlite
+			const char			assets[]		= "assets/member";		// <tenant directory>/assets/member
+		} // Namespace tenant
+
+		namespace mapping
+		{
+			const char logName[logNameLength] = "ObjectMapper       ";
+
+			// Media types of the encodings picked by the Accept and Content-Type headers
+			const char jsonContentType[]					= "application/json";
+			const char cborContentType[]					= "application/cbor";
+			const char messagePackContentType[]				= "application/msgpack";
+			const char messagePackAlternativeContentType[]	= "application/x-msgpack";	// Still sent by most MessagePack clients
+			const unsigned int maxDepth						= 64;						// Nesting of arrays and maps a CBOR or MessagePack body may have
+		} // Namespace mapping
+
+		namespace events
+		{
+			const char logName[logNameLength] = "ChangeBus          ";
+
+			// Defaults, each one can be overridden by the environment variable named in the comment
+			const unsigned long queueSize		 = 256;	// PRIMUS_EVENTS_QUEUE_SIZE, events queued per subscriber before the oldest one is dropped
+			const unsigned long maxSubscribers	 = 64;	// PRIMUS_EVENTS_MAX_SUBSCRIBERS, open streams, each one holds a connection thread
+			const unsigned long keepAlive		 = 15;	// Seconds without an event after which a stream sends a comment, so dead clients are noticed
+			const unsigned long retry			 = 3000;	// Milliseconds a disconnected EventSource waits before reconnecting
+			const char			contentType[]	 = "text/event-stream";
+		} // Namespace events
+
 		namespace databaseclient
 		{
 			const char logName[logNameLength] = "DatabaseClient     ";
@@ -48,8 +189,60 @@ namespace primus
 					// Name and seperation while logging
 					const char logName[logNameLength]		      = "MemberController   ";
 					const char logSeperation[logSeperationLength] = "------------------------";
+
+					namespace profile
+					{
+						// Sections of GET /api/member/{id}/profile, selected by ?include=member,addresses,...
+						const char member[]			= "member";
+						const char addresses[]		= "addresses";
+						const char departments[]	= "departments";
+						const char attendances[]	= "attendances";
+						const char fee[]			= "fee";
+						const char weaponPurchase[]	= "weaponpurchase";
+						const char avatar[]			= "avatar";
+
+						const unsigned int sectionLimit	= 100;	// Rows per list section, the profile page shows no more
+					} // Namespace profile
 			} // Namespace Member
+
+			namespace admin_endpoint
+			{
+					// Name and seperation while logging
+					const char logName[logNameLength]		      = "AdminController    ";
+					const char logSeperation[logSeperationLength] = "------------------------";
+			} // Namespace admin_endpoint
+
+			namespace report_endpoint
+			{
+					// Name and seperation while logging
+					const char logName[logNameLength]		      = "ReportController   ";
+					const char logSeperation[logSeperationLength] = "------------------------";
+			} // Namespace report_endpoint
+
+			namespace batch_endpoint
+			{
+					// Name and seperation while logging
+					const char logName[logNameLength]		      = "BatchController    ";
+					const char logSeperation[logSeperationLength] = "------------------------";
+
+					const unsigned long maxRequests	= 32;	// Sub-requests of one batch, more are answered with 400
+					const unsigned long parallelism	= 4;	// PRIMUS_BATCH_PARALLELISM, reads of a batch running at once (1 runs everything in order)
+			} // Namespace batch_endpoint
+
+			namespace event_endpoint
+			{
+					// Name and seperation while logging
+					const char logName[logNameLength]		      = "EventController    ";
+					const char logSeperation[logSeperationLength] = "------------------------";
+			} // Namespace event_endpoint
+
+			namespace sync_endpoint
+			{
+					// Name and seperation while logging
+					const char logName[logNameLength]		      = "SyncController     ";
+					const char logSeperation[logSeperationLength] = "------------------------";
+			} // Namespace sync_endpoint
 		} // Namespace ApiController
 	} // Namespace constants
 } // Namespace Primus
-#endif // PRIMUSCONSTANTS_HPP
\ No newline at end of file
+#endif // PRIMUSCONSTANTS_HPP
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef PRIMUSENVIRONMENT_HPP
+#define PRIMUSENVIRONMENT_HPP
+
+#include <cstdlib>
+#include <string>
+
+namespace primus
+{
+    namespace environment
+    {
+        /**
+         * Reads an unsigned integer from an environment variable
+         *
+         * @param name Name of the environment variable, e.g. PRIMUS_DB_POOL_SIZE
+         * @param fallback Value returned if the variable is not set or not a number
+         *
+         */
+        inline unsigned long getUInt(const char* name, unsigned long fallback)
+        {
+            const char* value = std::getenv(name);
+            if (value == nullptr || *value == '\0')
+                return fallback;
+
+            char* end = nullptr;
+            unsigned long result = std::strtoul(value, &end, 10);
+            return (end != nullptr && *end == '\0') ? result : fallback;
+        }
+
+        /**
+         * Reads a boolean from an environment variable. "1", "true", "yes" and "on" are treated as true
+         */
+        inline bool getBool(const char* name, bool fallback)
+        {
+            const char* value = std::getenv(name);
+            if (value == nullptr || *value == '\0')
+                return fallback;
+
+            std::string text(value);
+            return text == "1" || text == "true" || text == "yes" || text == "on";
+        }
+
+        /**
+         * Reads a string from an environment variable
+         */
+        inline std::string getString(const char* name, const std::string& fallback)
+        {
+            const char* value = std::getenv(name);
+            return (value == nullptr || *value == '\0') ? fallback : std::string(value);
+        }
+    } // namespace environment
+} // namespace primus
+
+#endif // PRIMUSENVIRONMENT_HPP
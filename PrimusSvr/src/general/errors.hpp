@@ -0,0 +1,245 @@
+#ifndef PRIMUSERRORS_HPP
+#define PRIMUSERRORS_HPP
+
+#include <cstring>
+#include <memory>
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/web/protocol/http/outgoing/BufferBody.hpp"
+#include "oatpp/web/protocol/http/outgoing/Response.hpp"
+#include "oatpp/web/protocol/http/outgoing/ResponseFactory.hpp"
+#include "oatpp/web/server/handler/ErrorHandler.hpp"
+
+#include "dto/StatusDto.hpp"
+#include "mapping/ContentNegotiation.hpp"
+
+namespace primus
+{
+    namespace error
+    {
+        /**
+         * @brief Errors answered without throwing, each one by a body serialized once at startup.
+         */
+        enum class Error : v_uint32
+        {
+            None,
+            RouteNotFound,
+            MemberNotFound,
+            DepartmentNotFound,
+            FileNotFound,
+            PictureNotFound,
+            InvalidListAttribute,
+            InvalidCountAttribute,
+            InvalidAssociationAttribute,
+            MissingField,
+            MemberChanged,
+            AddressNotFound,
+            AddressNotUnique,
+            UnknownProfileSection,
+            NoFieldsSelected,
+            UnknownField,
+            Count
+        };
+
+        /**
+         * @brief Status and StatusDto texts of an error.
+         */
+        struct ErrorInfo
+        {
+            oatpp::web::protocol::http::Status  status;
+            const char*                         text;
+            const char*                         message;
+        };
+
+        inline const ErrorInfo& info(Error error)
+        {
+            typedef oatpp::web::protocol::http::Status Status;
+
+            static const ErrorInfo infos[] = {
+                { Status::CODE_200, "OK", "OK" },
+                { Status::CODE_404, "NOT FOUND", "No endpoint is mapped to the requested method and path" },
+                { Status::CODE_404, "Member could not be found", "The member directory does not contain a member with the given id" },
+                { Status::CODE_404, "Department could not be found", "There is no department with the given id" },
+                { Status::CODE_404, "NOT FOUND", "The requested file could not be found" },
+                { Status::CODE_404, "NOT FOUND", "No picture to serve, the default profile pictures are missing as well" },
+                { Status::CODE_404, "INVALID ATTRIBUTE", "Received request to get a list of members with invalid attribute. Available options: birthday, all, active or inactive" },
+                { Status::CODE_404, "INVALID ATTRIBUTE", "Received request for a count of members with invalid attribute. Available options: all, active, inactive" },
+                { Status::CODE_404, "INVALID ATTRIBUTE", "Received request to get a list of members with invalid attribute. Available options: addresses, departments, attendances" },
+                { Status::CODE_403, "At least one necessary field was null", "At least one necessary field was null" },
+                { Status::CODE_412, "PRECONDITION FAILED", "The member was changed since it was read" },
+                { Status::CODE_404, "Address could not be found", "There is no address with the given id" },
+                { Status::CODE_500, "Critical database error", "More than one address has the given id" },
+                { Status::CODE_400, "UNKNOWN SECTION", "Received request for a profile with an unknown section. Available options: member, addresses, departments, attendances, fee, weaponpurchase, avatar" },
+                { Status::CODE_400, "NO FIELDS", "The fields parameter does not name any field" },
+                { Status::CODE_400, "UNKNOWN FIELD", "The fields parameter names a field the member does not have" }
+            };
+            static_assert(sizeof(infos) / sizeof(infos[0]) == static_cast<std::size_t>(Error::Count), "Every error needs its info");
+
+            return infos[static_cast<v_uint32>(error)];
+        }
+
+        /**
+         * @brief The value of an operation or the error it failed with, for the paths answering an error without
+         * throwing an HttpError.
+         */
+        template<typename T>
+        class Result
+        {
+        private:
+            T       m_value;
+            Error   m_error;
+
+            Result(const T& value, Error error)
+                : m_value(value)
+                , m_error(error)
+            {}
+
+        public:
+            static Result ok(const T& value)
+            {
+                return Result(value, Error::None);
+            }
+
+            static Result fail(Error error)
+            {
+                return Result(T(), error);
+            }
+
+            bool isOk() const
+            {
+                return m_error == Error::None;
+            }
+
+            Error getError() const
+            {
+                return m_error;
+            }
+
+            const T& getValue() const
+            {
+                return m_value;
+            }
+        };
+
+        //  _____                     ____
+        // | ____|_ __ _ __ ___  _ __|  _ \ ___  ___ _ __   ___  _ __  ___  ___  ___
+        // |  _| | '__| '__/ _ \| '__| |_) / _ \/ __| '_ \ / _ \| '_ \/ __|/ _ \/ __|
+        // | |___| |  | | | (_) | |  |  _ <  __/\__ \ |_) | (_) | | | \__ \  __/\__ \
+        // |_____|_|  |_|  \___/|_|  |_| \_\___||___/ .__/ \___/|_| |_|___/\___||___/
+        //                                          |_|
+        /**
+         * @brief The responses of the errors, serialized once per encoding.
+         *
+         * Answering one costs a lookup and a response sharing the body, as much as a cached page. A flood of
+         * requests for missing members, files or routes thereby costs less than the successful requests.
+         */
+        class ErrorResponses
+        {
+        private:
+            static const v_uint32 encodingCount = 3;
+
+            std::shared_ptr<primus::mapping::NegotiatingObjectMapper>   m_mapper;
+            oatpp::String                                               m_bodies[static_cast<v_uint32>(Error::Count)][encodingCount];
+
+            static v_uint32 index(primus::mapping::Encoding encoding)
+            {
+                switch (encoding)
+                {
+                case primus::mapping::Encoding::Cbor:           return 1;
+                case primus::mapping::Encoding::MessagePack:    return 2;
+                default:                                        return 0;
+                }
+            }
+
+        public:
+            ErrorResponses(const std::shared_ptr<primus::mapping::NegotiatingObjectMapper>& mapper)
+                : m_mapper(mapper)
+            {
+                const primus::mapping::Encoding encodings[encodingCount] = {
+                    primus::mapping::Encoding::Json, primus::mapping::Encoding::Cbor, primus::mapping::Encoding::MessagePack
+                };
+
+                for (v_uint32 error = 0; error < static_cast<v_uint32>(Error::Count); error++)
+                {
+                    const ErrorInfo& errorInfo = info(static_cast<Error>(error));
+
+                    auto status = primus::dto::StatusDto::createShared();
+                    status->code = errorInfo.status.code;
+                    status->status = errorInfo.text;
+                    status->message = errorInfo.message;
+
+                    for (const auto encoding : encodings)
+                        m_bodies[error][index(encoding)] = mapper->getMapper(encoding)->writeToString(status);
+                }
+            }
+
+            /**
+             * The mapper the bodies were serialized with, for the errors answered otherwise
+             */
+            const std::shared_ptr<primus::mapping::NegotiatingObjectMapper>& getMapper() const
+            {
+                return m_mapper;
+            }
+
+            /**
+             * The response of an error in the encoding of the current request
+             */
+            std::shared_ptr<oatpp::web::protocol::http::outgoing::Response> createResponse(Error error) const
+            {
+                const auto& body = m_bodies[static_cast<v_uint32>(error)][index(primus::mapping::CurrentEncoding::getResponse())];
+                return oatpp::web::protocol::http::outgoing::Response::createShared(info(error).status,
+                    oatpp::web::protocol::http::outgoing::BufferBody::createShared(body, primus::mapping::CurrentEncoding::getContentType()));
+            }
+        };
+
+        //  _____                     _   _                 _ _
+        // | ____|_ __ _ __ ___  _ __| | | | __ _ _ __   __| | | ___ _ __
+        // |  _| | '__| '__/ _ \| '__| |_| |/ _` | '_ \ / _` | |/ _ \ '__|
+        // | |___| |  | | | (_) | |  |  _  | (_| | | | | (_| | |  __/ |
+        // |_____|_|  |_|  \___/|_|  |_| |_|\__,_|_| |_|\__,_|_|\___|_|
+        /**
+         * @brief Answers the HttpErrors still thrown, e.g. by OATPP_ASSERT_HTTP, and requests no endpoint is
+         * mapped to, by a StatusDto instead of the plain text of oatpp.
+         *
+         * Requests for unmapped paths, mostly scanners, get the serialized RouteNotFound response.
+         */
+        class ErrorHandler : public oatpp::web::server::handler::ErrorHandler
+        {
+        private:
+            std::shared_ptr<ErrorResponses> m_responses;
+
+        public:
+            ErrorHandler(const std::shared_ptr<ErrorResponses>& responses)
+                : m_responses(responses)
+            {}
+
+            std::shared_ptr<oatpp::web::protocol::http::outgoing::Response> handleError(const oatpp::web::protocol::http::Status& status,
+                                                                                       const oatpp::String& message,
+                                                                                       const Headers& headers) override
+            {
+                std::shared_ptr<oatpp::web::protocol::http::outgoing::Response> response;
+
+                /* The router names the method and path in its message, which is not sent */
+                if (status.code == 404 && message && message->compare(0, std::strlen("No mapping"), "No mapping") == 0)
+                {
+                    response = m_responses->createResponse(Error::RouteNotFound);
+                }
+                else
+                {
+                    auto dto = primus::dto::StatusDto::createShared();
+                    dto->code = status.code;
+                    dto->status = status.description;
+                    dto->message = message;
+                    response = oatpp::web::protocol::http::outgoing::ResponseFactory::createResponse(status, dto, m_responses->getMapper());
+                }
+
+                for (const auto& pair : headers.getAll())
+                    response->putHeader_Unsafe(pair.first, pair.second);
+                return response;
+            }
+        };
+
+    } // namespace error
+} // namespace primus
+
+#endif // PRIMUSERRORS_HPP
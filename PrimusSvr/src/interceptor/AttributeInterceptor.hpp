@@ -0,0 +1,89 @@
+#ifndef ATTRIBUTEINTERCEPTOR_HPP
+#define ATTRIBUTEINTERCEPTOR_HPP
+
+#include <vector>
+
+#include "oatpp/web/server/interceptor/RequestInterceptor.hpp"
+#include "oatpp/web/url/mapping/Pattern.hpp"
+
+#include "general/attributes.hpp"
+#include "general/errors.hpp"
+
+namespace primus
+{
+    namespace interceptor
+    {
+        //     _   _   _        _ _           _       ___       _                          _
+        //    / \ | |_| |_ _ __(_) |__  _   _| |_ ___|_ _|_ __ | |_ ___ _ __ ___ ___ _ __ | |_ ___  _ __
+        //   / _ \| __| __| '__| | '_ \| | | | __/ _ \| || '_ \| __/ _ \ '__/ __/ _ \ '_ \| __/ _ \| '__|
+        //  / ___ \ |_| |_| |  | | |_) | |_| | ||  __/| || | | | ||  __/ | | (_|  __/ |_) | || (_) | |
+        // /_/   \_\__|\__|_|  |_|_.__/ \__,_|\__\___|___|_| |_|\__\___|_|  \___\___| .__/ \__\___/|_|
+        //                                                                          |_|
+        /**
+         * @brief Resolves the {attribute} of the member lists and counts once, before the request is routed.
+         *
+         * The paths are matched against the same patterns their endpoints are routed by, the segment is resolved
+         * through primus::attribute::AttributeTrie. An unknown one is answered by the serialized error of its
+         * endpoint without reaching the router or the controller, a known one is handed to the endpoint as the
+         * bundle data primus::attribute::bundleKey.
+         */
+        class AttributeInterceptor : public oatpp::web::server::interceptor::RequestInterceptor
+        {
+        private:
+            /**
+             * @brief An endpoint taking an {attribute}, with the attributes it accepts.
+             */
+            struct Route
+            {
+                std::shared_ptr<oatpp::web::url::mapping::Pattern>  pattern;
+                v_uint32                                            accepted;
+                primus::error::Error                                unknown;    // Answer to any other attribute
+            };
+
+            std::shared_ptr<primus::error::ErrorResponses>  m_errors;
+            std::vector<Route>                              m_routes;
+
+            void add(const char* path, v_uint32 accepted, primus::error::Error unknown)
+            {
+                Route route;
+                route.pattern = oatpp::web::url::mapping::Pattern::parse(path);
+                route.accepted = accepted;
+                route.unknown = unknown;
+                m_routes.push_back(route);
+            }
+
+        public:
+            AttributeInterceptor(const std::shared_ptr<primus::error::ErrorResponses>& errors)
+                : m_errors(errors)
+            {
+                add("/api/members/list/{attribute}", primus::attribute::memberLists, primus::error::Error::InvalidListAttribute);
+                add("/api/members/count/{attribute}", primus::attribute::memberCounts, primus::error::Error::InvalidCountAttribute);
+                add("/api/member/{memberId}/list/{attribute}", primus::attribute::associationLists, primus::error::Error::InvalidAssociationAttribute);
+            }
+
+            std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request) override
+            {
+                if (request->getStartingLine().method.std_str() != "GET")
+                    return nullptr;
+
+                for (const auto& route : m_routes)
+                {
+                    oatpp::web::url::mapping::Pattern::MatchMap matchMap;
+                    if (!route.pattern->match(request->getStartingLine().path, matchMap))
+                        continue;
+
+                    auto attribute = primus::attribute::resolve(matchMap.getVariable("attribute"), route.accepted);
+                    if (attribute == primus::attribute::Attribute::Unknown)
+                        return m_errors->createResponse(route.unknown);
+
+                    request->putBundleData(primus::attribute::bundleKey, oatpp::UInt32(static_cast<v_uint32>(attribute)));
+                    return nullptr;
+                }
+                return nullptr;
+            }
+        };
+
+    } // namespace interceptor
+} // namespace primus
+
+#endif // ATTRIBUTEINTERCEPTOR_HPP
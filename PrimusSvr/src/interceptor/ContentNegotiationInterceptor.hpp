@@ -0,0 +1,60 @@
+#ifndef CONTENTNEGOTIATIONINTERCEPTOR_HPP
+#define CONTENTNEGOTIATIONINTERCEPTOR_HPP
+
+#include "oatpp/web/server/interceptor/RequestInterceptor.hpp"
+#include "oatpp/web/server/interceptor/ResponseInterceptor.hpp"
+
+#include "mapping/ContentNegotiation.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace interceptor
+    {
+        //   ____            _             _   _   _                  _   _       _   _             ___       _                          _
+        //  / ___|___  _ __ | |_ ___ _ __ | |_| \ | | ___  __ _  ___ | |_(_) __ _| |_(_) ___  _ __ |_ _|_ __ | |_ ___ _ __ ___ ___ _ __ | |_ ___  _ __
+        // | |   / _ \| '_ \| __/ _ \ '_ \| __|  \| |/ _ \/ _` |/ _ \| __| |/ _` | __| |/ _ \| '_ \ | || '_ \| __/ _ \ '__/ __/ _ \ '_ \| __/ _ \| '__|
+        // | |__| (_) | | | | ||  __/ | | | |_| |\  |  __/ (_| | (_) | |_| | (_| | |_| | (_) | | | || || | | | ||  __/ | | (_|  __/ |_) | || (_) | |
+        //  \____\___/|_| |_|\__\___|_| |_|\__|_| \_|\___|\__, |\___/ \__|_|\__,_|\__|_|\___/|_| |_|___|_| |_|\__\___|_|  \___\___| .__/ \__\___/|_|
+        //                                                |___/                                                                   |_|
+        /**
+         * @brief Picks the encodings of a request before it is routed, see primus::mapping::CurrentEncoding.
+         * The body is read as the Content-Type names it, the response is written as the Accept header asks.
+         */
+        class ContentNegotiationInterceptor : public oatpp::web::server::interceptor::RequestInterceptor
+        {
+        public:
+            std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request) override
+            {
+                primus::mapping::CurrentEncoding::set(
+                    primus::mapping::CurrentEncoding::fromHeader(request->getHeader(oatpp::web::protocol::http::Header::CONTENT_TYPE)),
+                    primus::mapping::CurrentEncoding::fromHeader(request->getHeader("Accept")));
+                return nullptr;
+            }
+        };
+
+        /**
+         * @brief Names the binary encoding of a response written by the NegotiatingObjectMapper, whose
+         * bodies would otherwise declare JSON, and lets go of the encodings.
+         */
+        class ContentNegotiationResetInterceptor : public oatpp::web::server::interceptor::ResponseInterceptor
+        {
+        public:
+            std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request,
+                                                        const std::shared_ptr<OutgoingResponse>& response) override
+            {
+                (void)request;
+                if (response && primus::mapping::CurrentEncoding::isWritten() &&
+                    !response->getHeader(oatpp::web::protocol::http::Header::CONTENT_TYPE))
+                {
+                    response->putHeader(oatpp::web::protocol::http::Header::CONTENT_TYPE, primus::mapping::CurrentEncoding::getContentType());
+                }
+                primus::mapping::CurrentEncoding::clear();
+                return response;
+            }
+        };
+
+    } // namespace interceptor
+} // namespace primus
+
+#endif // CONTENTNEGOTIATIONINTERCEPTOR_HPP
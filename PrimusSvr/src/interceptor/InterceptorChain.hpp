@@ -0,0 +1,126 @@
+#ifndef INTERCEPTORCHAIN_HPP
+#define INTERCEPTORCHAIN_HPP
+
+#include <exception>
+#include <list>
+#include <memory>
+
+#include "oatpp/web/server/HttpConnectionHandler.hpp"
+#include "oatpp/web/server/HttpRouter.hpp"
+#include "oatpp/web/server/handler/ErrorHandler.hpp"
+#include "oatpp/web/server/interceptor/RequestInterceptor.hpp"
+#include "oatpp/web/server/interceptor/ResponseInterceptor.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+namespace primus
+{
+    namespace interceptor
+    {
+        //  ___       _                          _              ____ _           _
+        // |_ _|_ __ | |_ ___ _ __ ___ ___ _ __ | |_ ___  _ __ / ___| |__   __ _(_)_ __
+        //  | || '_ \| __/ _ \ '__/ __/ _ \ '_ \| __/ _ \| '__| |   | '_ \ / _` | | '_ \
+        //  | || | | | ||  __/ | | (_|  __/ |_) | || (_) | |  | |___| | | | (_| | | | | |
+        // |___|_| |_|\__\___|_|  \___\___| .__/ \__\___/|_|   \____|_| |_|\__,_|_|_| |_|
+        //                                |_|
+        /**
+         * @brief The interceptors, router and error handler of the server, so a request which does not come in
+         * through the network (a sub-request of a batch) is processed like one that does.
+         *
+         * install() hands them to the connection handler, process() runs a request through them on the calling
+         * thread in the order the oatpp HttpProcessor does: request interceptors, route, endpoint, response
+         * interceptors. The response interceptors always run, they let go of what the request interceptors set
+         * on the thread.
+         */
+        class InterceptorChain
+        {
+        private:
+            typedef oatpp::web::protocol::http::incoming::Request IncomingRequest;
+            typedef oatpp::web::protocol::http::outgoing::Response OutgoingResponse;
+
+            std::shared_ptr<oatpp::web::server::HttpRouter>                                         m_router;
+            std::shared_ptr<oatpp::web::server::handler::ErrorHandler>                              m_errorHandler;
+            std::list<std::shared_ptr<oatpp::web::server::interceptor::RequestInterceptor>>         m_requestInterceptors;
+            std::list<std::shared_ptr<oatpp::web::server::interceptor::ResponseInterceptor>>        m_responseInterceptors;
+
+            std::shared_ptr<OutgoingResponse> route(const std::shared_ptr<IncomingRequest>& request) const
+            {
+                const auto& startingLine = request->getStartingLine();
+                auto route = m_router->getRoute(startingLine.method, startingLine.path);
+                if (!route)
+                {
+                    /* Worded like the HttpProcessor, the error handler answers it with RouteNotFound */
+                    return m_errorHandler->handleError(oatpp::web::protocol::http::Status::CODE_404,
+                        "No mapping for HTTP-method: '" + startingLine.method.std_str() + "', URL: '" + startingLine.path.std_str() + "'");
+                }
+
+                request->setPathVariables(route.getMatchMap());
+                return route.getEndpoint()->handle(request);
+            }
+
+        public:
+            InterceptorChain(const std::shared_ptr<oatpp::web::server::HttpRouter>& router,
+                             const std::shared_ptr<oatpp::web::server::handler::ErrorHandler>& errorHandler)
+                : m_router(router)
+                , m_errorHandler(errorHandler)
+            {}
+
+            void addRequestInterceptor(const std::shared_ptr<oatpp::web::server::interceptor::RequestInterceptor>& interceptor)
+            {
+                m_requestInterceptors.push_back(interceptor);
+            }
+
+            void addResponseInterceptor(const std::shared_ptr<oatpp::web::server::interceptor::ResponseInterceptor>& interceptor)
+            {
+                m_responseInterceptors.push_back(interceptor);
+            }
+
+            /**
+             * Registers the error handler and the interceptors with the connection handler, in the order they were added
+             */
+            void install(const std::shared_ptr<oatpp::web::server::HttpConnectionHandler>& connectionHandler) const
+            {
+                connectionHandler->setErrorHandler(m_errorHandler);
+                for (const auto& interceptor : m_requestInterceptors)
+                    connectionHandler->addRequestInterceptor(interceptor);
+                for (const auto& interceptor : m_responseInterceptors)
+                    connectionHandler->addResponseInterceptor(interceptor);
+            }
+
+            /**
+             * Runs a request through the interceptors and its endpoint on the calling thread. Thrown errors are
+             * answered by the error handler, like those of a request from the network
+             */
+            std::shared_ptr<OutgoingResponse> process(const std::shared_ptr<IncomingRequest>& request) const
+            {
+                std::shared_ptr<OutgoingResponse> response;
+                try
+                {
+                    for (const auto& interceptor : m_requestInterceptors)
+                    {
+                        response = interceptor->intercept(request);
+                        if (response)
+                            break;
+                    }
+
+                    if (!response)
+                        response = route(request);
+                }
+                catch (oatpp::web::protocol::http::HttpError& error)
+                {
+                    response = m_errorHandler->handleError(error.getInfo().status, error.getMessage(), error.getHeaders());
+                }
+                catch (const std::exception& e)
+                {
+                    response = m_errorHandler->handleError(oatpp::web::protocol::http::Status::CODE_500, e.what());
+                }
+
+                for (const auto& interceptor : m_responseInterceptors)
+                    response = interceptor->intercept(request, response);
+                return response;
+            }
+        };
+
+    } // namespace interceptor
+} // namespace primus
+
+#endif // INTERCEPTORCHAIN_HPP
@@ -0,0 +1,62 @@
+#ifndef REQUESTDEADLINEINTERCEPTOR_HPP
+#define REQUESTDEADLINEINTERCEPTOR_HPP
+
+#include "oatpp/web/server/interceptor/RequestInterceptor.hpp"
+#include "oatpp/web/server/interceptor/ResponseInterceptor.hpp"
+
+#include "database/QueryDeadline.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace interceptor
+    {
+        //  ____                            _   ____                 _ _ _            ___       _                            _
+        // |  _ \ ___  __ _ _   _  ___  ___| |_|  _ \  ___  __ _  __| | (_)_ __   ___|_ _|_ __ | |_ ___ _ __ ___ ___ _ __ | |_ ___  _ __
+        // | |_) / _ \/ _` | | | |/ _ \/ __| __| | | |/ _ \/ _` |/ _` | | | '_ \ / _ \| || '_ \| __/ _ \ '__/ __/ _ \ '_ \| __/ _ \| '__|
+        // |  _ <  __/ (_| | |_| |  __/\__ \ |_| |_| |  __/ (_| | (_| | | | | | |  __/| || | | | ||  __/ | | (_|  __/ |_) | || (_) | |
+        // |_| \_\___|\__, |\__,_|\___||___/\__|____/ \___|\__,_|\__,_|_|_|_| |_|\___|___|_| |_|\__\___|_|  \___\___| .__/ \__\___/|_|
+        //               |_|                                                                                         |_|
+        /**
+         * @brief Starts the deadline of a request before it is routed. Every query of the request has to
+         * finish before it, see primus::database::QueryDeadline.
+         */
+        class RequestDeadlineInterceptor : public oatpp::web::server::interceptor::RequestInterceptor
+        {
+        private:
+            std::chrono::milliseconds m_timeout;
+
+        public:
+            RequestDeadlineInterceptor()
+                : m_timeout(primus::environment::getUInt("PRIMUS_REQUEST_TIMEOUT_MS", primus::constants::database::query::requestTimeout))
+            {}
+
+            std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request) override
+            {
+                (void)request;
+                primus::database::RequestDeadline::set(m_timeout);
+                return nullptr;
+            }
+        };
+
+        /**
+         * @brief Clears the deadline once the response is ready, so work on this thread outside of a request
+         * is not bound by it.
+         */
+        class RequestDeadlineResetInterceptor : public oatpp::web::server::interceptor::ResponseInterceptor
+        {
+        public:
+            std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request,
+                                                        const std::shared_ptr<OutgoingResponse>& response) override
+            {
+                (void)request;
+                primus::database::RequestDeadline::clear();
+                return response;
+            }
+        };
+
+    } // namespace interceptor
+} // namespace primus
+
+#endif // REQUESTDEADLINEINTERCEPTOR_HPP
@@ -0,0 +1,74 @@
+#ifndef TENANTINTERCEPTOR_HPP
+#define TENANTINTERCEPTOR_HPP
+
+#include "oatpp/web/server/interceptor/RequestInterceptor.hpp"
+#include "oatpp/web/server/interceptor/ResponseInterceptor.hpp"
+#include "oatpp/web/protocol/http/outgoing/ResponseFactory.hpp"
+
+#include "tenant/TenantRegistry.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace interceptor
+    {
+        //  _____                      _   ___       _                          _
+        // |_   _|__ _ __   __ _ _ __ | |_|_ _|_ __ | |_ ___ _ __ ___ ___ _ __ | |_ ___  _ __
+        //   | |/ _ \ '_ \ / _` | '_ \| __|| || '_ \| __/ _ \ '__/ __/ _ \ '_ \| __/ _ \| '__|
+        //   | |  __/ | | | (_| | | | | |_ | || | | | ||  __/ | | (_|  __/ |_) | || (_) | |
+        //   |_|\___|_| |_|\__,_|_| |_|\__|___|_| |_|\__\___|_|  \___\___| .__/ \__\___/|_|
+        //                                                               |_|
+        /**
+         * @brief Picks the tenant of a request before it is routed, see primus::tenant::TenantRegistry.
+         * The controllers read it through primus::tenant::CurrentTenant.
+         */
+        class TenantInterceptor : public oatpp::web::server::interceptor::RequestInterceptor
+        {
+        private:
+            std::shared_ptr<primus::tenant::TenantRegistry> m_registry;
+
+        public:
+            TenantInterceptor(const std::shared_ptr<primus::tenant::TenantRegistry>& registry)
+                : m_registry(registry)
+            {}
+
+            std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request) override
+            {
+                try
+                {
+                    primus::tenant::CurrentTenant::set(m_registry->resolve(request->getHeader(primus::constants::tenant::header), request->getHeader("Host")));
+                }
+                catch (oatpp::web::protocol::http::HttpError& error)
+                {
+                    primus::tenant::CurrentTenant::clear();
+                    return oatpp::web::protocol::http::outgoing::ResponseFactory::createResponse(error.getInfo().status, error.what());
+                }
+                catch (const std::exception& e)
+                {
+                    OATPP_LOGE(primus::constants::tenant::logName, "Opening the tenant of a request failed: %s", e.what());
+                    primus::tenant::CurrentTenant::clear();
+                    return oatpp::web::protocol::http::outgoing::ResponseFactory::createResponse(oatpp::web::protocol::http::Status::CODE_500, "The tenant could not be opened");
+                }
+                return nullptr;
+            }
+        };
+
+        /**
+         * @brief Lets go of the tenant once the response is ready, so an idle tenant can be closed.
+         */
+        class TenantResetInterceptor : public oatpp::web::server::interceptor::ResponseInterceptor
+        {
+        public:
+            std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request,
+                                                        const std::shared_ptr<OutgoingResponse>& response) override
+            {
+                (void)request;
+                primus::tenant::CurrentTenant::clear();
+                return response;
+            }
+        };
+
+    } // namespace interceptor
+} // namespace primus
+
+#endif // TENANTINTERCEPTOR_HPP
@@ -0,0 +1,945 @@
+#ifndef BINARYOBJECTMAPPER_HPP
+#define BINARYOBJECTMAPPER_HPP
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/data/mapping/ObjectMapper.hpp"
+#include "oatpp/core/data/stream/Stream.hpp"
+#include "oatpp/core/parser/Caret.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace mapping
+    {
+        /**
+         * @brief Wire format of a BinaryObjectMapper.
+         */
+        enum class BinaryFormat
+        {
+            Cbor,           // RFC 8949
+            MessagePack     // https://github.com/msgpack/msgpack/blob/master/spec.md
+        };
+
+        //  ____  _                      __        __    _ _
+        // | __ )(_)_ __   __ _ _ __ _   \ \      / / __(_) |_ ___ _ __
+        // |  _ \| | '_ \ / _` | '__| | | \ \ /\ / / '__| | __/ _ \ '__|
+        // | |_) | | | | | (_| | |  | |_| |\ V  V /| |  | | ||  __/ |
+        // |____/|_|_| |_|\__,_|_|   \__, | \_/\_/ |_|  |_|\__\___|_|
+        //                           |___/
+        /**
+         * @brief Writes single CBOR or MessagePack items, always in their shortest form.
+         */
+        class BinaryWriter
+        {
+        private:
+            BinaryFormat                                    m_format;
+            oatpp::data::stream::ConsistentOutputStream*    m_stream;
+
+            void byte(v_uint8 value)
+            {
+                m_stream->writeCharSimple(static_cast<v_char8>(value));
+            }
+
+            void bigEndian(v_uint64 value, v_int32 bytes)
+            {
+                for (v_int32 shift = (bytes - 1) * 8; shift >= 0; shift -= 8)
+                    byte(static_cast<v_uint8>(value >> shift));
+            }
+
+            /**
+             * CBOR initial byte of a major type with its argument
+             */
+            void cborHead(v_uint8 major, v_uint64 argument)
+            {
+                major <<= 5;
+                if (argument < 24)
+                    byte(major | static_cast<v_uint8>(argument));
+                else if (argument <= 0xFF)
+                {
+                    byte(major | 24);
+                    bigEndian(argument, 1);
+                }
+                else if (argument <= 0xFFFF)
+                {
+                    byte(major | 25);
+                    bigEndian(argument, 2);
+                }
+                else if (argument <= 0xFFFFFFFF)
+                {
+                    byte(major | 26);
+                    bigEndian(argument, 4);
+                }
+                else
+                {
+                    byte(major | 27);
+                    bigEndian(argument, 8);
+                }
+            }
+
+            /**
+             * MessagePack length of a str, array or map: the fix form below fixLimit, else 8 (str only), 16 or 32 bit
+             */
+            void packLength(v_uint64 length, v_uint8 fix, v_uint64 fixLimit, v_uint8 code8, v_uint8 code16, v_uint8 code32)
+            {
+                if (length < fixLimit)
+                    byte(fix | static_cast<v_uint8>(length));
+                else if (code8 != 0 && length <= 0xFF)
+                {
+                    byte(code8);
+                    bigEndian(length, 1);
+                }
+                else if (length <= 0xFFFF)
+                {
+                    byte(code16);
+                    bigEndian(length, 2);
+                }
+                else
+                {
+                    byte(code32);
+                    bigEndian(length, 4);
+                }
+            }
+
+        public:
+            BinaryWriter(BinaryFormat format, oatpp::data::stream::ConsistentOutputStream* stream)
+                : m_format(format)
+                , m_stream(stream)
+            {}
+
+            void writeNull()
+            {
+                byte(m_format == BinaryFormat::Cbor ? 0xF6 : 0xC0);
+            }
+
+            void writeBool(bool value)
+            {
+                if (m_format == BinaryFormat::Cbor)
+                    byte(value ? 0xF5 : 0xF4);
+                else
+                    byte(value ? 0xC3 : 0xC2);
+            }
+
+            void writeUInt(v_uint64 value)
+            {
+                if (m_format == BinaryFormat::Cbor)
+                    cborHead(0, value);
+                else if (value <= 0x7F)
+                    byte(static_cast<v_uint8>(value));
+                else if (value <= 0xFF)
+                {
+                    byte(0xCC);
+                    bigEndian(value, 1);
+                }
+                else if (value <= 0xFFFF)
+                {
+                    byte(0xCD);
+                    bigEndian(value, 2);
+                }
+                else if (value <= 0xFFFFFFFF)
+                {
+                    byte(0xCE);
+                    bigEndian(value, 4);
+                }
+                else
+                {
+                    byte(0xCF);
+                    bigEndian(value, 8);
+                }
+            }
+
+            void writeInt(v_int64 value)
+            {
+                if (value >= 0)
+                {
+                    writeUInt(static_cast<v_uint64>(value));
+                    return;
+                }
+
+                if (m_format == BinaryFormat::Cbor)
+                    cborHead(1, static_cast<v_uint64>(-(value + 1)));
+                else if (value >= -32)
+                    byte(static_cast<v_uint8>(value));
+                else if (value >= std::numeric_limits<v_int8>::min())
+                {
+                    byte(0xD0);
+                    bigEndian(static_cast<v_uint64>(value), 1);
+                }
+                else if (value >= std::numeric_limits<v_int16>::min())
+                {
+                    byte(0xD1);
+                    bigEndian(static_cast<v_uint64>(value), 2);
+                }
+                else if (value >= std::numeric_limits<v_int32>::min())
+                {
+                    byte(0xD2);
+                    bigEndian(static_cast<v_uint64>(value), 4);
+                }
+                else
+                {
+                    byte(0xD3);
+                    bigEndian(static_cast<v_uint64>(value), 8);
+                }
+            }
+
+            void writeFloat32(v_float32 value)
+            {
+                v_uint32 bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                byte(m_format == BinaryFormat::Cbor ? 0xFA : 0xCA);
+                bigEndian(bits, 4);
+            }
+
+            void writeFloat64(v_float64 value)
+            {
+                v_uint64 bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                byte(m_format == BinaryFormat::Cbor ? 0xFB : 0xCB);
+                bigEndian(bits, 8);
+            }
+
+            void writeString(const std::string& value)
+            {
+                if (m_format == BinaryFormat::Cbor)
+                    cborHead(3, value.size());
+                else
+                    packLength(value.size(), 0xA0, 32, 0xD9, 0xDA, 0xDB);
+                m_stream->writeSimple(value.data(), static_cast<v_buff_size>(value.size()));
+            }
+
+            void writeArrayHeader(v_uint64 count)
+            {
+                if (m_format == BinaryFormat::Cbor)
+                    cborHead(4, count);
+                else
+                    packLength(count, 0x90, 16, 0, 0xDC, 0xDD);
+            }
+
+            void writeMapHeader(v_uint64 count)
+            {
+                if (m_format == BinaryFormat::Cbor)
+                    cborHead(5, count);
+                else
+                    packLength(count, 0x80, 16, 0, 0xDE, 0xDF);
+            }
+        };
+
+        //  ____  _                        ____                _
+        // | __ )(_)_ __   __ _ _ __ _   _|  _ \ ___  __ _  __| | ___ _ __
+        // |  _ \| | '_ \ / _` | '__| | | | |_) / _ \/ _` |/ _` |/ _ \ '__|
+        // | |_) | | | | | (_| | |  | |_| |  _ <  __/ (_| | (_| |  __/ |
+        // |____/|_|_| |_|\__,_|_|   \__, |_| \_\___|\__,_|\__,_|\___|_|
+        //                           |___/
+        /**
+         * @brief Reads single CBOR or MessagePack items from a Caret.
+         *
+         * Errors are set on the caret and make every further read fail. Indefinite length CBOR items, tags,
+         * byte strings and MessagePack extensions are not accepted, the BinaryWriter never writes them.
+         * Arrays and maps may nest primus::constants::mapping::maxDepth levels deep, reading them recurses once
+         * per level.
+         */
+        class BinaryReader
+        {
+        public:
+            enum class Kind { Null, Bool, Integer, Float, String, Array, Map, Invalid };
+
+        private:
+            BinaryFormat            m_format;
+            oatpp::parser::Caret&   m_caret;
+            v_uint32                m_depth;
+
+            /**
+             * Whether as many bytes as a length read from the data announces are left, checked before the
+             * length is narrowed to v_buff_size
+             */
+            bool ensure(v_uint64 bytes)
+            {
+                if (m_caret.hasError())
+                    return false;
+                if (bytes > static_cast<v_uint64>(m_caret.getDataSize() - m_caret.getPosition()))
+                {
+                    m_caret.setError("[primus::mapping::BinaryReader]: Unexpected end of data");
+                    return false;
+                }
+                return true;
+            }
+
+            v_uint8 peek()
+            {
+                return static_cast<v_uint8>(m_caret.getData()[m_caret.getPosition()]);
+            }
+
+            v_uint64 bigEndian(v_int32 bytes)
+            {
+                v_uint64 value = 0;
+                if (!ensure(static_cast<v_uint64>(bytes)))
+                    return 0;
+                for (v_int32 i = 0; i < bytes; i++)
+                {
+                    value = (value << 8) | peek();
+                    m_caret.inc();
+                }
+                return value;
+            }
+
+            /**
+             * Argument of a CBOR item whose initial byte was consumed
+             */
+            v_uint64 cborArgument(v_uint8 initial)
+            {
+                v_uint8 info = initial & 0x1F;
+                if (info < 24)
+                    return info;
+                if (info <= 27)
+                    return bigEndian(1 << (info - 24));
+                m_caret.setError("[primus::mapping::BinaryReader]: Indefinite length or reserved CBOR item");
+                return 0;
+            }
+
+            static v_float64 halfToDouble(v_uint16 half)
+            {
+                v_int32 exponent = (half >> 10) & 0x1F;
+                v_int32 mantissa = half & 0x3FF;
+                v_float64 value;
+                if (exponent == 0)
+                    value = std::ldexp(mantissa, -24);
+                else if (exponent != 31)
+                    value = std::ldexp(mantissa + 1024, exponent - 25);
+                else
+                    value = mantissa == 0 ? std::numeric_limits<v_float64>::infinity() : std::numeric_limits<v_float64>::quiet_NaN();
+                return (half & 0x8000) ? -value : value;
+            }
+
+            static v_float64 bitsToFloat32(v_uint64 bits)
+            {
+                v_uint32 narrow = static_cast<v_uint32>(bits);
+                v_float32 value;
+                std::memcpy(&value, &narrow, sizeof(value));
+                return value;
+            }
+
+            static v_float64 bitsToFloat64(v_uint64 bits)
+            {
+                v_float64 value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+
+            /**
+             * MessagePack length of a str, array or map whose code was consumed
+             */
+            v_uint64 packLength(v_uint8 code, v_uint8 fix, v_uint8 fixMask, v_uint8 code8, v_uint8 code16, v_uint8 code32)
+            {
+                if ((code & ~fixMask) == fix)
+                    return code & fixMask;
+                if (code8 != 0 && code == code8)
+                    return bigEndian(1);
+                if (code == code16)
+                    return bigEndian(2);
+                if (code == code32)
+                    return bigEndian(4);
+                m_caret.setError("[primus::mapping::BinaryReader]: Unexpected MessagePack type");
+                return 0;
+            }
+
+        public:
+            BinaryReader(BinaryFormat format, oatpp::parser::Caret& caret)
+                : m_format(format)
+                , m_caret(caret)
+                , m_depth(0)
+            {}
+
+            bool hasError() const
+            {
+                return m_caret.hasError();
+            }
+
+            void fail(const char* message)
+            {
+                if (!m_caret.hasError())
+                    m_caret.setError(message);
+            }
+
+            /**
+             * Enters an array or map, failing the reader if it nests deeper than primus::constants::mapping::maxDepth
+             *
+             * @return Whether its items may be read, leave() has to follow either way
+             */
+            bool enter()
+            {
+                if (++m_depth > primus::constants::mapping::maxDepth)
+                    fail("[primus::mapping::BinaryReader]: Items nested too deeply");
+                return !hasError();
+            }
+
+            void leave()
+            {
+                m_depth--;
+            }
+
+            /**
+             * Kind of the next item, without consuming it
+             */
+            Kind next()
+            {
+                if (!ensure(1))
+                    return Kind::Invalid;
+
+                v_uint8 code = peek();
+                if (m_format == BinaryFormat::Cbor)
+                {
+                    switch (code >> 5)
+                    {
+                    case 0:
+                    case 1: return Kind::Integer;
+                    case 3: return Kind::String;
+                    case 4: return Kind::Array;
+                    case 5: return Kind::Map;
+                    case 7:
+                        if (code == 0xF6 || code == 0xF7) return Kind::Null;
+                        if (code == 0xF4 || code == 0xF5) return Kind::Bool;
+                        if (code >= 0xF9 && code <= 0xFB) return Kind::Float;
+                        return Kind::Invalid;
+                    default: return Kind::Invalid;
+                    }
+                }
+
+                if (code <= 0x7F || code >= 0xE0 || (code >= 0xCC && code <= 0xD3)) return Kind::Integer;
+                if ((code & 0xE0) == 0xA0 || (code >= 0xD9 && code <= 0xDB)) return Kind::String;
+                if ((code & 0xF0) == 0x90 || code == 0xDC || code == 0xDD) return Kind::Array;
+                if ((code & 0xF0) == 0x80 || code == 0xDE || code == 0xDF) return Kind::Map;
+                if (code == 0xC0) return Kind::Null;
+                if (code == 0xC2 || code == 0xC3) return Kind::Bool;
+                if (code == 0xCA || code == 0xCB) return Kind::Float;
+                return Kind::Invalid;
+            }
+
+            /**
+             * Consumes a null if it is the next item
+             */
+            bool readNull()
+            {
+                if (next() != Kind::Null)
+                    return false;
+                m_caret.inc();
+                return true;
+            }
+
+            bool readBool()
+            {
+                if (next() != Kind::Bool)
+                {
+                    fail("[primus::mapping::BinaryReader]: Expected a boolean");
+                    return false;
+                }
+                v_uint8 code = peek();
+                m_caret.inc();
+                return code == 0xF5 || code == 0xC3;
+            }
+
+            /**
+             * Reads an integer as sign and magnitude, so the full ranges of v_int64 and v_uint64 fit
+             */
+            void readInteger(bool& negative, v_uint64& magnitude)
+            {
+                negative = false;
+                magnitude = 0;
+                if (next() != Kind::Integer)
+                {
+                    fail("[primus::mapping::BinaryReader]: Expected an integer");
+                    return;
+                }
+
+                v_uint8 code = peek();
+                m_caret.inc();
+
+                if (m_format == BinaryFormat::Cbor)
+                {
+                    v_uint64 argument = cborArgument(code);
+                    if ((code >> 5) == 0)
+                        magnitude = argument;
+                    else if (argument == std::numeric_limits<v_uint64>::max())
+                        fail("[primus::mapping::BinaryReader]: Integer out of range");
+                    else
+                    {
+                        negative = true;
+                        magnitude = argument + 1;
+                    }
+                    return;
+                }
+
+                v_int64 value;
+                if (code <= 0x7F)
+                {
+                    magnitude = code;
+                    return;
+                }
+                if (code >= 0xCC && code <= 0xCF)
+                {
+                    magnitude = bigEndian(1 << (code - 0xCC));
+                    return;
+                }
+                if (code >= 0xE0)
+                    value = static_cast<v_int8>(code);
+                else
+                {
+                    v_int32 bytes = 1 << (code - 0xD0);
+                    v_uint64 bits = bigEndian(bytes);
+                    /* Sign extend from the width of the item */
+                    v_int32 unused = 64 - bytes * 8;
+                    value = unused > 0 ? static_cast<v_int64>(bits << unused) >> unused : static_cast<v_int64>(bits);
+                }
+
+                negative = value < 0;
+                magnitude = negative ? static_cast<v_uint64>(-(value + 1)) + 1 : static_cast<v_uint64>(value);
+            }
+
+            /**
+             * Reads a float, integers are accepted as well
+             */
+            v_float64 readFloat()
+            {
+                Kind kind = next();
+                if (kind == Kind::Integer)
+                {
+                    bool negative;
+                    v_uint64 magnitude;
+                    readInteger(negative, magnitude);
+                    return negative ? -static_cast<v_float64>(magnitude) : static_cast<v_float64>(magnitude);
+                }
+                if (kind != Kind::Float)
+                {
+                    fail("[primus::mapping::BinaryReader]: Expected a number");
+                    return 0;
+                }
+
+                v_uint8 code = peek();
+                m_caret.inc();
+                if (code == 0xF9)
+                    return halfToDouble(static_cast<v_uint16>(bigEndian(2)));
+                if (code == 0xFA || code == 0xCA)
+                    return bitsToFloat32(bigEndian(4));
+                return bitsToFloat64(bigEndian(8));
+            }
+
+            oatpp::String readString()
+            {
+                if (next() != Kind::String)
+                {
+                    fail("[primus::mapping::BinaryReader]: Expected a string");
+                    return nullptr;
+                }
+
+                v_uint8 code = peek();
+                m_caret.inc();
+                v_uint64 length = m_format == BinaryFormat::Cbor ? cborArgument(code) : packLength(code, 0xA0, 0x1F, 0xD9, 0xDA, 0xDB);
+                if (!ensure(length))
+                    return nullptr;
+
+                oatpp::String value(m_caret.getCurrData(), static_cast<v_buff_size>(length));
+                m_caret.inc(static_cast<v_buff_size>(length));
+                return value;
+            }
+
+            v_uint64 readArrayHeader()
+            {
+                if (next() != Kind::Array)
+                {
+                    fail("[primus::mapping::BinaryReader]: Expected an array");
+                    return 0;
+                }
+                v_uint8 code = peek();
+                m_caret.inc();
+
+                /* Every item takes at least a byte */
+                v_uint64 count = m_format == BinaryFormat::Cbor ? cborArgument(code) : packLength(code, 0x90, 0x0F, 0, 0xDC, 0xDD);
+                return ensure(count) ? count : 0;
+            }
+
+            v_uint64 readMapHeader()
+            {
+                if (next() != Kind::Map)
+                {
+                    fail("[primus::mapping::BinaryReader]: Expected a map");
+                    return 0;
+                }
+                v_uint8 code = peek();
+                m_caret.inc();
+
+                /* Every key and value takes at least a byte */
+                v_uint64 count = m_format == BinaryFormat::Cbor ? cborArgument(code) : packLength(code, 0x80, 0x0F, 0, 0xDE, 0xDF);
+                if (count > std::numeric_limits<v_uint64>::max() / 2 || !ensure(count * 2))
+                {
+                    fail("[primus::mapping::BinaryReader]: Unexpected end of data");
+                    return 0;
+                }
+                return count;
+            }
+
+            /**
+             * Skips the next item with everything nested in it
+             */
+            void skip()
+            {
+                bool negative;
+                v_uint64 magnitude;
+
+                switch (next())
+                {
+                case Kind::Null: readNull(); break;
+                case Kind::Bool: readBool(); break;
+                case Kind::Integer: readInteger(negative, magnitude); break;
+                case Kind::Float: readFloat(); break;
+                case Kind::String: readString(); break;
+                case Kind::Array:
+                    if (enter())
+                    {
+                        for (v_uint64 count = readArrayHeader(); count > 0 && !hasError(); count--)
+                            skip();
+                    }
+                    leave();
+                    break;
+                case Kind::Map:
+                    if (enter())
+                    {
+                        for (v_uint64 count = readMapHeader(); count > 0 && !hasError(); count--)
+                        {
+                            skip();
+                            skip();
+                        }
+                    }
+                    leave();
+                    break;
+                default:
+                    fail("[primus::mapping::BinaryReader]: Unsupported item");
+                }
+            }
+        };
+
+        //  ____  _                         ___  _     _           _   __  __
+        // | __ )(_)_ __   __ _ _ __ _   _ / _ \| |__ (_) ___  ___| |_|  \/  | __ _ _ __  _ __   ___ _ __
+        // |  _ \| | '_ \ / _` | '__| | | | | | | '_ \| |/ _ \/ __| __| |\/| |/ _` | '_ \| '_ \ / _ \ '__|
+        // | |_) | | | | | (_| | |  | |_| | |_| | |_) | |  __/ (__| |_| |  | | (_| | |_) | |_) |  __/ |
+        // |____/|_|_| |_|\__,_|_|   \__, |\___/|_.__// |\___|\___|\__|_|  |_|\__,_| .__/| .__/ \___|_|
+        //                           |___/          |__/                           |_|   |_|
+        /**
+         * @brief ObjectMapper writing and reading DTOs as CBOR or MessagePack.
+         *
+         * Walks the same type information as the JSON mapper: objects become maps keyed by field name,
+         * Vector, List and UnorderedSet become arrays and Fields become maps. Integers take the shortest
+         * encoding of their value, floats keep the width of their type. oatpp::Any is written as the value it
+         * holds but cannot be read, there is no type to read it into.
+         */
+        class BinaryObjectMapper : public oatpp::data::mapping::ObjectMapper
+        {
+        public:
+            struct Config
+            {
+                bool includeNullFields;     // Write fields which are null, like the JSON serializer does by default
+
+                Config() : includeNullFields(true) {}
+            };
+
+        private:
+            typedef oatpp::data::mapping::type::Type Type;
+            typedef oatpp::data::mapping::type::BaseObject BaseObject;
+            typedef oatpp::data::mapping::type::__class::AbstractObject AbstractObject;
+            typedef oatpp::data::mapping::type::__class::Collection Collection;
+            typedef oatpp::data::mapping::type::__class::Map Map;
+
+            BinaryFormat    m_format;
+            Config          m_config;
+
+            static bool is(const Type* type, const oatpp::data::mapping::type::ClassId& classId)
+            {
+                return type->classId.id == classId.id;
+            }
+
+            static bool isCollection(const Type* type)
+            {
+                namespace __class = oatpp::data::mapping::type::__class;
+                return is(type, __class::AbstractVector::CLASS_ID) || is(type, __class::AbstractList::CLASS_ID) || is(type, __class::AbstractUnorderedSet::CLASS_ID);
+            }
+
+            static bool isMap(const Type* type)
+            {
+                namespace __class = oatpp::data::mapping::type::__class;
+                return is(type, __class::AbstractPairList::CLASS_ID) || is(type, __class::AbstractUnorderedMap::CLASS_ID);
+            }
+
+            template<class T>
+            static T& valueOf(const oatpp::Void& value)
+            {
+                return *static_cast<T*>(value.get());
+            }
+
+            void writeObject(BinaryWriter& writer, const oatpp::Void& value) const
+            {
+                auto dispatcher = static_cast<const AbstractObject::PolymorphicDispatcher*>(value.getValueType()->polymorphicDispatcher);
+                const auto& properties = dispatcher->getProperties()->getList();
+                auto object = static_cast<BaseObject*>(value.get());
+
+                v_uint64 count = 0;
+                for (auto property : properties)
+                {
+                    if (m_config.includeNullFields || property->get(object))
+                        count++;
+                }
+
+                writer.writeMapHeader(count);
+                for (auto property : properties)
+                {
+                    oatpp::Void field = property->get(object);
+                    if (!m_config.includeNullFields && !field)
+                        continue;
+                    writer.writeString(property->name);
+                    writeValue(writer, field);
+                }
+            }
+
+            void writeCollection(BinaryWriter& writer, const oatpp::Void& value) const
+            {
+                auto dispatcher = static_cast<const Collection::PolymorphicDispatcher*>(value.getValueType()->polymorphicDispatcher);
+
+                writer.writeArrayHeader(static_cast<v_uint64>(dispatcher->getCollectionSize(value)));
+                for (auto iterator = dispatcher->beginIteration(value); !iterator->finished(); iterator->next())
+                    writeValue(writer, iterator->get());
+            }
+
+            void writeMap(BinaryWriter& writer, const oatpp::Void& value) const
+            {
+                auto dispatcher = static_cast<const Map::PolymorphicDispatcher*>(value.getValueType()->polymorphicDispatcher);
+                if (!is(dispatcher->getKeyType(), oatpp::String::Class::CLASS_ID))
+                    throw std::runtime_error("[primus::mapping::BinaryObjectMapper]: Map keys have to be strings");
+
+                writer.writeMapHeader(static_cast<v_uint64>(dispatcher->getMapSize(value)));
+                for (auto iterator = dispatcher->beginIteration(value); !iterator->finished(); iterator->next())
+                {
+                    const auto& key = iterator->getKey();
+                    writer.writeString(key ? valueOf<std::string>(key) : std::string());
+                    writeValue(writer, iterator->getValue());
+                }
+            }
+
+            void writeValue(BinaryWriter& writer, const oatpp::Void& value) const
+            {
+                if (!value)
+                {
+                    writer.writeNull();
+                    return;
+                }
+
+                const Type* type = value.getValueType();
+                if (is(type, oatpp::String::Class::CLASS_ID))           writer.writeString(valueOf<std::string>(value));
+                else if (is(type, oatpp::Int8::Class::CLASS_ID))        writer.writeInt(valueOf<v_int8>(value));
+                else if (is(type, oatpp::UInt8::Class::CLASS_ID))       writer.writeUInt(valueOf<v_uint8>(value));
+                else if (is(type, oatpp::Int16::Class::CLASS_ID))       writer.writeInt(valueOf<v_int16>(value));
+                else if (is(type, oatpp::UInt16::Class::CLASS_ID))      writer.writeUInt(valueOf<v_uint16>(value));
+                else if (is(type, oatpp::Int32::Class::CLASS_ID))       writer.writeInt(valueOf<v_int32>(value));
+                else if (is(type, oatpp::UInt32::Class::CLASS_ID))      writer.writeUInt(valueOf<v_uint32>(value));
+                else if (is(type, oatpp::Int64::Class::CLASS_ID))       writer.writeInt(valueOf<v_int64>(value));
+                else if (is(type, oatpp::UInt64::Class::CLASS_ID))      writer.writeUInt(valueOf<v_uint64>(value));
+                else if (is(type, oatpp::Float32::Class::CLASS_ID))     writer.writeFloat32(valueOf<v_float32>(value));
+                else if (is(type, oatpp::Float64::Class::CLASS_ID))     writer.writeFloat64(valueOf<v_float64>(value));
+                else if (is(type, oatpp::Boolean::Class::CLASS_ID))     writer.writeBool(valueOf<bool>(value));
+                else if (is(type, AbstractObject::CLASS_ID))            writeObject(writer, value);
+                else if (isCollection(type))                            writeCollection(writer, value);
+                else if (isMap(type))                                   writeMap(writer, value);
+                else if (is(type, oatpp::Any::Class::CLASS_ID))
+                {
+                    auto handle = static_cast<oatpp::data::mapping::type::AnyHandle*>(value.get());
+                    writeValue(writer, oatpp::Void(handle->ptr, handle->type));
+                }
+                else if (is(type, oatpp::data::mapping::type::__class::AbstractEnum::CLASS_ID))
+                {
+                    auto dispatcher = static_cast<const oatpp::data::mapping::type::__class::AbstractEnum::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+                    oatpp::data::mapping::type::EnumInterpreterError error = oatpp::data::mapping::type::EnumInterpreterError::OK;
+                    auto interpretation = dispatcher->toInterpretation(value, error);
+                    if (error != oatpp::data::mapping::type::EnumInterpreterError::OK)
+                        throw std::runtime_error("[primus::mapping::BinaryObjectMapper]: Enum value cannot be written");
+                    writeValue(writer, interpretation);
+                }
+                else
+                    throw std::runtime_error(std::string("[primus::mapping::BinaryObjectMapper]: Unsupported type ") + type->classId.name);
+            }
+
+            /**
+             * Reads an integer into the range of T, failing the reader if it does not fit
+             */
+            template<class Wrapper>
+            static oatpp::Void readInteger(BinaryReader& reader)
+            {
+                typedef typename Wrapper::UnderlyingType T;
+
+                bool negative;
+                v_uint64 magnitude;
+                reader.readInteger(negative, magnitude);
+                if (reader.hasError())
+                    return nullptr;
+
+                if (negative)
+                {
+                    v_uint64 limit = std::numeric_limits<T>::is_signed ? static_cast<v_uint64>(-(std::numeric_limits<T>::min() + 1)) + 1 : 0;
+                    if (magnitude > limit)
+                    {
+                        reader.fail("[primus::mapping::BinaryObjectMapper]: Integer out of range");
+                        return nullptr;
+                    }
+                    return Wrapper(static_cast<T>(-static_cast<v_int64>(magnitude - 1) - 1));
+                }
+
+                if (magnitude > static_cast<v_uint64>(std::numeric_limits<T>::max()))
+                {
+                    reader.fail("[primus::mapping::BinaryObjectMapper]: Integer out of range");
+                    return nullptr;
+                }
+                return Wrapper(static_cast<T>(magnitude));
+            }
+
+            oatpp::Void readObject(BinaryReader& reader, const Type* type) const
+            {
+                auto dispatcher = static_cast<const AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+                auto object = dispatcher->createObject();
+                const auto& properties = dispatcher->getProperties()->getMap();
+
+                if (reader.enter())
+                {
+                    for (v_uint64 count = reader.readMapHeader(); count > 0 && !reader.hasError(); count--)
+                    {
+                        oatpp::String key = reader.readString();
+                        if (reader.hasError())
+                            break;
+
+                        auto property = properties.find(*key);
+                        if (property == properties.end())
+                            reader.skip();
+                        else
+                            property->second->set(static_cast<BaseObject*>(object.get()), readValue(reader, property->second->type));
+                    }
+                }
+                reader.leave();
+                return object;
+            }
+
+            oatpp::Void readCollection(BinaryReader& reader, const Type* type) const
+            {
+                auto dispatcher = static_cast<const Collection::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+                auto collection = dispatcher->createObject();
+                const Type* itemType = dispatcher->getItemType();
+
+                if (reader.enter())
+                {
+                    for (v_uint64 count = reader.readArrayHeader(); count > 0 && !reader.hasError(); count--)
+                        dispatcher->addItem(collection, readValue(reader, itemType));
+                }
+                reader.leave();
+                return collection;
+            }
+
+            oatpp::Void readMap(BinaryReader& reader, const Type* type) const
+            {
+                auto dispatcher = static_cast<const Map::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+                if (!is(dispatcher->getKeyType(), oatpp::String::Class::CLASS_ID))
+                {
+                    reader.fail("[primus::mapping::BinaryObjectMapper]: Map keys have to be strings");
+                    return nullptr;
+                }
+
+                auto map = dispatcher->createObject();
+                const Type* valueType = dispatcher->getValueType();
+
+                if (reader.enter())
+                {
+                    for (v_uint64 count = reader.readMapHeader(); count > 0 && !reader.hasError(); count--)
+                    {
+                        oatpp::String key = reader.readString();
+                        if (reader.hasError())
+                            break;
+                        dispatcher->addItem(map, key, readValue(reader, valueType));
+                    }
+                }
+                reader.leave();
+                return map;
+            }
+
+            oatpp::Void readValue(BinaryReader& reader, const Type* type) const
+            {
+                if (reader.readNull())
+                    return oatpp::Void(type);
+
+                if (is(type, oatpp::String::Class::CLASS_ID))           return reader.readString();
+                if (is(type, oatpp::Int8::Class::CLASS_ID))             return readInteger<oatpp::Int8>(reader);
+                if (is(type, oatpp::UInt8::Class::CLASS_ID))            return readInteger<oatpp::UInt8>(reader);
+                if (is(type, oatpp::Int16::Class::CLASS_ID))            return readInteger<oatpp::Int16>(reader);
+                if (is(type, oatpp::UInt16::Class::CLASS_ID))           return readInteger<oatpp::UInt16>(reader);
+                if (is(type, oatpp::Int32::Class::CLASS_ID))            return readInteger<oatpp::Int32>(reader);
+                if (is(type, oatpp::UInt32::Class::CLASS_ID))           return readInteger<oatpp::UInt32>(reader);
+                if (is(type, oatpp::Int64::Class::CLASS_ID))            return readInteger<oatpp::Int64>(reader);
+                if (is(type, oatpp::UInt64::Class::CLASS_ID))           return readInteger<oatpp::UInt64>(reader);
+                if (is(type, oatpp::Float32::Class::CLASS_ID))          return oatpp::Float32(static_cast<v_float32>(reader.readFloat()));
+                if (is(type, oatpp::Float64::Class::CLASS_ID))          return oatpp::Float64(reader.readFloat());
+                if (is(type, oatpp::Boolean::Class::CLASS_ID))          return oatpp::Boolean(reader.readBool());
+                if (is(type, AbstractObject::CLASS_ID))                 return readObject(reader, type);
+                if (isCollection(type))                                 return readCollection(reader, type);
+                if (isMap(type))                                        return readMap(reader, type);
+
+                if (is(type, oatpp::data::mapping::type::__class::AbstractEnum::CLASS_ID))
+                {
+                    auto dispatcher = static_cast<const oatpp::data::mapping::type::__class::AbstractEnum::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+                    oatpp::Void interpretation = readValue(reader, dispatcher->getInterpretationType());
+                    oatpp::data::mapping::type::EnumInterpreterError error = oatpp::data::mapping::type::EnumInterpreterError::OK;
+                    oatpp::Void value = dispatcher->fromInterpretation(interpretation, error);
+                    if (error != oatpp::data::mapping::type::EnumInterpreterError::OK)
+                        reader.fail("[primus::mapping::BinaryObjectMapper]: Unknown enum value");
+                    return value;
+                }
+
+                reader.fail("[primus::mapping::BinaryObjectMapper]: Unsupported type");
+                return nullptr;
+            }
+
+        public:
+            /**
+             * @param contentType The media type of the format, see primus::constants::mapping
+             */
+            BinaryObjectMapper(BinaryFormat format, const char* contentType, const Config& config = Config())
+                : oatpp::data::mapping::ObjectMapper(Info(contentType))
+                , m_format(format)
+                , m_config(config)
+            {}
+
+            static std::shared_ptr<BinaryObjectMapper> createShared(BinaryFormat format, const char* contentType, const Config& config = Config())
+            {
+                return std::make_shared<BinaryObjectMapper>(format, contentType, config);
+            }
+
+            void write(oatpp::data::stream::ConsistentOutputStream* stream, const oatpp::Void& variant) const override
+            {
+                BinaryWriter writer(m_format, stream);
+                writeValue(writer, variant);
+            }
+
+            /**
+             * Reads a body, a malformed one is answered by 400 like any other bad request
+             */
+            oatpp::Void read(oatpp::parser::Caret& caret, const Type* type) const override
+            {
+                BinaryReader reader(m_format, caret);
+                oatpp::Void value = readValue(reader, type);
+                if (reader.hasError())
+                    throw oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_400, caret.getErrorMessage());
+                return value;
+            }
+        };
+
+    } // namespace mapping
+} // namespace primus
+
+#endif // BINARYOBJECTMAPPER_HPP
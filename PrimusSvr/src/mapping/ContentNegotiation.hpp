@@ -0,0 +1,222 @@
+#ifndef CONTENTNEGOTIATION_HPP
+#define CONTENTNEGOTIATION_HPP
+
+#include <memory>
+#include <string>
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/data/mapping/ObjectMapper.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+
+#include "BinaryObjectMapper.hpp"
+#include "SpecializedJsonObjectMapper.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace mapping
+    {
+        /**
+         * @brief Encodings the API reads and writes DTOs in.
+         */
+        enum class Encoding
+        {
+            Json,
+            Cbor,
+            MessagePack
+        };
+
+        //   ____                          _   _____                     _ _
+        //  / ___|   _ _ __ _ __ ___ _ __ | |_| ____|_ __   ___ ___   __| (_)_ __   __ _
+        // | |  | | | | '__| '__/ _ \ '_ \| __|  _| | '_ \ / __/ _ \ / _` | | '_ \ / _` |
+        // | |__| |_| | |  | | |  __/ | | | |_| |___| | | | (_| (_) | (_| | | | | | (_| |
+        //  \____\__,_|_|  |_|  \___|_| |_|\__|_____|_| |_|\___\___/ \__,_|_|_| |_|\__, |
+        //                                                                         |___/
+        /**
+         * @brief Encodings of the request handled by the current thread, JSON unless the request asks otherwise.
+         *
+         * Set by the ContentNegotiationInterceptor from the Content-Type (request body) and Accept (response)
+         * headers, like the CurrentTenant.
+         */
+        class CurrentEncoding
+        {
+        private:
+            struct State
+            {
+                Encoding    request;
+                Encoding    response;
+                bool        written;    // A DTO was written in the response encoding
+
+                State() : request(Encoding::Json), response(Encoding::Json), written(false) {}
+            };
+
+            static State& current()
+            {
+                static thread_local State state;
+                return state;
+            }
+
+        public:
+            /**
+             * The encoding a media type header names, JSON for anything else. Quality values are not weighed,
+             * a header naming CBOR or MessagePack anywhere gets it.
+             */
+            static Encoding fromHeader(const oatpp::String& header)
+            {
+                if (!header)
+                    return Encoding::Json;
+                if (header->find(primus::constants::mapping::cborContentType) != std::string::npos)
+                    return Encoding::Cbor;
+                if (header->find(primus::constants::mapping::messagePackContentType) != std::string::npos ||
+                    header->find(primus::constants::mapping::messagePackAlternativeContentType) != std::string::npos)
+                    return Encoding::MessagePack;
+                return Encoding::Json;
+            }
+
+            static void set(Encoding request, Encoding response)
+            {
+                current().request = request;
+                current().response = response;
+                current().written = false;
+            }
+
+            static void clear()
+            {
+                current() = State();
+            }
+
+            static Encoding getRequest()
+            {
+                return current().request;
+            }
+
+            static Encoding getResponse()
+            {
+                return current().response;
+            }
+
+            static void markWritten()
+            {
+                current().written = true;
+            }
+
+            static bool isWritten()
+            {
+                return current().written;
+            }
+
+            /**
+             * Content type of the response encoding, e.g. "application/cbor"
+             */
+            static const char* getContentType()
+            {
+                switch (current().response)
+                {
+                case Encoding::Cbor:        return primus::constants::mapping::cborContentType;
+                case Encoding::MessagePack: return primus::constants::mapping::messagePackContentType;
+                default:                    return primus::constants::mapping::jsonContentType;
+                }
+            }
+
+            /**
+             * Appended to cache keys, so the encodings of one resource are cached side by side
+             */
+            static const char* getKeySuffix()
+            {
+                switch (current().response)
+                {
+                case Encoding::Cbor:        return "#cbor";
+                case Encoding::MessagePack: return "#msgpack";
+                default:                    return "";
+                }
+            }
+        };
+
+        //  _   _                  _   _       _   _              ___  _     _           _   __  __
+        // | \ | | ___  __ _  ___ | |_(_) __ _| |_(_)_ __   __ _ / _ \| |__ (_) ___  ___| |_|  \/  | __ _ _ __  _ __   ___ _ __
+        // |  \| |/ _ \/ _` |/ _ \| __| |/ _` | __| | '_ \ / _` | | | | '_ \| |/ _ \/ __| __| |\/| |/ _` | '_ \| '_ \ / _ \ '__|
+        // | |\  |  __/ (_| | (_) | |_| | (_| | |_| | | | | (_| | |_| | |_) | |  __/ (__| |_| |  | | (_| | |_) | |_) |  __/ |
+        // |_| \_|\___|\__, |\___/ \__|_|\__,_|\__|_|_| |_|\__, |\___/|_.__// |\___|\___|\__|_|  |_|\__,_| .__/| .__/ \___|_|
+        //             |___/                               |___/          |__/                           |_|   |_|
+        /**
+         * @brief ObjectMapper writing in the response encoding and reading in the request encoding of the
+         * current request, see CurrentEncoding.
+         *
+         * Its info always names JSON, the content type of a binary response is set by the
+         * ContentNegotiationResetInterceptor or, for serialized cached responses, by the controller.
+         */
+        class NegotiatingObjectMapper : public oatpp::data::mapping::ObjectMapper
+        {
+        private:
+            std::shared_ptr<SpecializedJsonObjectMapper>        m_json;
+            std::shared_ptr<oatpp::data::mapping::ObjectMapper> m_cbor;
+            std::shared_ptr<oatpp::data::mapping::ObjectMapper> m_messagePack;
+
+            oatpp::data::mapping::ObjectMapper* select(Encoding encoding) const
+            {
+                switch (encoding)
+                {
+                case Encoding::Cbor:        return m_cbor.get();
+                case Encoding::MessagePack: return m_messagePack.get();
+                default:                    return m_json.get();
+                }
+            }
+
+        public:
+            NegotiatingObjectMapper(const std::shared_ptr<SpecializedJsonObjectMapper>& json,
+                                    const std::shared_ptr<oatpp::data::mapping::ObjectMapper>& cbor,
+                                    const std::shared_ptr<oatpp::data::mapping::ObjectMapper>& messagePack)
+                : oatpp::data::mapping::ObjectMapper(json->getInfo())
+                , m_json(json)
+                , m_cbor(cbor)
+                , m_messagePack(messagePack)
+            {}
+
+            /**
+             * @param json The JSON mapper, wrapped into a SpecializedJsonObjectMapper. Its binary counterparts are
+             * created with the same includeNullFields
+             */
+            static std::shared_ptr<NegotiatingObjectMapper> createShared(const std::shared_ptr<oatpp::parser::json::mapping::ObjectMapper>& json)
+            {
+                BinaryObjectMapper::Config config;
+                config.includeNullFields = json->getSerializer()->getConfig()->includeNullFields;
+
+                return std::make_shared<NegotiatingObjectMapper>(SpecializedJsonObjectMapper::createShared(json),
+                    BinaryObjectMapper::createShared(BinaryFormat::Cbor, primus::constants::mapping::cborContentType, config),
+                    BinaryObjectMapper::createShared(BinaryFormat::MessagePack, primus::constants::mapping::messagePackContentType, config));
+            }
+
+            /**
+             * The mapper of one encoding, for bodies serialized ahead of the requests they answer
+             */
+            const oatpp::data::mapping::ObjectMapper* getMapper(Encoding encoding) const
+            {
+                return select(encoding);
+            }
+
+            /**
+             * The JSON mapper, for the flat rows it can write without DTOs
+             */
+            const std::shared_ptr<SpecializedJsonObjectMapper>& getJson() const
+            {
+                return m_json;
+            }
+
+            void write(oatpp::data::stream::ConsistentOutputStream* stream, const oatpp::Void& variant) const override
+            {
+                Encoding encoding = CurrentEncoding::getResponse();
+                select(encoding)->write(stream, variant);
+                if (encoding != Encoding::Json)
+                    CurrentEncoding::markWritten();
+            }
+
+            oatpp::Void read(oatpp::parser::Caret& caret, const oatpp::data::mapping::type::Type* type) const override
+            {
+                return select(CurrentEncoding::getRequest())->read(caret, type);
+            }
+        };
+
+    } // namespace mapping
+} // namespace primus
+
+#endif // CONTENTNEGOTIATION_HPP
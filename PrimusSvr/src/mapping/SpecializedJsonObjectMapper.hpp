@@ -0,0 +1,507 @@
+#ifndef SPECIALIZEDJSONOBJECTMAPPER_HPP
+#define SPECIALIZEDJSONOBJECTMAPPER_HPP
+
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/data/mapping/ObjectMapper.hpp"
+#include "oatpp/core/data/stream/BufferStream.hpp"
+#include "oatpp/core/data/stream/Stream.hpp"
+#include "oatpp/parser/json/Utils.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+
+#include "database/RowArena.hpp"
+#include "dto/DatabaseDtos.hpp"
+#include "dto/PageDto.hpp"
+#include "general/constants.hpp"
+
+namespace primus
+{
+    namespace mapping
+    {
+        /**
+         * @brief Lists the fields of a DTO for the SpecializedJsonObjectMapper, in the order the DTO declares them.
+         *
+         * A specialization calls visitor(name, field) once per field. DTOs without one are written by the
+         * generic mapper. The mapper compares each list with the reflection of its DTO when it is created,
+         * so a field added to the DTO but not here falls back to the generic mapper instead of going missing.
+         */
+        template<class DtoT>
+        struct JsonFields;
+
+        template<>
+        struct JsonFields<primus::dto::database::AddressDto>
+        {
+            template<class Visitor>
+            static void visit(const primus::dto::database::AddressDto& dto, Visitor& visitor)
+            {
+                visitor("id", dto.id);
+                visitor("postalCode", dto.postalCode);
+                visitor("city", dto.city);
+                visitor("country", dto.country);
+                visitor("houseNumber", dto.houseNumber);
+                visitor("street", dto.street);
+            }
+        };
+
+        template<>
+        struct JsonFields<primus::dto::database::DateDto>
+        {
+            template<class Visitor>
+            static void visit(const primus::dto::database::DateDto& dto, Visitor& visitor)
+            {
+                visitor("date", dto.date);
+            }
+        };
+
+        template<>
+        struct JsonFields<primus::dto::database::DepartmentDto>
+        {
+            template<class Visitor>
+            static void visit(const primus::dto::database::DepartmentDto& dto, Visitor& visitor)
+            {
+                visitor("id", dto.id);
+                visitor("name", dto.name);
+            }
+        };
+
+        template<>
+        struct JsonFields<primus::dto::database::DepartmentMembershipDto>
+        {
+            template<class Visitor>
+            static void visit(const primus::dto::database::DepartmentMembershipDto& dto, Visitor& visitor)
+            {
+                visitor("memberId", dto.memberId);
+                visitor("departmentId", dto.departmentId);
+            }
+        };
+
+        template<>
+        struct JsonFields<primus::dto::database::PricingRuleDto>
+        {
+            template<class Visitor>
+            static void visit(const primus::dto::database::PricingRuleDto& dto, Visitor& visitor)
+            {
+                visitor("rule", dto.rule);
+                visitor("departmentId", dto.departmentId);
+                visitor("fee", dto.fee);
+            }
+        };
+
+        template<>
+        struct JsonFields<primus::dto::database::MemberDto>
+        {
+            template<class Visitor>
+            static void visit(const primus::dto::database::MemberDto& dto, Visitor& visitor)
+            {
+                visitor("id", dto.id);
+                visitor("firstName", dto.firstName);
+                visitor("lastName", dto.lastName);
+                visitor("email", dto.email);
+                visitor("phoneNumber", dto.phoneNumber);
+                visitor("birthDate", dto.birthDate);
+                visitor("createDate", dto.createDate);
+                visitor("notes", dto.notes);
+                visitor("active", dto.active);
+            }
+        };
+
+        template<class T>
+        struct JsonFields<primus::dto::PageDto<T>>
+        {
+            template<class Visitor>
+            static void visit(const primus::dto::PageDto<T>& dto, Visitor& visitor)
+            {
+                visitor("offset", dto.offset);
+                visitor("limit", dto.limit);
+                visitor("count", dto.count);
+                visitor("items", dto.items);
+            }
+        };
+
+        template<>
+        struct JsonFields<primus::dto::MemberPageDto> : JsonFields<primus::dto::PageDto<oatpp::Object<primus::dto::database::MemberDto>>>
+        {};
+
+        //      _                 ____  _     __        __    _ _
+        //     | |___  ___  _ __ |  _ \| |_ __\ \      / / __(_) |_ ___ _ __
+        //  _  | / __|/ _ \| '_ \| | | | __/ _ \ \ /\ / / '__| | __/ _ \ '__|
+        // | |_| \__ \ (_) | | | | |_| | || (_) \ V  V /| |  | | ||  __/ |
+        //  \___/|___/\___/|_| |_|____/ \__\___/ \_/\_/ |_|  |_|\__\___|_|
+        /**
+         * @brief Writes DTOs with a JsonFields specialization straight to a stream, byte for byte like the
+         * oatpp JSON serializer with the same configuration.
+         *
+         * Every field is written by an overload picked at compile time, no type information is looked up.
+         * Strings without characters to escape are copied as they are, the others go through the escaping
+         * of the JSON serializer.
+         */
+        class JsonDtoWriter
+        {
+        private:
+            oatpp::data::stream::ConsistentOutputStream*                m_stream;
+            const oatpp::parser::json::mapping::Serializer::Config&     m_config;
+            bool                                                        m_first;    // No field of the current object written yet
+
+            template<v_buff_size N>
+            void key(const char (&name)[N])
+            {
+                if (!m_first)
+                    m_stream->writeCharSimple(',');
+                m_first = false;
+                m_stream->writeCharSimple('"');
+                m_stream->writeSimple(name, N - 1);
+                m_stream->writeSimple("\":", 2);
+            }
+
+            static bool needsEscaping(const char* data, v_buff_size size)
+            {
+                for (v_buff_size i = 0; i < size; i++)
+                {
+                    unsigned char c = static_cast<unsigned char>(data[i]);
+                    if (c < 0x20 || c >= 0x80 || c == '"' || c == '\\' || c == '/')
+                        return true;
+                }
+                return false;
+            }
+
+            void writeText(const char* data, v_buff_size size)
+            {
+                m_stream->writeCharSimple('"');
+                if (needsEscaping(data, size))
+                {
+                    oatpp::String escaped = oatpp::parser::json::Utils::escapeString(data, size, m_config.escapeFlags);
+                    m_stream->writeSimple(escaped->data(), static_cast<v_buff_size>(escaped->size()));
+                }
+                else
+                    m_stream->writeSimple(data, size);
+                m_stream->writeCharSimple('"');
+            }
+
+            template<class T>
+            static bool isNull(const T& value)
+            {
+                return !value;
+            }
+
+            template<class T>
+            static bool isNull(const std::vector<T>&)
+            {
+                return false;
+            }
+
+        public:
+            JsonDtoWriter(oatpp::data::stream::ConsistentOutputStream* stream, const oatpp::parser::json::mapping::Serializer::Config& config)
+                : m_stream(stream)
+                , m_config(config)
+                , m_first(true)
+            {}
+
+            void write(const oatpp::UInt32& value)
+            {
+                if (value)
+                    m_stream->writeAsString(*value);
+                else
+                    m_stream->writeSimple("null", 4);
+            }
+
+            void write(const oatpp::Boolean& value)
+            {
+                if (!value)
+                    m_stream->writeSimple("null", 4);
+                else if (*value)
+                    m_stream->writeSimple("true", 4);
+                else
+                    m_stream->writeSimple("false", 5);
+            }
+
+            void write(const oatpp::String& value)
+            {
+                if (value)
+                    writeText(value->data(), static_cast<v_buff_size>(value->size()));
+                else
+                    m_stream->writeSimple("null", 4);
+            }
+
+            void write(const primus::database::TextView& value)
+            {
+                if (value)
+                    writeText(value.data, value.size);
+                else
+                    m_stream->writeSimple("null", 4);
+            }
+
+            void write(const primus::database::ValueView<v_uint32>& value)
+            {
+                if (value)
+                    m_stream->writeAsString(value.value);
+                else
+                    m_stream->writeSimple("null", 4);
+            }
+
+            void write(const primus::database::ValueView<bool>& value)
+            {
+                if (!value)
+                    m_stream->writeSimple("null", 4);
+                else if (value.value)
+                    m_stream->writeSimple("true", 4);
+                else
+                    m_stream->writeSimple("false", 5);
+            }
+
+            template<class DtoT>
+            void write(const oatpp::Object<DtoT>& value)
+            {
+                if (!value)
+                {
+                    m_stream->writeSimple("null", 4);
+                    return;
+                }
+
+                m_stream->writeCharSimple('{');
+                m_first = true;
+                JsonFields<DtoT>::visit(*value, *this);
+                m_stream->writeCharSimple('}');
+
+                /* Back in the enclosing object, whose field this was */
+                m_first = false;
+            }
+
+            template<class T>
+            void write(const oatpp::Vector<T>& value)
+            {
+                if (!value)
+                {
+                    m_stream->writeSimple("null", 4);
+                    return;
+                }
+
+                bool first = true;
+                m_stream->writeCharSimple('[');
+                for (const T& item : *value)
+                {
+                    if (!item && !m_config.includeNullFields && !m_config.alwaysIncludeNullCollectionElements)
+                        continue;
+                    if (!first)
+                        m_stream->writeCharSimple(',');
+                    first = false;
+                    write(item);
+                }
+                m_stream->writeCharSimple(']');
+            }
+
+            /**
+             * Writes a flat row or page of the database layer, which lists its own fields like MemberRow::visit
+             */
+            template<class FlatT>
+            void writeFlat(const FlatT& value)
+            {
+                m_stream->writeCharSimple('{');
+                m_first = true;
+                FlatT::visit(value, *this);
+                m_stream->writeCharSimple('}');
+                m_first = false;
+            }
+
+            template<class FlatT>
+            void write(const std::vector<FlatT>& value)
+            {
+                m_stream->writeCharSimple('[');
+                for (std::size_t i = 0; i < value.size(); i++)
+                {
+                    if (i > 0)
+                        m_stream->writeCharSimple(',');
+                    writeFlat(value[i]);
+                }
+                m_stream->writeCharSimple(']');
+            }
+
+            /**
+             * Writes one field of an object, called by JsonFields<DtoT>::visit
+             */
+            template<v_buff_size N, class T>
+            void operator()(const char (&name)[N], const T& value)
+            {
+                if (isNull(value) && !m_config.includeNullFields)
+                    return;
+                key(name);
+                write(value);
+            }
+        };
+
+        //  ____                  _       _ _             _     _                  ___  _     _           _   __  __
+        // / ___| _ __   ___  ___(_) __ _| (_)_______  __| |   | |___  ___  _ __  / _ \| |__ (_) ___  ___| |_|  \/  | __ _ _ __  _ __   ___ _ __
+        // \___ \| '_ \ / _ \/ __| |/ _` | | |_  / _ \/ _` |_  | / __|/ _ \| '_ \| | | | '_ \| |/ _ \/ __| __| |\/| |/ _` | '_ \| '_ \ / _ \ '__|
+        //  ___) | |_) |  __/ (__| | (_| | | |/ /  __/ (_| | |_| \__ \ (_) | | | | |_| | |_) | |  __/ (__| |_| |  | | (_| | |_) | |_) |  __/ |
+        // |____/| .__/ \___|\___|_|\__,_|_|_/___\___|\__,_|\___/|___/\___/|_| |_|\___/|_.__// |\___|\___|\__|_|  |_|\__,_| .__/| .__/ \___|_|
+        //       |_|                                                                       |__/                           |_|   |_|
+        /**
+         * @brief JSON ObjectMapper writing the hot DTOs with a JsonDtoWriter and everything else with the
+         * generic oatpp mapper it wraps.
+         *
+         * The DTOs of dto/DatabaseDtos.hpp and their pages are written without runtime reflection, as
+         * objects or as vectors of them. Pages of flat rows decoded by a primus::database::RowDecoder are
+         * written by writeRows. Reading is left to the generic mapper.
+         */
+        class SpecializedJsonObjectMapper : public oatpp::data::mapping::ObjectMapper
+        {
+        private:
+            typedef void (*Writer)(JsonDtoWriter& writer, const oatpp::Void& variant);
+
+            std::shared_ptr<oatpp::parser::json::mapping::ObjectMapper>         m_generic;
+            std::unordered_map<const oatpp::data::mapping::type::Type*, Writer> m_writers;
+            std::unordered_set<std::type_index>                                 m_rowTypes;     // Flat rows encoding like their DTO
+
+            /**
+             * Collects the field names a JsonFields specialization lists
+             */
+            struct NameCollector
+            {
+                std::vector<std::string> names;
+
+                template<v_buff_size N, class T>
+                void operator()(const char (&name)[N], const T&)
+                {
+                    names.push_back(name);
+                }
+            };
+
+            template<class Wrapper>
+            static void writeVariant(JsonDtoWriter& writer, const oatpp::Void& variant)
+            {
+                writer.write(variant.staticCast<Wrapper>());
+            }
+
+            /**
+             * Whether names are the fields of the DTO, in the order it declares them
+             */
+            template<class DtoT>
+            static bool matches(const std::vector<std::string>& names)
+            {
+                auto type = oatpp::Object<DtoT>::Class::getType();
+                auto dispatcher = static_cast<const oatpp::data::mapping::type::__class::AbstractObject::PolymorphicDispatcher*>(type->polymorphicDispatcher);
+                const auto& properties = dispatcher->getProperties()->getList();
+
+                bool matches = properties.size() == names.size();
+                auto name = names.begin();
+                for (auto it = properties.begin(); matches && it != properties.end(); ++it, ++name)
+                    matches = *name == (*it)->name;
+
+                if (!matches)
+                    OATPP_LOGE(primus::constants::mapping::logName, "The JSON fields of %s do not match the DTO, it is written by the generic mapper", type->classId.name);
+                return matches;
+            }
+
+            /**
+             * Registers the writers of a DTO, unless its JsonFields specialization misses a field or lists them
+             * in another order than the DTO
+             */
+            template<class DtoT>
+            void add()
+            {
+                DtoT dto;
+                NameCollector collector;
+                JsonFields<DtoT>::visit(dto, collector);
+                if (!matches<DtoT>(collector.names))
+                    return;
+
+                m_writers[oatpp::Object<DtoT>::Class::getType()] = &writeVariant<oatpp::Object<DtoT>>;
+                m_writers[oatpp::Vector<oatpp::Object<DtoT>>::Class::getType()] = &writeVariant<oatpp::Vector<oatpp::Object<DtoT>>>;
+            }
+
+            /**
+             * Allows writeRows for a flat row type, unless it lists other fields than its DTO
+             */
+            template<class RowT>
+            void addRows()
+            {
+                RowT row;
+                NameCollector collector;
+                RowT::visit(row, collector);
+                if (matches<typename RowT::Dto>(collector.names))
+                    m_rowTypes.insert(std::type_index(typeid(RowT)));
+            }
+
+        public:
+            SpecializedJsonObjectMapper(const std::shared_ptr<oatpp::parser::json::mapping::ObjectMapper>& generic)
+                : oatpp::data::mapping::ObjectMapper(generic->getInfo())
+                , m_generic(generic)
+            {
+                add<primus::dto::database::AddressDto>();
+                add<primus::dto::database::DateDto>();
+                add<primus::dto::database::DepartmentDto>();
+                add<primus::dto::database::DepartmentMembershipDto>();
+                add<primus::dto::database::PricingRuleDto>();
+                add<primus::dto::database::MemberDto>();
+                add<primus::dto::PageDto<oatpp::Object<primus::dto::database::AddressDto>>>();
+                add<primus::dto::PageDto<oatpp::Object<primus::dto::database::DateDto>>>();
+                add<primus::dto::PageDto<oatpp::Object<primus::dto::database::DepartmentDto>>>();
+                add<primus::dto::PageDto<oatpp::Object<primus::dto::database::MemberDto>>>();
+                add<primus::dto::MemberPageDto>();
+                addRows<primus::database::MemberRow>();
+            }
+
+            static std::shared_ptr<SpecializedJsonObjectMapper> createShared(const std::shared_ptr<oatpp::parser::json::mapping::ObjectMapper>& generic)
+            {
+                return std::make_shared<SpecializedJsonObjectMapper>(generic);
+            }
+
+            const std::shared_ptr<oatpp::parser::json::mapping::ObjectMapper>& getGeneric() const
+            {
+                return m_generic;
+            }
+
+            /**
+             * Whether writeRows can write pages of RowT. Decide before decoding, the DTO path is the fallback
+             */
+            template<class RowT>
+            bool canWriteRows() const
+            {
+                return !m_generic->getSerializer()->getConfig()->useBeautifier && m_rowTypes.count(std::type_index(typeid(RowT))) > 0;
+            }
+
+            /**
+             * Writes a page of flat rows exactly like the PageDto of their DTOs, see canWriteRows
+             *
+             * @param capacity Initial size of the output buffer
+             */
+            template<class RowT>
+            oatpp::String writeRows(const primus::database::RowPage<RowT>& page, v_buff_size capacity) const
+            {
+                oatpp::data::stream::BufferOutputStream stream(capacity);
+                JsonDtoWriter json(&stream, *m_generic->getSerializer()->getConfig());
+                json.writeFlat(page);
+                return stream.toString();
+            }
+
+            void write(oatpp::data::stream::ConsistentOutputStream* stream, const oatpp::Void& variant) const override
+            {
+                const auto& config = *m_generic->getSerializer()->getConfig();
+                auto writer = m_writers.find(variant.getValueType());
+
+                /* The beautifier indents, only the generic serializer knows how */
+                if (writer == m_writers.end() || config.useBeautifier)
+                {
+                    m_generic->write(stream, variant);
+                    return;
+                }
+
+                JsonDtoWriter json(stream, config);
+                writer->second(json, variant);
+            }
+
+            oatpp::Void read(oatpp::parser::Caret& caret, const oatpp::data::mapping::type::Type* type) const override
+            {
+                return m_generic->read(caret, type);
+            }
+        };
+
+    } // namespace mapping
+} // namespace primus
+
+#endif // SPECIALIZEDJSONOBJECTMAPPER_HPP
@@ -0,0 +1,485 @@
+#ifndef PRIMUS_TENANTREGISTRY_HPP
+#define PRIMUS_TENANTREGISTRY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include "database/AddressDeduplicator.hpp"
+#include "database/ConnectionPool.hpp"
+#include "database/DatabaseClient.hpp"
+#include "database/Executor.hpp"
+#include "database/MemberDirectory.hpp"
+#include "database/QueryMonitor.hpp"
+#include "database/ReferenceData.hpp"
+#include "filesystemHelper.hpp"
+#include "general/constants.hpp"
+#include "general/environment.hpp"
+
+namespace primus
+{
+    namespace tenant
+    {
+        /**
+         * @brief Thrown if a request names a tenant which has no directory. Answered with 404.
+         */
+        class UnknownTenantError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            UnknownTenantError(const std::string& name)
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_404, "Unknown tenant '" + name + "'")
+            {}
+        };
+
+        /**
+         * @brief Thrown if the tenant header is not a valid tenant name. Answered with 400.
+         */
+        class InvalidTenantError : public oatpp::web::protocol::http::HttpError
+        {
+        public:
+            InvalidTenantError()
+                : oatpp::web::protocol::http::HttpError(oatpp::web::protocol::http::Status::CODE_400, "Invalid tenant name")
+            {}
+        };
+
+        //  _____                      _
+        // |_   _|__ _ __   __ _ _ __ | |_
+        //   | |/ _ \ '_ \ / _` | '_ \| __|
+        //   | |  __/ | | | (_| | | | | |_
+        //   |_|\___|_| |_|\__,_|_| |_|\__|
+        /**
+         * @brief Everything the server keeps per club: database file, connection pool, client, member
+         * directory, reference data and asset directory.
+         *
+         * A tenant lives in a directory of its own below the tenant root. Opening it runs the migrations on
+         * its database, so every club carries its own schema version.
+         */
+        class Tenant
+        {
+        private:
+            std::string                                                     m_name;
+            std::string                                                     m_databaseFile;
+            std::string                                                     m_assetsDirectory;
+            std::shared_ptr<primus::database::InstrumentedConnectionPool>   m_connectionPool;
+            std::shared_ptr<primus::component::DatabaseClient>              m_database;
+            std::shared_ptr<primus::component::MemberDirectory>             m_directory;
+            std::shared_ptr<primus::component::ReferenceDataStore>          m_referenceData;
+            std::atomic<v_int64>                                            m_lastUsed;
+
+            static v_int64 now()
+            {
+                return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+        public:
+            Tenant(const std::string& name,
+                   const std::string& directory,
+                   const primus::database::PoolConfiguration& poolConfiguration,
+                   const std::shared_ptr<primus::database::QueryMonitor>& monitor)
+                : m_name(name)
+                , m_databaseFile(directory + "/" + primus::constants::tenant::databaseFile)
+                , m_assetsDirectory(directory + "/" + primus::constants::tenant::assets)
+                , m_lastUsed(now())
+            {
+                m_connectionPool = primus::database::InstrumentedConnectionPool::createShared(m_databaseFile.c_str(), poolConfiguration);
+
+                auto provider = std::static_pointer_cast<oatpp::provider::Provider<oatpp::sqlite::Connection>>(m_connectionPool);
+                m_database = std::make_shared<primus::component::DatabaseClient>(std::make_shared<primus::database::Executor>(provider, monitor));
+
+                m_directory = std::make_shared<primus::component::MemberDirectory>();
+                m_directory->load(m_database);
+
+                /* A club database is small, its addresses are keyed before the first request instead of in the background */
+                primus::database::AddressDeduplicator(m_database, nullptr).run();
+
+                m_referenceData = std::make_shared<primus::component::ReferenceDataStore>(m_database);
+                m_referenceData->load();
+            }
+
+            Tenant(const Tenant&) = delete;
+            Tenant& operator=(const Tenant&) = delete;
+
+            ~Tenant()
+            {
+                m_referenceData.reset();
+                m_directory.reset();
+                m_database.reset();
+                m_connectionPool->stop();
+            }
+
+            void touch()
+            {
+                m_lastUsed = now();
+            }
+
+            /**
+             * Seconds since the tenant last served a request
+             */
+            v_int64 getIdleSeconds() const
+            {
+                return now() - m_lastUsed.load();
+            }
+
+            const std::string& getName() const
+            {
+                return m_name;
+            }
+
+            const std::string& getAssetsDirectory() const
+            {
+                return m_assetsDirectory;
+            }
+
+            const std::shared_ptr<primus::database::InstrumentedConnectionPool>& getConnectionPool() const
+            {
+                return m_connectionPool;
+            }
+
+            const std::shared_ptr<primus::component::DatabaseClient>& getDatabase() const
+            {
+                return m_database;
+            }
+
+            const std::shared_ptr<primus::component::MemberDirectory>& getDirectory() const
+            {
+                return m_directory;
+            }
+
+            const std::shared_ptr<primus::component::ReferenceDataStore>& getReferenceData() const
+            {
+                return m_referenceData;
+            }
+        };
+
+        //   ____                          _  _____                      _
+        //  / ___|   _ _ __ _ __ ___ _ __ | ||_   _|__ _ __   __ _ _ __ | |_
+        // | |  | | | | '__| '__/ _ \ '_ \| __|| |/ _ \ '_ \ / _` | '_ \| __|
+        // | |__| |_| | |  | | |  __/ | | | |_ | |  __/ | | | (_| | | | | |_
+        //  \____\__,_|_|  |_|  \___|_| |_|\__||_|\___|_| |_|\__,_|_| |_|\__|
+        /**
+         * @brief Tenant of the request handled by the current thread, null for the default database.
+         *
+         * Set by the TenantInterceptor, like the RequestDeadline. Holding the tenant here also keeps it open
+         * until the request is done, even if the registry closes it in the meantime.
+         */
+        class CurrentTenant
+        {
+        private:
+            static std::shared_ptr<Tenant>& current()
+            {
+                static thread_local std::shared_ptr<Tenant> tenant;
+                return tenant;
+            }
+
+        public:
+            static void set(const std::shared_ptr<Tenant>& tenant)
+            {
+                current() = tenant;
+            }
+
+            static void clear()
+            {
+                current().reset();
+            }
+
+            static const std::shared_ptr<Tenant>& get()
+            {
+                return current();
+            }
+
+            /**
+             * Asset directory of the current tenant or the given default
+             */
+            static std::string getAssetsDirectory(const std::string& defaultDirectory)
+            {
+                return current() ? current()->getAssetsDirectory() : defaultDirectory;
+            }
+        };
+
+        //  _____                      _   ____            _     _
+        // |_   _|__ _ __   __ _ _ __ | |_|  _ \ ___  __ _(_)___| |_ _ __ _   _
+        //   | |/ _ \ '_ \ / _` | '_ \| __| |_) / _ \/ _` | / __| __| '__| | | |
+        //   | |  __/ | | | (_| | | | | |_|  _ <  __/ (_| | \__ \ |_| |  | |_| |
+        //   |_|\___|_| |_|\__,_|_| |_|\__|_| \_\___|\__, |_|___/\__|_|   \__, |
+        //                                           |___/                |___/
+        /**
+         * @brief Maps requests to tenants and keeps the most recently used ones open.
+         *
+         * The tenant is named by the X-Tenant header or, failing that, by the first label of the Host header
+         * (club-a.example.org -> club-a). Requests naming no known tenant by host use the default database.
+         *
+         * Tenants are opened on their first request. Beyond the limit of open tenants the least recently used
+         * one is closed, and a background thread closes tenants which were idle for too long. Tenants still
+         * serving a request are skipped.
+         */
+        class TenantRegistry
+        {
+        public:
+            struct Configuration
+            {
+                bool enabled;
+                bool byHost;
+                std::string directory;
+                v_uint32 maxOpen;
+                std::chrono::minutes idleTimeout;
+                v_uint32 maxConnections;
+
+                static Configuration fromEnvironment(const std::string& directory)
+                {
+                    namespace defaults = primus::constants::tenant;
+
+                    Configuration configuration;
+                    configuration.enabled = primus::environment::getBool("PRIMUS_MULTI_TENANT", defaults::enabled);
+                    configuration.byHost = primus::environment::getBool("PRIMUS_TENANT_BY_HOST", defaults::byHost);
+                    configuration.directory = primus::environment::getString("PRIMUS_TENANT_DIRECTORY", directory);
+                    configuration.maxOpen = static_cast<v_uint32>(std::max<unsigned long>(1, primus::environment::getUInt("PRIMUS_TENANT_MAX_OPEN", defaults::maxOpen)));
+                    configuration.idleTimeout = std::chrono::minutes(std::max<unsigned long>(1, primus::environment::getUInt("PRIMUS_TENANT_IDLE_MINUTES", defaults::idleMinutes)));
+                    configuration.maxConnections = static_cast<v_uint32>(std::max<unsigned long>(1, primus::environment::getUInt("PRIMUS_TENANT_POOL_SIZE", defaults::maxConnections)));
+                    return configuration;
+                }
+            };
+
+        private:
+            typedef std::list<std::shared_ptr<Tenant>> LruList;
+
+            Configuration                                           m_configuration;
+            primus::database::PoolConfiguration                     m_poolConfiguration;
+            std::shared_ptr<primus::database::QueryMonitor>         m_monitor;
+            std::mutex                                              m_lock;
+            std::mutex                                              m_openLock;
+            LruList                                                 m_lru;
+            std::unordered_map<std::string, LruList::iterator>      m_index;
+            std::mutex                                              m_scheduleLock;
+            std::condition_variable                                 m_scheduleCondition;
+            std::atomic<bool>                                       m_running;
+            std::thread                                             m_closer;
+
+        private:
+            static bool isValidName(const std::string& name)
+            {
+                if (name.empty() || name.size() > primus::constants::tenant::maxNameLength)
+                    return false;
+
+                for (char c : name)
+                {
+                    if (!std::islower(static_cast<unsigned char>(c)) && !std::isdigit(static_cast<unsigned char>(c)) && c != '-' && c != '_')
+                        return false;
+                }
+                return true;
+            }
+
+            bool exists(const std::string& name) const
+            {
+                return primus::component::filesystem::isDirectory(m_configuration.directory + "/" + name);
+            }
+
+            /**
+             * Removes tenants from the registry, the caller closes them outside of the lock.
+             * Only tenants nobody else holds are taken, the registry owns the last reference to them
+             */
+            void takeClosable(std::vector<std::shared_ptr<Tenant>>& closed, bool idleOnly)
+            {
+                auto it = m_lru.end();
+                while (it != m_lru.begin())
+                {
+                    --it;
+                    if (!idleOnly && m_lru.size() <= m_configuration.maxOpen)
+                        break;
+
+                    bool idle = (*it)->getIdleSeconds() >= std::chrono::duration_cast<std::chrono::seconds>(m_configuration.idleTimeout).count();
+                    if (it->use_count() > 1 || (idleOnly && !idle))
+                        continue;
+
+                    closed.push_back(*it);
+                    m_index.erase((*it)->getName());
+                    it = m_lru.erase(it);
+                }
+            }
+
+            void closeAll(std::vector<std::shared_ptr<Tenant>>& closed)
+            {
+                for (auto& tenant : closed)
+                    OATPP_LOGI(primus::constants::tenant::logName, "Closing tenant '%s', idle for %ld s", tenant->getName().c_str(), static_cast<long>(tenant->getIdleSeconds()));
+                closed.clear();
+            }
+
+            void closeIdle()
+            {
+                std::unique_lock<std::mutex> guard(m_scheduleLock);
+
+                while (m_running)
+                {
+                    m_scheduleCondition.wait_for(guard, std::chrono::minutes(1));
+                    if (!m_running)
+                        break;
+
+                    std::vector<std::shared_ptr<Tenant>> closed;
+                    {
+                        std::lock_guard<std::mutex> lock(m_lock);
+                        takeClosable(closed, true);
+                    }
+                    closeAll(closed);
+                }
+            }
+
+            std::shared_ptr<Tenant> find(const std::string& name)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                auto found = m_index.find(name);
+                if (found == m_index.end())
+                    return nullptr;
+
+                m_lru.splice(m_lru.begin(), m_lru, found->second);
+                (*found->second)->touch();
+                return *found->second;
+            }
+
+        public:
+            TenantRegistry(const Configuration& configuration,
+                           const primus::database::PoolConfiguration& poolConfiguration,
+                           const std::shared_ptr<primus::database::QueryMonitor>& monitor)
+                : m_configuration(configuration)
+                , m_poolConfiguration(poolConfiguration)
+                , m_monitor(monitor)
+                , m_running(false)
+            {
+                /* Dozens of tenants share the process, each one gets a small pool and opens it on demand */
+                m_poolConfiguration.maxConnections = std::min(m_poolConfiguration.maxConnections, m_configuration.maxConnections);
+                m_poolConfiguration.minConnections = std::min(m_poolConfiguration.minConnections, m_poolConfiguration.maxConnections);
+                m_poolConfiguration.warmupConnections = 0;
+
+                if (m_configuration.enabled)
+                    primus::component::filesystem::makeDirectory(m_configuration.directory);
+            }
+
+            ~TenantRegistry()
+            {
+                stop();
+            }
+
+            /**
+             * Starts the thread closing idle tenants, if multi-tenant mode is enabled
+             */
+            void start()
+            {
+                if (!m_configuration.enabled || m_running.exchange(true))
+                    return;
+
+                OATPP_LOGI(primus::constants::tenant::logName, "Multi-tenant mode: tenants in %s, at most %d open, closed after %ld min idle",
+                    m_configuration.directory.c_str(), m_configuration.maxOpen, static_cast<long>(m_configuration.idleTimeout.count()));
+                m_closer = std::thread(&TenantRegistry::closeIdle, this);
+            }
+
+            void stop()
+            {
+                if (!m_running.exchange(false))
+                    return;
+
+                m_scheduleCondition.notify_all();
+                if (m_closer.joinable())
+                    m_closer.join();
+            }
+
+            bool isEnabled() const
+            {
+                return m_configuration.enabled;
+            }
+
+            /**
+             * The tenant with the given name, opened if necessary
+             *
+             * @throws UnknownTenantError if the tenant has no directory
+             *
+             */
+            std::shared_ptr<Tenant> get(const std::string& name)
+            {
+                auto tenant = find(name);
+                if (tenant)
+                    return tenant;
+
+                /* Opening runs the migrations, lookups of open tenants go on meanwhile */
+                std::lock_guard<std::mutex> openGuard(m_openLock);
+
+                tenant = find(name);
+                if (tenant)
+                    return tenant;
+
+                if (!exists(name))
+                    throw UnknownTenantError(name);
+
+                OATPP_LOGI(primus::constants::tenant::logName, "Opening tenant '%s'", name.c_str());
+                tenant = std::make_shared<Tenant>(name, m_configuration.directory + "/" + name, m_poolConfiguration, m_monitor);
+
+                std::vector<std::shared_ptr<Tenant>> closed;
+                {
+                    std::lock_guard<std::mutex> guard(m_lock);
+                    m_lru.push_front(tenant);
+                    m_index[name] = m_lru.begin();
+                    takeClosable(closed, false);
+                }
+                closeAll(closed);
+
+                return tenant;
+            }
+
+            /**
+             * The tenant a request is meant for, null for the default database
+             *
+             * @param tenantHeader Value of the X-Tenant header
+             * @param host Value of the Host header
+             *
+             * @throws InvalidTenantError if the X-Tenant header is not a valid name
+             * @throws UnknownTenantError if the X-Tenant header names an unknown tenant
+             *
+             */
+            std::shared_ptr<Tenant> resolve(const oatpp::String& tenantHeader, const oatpp::String& host)
+            {
+                if (!m_configuration.enabled)
+                    return nullptr;
+
+                if (tenantHeader && !tenantHeader->empty())
+                {
+                    if (!isValidName(*tenantHeader))
+                        throw InvalidTenantError();
+                    return get(*tenantHeader);
+                }
+
+                if (!m_configuration.byHost || !host)
+                    return nullptr;
+
+                std::string name = host->substr(0, host->find_first_of(".:"));
+                std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+                /* Hosts without a tenant directory (localhost, plain addresses) keep using the default database */
+                if (!isValidName(name) || !exists(name))
+                    return nullptr;
+                return get(name);
+            }
+
+            std::size_t getOpenCount()
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                return m_lru.size();
+            }
+
+            const Configuration& getConfiguration() const
+            {
+                return m_configuration;
+            }
+        };
+
+    } // namespace tenant
+} // namespace primus
+
+#endif // PRIMUS_TENANTREGISTRY_HPP